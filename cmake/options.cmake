@@ -13,6 +13,7 @@ option( ENABLE_DEV_MODE "Enable specific dev related printouts." OFF  )
 # extensions
 option( WITH_DOXYGEN "Build documentation with doxygen." OFF )
 option( WITH_GUNDAM_ROOT_APP "Build app gundamRoot." ON )
+option( WITH_GUNDAM_BENCHMARKS "Build app gundamBenchmarks (propagation micro-benchmarks)." OFF )
 option( WITH_CACHE_MANAGER "Enable compiling of the cache manager (required for GPU computing)." ON )
 option( WITH_CUDA_LIB "Enable CUDA language check (Cache::Manager requires a GPU if CUDA is found)." OFF )
 
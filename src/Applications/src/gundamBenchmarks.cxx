@@ -0,0 +1,592 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#include "GundamGlobals.h"
+#include "GundamApp.h"
+#include "GundamUtils.h"
+#include "ParameterSet.h"
+#include "DialBaseFactory.h"
+#include "DialInputBuffer.h"
+#include "DialInterface.h"
+#include "DialResponseSupervisor.h"
+#include "EventDialCache.h"
+#include "JointProbability.h"
+#include "Sample.h"
+#include "TruncatedGaussianSampler.h"
+
+#include "Logger.h"
+#include "CmdLineParser.h"
+#include "GenericToolbox.Json.h"
+#include "GenericToolbox.Utils.h"
+
+#include "TGraph.h"
+#include "TMatrixDSym.h"
+#include "TDecompChol.h"
+#include "TRandom3.h"
+
+#include <cmath>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+
+LoggerInit([]{
+  Logger::getUserHeader() << "[" << FILENAME << "]";
+});
+
+/*
+ * Micro-benchmarks of the propagation hot paths. Everything is built in
+ * memory from random numbers: no config nor input file is needed. Each
+ * benchmark is run nbRuns times and the timings per call are written in a
+ * JSON file so they can be compared between builds.
+ */
+
+namespace {
+
+  /// Run the benchmark body nbRuns_ times. The body returns a checksum so its
+  /// work can't be optimized away, and nbCallsPerRun_ is used to normalise
+  /// the timings.
+  template<typename F> JsonType runBenchmark(const std::string& name_, size_t nbCallsPerRun_, int nbRuns_, F&& runFct_){
+    double checksum{0};
+    double bestTime{std::numeric_limits<double>::max()};
+    double totalTime{0};
+
+    for( int iRun = 0 ; iRun < nbRuns_ ; iRun++ ){
+      auto start = std::chrono::steady_clock::now();
+      checksum += runFct_( iRun );
+      std::chrono::duration<double, std::nano> runTime{std::chrono::steady_clock::now() - start};
+      totalTime += runTime.count();
+      bestTime = std::min(bestTime, runTime.count());
+    }
+
+    JsonType out;
+    out["name"] = name_;
+    out["nbCallsPerRun"] = nbCallsPerRun_;
+    out["nbRuns"] = nbRuns_;
+    out["bestNsPerCall"] = bestTime / double(nbCallsPerRun_);
+    out["meanNsPerCall"] = totalTime / double(nbRuns_) / double(nbCallsPerRun_);
+    out["checksum"] = checksum;
+
+    LogInfo << name_ << ": " << out["meanNsPerCall"].get<double>() << " ns/call (best: "
+            << out["bestNsPerCall"].get<double>() << " ns/call)" << std::endl;
+    return out;
+  }
+
+  /// A smooth positive response curve sampled on nKnots_ knots over [-3, 3]
+  std::unique_ptr<TGraph> makeResponseGraph(int nKnots_, bool isUniform_){
+    auto out = std::make_unique<TGraph>(nKnots_);
+    double slope{gRandom->Uniform(-0.2, 0.2)};
+    double curvature{gRandom->Uniform(-0.02, 0.02)};
+    double step{6. / (nKnots_ - 1)};
+    for( int iKnot = 0 ; iKnot < nKnots_ ; iKnot++ ){
+      double x{-3 + iKnot * step};
+      // keep the order of the knots while moving them
+      if( not isUniform_ and iKnot != 0 and iKnot != nKnots_ - 1 ){ x += gRandom->Uniform(-0.3, 0.3) * step; }
+      out->SetPoint(iKnot, x, 1 + slope * x + curvature * x * x);
+    }
+    return out;
+  }
+
+}
+
+
+int main(int argc, char** argv){
+
+  GundamApp app{"propagation benchmarks"};
+
+  // --------------------------
+  // Read Command Line Args:
+  // --------------------------
+  CmdLineParser clParser;
+
+  clParser.addDummyOption("Main options:");
+  clParser.addOption("outputFile", {"-o", "--out-file"}, "Specify the output JSON file (default: gundamBenchmarks.json)");
+  clParser.addOption("nbEvents", {"-e", "--nb-events"}, "Number of synthetic MC events (default: 100000)");
+  clParser.addOption("nbRuns", {"-r", "--nb-runs"}, "Number of timed runs of each benchmark (default: 10)");
+  clParser.addOption("randomSeed", {"-s", "--seed"}, "Set random seed (default: 1)");
+
+  LogInfo << "Usage: " << std::endl;
+  LogInfo << clParser.getConfigSummary() << std::endl << std::endl;
+
+  clParser.parseCmdLine(argc, argv);
+
+  LogInfo << "Provided arguments: " << std::endl;
+  LogInfo << clParser.getValueSummary() << std::endl << std::endl;
+
+  auto outFilePath{clParser.getOptionVal("outputFile", std::string("gundamBenchmarks.json"))};
+  auto nbEvents{clParser.getOptionVal("nbEvents", 100000)};
+  auto nbRuns{clParser.getOptionVal("nbRuns", 10)};
+  auto randomSeed{clParser.getOptionVal("randomSeed", 1)};
+
+  LogThrowIf(nbEvents <= 0, "Invalid number of events: " << nbEvents);
+  LogThrowIf(nbRuns <= 0, "Invalid number of runs: " << nbRuns);
+
+  // the benchmarks are single threaded: they time the work done by one thread
+  GundamGlobals::getParallelWorker().setNThreads( 1 );
+  gRandom = new TRandom3( randomSeed );
+
+  // sizes of the synthetic setup
+  const int nbParameters{20};
+  const int nbDialsPerParameter{100};
+  const int nbDialsPerEvent{5};
+  const int nbKnots{7};
+  const int nbBinsPerAxis{20};
+  const size_t nbDialCalls{1000000};
+
+  JsonType benchmarkList = JsonType::array();
+
+
+  // --------------------------
+  // Parameters
+  // --------------------------
+  LogInfo << "Defining " << nbParameters << " parameters..." << std::endl;
+  std::vector<ParameterSet> parSetList(1);
+  parSetList[0].setConfig( JsonType{
+    {"name", "benchmarkParameters"},
+    {"isEnabled", true},
+    {"numberOfParameters", nbParameters},
+    {"nominalStepSize", 1.}
+  } );
+  parSetList[0].readConfig();
+  parSetList[0].initialize();
+
+  std::vector<DialInputBuffer> inputBufferList(nbParameters);
+  for( int iPar = 0 ; iPar < nbParameters ; iPar++ ){
+    inputBufferList[iPar].setParSetRef( &parSetList );
+    inputBufferList[iPar].addParameterReference( {0, iPar} );
+    inputBufferList[iPar].initialise();
+    inputBufferList[iPar].update();
+  }
+
+  // same cap as the default dial collections
+  DialResponseSupervisor responseSupervisor;
+  responseSupervisor.setMinResponse( 0 );
+
+  // parameter values visited by the benchmarks
+  std::vector<double> inputValueList(1024);
+  for( auto& value : inputValueList ){ value = gRandom->Uniform(-3, 3); }
+
+
+  // --------------------------
+  // DialBase::evalResponse
+  // --------------------------
+  LogInfo << "Benchmarking the dial evaluation per dial type..." << std::endl;
+  {
+    struct DialTypeDefinition{
+      std::string type;
+      std::string subType;
+      bool isUniform;
+    };
+    std::vector<DialTypeDefinition> dialTypeList{
+        {"Norm", "", true},
+        {"Graph", "", false},
+        {"Graph", "ROOT", false},
+        {"Spline", "catmull-rom", true},
+        {"Spline", "catmull-rom, monotonic", true},
+        {"Spline", "not-a-knot", true},
+        {"Spline", "not-a-knot", false},
+        {"Spline", "ROOT", false},
+    };
+
+    DialInputBuffer inputBuffer;
+    inputBuffer.setParSetRef( &parSetList );
+    inputBuffer.addParameterReference( {0, 0} );
+    inputBuffer.initialise();
+
+    for( auto& dialType : dialTypeList ){
+      std::vector<std::unique_ptr<DialBase>> dialList;
+      dialList.reserve( nbDialsPerParameter );
+      for( int iDial = 0 ; iDial < nbDialsPerParameter ; iDial++ ){
+        auto graph{makeResponseGraph(nbKnots, dialType.isUniform)};
+        dialList.emplace_back( DialBaseFactory().makeDial(
+            dialType.type, dialType.type, dialType.subType, graph.get(), false
+        ) );
+        LogThrowIf(dialList.back() == nullptr, "Could not build the " << dialType.type << " dial.");
+      }
+
+      benchmarkList.emplace_back( runBenchmark(
+          "DialBase::evalResponse/" + dialList[0]->getDialTypeName(), nbDialCalls, nbRuns, [&](int){
+            double sum{0};
+            for( size_t iCall = 0 ; iCall < nbDialCalls ; iCall++ ){
+              inputBuffer.getInputBuffer()[0] = inputValueList[iCall % inputValueList.size()];
+              sum += dialList[iCall % dialList.size()]->evalResponse( inputBuffer );
+            }
+            return sum;
+          }
+      ) );
+    }
+  }
+
+
+  // --------------------------
+  // Sample & events
+  // --------------------------
+  LogInfo << "Creating " << nbEvents << " events in a "
+          << nbBinsPerAxis << "x" << nbBinsPerAxis << " bins sample..." << std::endl;
+  std::vector<Sample> sampleList(1);
+  auto& sample{sampleList[0]};
+  sample.setName("benchmarkSample");
+
+  auto& binning{sample.getBinning()};
+  binning.setName("benchmarkBinning");
+  for( int iX = 0 ; iX < nbBinsPerAxis ; iX++ ){
+    for( int iY = 0 ; iY < nbBinsPerAxis ; iY++ ){
+      auto& bin = binning.getBinList().emplace_back( int(binning.getBinList().size()) );
+      bin.addBinEdge( "var0", double(iX) / nbBinsPerAxis, double(iX + 1) / nbBinsPerAxis );
+      bin.addBinEdge( "var1", double(iY) / nbBinsPerAxis, double(iY + 1) / nbBinsPerAxis );
+      // the variables are stored in the same order as in the events
+      for( auto& edges : bin.getEdgesList() ){ edges.varIndexCache = edges.index; }
+    }
+  }
+  binning.buildSearchIndex();
+
+  Event eventBuffer;
+  eventBuffer.getVariables().setVarNameList( std::make_shared<std::vector<std::string>>( std::vector<std::string>{"var0", "var1"} ) );
+  for( auto& var : eventBuffer.getVariables().getVarList() ){ var.set( double(0) ); }
+
+  auto& mcContainer{sample.getMcContainer()};
+  mcContainer.setName("benchmarkSample/MC");
+  mcContainer.buildHistogram( binning );
+  mcContainer.reserveEventMemory( 0, nbEvents, eventBuffer );
+  for( auto& event : mcContainer.getEventList() ){
+    // populate the low values so the bins are not evenly filled
+    event.getVariables().setVarValue( 0, gRandom->Uniform() * gRandom->Uniform() );
+    event.getVariables().setVarValue( 1, gRandom->Uniform() );
+    mcContainer.getWeightStore().base[event.getIndices().weight] = gRandom->Uniform(0.5, 1.5);
+  }
+
+
+  // --------------------------
+  // DataBinSet lookup
+  // --------------------------
+  LogInfo << "Benchmarking the bin lookup..." << std::endl;
+  LogThrowIf(not binning.isSearchIndexValid(), "The bin search index should have been built.");
+  auto& eventList{mcContainer.getEventList()};
+  benchmarkList.emplace_back( runBenchmark(
+      "DataBinSet::findBinIndex/scan", eventList.size(), nbRuns, [&](int){
+        double sum{0};
+        for( auto& event : eventList ){ sum += event.getVariables().findBinIndex( binning.getBinList() ); }
+        return sum;
+      }
+  ) );
+  benchmarkList.emplace_back( runBenchmark(
+      "DataBinSet::findBinIndex/searchIndex", eventList.size(), nbRuns, [&](int){
+        double sum{0};
+        for( auto& event : eventList ){ sum += event.getVariables().findBinIndex( binning ); }
+        return sum;
+      }
+  ) );
+
+  for( auto& event : eventList ){
+    event.fillBinIndex( binning, mcContainer.getWeightStore() );
+  }
+  mcContainer.updateBinEventList();
+
+
+  // --------------------------
+  // EventDialCache::reweightEntry
+  // --------------------------
+  LogInfo << "Benchmarking the event reweight (" << nbDialsPerEvent << " dials per event)..." << std::endl;
+  {
+    std::vector<std::unique_ptr<DialBase>> dialList;
+    std::vector<DialInterface> dialInterfaceList;
+    dialList.reserve( nbParameters * nbDialsPerParameter );
+    dialInterfaceList.reserve( nbParameters * nbDialsPerParameter ); // referenced by the cache: no reallocation
+    for( int iPar = 0 ; iPar < nbParameters ; iPar++ ){
+      for( int iDial = 0 ; iDial < nbDialsPerParameter ; iDial++ ){
+        auto graph{makeResponseGraph(nbKnots, true)};
+        dialList.emplace_back( DialBaseFactory().makeDial( "Spline", "Spline", "catmull-rom", graph.get(), false ) );
+        auto& dialInterface = dialInterfaceList.emplace_back();
+        dialInterface.setDialBaseRef( dialList.back().get() );
+        dialInterface.setInputBufferRef( &inputBufferList[iPar] );
+        dialInterface.setResponseSupervisorRef( &responseSupervisor );
+      }
+    }
+
+    EventDialCache eventDialCache;
+    auto& cache{eventDialCache.getCache()};
+    cache.reserve( eventList.size() );
+    std::vector<int> parIndexList(nbParameters);
+    for( int iPar = 0 ; iPar < nbParameters ; iPar++ ){ parIndexList[iPar] = iPar; }
+    for( auto& event : eventList ){
+      auto& entry = cache.emplace_back();
+      entry.event = &event;
+      entry.weightStorePtr = &mcContainer.getWeightStore();
+      entry.weightIndex = event.getIndices().weight;
+
+      // distinct parameters for each dial of the event
+      for( int iDial = 0 ; iDial < nbDialsPerEvent ; iDial++ ){
+        std::swap( parIndexList[iDial], parIndexList[iDial + int(gRandom->Integer(nbParameters - iDial))] );
+        int dialIndex{parIndexList[iDial] * nbDialsPerParameter + int(gRandom->Integer(nbDialsPerParameter))};
+        entry.dialResponseCacheList.emplace_back( dialInterfaceList[dialIndex] );
+      }
+    }
+
+    benchmarkList.emplace_back( runBenchmark(
+        "EventDialCache::reweightEntry", cache.size(), nbRuns, [&](int iRun_){
+          // every run moves all the parameters: all dials are re-evaluated
+          for( auto& par : parSetList[0].getParameterList() ){
+            par.setParameterValue( inputValueList[(iRun_ * nbParameters + par.getParameterIndex()) % inputValueList.size()] );
+          }
+          for( auto& inputBuffer : inputBufferList ){ inputBuffer.update(); }
+
+          for( auto& entry : cache ){ eventDialCache.reweightEntry( entry ); }
+          return mcContainer.getSumWeights();
+        }
+    ) );
+  }
+
+
+  // --------------------------
+  // SampleElement::refillHistogram
+  // --------------------------
+  LogInfo << "Benchmarking the histogram refill..." << std::endl;
+  benchmarkList.emplace_back( runBenchmark(
+      "SampleElement::refillHistogram", eventList.size(), nbRuns, [&](int){
+        mcContainer.refillHistogram();
+        double sum{0};
+        for( auto& bin : mcContainer.getHistogram().binList ){ sum += bin.content; }
+        return sum;
+      }
+  ) );
+
+
+  // --------------------------
+  // JointProbability::eval
+  // --------------------------
+  LogInfo << "Benchmarking the joint probabilities..." << std::endl;
+  {
+    // data: a poisson throw around the MC prediction
+    auto& dataContainer{sample.getDataContainer()};
+    dataContainer.setName("benchmarkSample/Data");
+    dataContainer.buildHistogram( binning );
+    for( int iBin = 0 ; iBin < dataContainer.getHistogram().nBins ; iBin++ ){
+      auto& dataBin = dataContainer.getHistogram().binList[iBin];
+      dataBin.content = gRandom->Poisson( mcContainer.getHistogram().binList[iBin].content );
+      dataBin.error = std::sqrt( dataBin.content );
+    }
+
+    std::vector<std::string> jointProbabilityTypeList{
+        "PoissonLLH", "LeastSquares", "Chi2", "BarlowLLH", "BarlowLLH_BANFF_OA2021"
+    };
+    size_t nbBins{binning.getBinList().size()};
+    for( auto& jointProbabilityType : jointProbabilityTypeList ){
+      std::unique_ptr<JointProbability::JointProbabilityBase> jointProbability{
+        JointProbability::makeJointProbability( jointProbabilityType )
+      };
+      jointProbability->readConfig( JsonType{{"type", jointProbabilityType}} );
+      jointProbability->initialize();
+      jointProbability->prepareSamples( sampleList );
+
+      benchmarkList.emplace_back( runBenchmark(
+          "JointProbability::eval/" + jointProbabilityType, nbBins, nbRuns, [&](int){
+            double sum{0};
+            for( int iBin = 0 ; iBin < int(nbBins) ; iBin++ ){ sum += jointProbability->eval( sample, iBin ); }
+            return sum;
+          }
+      ) );
+    }
+  }
+
+
+  // --------------------------
+  // Bounded correlated throws
+  // --------------------------
+  LogInfo << "Benchmarking the bounded correlated throws..." << std::endl;
+  JsonType truncatedThrowCheck;
+  bool isTruncatedThrowCheckPassed{false};
+  {
+    // a few strongly correlated parameters, cut on both sides
+    const int nbThrowPars{3};
+    const int nbThrows{100000};
+    TMatrixDSym covMatrix(nbThrowPars);
+    double corrList[nbThrowPars][nbThrowPars]{{1, 0.7, -0.4}, {0.7, 1, -0.2}, {-0.4, -0.2, 1}};
+    double sigmaList[nbThrowPars]{1, 0.5, 2};
+    for( int iPar = 0 ; iPar < nbThrowPars ; iPar++ ){
+      for( int jPar = 0 ; jPar < nbThrowPars ; jPar++ ){
+        covMatrix[iPar][jPar] = corrList[iPar][jPar] * sigmaList[iPar] * sigmaList[jPar];
+      }
+    }
+    std::vector<double> minDeltaList{-0.5, -0.6, std::nan("unset")};
+    std::vector<double> maxDeltaList{1.5, 0.4, 1.};
+
+    TDecompChol choleskyDecomp(covMatrix);
+    LogThrowIf(not choleskyDecomp.Decompose(), "Could not decompose the test covariance matrix.");
+    TMatrixD choleskyMatrix{TMatrixD::kTransposed, choleskyDecomp.GetU()};
+
+    TruncatedGaussianSampler sampler;
+    sampler.setCovarianceMatrix( covMatrix );
+
+    auto isInBounds = [&](const std::vector<double>& deltaList_){
+      for( int iPar = 0 ; iPar < nbThrowPars ; iPar++ ){
+        if( deltaList_[iPar] < minDeltaList[iPar] or deltaList_[iPar] > maxDeltaList[iPar] ){ return false; }
+      }
+      return true;
+    };
+    auto rejectionThrow = [&](std::vector<double>& deltaList_){
+      int nbTries{0};
+      do{
+        nbTries++;
+        std::vector<double> normalList(nbThrowPars);
+        for( auto& normal : normalList ){ normal = gRandom->Gaus(); }
+        for( int iPar = 0 ; iPar < nbThrowPars ; iPar++ ){
+          deltaList_[iPar] = 0;
+          for( int jPar = 0 ; jPar <= iPar ; jPar++ ){ deltaList_[iPar] += choleskyMatrix[iPar][jPar] * normalList[jPar]; }
+        }
+      } while( not isInBounds(deltaList_) );
+      return nbTries;
+    };
+
+    // the gibbs throws must reproduce the mean and covariance of the rejection throws
+    struct Moments{
+      std::vector<double> sumList;
+      std::vector<std::vector<double>> sumProdMatrix;
+      // the gibbs throws are correlated: the error on the mean is taken from batch means
+      std::vector<std::vector<double>> batchSumList;
+
+      explicit Moments(int nbPars_, int nbBatches_) :
+          sumList(nbPars_, 0), sumProdMatrix(nbPars_, std::vector<double>(nbPars_, 0)),
+          batchSumList(nbBatches_, std::vector<double>(nbPars_, 0)) {}
+      void fill(const std::vector<double>& deltaList_, int iBatch_){
+        for( size_t iPar = 0 ; iPar < sumList.size() ; iPar++ ){
+          sumList[iPar] += deltaList_[iPar];
+          batchSumList[iBatch_][iPar] += deltaList_[iPar];
+          for( size_t jPar = 0 ; jPar < sumList.size() ; jPar++ ){ sumProdMatrix[iPar][jPar] += deltaList_[iPar] * deltaList_[jPar]; }
+        }
+      }
+      [[nodiscard]] double getMean(int iPar_, int nbThrows_) const{ return sumList[iPar_] / nbThrows_; }
+      [[nodiscard]] double getCov(int iPar_, int jPar_, int nbThrows_) const{
+        return sumProdMatrix[iPar_][jPar_] / nbThrows_ - getMean(iPar_, nbThrows_) * getMean(jPar_, nbThrows_);
+      }
+      [[nodiscard]] double getMeanError(int iPar_, int nbThrows_) const{
+        double nbBatches{double(batchSumList.size())};
+        double var{0};
+        for( auto& batchSum : batchSumList ){
+          double batchMean{batchSum[iPar_] / (nbThrows_ / nbBatches)};
+          var += (batchMean - getMean(iPar_, nbThrows_)) * (batchMean - getMean(iPar_, nbThrows_));
+        }
+        return std::sqrt(var / (nbBatches - 1) / nbBatches);
+      }
+    };
+
+    const int nbBatches{100};
+    std::vector<double> deltaList(nbThrowPars);
+    Moments rejection(nbThrowPars, nbBatches);
+    Moments gibbs(nbThrowPars, nbBatches);
+    long nbTries{0};
+    for( int iThrow = 0 ; iThrow < nbThrows ; iThrow++ ){
+      int iBatch{iThrow / (nbThrows / nbBatches)};
+      nbTries += rejectionThrow( deltaList );
+      rejection.fill( deltaList, iBatch );
+      sampler.throwDeltas( minDeltaList, maxDeltaList, deltaList, *gRandom );
+      LogThrowIf(not isInBounds(deltaList), "Gibbs throw out of bounds.");
+      gibbs.fill( deltaList, iBatch );
+    }
+
+    double maxMeanPull{0};
+    double maxCovDiff{0}; // relative to sigma_i * sigma_j
+    for( int iPar = 0 ; iPar < nbThrowPars ; iPar++ ){
+      double meanRejection{rejection.getMean(iPar, nbThrows)};
+      double meanGibbs{gibbs.getMean(iPar, nbThrows)};
+      double meanPull{(meanGibbs - meanRejection) / std::sqrt(
+          std::pow(rejection.getMeanError(iPar, nbThrows), 2) + std::pow(gibbs.getMeanError(iPar, nbThrows), 2)
+      )};
+      LogInfo << "Parameter #" << iPar << ": mean(rejection)=" << meanRejection << " mean(gibbs)=" << meanGibbs
+              << " sigma(rejection)=" << std::sqrt(rejection.getCov(iPar, iPar, nbThrows))
+              << " sigma(gibbs)=" << std::sqrt(gibbs.getCov(iPar, iPar, nbThrows)) << std::endl;
+      maxMeanPull = std::max(maxMeanPull, std::abs(meanPull));
+      for( int jPar = 0 ; jPar < nbThrowPars ; jPar++ ){
+        double sigmaProd{std::sqrt(rejection.getCov(iPar, iPar, nbThrows) * rejection.getCov(jPar, jPar, nbThrows))};
+        maxCovDiff = std::max(maxCovDiff, std::abs(gibbs.getCov(iPar, jPar, nbThrows) - rejection.getCov(iPar, jPar, nbThrows)) / sigmaProd);
+      }
+    }
+
+    // ~5 sigma with 1E5 throws
+    isTruncatedThrowCheckPassed = ( maxMeanPull < 5 and maxCovDiff < 0.03 );
+    LogErrorIf(not isTruncatedThrowCheckPassed)
+      << "The gibbs throws don't match the rejection throws: max mean pull = " << maxMeanPull
+      << ", max covariance difference = " << maxCovDiff << " sigma_i*sigma_j" << std::endl;
+
+    truncatedThrowCheck["nbThrows"] = nbThrows;
+    truncatedThrowCheck["rejectionEfficiency"] = double(nbThrows) / double(nbTries);
+    truncatedThrowCheck["maxMeanPull"] = maxMeanPull;
+    truncatedThrowCheck["maxCovDiff"] = maxCovDiff;
+    truncatedThrowCheck["isPassed"] = isTruncatedThrowCheckPassed;
+    LogInfo << "Rejection efficiency: " << truncatedThrowCheck["rejectionEfficiency"].get<double>() << std::endl;
+
+    const size_t nbTimedThrows{10000};
+    benchmarkList.emplace_back( runBenchmark(
+        "BoundedThrow/Rejection", nbTimedThrows, nbRuns, [&](int){
+          double sum{0};
+          for( size_t iThrow = 0 ; iThrow < nbTimedThrows ; iThrow++ ){ rejectionThrow( deltaList ); sum += deltaList[0]; }
+          return sum;
+        }
+    ) );
+    benchmarkList.emplace_back( runBenchmark(
+        "BoundedThrow/Gibbs", nbTimedThrows, nbRuns, [&](int){
+          double sum{0};
+          for( size_t iThrow = 0 ; iThrow < nbTimedThrows ; iThrow++ ){
+            sampler.throwDeltas( minDeltaList, maxDeltaList, deltaList, *gRandom );
+            sum += deltaList[0];
+          }
+          return sum;
+        }
+    ) );
+  }
+
+
+  // --------------------------
+  // Write results
+  // --------------------------
+  JsonType output;
+  output["gundamVersion"] = GundamUtils::getVersionFullStr();
+  output["setup"] = JsonType{
+    {"nbEvents", nbEvents},
+    {"nbRuns", nbRuns},
+    {"randomSeed", randomSeed},
+    {"nbParameters", nbParameters},
+    {"nbDialsPerParameter", nbDialsPerParameter},
+    {"nbDialsPerEvent", nbDialsPerEvent},
+    {"nbKnots", nbKnots},
+    {"nbBins", binning.getBinList().size()}
+  };
+  output["benchmarks"] = benchmarkList;
+  output["truncatedThrowCheck"] = truncatedThrowCheck;
+
+  LogInfo << "Writing benchmark results in: " << outFilePath << std::endl;
+  GenericToolbox::dumpStringInFile( outFilePath, output.dump(2) );
+
+  LogThrowIf(not isTruncatedThrowCheckPassed, "The bounded correlated throws check failed.");
+  return EXIT_SUCCESS;
+}
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
@@ -3,6 +3,7 @@
 #include "GundamApp.h"
 #include "GundamUtils.h"
 #include "FitterEngine.h"
+#include "PropagatorReplicaPool.h"
 #include "ConfigUtils.h"
 
 #include "Logger.h"
@@ -14,9 +15,11 @@
 #include <TFile.h>
 #include "TH1D.h"
 #include "TH2D.h"
+#include "TRandom3.h"
 
 #include <string>
 #include <vector>
+#include <cstdint>
 
 
 LoggerInit([]{
@@ -42,6 +45,7 @@ int main(int argc, char** argv){
   clParser.addOption("nbThreads", {"-t", "--nb-threads"}, "Specify nb of parallel threads");
   clParser.addOption("nToys", {"-n"}, "Specify number of toys");
   clParser.addOption("randomSeed", {"-s", "--seed"}, "Set random seed");
+  clParser.addOption("nbReplicas", {"--nb-replicas"}, "Propagate the toys concurrently on N propagator replicas");
 
   clParser.addDummyOption("Trigger options:");
   clParser.addTriggerOption("dryRun", {"-d", "--dry-run"}, "Only overrides fitter config and print it.");
@@ -67,15 +71,16 @@ int main(int argc, char** argv){
 
   // Global parameters
   gRandom = new TRandom3(0);     // Initialize with a UUID
+  ULong_t randomSeed;
   if( clParser.isOptionTriggered("randomSeed") ){
-    LogAlert << "Using user-specified random seed: " << clParser.getOptionVal<ULong_t>("randomSeed") << std::endl;
-    gRandom->SetSeed(clParser.getOptionVal<ULong_t>("randomSeed"));
+    randomSeed = clParser.getOptionVal<ULong_t>("randomSeed");
+    LogAlert << "Using user-specified random seed: " << randomSeed << std::endl;
   }
   else{
-    ULong_t seed = time(nullptr);
-    LogInfo << "Using \"time(nullptr)\" random seed: " << seed << std::endl;
-    gRandom->SetSeed(seed);
+    randomSeed = time(nullptr);
+    LogInfo << "Using \"time(nullptr)\" random seed: " << randomSeed << std::endl;
   }
+  gRandom->SetSeed(randomSeed);
   
   GundamGlobals::getParallelWorker().setNThreads( clParser.getOptionVal("nbThreads", 1) );
   LogInfo << "Running the fitter with " << GundamGlobals::getParallelWorker().getNbThreads() << " parallel threads." << std::endl;
@@ -442,6 +447,9 @@ int main(int argc, char** argv){
 
     TH1D histogram{};
     std::vector<BinNormaliser> normList{};
+
+    // sum of the MC bin data over the toys, independent of the propagation
+    std::vector<double> mcBinDataSumList{};
   };
   std::vector<CrossSectionData> crossSectionDataList{};
 
@@ -489,6 +497,7 @@ int main(int argc, char** argv){
         0,
         sample.getMcContainer().getHistogram().nBins
     );
+    xsecEntry.mcBinDataSumList.resize( sample.getMcContainer().getHistogram().nBins, 0 );
   }
 
   int nToys{ clParser.getOptionVal<int>("nToys") };
@@ -496,12 +505,12 @@ int main(int argc, char** argv){
   // no bin volume of events -> use the current weight container
   for( auto& xsec : crossSectionDataList ){
     {
-      auto& mcEvList{xsec.samplePtr->getMcContainer().getEventList()};
-      std::for_each(mcEvList.begin(), mcEvList.end(), []( Event& ev_){ ev_.getWeights().current = 0; });
+      auto& mcWeights{xsec.samplePtr->getMcContainer().getWeightStore()};
+      std::fill(mcWeights.current.begin(), mcWeights.current.end(), 0);
     }
     {
-      auto& dataEvList{xsec.samplePtr->getDataContainer().getEventList()};
-      std::for_each(dataEvList.begin(), dataEvList.end(), []( Event& ev_){ ev_.getWeights().current = 0; });
+      auto& dataWeights{xsec.samplePtr->getDataContainer().getWeightStore()};
+      std::fill(dataWeights.current.begin(), dataWeights.current.end(), 0);
     }
   }
 
@@ -511,50 +520,46 @@ int main(int argc, char** argv){
   enableStatThrowInToys = GenericToolbox::Json::fetchValue( xsecCalcConfig, "enableStatThrowInToys", enableStatThrowInToys);
   enableEventMcThrow    = GenericToolbox::Json::fetchValue( xsecCalcConfig, "enableEventMcThrow", enableEventMcThrow);
 
-  auto writeBinDataFct = std::function<void()>([&]{
-    for( auto& xsec : crossSectionDataList ){
+  // the bin contents, the random generator and the parSet normalisations
+  // depend on where the toy has been propagated
+  typedef std::function<double(size_t iXsec_, int iBin_)> BinContentFct;
+  typedef std::function<double(size_t iParSetNorm_)> NormFactorFct;
+  auto writeBinDataFct = std::function<void(const BinContentFct&, TRandom&, const NormFactorFct&)>(
+      [&](const BinContentFct& getBinContent_, TRandom& rng_, const NormFactorFct& getNormFactor_){
+    for( size_t iXsec = 0 ; iXsec < crossSectionDataList.size() ; iXsec++ ){
+      auto& xsec = crossSectionDataList[iXsec];
 
       xsec.branchBinsData.resetCurrentByteOffset();
       for( int iBin = 0 ; iBin < xsec.samplePtr->getMcContainer().getHistogram().nBins ; iBin++ ){
-        double binData{ xsec.samplePtr->getMcContainer().getHistogram().binList[iBin].content };
+        double binData{ getBinContent_(iXsec, iBin) };
 
         // special re-norm
         for( auto& normData : xsec.normList ){
           if( not std::isnan( normData.normParameter.first ) ){
             double norm{normData.normParameter.first};
-            if( normData.normParameter.second != 0 ){ norm += normData.normParameter.second * gRandom->Gaus(); }
+            if( normData.normParameter.second != 0 ){ norm += normData.normParameter.second * rng_.Gaus(); }
             binData /= norm;
           }
           else if( not normData.parSetNormaliserName.empty() ){
-            ParSetNormaliser* parSetNormPtr{nullptr};
-            for( auto& parSetNorm : parSetNormList ){
-              if( parSetNorm.name == normData.parSetNormaliserName ){
-                parSetNormPtr = &parSetNorm;
-                break;
-              }
-            }
-            LogThrowIf(parSetNormPtr == nullptr, "Could not find parSetNorm obj with name: " << normData.parSetNormaliserName);
+            size_t iParSetNorm{0};
+            while( iParSetNorm < parSetNormList.size() and parSetNormList[iParSetNorm].name != normData.parSetNormaliserName ){ iParSetNorm++; }
+            LogThrowIf(iParSetNorm == parSetNormList.size(), "Could not find parSetNorm obj with name: " << normData.parSetNormaliserName);
 
-            binData /= parSetNormPtr->getNormFactor();
+            binData /= getNormFactor_(iParSetNorm);
           }
         }
 
-        // no bin volume of events
-        {
-          auto& mcEvList{xsec.samplePtr->getMcContainer().getEventList()};
-          std::for_each(mcEvList.begin(), mcEvList.end(), [&]( Event& ev_){
-            if( iBin != ev_.getIndices().bin ){ return; }
-            ev_.getWeights().current += binData;
-          });
-        }
+        // no bin volume of events. The MC event weights are overwritten by
+        // the propagations: they are filled with the sums after the toys.
+        xsec.mcBinDataSumList[iBin] += binData;
 
         // set event weight
         {
-          auto& dataEvList{xsec.samplePtr->getDataContainer().getEventList()};
-          std::for_each(dataEvList.begin(), dataEvList.end(), [&]( Event& ev_){
-            if( iBin != ev_.getIndices().bin ){ return; }
-            ev_.getWeights().current = binData;
-          });
+          auto& dataWeights{xsec.samplePtr->getDataContainer().getWeightStore()};
+          for( size_t iEvent = 0 ; iEvent < dataWeights.size() ; iEvent++ ){
+            if( iBin != dataWeights.bin[iEvent] ){ continue; }
+            dataWeights.current[iEvent] = binData;
+          }
         }
 
         // bin volume
@@ -578,11 +583,17 @@ int main(int argc, char** argv){
     }
   });
 
+  // toys propagated with the propagator itself
+  BinContentFct getSampleBinContent = [&](size_t iXsec_, int iBin_){
+    return crossSectionDataList[iXsec_].samplePtr->getMcContainer().getHistogram().binList[iBin_].content;
+  };
+  NormFactorFct getParSetNormFactor = [&](size_t iParSetNorm_){ return parSetNormList[iParSetNorm_].getNormFactor(); };
+
   {
     LogWarning << "Calculating weight at best-fit" << std::endl;
     for( auto& parSet : propagator.getParametersManager().getParameterSetsList() ){ parSet.moveParametersToPrior(); }
     propagator.propagateParameters();
-    writeBinDataFct();
+    writeBinDataFct( getSampleBinContent, *gRandom, getParSetNormFactor );
     xsecAtBestFitTree->Fill();
     GenericToolbox::writeInTFile( GenericToolbox::mkdirTFile(calcXsecDir, "throws"), xsecAtBestFitTree );
   }
@@ -593,31 +604,115 @@ int main(int argc, char** argv){
   /////////////////////////////////////
   LogWarning << std::endl << GenericToolbox::addUpDownBars( "Generating toys..." ) << std::endl;
 
+  int nbReplicas{ clParser.getOptionVal("nbReplicas", 0) };
+  if( nbReplicas > 0 and not PropagatorReplica::isSupported( propagator ) ){
+    LogAlert << "Some dials can't be evaluated by the propagator replicas. Toys will be propagated one at a time." << std::endl;
+    nbReplicas = 0;
+  }
+
   std::stringstream ss; ss << LogWarning.getPrefixString() << "Generating " << nToys << " toys...";
-  for( int iToy = 0 ; iToy < nToys ; iToy++ ){
+  if( nbReplicas > 0 ){
+    LogInfo << "Building " << nbReplicas << " propagator replicas..." << std::endl;
+
+    // each toy gets its own seeds: the throws don't depend on the number of replicas or threads
+    auto getToySeed = [&](int iToy_, int iStream_){
+      // splitmix64
+      uint64_t z{uint64_t(randomSeed) + 0x9E3779B97F4A7C15ULL * uint64_t(2*iToy_ + iStream_ + 1)};
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      z ^= (z >> 31);
+      return ULong_t( (z & 0xFFFFFFFFULL) | 1 ); // a null seed would be taken from a UUID
+    };
 
-    // loading...
-    GenericToolbox::displayProgressBar( iToy+1, nToys, ss.str() );
+    struct ToySlot{
+      TRandom3 rng{};
+      std::vector<double> parSetNormFactorList{};
+    };
+    std::vector<ToySlot> toySlotList( nbReplicas );
+    PropagatorReplicaPool replicaPool{"calcXsec::propagateReplicas"};
+    replicaPool.build( propagator, nbReplicas );
+
+    TMatrixD throwDeltas{};
+    replicaPool.evalBatch(
+        nToys,
+        [&](int iToy_){
+          // the parameters of the batch are thrown at once, each toy keeping its own seed
+          int iThrow{iToy_ % nbReplicas};
+          if( iThrow == 0 ){
+            int nBatchToys{std::min( nbReplicas, nToys - iToy_ )};
+            auto batchDeltas = propagator.getParametersManager().throwGlobalCovarianceDeltas(
+                nBatchToys, [&](int iThrow_){ gRandom->SetSeed( getToySeed(iToy_ + iThrow_, 0) ); }
+            );
+            throwDeltas.ResizeTo( batchDeltas ); // the last batch can be smaller
+            throwDeltas = batchDeltas;
+          }
 
-    // Do the throwing:
-    propagator.getParametersManager().throwParametersFromGlobalCovariance();
-    propagator.propagateParameters();
+          if( not propagator.getParametersManager().applyGlobalCovarianceThrow( throwDeltas, iThrow ) ){
+            // out of bounds: replay the random sequence of this toy, the rethrows follow the first attempt
+            gRandom->SetSeed( getToySeed(iToy_, 0) );
+            propagator.getParametersManager().throwParametersFromGlobalCovariance();
+          }
+          propagator.resetEventWeights(); // updates the dial inputs
 
-    if( enableStatThrowInToys ){
-      for( auto& xsec : crossSectionDataList ){
-        if( enableEventMcThrow ){
+          auto& toySlot = toySlotList[iThrow];
+          toySlot.parSetNormFactorList.resize( parSetNormList.size() );
+          for( size_t iParSetNorm = 0 ; iParSetNorm < parSetNormList.size() ; iParSetNorm++ ){
+            toySlot.parSetNormFactorList[iParSetNorm] = parSetNormList[iParSetNorm].getNormFactor();
+          }
+          toySlot.rng.SetSeed( getToySeed(iToy_, 1) );
+          return true;
+        },
+        [&](int iToy_, PropagatorReplica& replica_){
+          // written in the toy order
+          auto& toySlot = toySlotList[iToy_ % nbReplicas];
+          GenericToolbox::displayProgressBar( iToy_+1, nToys, ss.str() );
+
+          auto& sampleBufferList = replica_.getSampleBufferList();
+          writeBinDataFct(
+              [&](size_t iXsec_, int iBin_){ return sampleBufferList[iXsec_].binContentList[iBin_]; },
+              toySlot.rng,
+              [&](size_t iParSetNorm_){ return toySlot.parSetNormFactorList[iParSetNorm_]; }
+          );
+          xsecThrowTree->Fill();
+        },
+        [&](int iToy_, PropagatorReplica& replica_){
+          if( not enableStatThrowInToys ){ return; }
+          auto& toySlot = toySlotList[iToy_ % nbReplicas];
           // Take into account the finite amount of event in MC
-          xsec.samplePtr->getMcContainer().throwEventMcError();
+          if( enableEventMcThrow ){ replica_.throwEventMcError( toySlot.rng ); }
+          // Asimov bin content -> toy data
+          replica_.throwStatError( toySlot.rng );
+        }
+    );
+  }
+  else{
+    for( int iToy = 0 ; iToy < nToys ; iToy++ ){
+
+      // loading...
+      GenericToolbox::displayProgressBar( iToy+1, nToys, ss.str() );
+
+      // Do the throwing:
+      propagator.getParametersManager().throwParametersFromGlobalCovariance();
+      // the MC weights have been modified after the last propagation (stat throws, bin data)
+      propagator.requestFullReweight();
+      propagator.propagateParameters();
+
+      if( enableStatThrowInToys ){
+        for( auto& xsec : crossSectionDataList ){
+          if( enableEventMcThrow ){
+            // Take into account the finite amount of event in MC
+            xsec.samplePtr->getMcContainer().throwEventMcError();
+          }
+          // Asimov bin content -> toy data
+          xsec.samplePtr->getMcContainer().throwStatError();
         }
-        // Asimov bin content -> toy data
-        xsec.samplePtr->getMcContainer().throwStatError();
       }
-    }
 
-    writeBinDataFct();
+      writeBinDataFct( getSampleBinContent, *gRandom, getParSetNormFactor );
 
-    // Write the branches
-    xsecThrowTree->Fill();
+      // Write the branches
+      xsecThrowTree->Fill();
+    }
   }
 
 
@@ -684,34 +779,23 @@ int main(int argc, char** argv){
   // now propagate to the engine for the plot generator
   LogInfo << "Re-normalizing the samples for the plot generator..." << std::endl;
   for( auto& xsec : crossSectionDataList ){
-    // this gives the average as the event weights were summed together
     {
-      auto &mcEvList{xsec.samplePtr->getMcContainer().getEventList()};
-      std::vector<size_t> nEventInBin(xsec.histogram.GetNbinsX(), 0);
-      for( size_t iBin = 0 ; iBin < nEventInBin.size() ; iBin++ ){
-        nEventInBin[iBin] = std::count_if(mcEvList.begin(), mcEvList.end(), [iBin]( Event &ev_) {
-          return ev_.getIndices().bin == iBin;
-        });
+      auto& mcWeights{xsec.samplePtr->getMcContainer().getWeightStore()};
+      for( size_t iEvent = 0 ; iEvent < mcWeights.size() ; iEvent++ ){
+        mcWeights.current[iEvent] = mcWeights.bin[iEvent] >= 0 ? xsec.mcBinDataSumList[mcWeights.bin[iEvent]] : 0;
       }
-
-      std::for_each(mcEvList.begin(), mcEvList.end(), [&]( Event &ev_) {
-        ev_.getWeights().current /= nToys;
-        ev_.getWeights().current /= double(nEventInBin[ev_.getIndices().bin]);
-      });
     }
-    {
-      auto &dataEvList{xsec.samplePtr->getDataContainer().getEventList()};
+
+    // this gives the average as the event weights were summed together
+    for( auto* weightStorePtr : { &xsec.samplePtr->getMcContainer().getWeightStore(), &xsec.samplePtr->getDataContainer().getWeightStore() } ){
       std::vector<size_t> nEventInBin(xsec.histogram.GetNbinsX(), 0);
-      for( size_t iBin = 0 ; iBin < nEventInBin.size() ; iBin++ ){
-        nEventInBin[iBin] = std::count_if(dataEvList.begin(), dataEvList.end(), [iBin]( Event &ev_) {
-          return ev_.getIndices().bin== iBin;
-        });
-      }
+      for( auto bin : weightStorePtr->bin ){ if( bin >= 0 ){ nEventInBin[bin]++; } }
 
-      std::for_each(dataEvList.begin(), dataEvList.end(), [&]( Event &ev_) {
-        ev_.getWeights().current /= nToys;
-        ev_.getWeights().current /= double(nEventInBin[ev_.getIndices().bin]);
-      });
+      for( size_t iEvent = 0 ; iEvent < weightStorePtr->size() ; iEvent++ ){
+        if( weightStorePtr->bin[iEvent] < 0 ){ continue; }
+        weightStorePtr->current[iEvent] /= nToys;
+        weightStorePtr->current[iEvent] /= double(nEventInBin[weightStorePtr->bin[iEvent]]);
+      }
     }
   }
 
@@ -380,4 +380,9 @@ int main(int argc, char** argv){
   // --------------------------
   fitter.fit();
 
+#ifdef GUNDAM_USING_CACHE_MANAGER
+  // releases the host kernel job of the parallel worker
+  Cache::Manager::Deinit();
+#endif
+
 }
@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace Cache {
     class IndexedSums;
@@ -33,6 +34,15 @@ private:
     // Cache of whether the result values in memory are valid.
     bool fSumsValid;
 
+    // The per-thread partial sums used when the sums are calculated on
+    // several host threads.  Each thread owns a contiguous block of
+    // GetSumCount() entries, so no atomic addition is needed.
+    std::vector<double> fHostPartialSums;
+    std::vector<double> fHostPartialSums2;
+
+    /// Calculate the sums on the host threads.
+    void HostApply();
+
     /// The (approximate) amount of memory required on the GPU.
     std::size_t fTotalBytes{};
 
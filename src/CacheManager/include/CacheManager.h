@@ -59,6 +59,20 @@ public:
     /// Return true if a GPU is available.
     static bool HasCUDA();
 
+    /// Run the host (non-GPU) kernels on the GundamGlobals parallel worker.
+    /// This is called by Build when the GPU isn't available.  Kernels are
+    /// run on the calling thread when there is only one worker thread.
+    static void SetHostLauncher();
+
+    /// Remove the host kernel job from the parallel worker, and go back to
+    /// running the kernels on the calling thread.  This is called when the
+    /// Cache::Manager is deleted.
+    static void ClearHostLauncher();
+
+    /// Delete the cache manager (if any).  This is called at the end of the
+    /// applications so nothing is left registered with the parallel worker.
+    static void Deinit();
+
     /// Return the approximate allocated memory (e.g. on the GPU).
     std::size_t GetResidentMemory() const {return fTotalBytes;}
 
@@ -113,7 +127,7 @@ private:
     std::size_t fTotalBytes;
 
 public:
-    virtual ~Manager() = default;
+    virtual ~Manager();
 
     // Provide "internal" references to the GPU cache.  This is used in the
     // implementation, and should be ignored by most people.
@@ -19,6 +19,8 @@
 
 #include "hemi.h"
 
+#include "host_threads.h"
+
 namespace hemi
 {
 	HEMI_DEV_CALLABLE_INLINE
@@ -26,7 +28,7 @@ namespace hemi
     #ifdef HEMI_DEV_CODE
     	return threadIdx.x + blockIdx.x * blockDim.x;
     #else
-    	return 0;
+    	return hemi::host::threadIndex();
     #endif
     }
 
@@ -36,7 +38,7 @@ namespace hemi
     #ifdef HEMI_DEV_CODE
     	return blockDim.x * gridDim.x;
     #else
-    	return 1;
+    	return hemi::host::threadCount();
     #endif
     }
 
@@ -31,6 +31,18 @@ namespace hemi {
 	template <typename T>
 	HEMI_DEV_CALLABLE_INLINE
 	step_range<T> grid_stride_range(T begin, T end) {
+#ifndef HEMI_DEV_CODE
+	    // On the host each thread takes a contiguous block of the range
+	    // (a strided loop would make the threads share cache lines).
+	    const T count = hemi::globalThreadCount();
+	    if (count > 1 && begin < end) {
+	        const T index = hemi::globalThreadIndex();
+	        const T block = (end - begin + count - 1)/count;
+	        const T first = (block*index < end - begin) ? begin + block*index : end;
+	        const T last = (block < end - first) ? first + block : end;
+	        return range(first, last).step(1);
+	    }
+#endif
 	    begin += hemi::globalThreadIndex();
 	    return range(begin, end).step(hemi::globalThreadCount());
 	}
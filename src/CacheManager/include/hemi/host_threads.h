@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// "Hemi" CUDA Portable C/C++ Utilities
+//
+// Copyright 2012-2015 NVIDIA Corporation
+//
+// License: BSD License, see LICENSE file in Hemi home directory
+//
+// The home for Hemi is https://github.com/harrism/hemi
+//
+///////////////////////////////////////////////////////////////////////////////
+// GUNDAM extension: support for running host (non-CUDA) launches on more than
+// one CPU thread.  The upstream hemi runs a host launch as a single call of
+// the kernel.  Here, the application can register a "launcher" that calls
+// the kernel once per worker thread.  While a kernel is running on a worker,
+// hemi::globalThreadIndex() and hemi::globalThreadCount() return the worker
+// index and the number of workers, so grid_stride_range splits the loop
+// between the workers.  Without a launcher, the behavior is unchanged.
+///////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <functional>
+
+namespace hemi {
+namespace host {
+
+    /// The work done by one host thread.  It receives the thread index and
+    /// the number of threads.
+    typedef std::function<void(unsigned int, unsigned int)> ThreadWork;
+
+    /// A launcher must call work(iThread, nThreads) for each iThread in
+    /// [0,nThreads) and only return when all of the calls are finished.
+    typedef std::function<void(const ThreadWork&)> Launcher;
+
+    inline Launcher& launcher() {
+        static Launcher hostLauncher;
+        return hostLauncher;
+    }
+
+    /// The number of threads the launcher runs the work on.
+    inline unsigned int& launcherThreads() {
+        static unsigned int nThreads = 1;
+        return nThreads;
+    }
+
+    /// Set the host launcher and the number of threads it uses.  An empty
+    /// launcher restores the single thread behavior.
+    inline void setLauncher(const Launcher& hostLauncher,
+                            unsigned int nThreads) {
+        launcher() = hostLauncher;
+        launcherThreads() = (hostLauncher && nThreads > 0) ? nThreads : 1;
+    }
+
+    /// The index of the host thread running the current kernel.
+    inline unsigned int& threadIndex() {
+        static thread_local unsigned int index = 0;
+        return index;
+    }
+
+    /// The number of host threads running the current kernel.
+    inline unsigned int& threadCount() {
+        static thread_local unsigned int count = 1;
+        return count;
+    }
+
+    /// Run the work on all of the host threads (or on the calling thread if
+    /// there isn't a launcher).  The thread index and count seen by the
+    /// device API are set while the work is running.
+    inline void parallel(const ThreadWork& work) {
+        auto runOnThread = [&work](unsigned int iThread,
+                                   unsigned int nThreads) {
+            unsigned int savedIndex = threadIndex();
+            unsigned int savedCount = threadCount();
+            threadIndex() = iThread;
+            threadCount() = nThreads;
+            work(iThread, nThreads);
+            threadIndex() = savedIndex;
+            threadCount() = savedCount;
+        };
+        if (launcher() && threadCount() == 1) {
+            launcher()(runOnThread);
+            return;
+        }
+        // Either no launcher, or this is already running inside a threaded
+        // launch, so don't nest.
+        runOnThread(0, 1);
+    }
+}
+}
@@ -18,6 +18,8 @@
 
 #ifdef HEMI_CUDA_COMPILER
 #include "configure.h"
+#else
+#include "host_threads.h"
 #endif
 
 namespace hemi {
@@ -32,7 +34,9 @@ void launch(Function f, Arguments... args)
     launch(p, f, args...);
 #else
     HEMI_LAUNCH_OUTPUT("Host launch (no GPU used)");
-    Kernel(f, args...);
+    hemi::host::parallel([&](unsigned int, unsigned int) {
+        Kernel(f, args...);
+    });
 #endif
 }
 
@@ -62,7 +66,9 @@ void launch(const ExecutionPolicy &policy, Function f, Arguments... args)
 void launch(const ExecutionPolicy&, Function f, Arguments... args)
 {
     HEMI_LAUNCH_OUTPUT("Host launch (no GPU used)");
-    Kernel(f, args...);
+    hemi::host::parallel([&](unsigned int, unsigned int) {
+        Kernel(f, args...);
+    });
 }
 #endif
 
@@ -3,10 +3,26 @@
 namespace {
     /// Do an atomic multiplication on the GPU.  On the GPU this uses
      /// compare-and-set.  On the CPU, this is just a multiplication (no
-     /// mutex, so not atomic).
+     /// mutex, so not atomic) unless the kernel is running on several host
+     /// threads, and then it also uses compare-and-set.
     HEMI_DEV_CALLABLE_INLINE
     double CacheAtomicMult(double* address, const double v) {
 #ifndef HEMI_DEV_CODE
+        if (hemi::globalThreadCount() > 1) {
+            // Several host threads may be updating the same result, so use
+            // the compiler builtin compare-and-set.  A failed exchange
+            // reloads "old" with the current value.
+            double old;
+            __atomic_load(address, &old, __ATOMIC_RELAXED);
+            double result = old * v;
+            while (not __atomic_compare_exchange(address, &old, &result,
+                                                 true,
+                                                 __ATOMIC_RELAXED,
+                                                 __ATOMIC_RELAXED)) {
+                result = old * v;
+            }
+            return old;
+        }
         // When this isn't CUDA use a simple multiplication.
         double old = *address;
         *address = *address * v;
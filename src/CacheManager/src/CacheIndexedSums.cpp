@@ -5,6 +5,7 @@
 #include <exception>
 #include <cmath>
 #include <memory>
+#include <algorithm>
 
 #include <hemi/hemi_error.h>
 #include <hemi/launch.h>
@@ -151,10 +152,81 @@ namespace {
 
 }
 
+void Cache::IndexedSums::HostApply() {
+    double* sums = fSums->writeOnlyPtr();
+    double* sums2 = fSums2->writeOnlyPtr();
+    const double* inputs = fEventWeights.readOnlyPtr();
+    const short* indexes = fIndexes->readOnlyPtr();
+    const std::size_t bins = fSums->size();
+    const std::size_t entries = fEventWeights.size();
+    const std::size_t threads = hemi::host::launcherThreads();
+
+    if (threads < 2) {
+        std::fill(sums, sums + bins, 0.0);
+        std::fill(sums2, sums2 + bins, 0.0);
+        for (std::size_t i = 0; i < entries; ++i) {
+            const double v = inputs[i];
+            sums[indexes[i]] += v;
+            sums2[indexes[i]] += v*v;
+        }
+        return;
+    }
+
+    if (fHostPartialSums.size() != threads*bins) {
+        fHostPartialSums.resize(threads*bins);
+        fHostPartialSums2.resize(threads*bins);
+    }
+    double* partialSums = fHostPartialSums.data();
+    double* partialSums2 = fHostPartialSums2.data();
+
+    // Each thread sums a contiguous block of events into its own slice of
+    // the partial sums.
+    hemi::host::parallel([&](unsigned int iThread, unsigned int nThreads) {
+        if (nThreads != threads) {
+            throw std::runtime_error("Host thread count changed");
+        }
+        double* s = partialSums + iThread*bins;
+        double* s2 = partialSums2 + iThread*bins;
+        std::fill(s, s + bins, 0.0);
+        std::fill(s2, s2 + bins, 0.0);
+        const std::size_t block = (entries + threads - 1)/threads;
+        const std::size_t first = std::min(entries, iThread*block);
+        const std::size_t last = std::min(entries, first + block);
+        for (std::size_t i = first; i < last; ++i) {
+            const double v = inputs[i];
+            s[indexes[i]] += v;
+            s2[indexes[i]] += v*v;
+        }
+    });
+
+    // Reduce the slices.  Each thread owns a block of bins, and the slices
+    // are always added in the same order so the result is reproducible.
+    hemi::host::parallel([&](unsigned int iThread, unsigned int nThreads) {
+        const std::size_t block = (bins + nThreads - 1)/nThreads;
+        const std::size_t first = std::min(bins, iThread*block);
+        const std::size_t last = std::min(bins, first + block);
+        for (std::size_t b = first; b < last; ++b) {
+            double v = 0.0;
+            double v2 = 0.0;
+            for (std::size_t t = 0; t < threads; ++t) {
+                v += partialSums[t*bins + b];
+                v2 += partialSums2[t*bins + b];
+            }
+            sums[b] = v;
+            sums2[b] = v2;
+        }
+    });
+}
+
 bool Cache::IndexedSums::Apply() {
     // Mark the results has having changed.
     fSumsValid = false;
 
+#ifndef HEMI_CUDA_COMPILER
+    // On the host, the sums are done with per-thread partial sums instead of
+    // the atomic additions in the kernel.
+    HostApply();
+#else
     HEMIResetKernel resetKernel;
     hemi::launch(resetKernel,
                  fSums->writeOnlyPtr(),
@@ -183,6 +255,7 @@ bool Cache::IndexedSums::Apply() {
 
     // A simple way to force a copy from the device.
     // fSums->hostPtr();
+#endif
 
     return true;
 }
@@ -23,6 +23,8 @@
 #include "LightGraph.h"
 #include "Shift.h"
 
+#include "hemi/host_threads.h"
+
 #include <memory>
 #include <set>
 
@@ -34,6 +36,15 @@ Cache::Manager* Cache::Manager::fSingleton = nullptr;
 bool Cache::Manager::fUpdateRequired = true;
 std::map<const Parameter*, int> Cache::Manager::ParameterMap;
 
+namespace {
+    // The work of the host kernel that is currently being run by the
+    // parallel worker (see Cache::Manager::SetHostLauncher).
+    const hemi::host::ThreadWork* gHostThreadWork = nullptr;
+
+    // True while the host kernel job is registered in the parallel worker.
+    bool gHostLaunchJobIsSet = false;
+}
+
 Cache::Manager::Manager(int events, int parameters,
                         int norms,
                         int compactSplines, int compactPoints,
@@ -125,6 +136,11 @@ Cache::Manager::Manager(int events, int parameters,
             << std::endl;
 }
 
+Cache::Manager::~Manager() {
+    // The host kernels could still refer to the deleted caches.
+    ClearHostLauncher();
+}
+
 bool Cache::Manager::HasCUDA() {
     return Cache::Parameters::UsingCUDA();
 }
@@ -304,6 +320,7 @@ bool Cache::Manager::Build( SampleSet& sampleList,
                                  graphs, graphPoints,
                                  histCells,
                                  "space");
+        if (!Cache::Manager::HasCUDA()) SetHostLauncher();
     }
 
     // In case the cache isn't allocated (usually because it's turned off on
@@ -369,7 +386,7 @@ bool Cache::Manager::Update( SampleSet& sampleList,
             [](){Cache::Manager::Get()->GetWeightsCache().GetResult(0);});
 
         // Get the initial value for this event and save it.
-        double initialEventWeight = event.getWeights().base;
+        double initialEventWeight = elem.weightStorePtr->base[elem.weightIndex];
 
         // Add each dial for the event to the GPU caches.
         for( auto& dialElem : elem.dialResponseCacheList ){
@@ -618,6 +635,43 @@ bool Cache::Manager::Fill() {
     return true;
 }
 
+void Cache::Manager::SetHostLauncher() {
+    // The kernels run on the parallel worker threads when the GPU isn't
+    // available.  A single job is registered and it runs whichever kernel is
+    // currently being launched.
+    const int nThreads = GundamGlobals::getParallelWorker().getNbThreads();
+    if (nThreads < 2) return;
+    LogInfo << "Host kernels will run on " << nThreads << " threads"
+            << std::endl;
+    GundamGlobals::getParallelWorker().addJob(
+        "Cache::Manager::hostLaunch",
+        [nThreads](int iThread) {
+            if (iThread < 0) iThread = 0;
+            (*gHostThreadWork)(iThread, nThreads);
+        });
+    hemi::host::setLauncher(
+        [](const hemi::host::ThreadWork& work) {
+            gHostThreadWork = &work;
+            GundamGlobals::getParallelWorker().runJob(
+                "Cache::Manager::hostLaunch");
+            gHostThreadWork = nullptr;
+        }, nThreads);
+    gHostLaunchJobIsSet = true;
+}
+
+void Cache::Manager::ClearHostLauncher() {
+    if (!gHostLaunchJobIsSet) return;
+    hemi::host::setLauncher(hemi::host::Launcher(), 1);
+    GundamGlobals::getParallelWorker().removeJob(
+        "Cache::Manager::hostLaunch");
+    gHostLaunchJobIsSet = false;
+}
+
+void Cache::Manager::Deinit() {
+    delete fSingleton;
+    fSingleton = nullptr;
+}
+
 int Cache::Manager::ParameterIndex(const Parameter* fp) {
     auto parMapIt = Cache::Manager::ParameterMap.find(fp);
     if (parMapIt == Cache::Manager::ParameterMap.end()) return -1;
@@ -325,6 +325,27 @@ namespace {
                          const short* pIndex,
                          const int* sIndex,
                          const int NP) {
+#ifndef HEMI_CUDA_COMPILER
+        // On the host, collect the splines handled by this thread and
+        // evaluate them in batches using the CPU vector extensions.  The
+        // values are identical to the ones from CalculateUniformSpline.
+        SplineBatchBufferT<WEIGHT_BUFFER_FLOAT> batch(&CalculateUniformSplineBatch, knots);
+        auto store = [&](int i, double v) {
+            const double lClamp = lowerClamp[pIndex[i]];
+            const double uClamp = upperClamp[pIndex[i]];
+            if (v < lClamp) v = lClamp;
+            if (v > uClamp) v = uClamp;
+#ifdef CACHE_MANAGER_SLOW_VALIDATION
+            splineValues[i] = v;
+#endif
+            CacheAtomicMult(&results[rIndex[i]], v);
+        };
+        for (int i : hemi::grid_stride_range(0,NP)) {
+            const int dim = sIndex[i+1]-sIndex[i];
+            batch.Add(params[pIndex[i]], sIndex[i], dim, i, store);
+        }
+        batch.Flush(store);
+#else
         for (int i : hemi::grid_stride_range(0,NP)) {
             const int id0 = sIndex[i];
             const int id1 = sIndex[i+1];
@@ -370,6 +391,7 @@ namespace {
 
             CacheAtomicMult(&results[rIndex[i]], v);
         }
+#endif
     }
 }
 
@@ -10,11 +10,13 @@
 
 #include "Propagator.h"
 #include "JsonBaseClass.h"
+#include "CompiledFormula.h"
 
 #include "TChain.h"
 #include "nlohmann/json.hpp"
 
 #include <map>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -34,6 +36,7 @@ public:
 
   // setters
   void setOwner( DatasetDefinition* owner_){ _owner_ = owner_; }
+  void setSnapshotDirectory(const std::string& snapshotDirectory_){ _snapshotDirectory_ = snapshotDirectory_; }
 
   // const getters
   [[nodiscard]] const DataDispenserParameters &getParameters() const{ return _parameters_; }
@@ -48,6 +51,30 @@ public:
   void load(Propagator& propagator_);
 
 protected:
+  /// A selection cut is compiled when possible and evaluated from the leaf
+  /// buffers. Otherwise, it is a TTreeFormula leaf expression of the
+  /// LeafCollection. On the first entries, the compiled cuts are also
+  /// evaluated with their TTreeFormula to check that both agree.
+  struct SelectionCut{
+    std::string formulaStr{}; // empty if there is no cut
+    int leafExpIndex{-1}; // TTreeFormula fallback, or cross-check of the compiled formula
+    CompiledFormula compiledFormula{};
+    std::vector<int> leafIndexList{}; // compiled formula variable -> SelectionCuts leaf
+  };
+  struct SelectionCuts{
+    SelectionCut globalCut{};
+    std::vector<SelectionCut> sampleCutList{};
+
+    // leaves read by the compiled cuts, shared by all the cuts
+    std::vector<std::string> leafExpList{};
+    std::vector<int> leafExpIndexList{};
+    std::vector<CompiledFormula::ValueType> leafTypeList{};
+    std::vector<const GenericToolbox::LeafForm*> leafFormList{}; // set by bindSelectionCuts()
+    std::vector<double> leafValueList{}; // read once per entry
+
+    int nbEntriesToCheck{0}; // compiled cuts left to compare with their TTreeFormula
+  };
+
   void buildSampleToFillList();
   void parseStringParameters();
   void doEventSelection();
@@ -55,9 +82,27 @@ protected:
   void preAllocateMemory();
   void readAndFill();
   void loadFromHistContent();
+  void fillVarIndexCache();
+  void printSampleEventCount();
+
+  // single-pass loading
+  void prepareThreadFillBuffers();
+  void mergeThreadFillBuffers();
+
+  // snapshots
+  uint64_t buildSnapshotKey();
 
   // utils
   std::unique_ptr<TChain> openChain(bool verbose_ = false);
+  /// Number of evaluations of each compiled formula compared with ROOT, per thread
+  [[nodiscard]] int getNbCompiledFormulaChecks() const;
+  /// Types of the sample event variables. Outputs of the transforms are stored as double.
+  void fillStorageTypeNameList(const std::vector<const GenericToolbox::LeafForm*>& leafFormStorageList_);
+  SelectionCuts defineSelectionCuts(GenericToolbox::LeafCollection& lCollection_, TChain& treeChain_, bool verbose_);
+  void defineSelectionCut(SelectionCut& cut_, SelectionCuts& cuts_, GenericToolbox::LeafCollection& lCollection_, TChain& treeChain_);
+  /// To be called once the LeafCollection is initialized
+  static void bindSelectionCuts(SelectionCuts& cuts_, GenericToolbox::LeafCollection& lCollection_);
+  bool evalSelectionCuts(SelectionCuts& cuts_, GenericToolbox::LeafCollection& lCollection_, TChain& treeChain_, std::vector<bool>& isInSampleList_);
 
   // multi-thread
   void eventSelectionFunction(int iThread_);
@@ -69,6 +114,7 @@ private:
   DataDispenserParameters _parameters_;
 
   // internals
+  std::string _snapshotDirectory_{};
   DatasetDefinition* _owner_{nullptr};
   DataDispenserCache _cache_;
 
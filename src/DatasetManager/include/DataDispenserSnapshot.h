@@ -0,0 +1,95 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#ifndef GUNDAM_DATA_DISPENSER_SNAPSHOT_H
+#define GUNDAM_DATA_DISPENSER_SNAPSHOT_H
+
+#include "DataDispenserUtils.h"
+
+#include "string"
+#include "vector"
+#include "cstdint"
+
+
+/// Binary image of what a DataDispenser has put in the Propagator once the
+/// events have been selected and read: the events (indices, stored variables
+/// and nominal weights), the event-by-event dials and the indexed entries of
+/// the EventDialCache. Reloading it skips the event selection, the TChain
+/// reading and the dial building.
+///
+/// The file is identified by a key hashed from everything the loading depends
+/// on (see DataDispenser::buildSnapshotKey()). Every array is 8-byte aligned
+/// so the file is mapped in memory and read in place.
+class DataDispenserSnapshot{
+
+public:
+  DataDispenserSnapshot() = default;
+
+  /// FNV-1a hash used to build the snapshot keys
+  static uint64_t hash(const std::string& str_, uint64_t seed_ = 14695981039346656037ULL);
+
+  /// Only fundamental types can be copied as raw bytes
+  static bool isSupportedType(const std::string& leafTypeName_);
+
+  // setters
+  void setKey(uint64_t key_){ _key_ = key_; }
+  void setFilePath(const std::string& filePath_){ _filePath_ = filePath_; }
+
+  // const getters
+  [[nodiscard]] uint64_t getKey() const{ return _key_; }
+  [[nodiscard]] const std::string& getFilePath() const{ return _filePath_; }
+
+  /// Remember where the dispenser starts filling the containers. Must be
+  /// called once the memory has been reserved and before the events are read.
+  void beginRecord(const DataDispenserCache& cache_);
+
+  /// Write everything that has been filled since beginRecord(). Returns false
+  /// if the content can't be represented in a snapshot.
+  bool write(const DataDispenserCache& cache_, bool useMcContainer_) const;
+
+  /// Fill the containers with the content of the snapshot. Returns false if
+  /// the file is missing or doesn't match the key, in which case nothing has
+  /// been modified.
+  bool read(DataDispenserCache& cache_, int dataSetIndex_, bool useMcContainer_) const;
+
+private:
+  uint64_t _key_{0};
+  std::string _filePath_{};
+
+  // filled by beginRecord()
+  std::vector<size_t> _sampleBeginList_{};
+  std::vector<size_t> _dialSlotBeginList_{};
+  size_t _cacheEntryBegin_{0};
+
+};
+
+
+#endif //GUNDAM_DATA_DISPENSER_SNAPSHOT_H
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
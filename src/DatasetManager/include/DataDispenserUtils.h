@@ -14,6 +14,7 @@
 
 #include "string"
 #include "map"
+#include "atomic"
 
 
 struct DataDispenserParameters{
@@ -35,6 +36,19 @@ struct DataDispenserParameters{
   [[nodiscard]] std::string getSummary() const;
 };
 
+/// Lock-free counter claimed with fetch_add while filling. The copy only
+/// exists so the cache (and its DataDispenser) stays copyable: it is never
+/// used while threads are filling.
+struct EventSlotCounter{
+  std::atomic<size_t> value{0};
+
+  EventSlotCounter() = default;
+  EventSlotCounter(const EventSlotCounter& other_) : value(other_.value.load()) {}
+  EventSlotCounter& operator=(const EventSlotCounter& other_){ value = other_.value.load(); return *this; }
+
+  size_t claim(){ return value.fetch_add( 1, std::memory_order_relaxed ); }
+};
+
 struct DataDispenserCache{
   Propagator* propagatorPtr{nullptr};
 
@@ -42,11 +56,14 @@ struct DataDispenserCache{
   std::vector<size_t> sampleNbOfEvents;
   std::vector<std::vector<bool>> eventIsInSamplesList{};
   std::vector<size_t> sampleIndexOffsetList;
+  std::vector<EventSlotCounter> sampleSlotCounterList{}; // next free event slots, claimed without lock while filling
   std::vector< std::vector<Event>* > sampleEventListPtrToFill;
+  std::vector< EventUtils::WeightStore* > sampleWeightStorePtrToFill;
   std::vector<DialCollection*> dialCollectionsRefList{};
 
   std::vector<std::string> varsRequestedForIndexing{};
   std::vector<std::string> varsRequestedForStorage{};
+  std::vector<std::string> varsStorageTypeNameList{}; // leaf type names of varsRequestedForStorage
   std::map<std::string, std::pair<std::string, bool>> varToLeafDict; // varToLeafDict[EVENT_VAR_NAME] = {LEAF_NAME, IS_DUMMY}
 
   std::vector<std::string> varsToOverrideList; // stores the leaves names to override in the right order
@@ -60,6 +77,25 @@ struct DataDispenserCache{
   };
   std::vector<ThreadSelectionResult> threadSelectionResults;
 
+  // single-pass loading: each thread fills its own buffers which are merged
+  // into the sample containers once the TChain has been read
+  struct ThreadFillBuffer{
+    struct SampleBuffer{
+      std::vector<Event> eventList{};
+      EventUtils::WeightStore weightStore{};
+    };
+    std::vector<SampleBuffer> sampleBufferList{};
+
+    // the event indices refer to the thread sample buffers
+    std::vector<EventDialCache::IndexedCacheEntry> indexedCacheEntryList{};
+
+    // event-by-event dials for each entry of dialCollectionsRefList
+    std::vector<std::vector<DialCollection::DialBaseObject>> dialList{};
+  };
+  std::vector<ThreadFillBuffer> threadFillBuffers;
+
+  EventSlotCounter nbLoadedEvents{}; // for debugNbMaxEventsToLoad
+
   void clear();
   void addVarRequestedForIndexing(const std::string& varName_);
   void addVarRequestedForStorage(const std::string& varName_);
@@ -37,6 +37,9 @@ protected:
   void loadData();
 
 private:
+  // config
+  std::string _snapshotDirectory_{};
+
   // internals
   Propagator _propagator_{};
   EventTreeWriter _treeWriter_{};
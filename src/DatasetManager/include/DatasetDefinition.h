@@ -34,6 +34,8 @@ public:
   [[nodiscard]] bool isEnabled() const{ return _isEnabled_; }
   [[nodiscard]] bool isSortLoadedEvents() const{ return _sortLoadedEvents_; }
   [[nodiscard]] bool isShowSelectedEventCount() const{ return _showSelectedEventCount_; }
+  [[nodiscard]] bool isSinglePassLoading() const{ return _singlePassLoading_; }
+  [[nodiscard]] int getNbCompiledFormulaChecks() const{ return _nbCompiledFormulaChecks_; }
   [[nodiscard]] bool isDevSingleThreadEventSelection() const{ return _devSingleThreadEventSelection_; }
   [[nodiscard]] bool isDevSingleThreadEventLoaderAndIndexer() const{ return _devSingleThreadEventLoaderAndIndexer_; }
   [[nodiscard]] int getDataSetIndex() const{ return _dataSetIndex_; }
@@ -58,6 +60,8 @@ private:
   std::string _selectedToyEntry_{"Asimov"};
 
   bool _sortLoadedEvents_{true}; // needed for reproducibility of toys in stat throw
+  bool _singlePassLoading_{false}; // select and fill the events while reading the TChain once
+  int _nbCompiledFormulaChecks_{100}; // entries per thread where the compiled formulas are compared with ROOT
   bool _devSingleThreadEventLoaderAndIndexer_{false};
   bool _devSingleThreadEventSelection_{false};
 
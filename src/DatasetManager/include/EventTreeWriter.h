@@ -21,14 +21,28 @@ public:
 
   void writeSamples(TDirectory* saveDir_, const Propagator& propagator_) const;
 
-  void writeEvents(TDirectory* saveDir_, const std::string& treeName_, const std::vector<Event> & eventList_) const;
+  void writeEvents(TDirectory* saveDir_, const std::string& treeName_, const SampleElement& container_) const;
   void writeEvents(TDirectory* saveDir_, const std::string& treeName_, const std::vector<const EventDialCache::CacheEntry*>& cacheSampleList_) const;
 
 protected:
+  /// Dial responses of a block of events. The events are split in
+  /// contiguous ranges, one per thread, and each thread fills its own buffer.
+  struct ResponseBlock{
+    struct ThreadBuffer{
+      std::vector<size_t> eventOffsetList{}; // [iEvent, iEvent+1[ -> dials in parIndexList
+      std::vector<int> parIndexList{}; // global parameter index of each dial
+      std::vector<double> responseList{}; // _nPointsPerDial_ values per dial
+    };
+
+    size_t beginIndex{0};
+    size_t endIndex{0};
+    std::vector<ThreadBuffer> threadBufferList{};
+  };
+
   void readConfigImpl() override;
 
   // templates related -> ensure the exact same code is used to write standard vars
-  template<typename T> void writeEventsTemplate(TDirectory* saveDir_, const std::string& treeName_, const T& eventList_) const;
+  template<typename T> void writeEventsTemplate(TDirectory* saveDir_, const std::string& treeName_, const T& eventList_, const EventUtils::WeightStore& weightStore_) const;
 
   static const Event* getEventPtr( const Event& ev_){ return &ev_; }
   static const Event* getEventPtr( const EventDialCache::CacheEntry* ev_){ return ev_->event; }
@@ -40,6 +54,7 @@ private:
   // config
   bool _writeDials_{false};
   int _nPointsPerDial_{3};
+  int _nEventsPerBlock_{1024};
 
   // cache
   mutable const Propagator* propagatorPtr{nullptr};
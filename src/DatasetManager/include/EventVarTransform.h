@@ -7,6 +7,7 @@
 
 #include "Event.h"
 #include "JsonBaseClass.h"
+#include "CompiledFormula.h"
 
 #include "TFormula.h"
 
@@ -24,6 +25,7 @@ public:
   void setIsEnabled(bool isEnabled_){ _isEnabled_=isEnabled_; }
   void setIndex(int index_){ _index_ = index_; }
   void setUseCache(bool useCache_){ _useCache_ = useCache_; }
+  void setNbCompiledFormulaChecks(int nbChecks_){ _nbCompiledFormulaChecks_ = nbChecks_; }
 
   bool isEnabled(){ return _isEnabled_; }
   bool useCache() const { return _useCache_; }
@@ -58,6 +60,8 @@ protected:
   // Internals
   bool _useCache_{true};
   std::vector<TFormula> _inputFormulaList_;
+  std::vector<CompiledFormula> _compiledInputFormulaList_; // not compiled: use the TFormula
+  mutable int _nbCompiledFormulaChecks_{0}; // evaluations left to compare with the TFormula
 
   // CACHES / not parallelisable
   double _outputCache_{};
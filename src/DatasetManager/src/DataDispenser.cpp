@@ -4,10 +4,12 @@
 
 
 #include "DataDispenser.h"
+#include "DataDispenserSnapshot.h"
 #include "DatasetDefinition.h"
 
 #include "EventVarTransform.h"
 #include "GundamGlobals.h"
+#include "GundamUtils.h"
 #include "GenericToolbox.Json.h"
 #include "ConfigUtils.h"
 
@@ -23,11 +25,17 @@
 #include "TChainElement.h"
 #include "TClonesArray.h"
 #include "TChain.h"
+#include "TLeaf.h"
 #include "THn.h"
 
 #include <string>
 #include <vector>
 #include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <limits>
+
+#include <sys/stat.h>
 
 LoggerInit([]{
   Logger::setUserHeaderStr("[DataDispenser]");
@@ -101,11 +109,44 @@ void DataDispenser::load(Propagator& propagator_){
   }
 
   this->parseStringParameters();
-  this->doEventSelection();
   this->fetchRequestedLeaves();
-  this->preAllocateMemory();
+
+  DataDispenserSnapshot snapshot{};
+  if( not _snapshotDirectory_.empty() ){
+    snapshot.setKey( this->buildSnapshotKey() );
+    if( snapshot.getKey() != 0 ){
+      std::stringstream ss;
+      ss << _snapshotDirectory_ << "/" << std::hex << std::setw(16) << std::setfill('0') << snapshot.getKey() << ".gundam.snapshot";
+      snapshot.setFilePath( ss.str() );
+
+      if( snapshot.read(_cache_, _owner_->getDataSetIndex(), _parameters_.useMcContainer) ){
+        this->fillVarIndexCache();
+        LogWarning << "Loaded " << getTitle() << " from snapshot" << std::endl;
+        return;
+      }
+    }
+  }
+
+  if( _owner_->isSinglePassLoading() ){
+    this->prepareThreadFillBuffers();
+  }
+  else{
+    this->doEventSelection();
+    this->preAllocateMemory();
+  }
+  if( not snapshot.getFilePath().empty() ){
+    // the snapshot records the entries of the indexed cache
+    _cache_.propagatorPtr->getEventDialCache().mergeThreadIndexedCaches();
+    snapshot.beginRecord(_cache_);
+  }
   this->readAndFill();
 
+  if( not snapshot.getFilePath().empty() ){
+    GenericToolbox::mkdir( _snapshotDirectory_ );
+    _cache_.propagatorPtr->getEventDialCache().mergeThreadIndexedCaches();
+    snapshot.write(_cache_, _parameters_.useMcContainer);
+  }
+
   LogWarning << "Loaded " << getTitle() << std::endl;
 }
 std::string DataDispenser::getTitle(){
@@ -254,12 +295,7 @@ void DataDispenser::doEventSelection(){
 
   if( _owner_->isShowSelectedEventCount() ){
     LogWarning << "Events passing selection cuts:" << std::endl;
-    GenericToolbox::TablePrinter t;
-    t.setColTitles({{"Sample"}, {"# of events"}});
-    for(size_t iSample = 0 ; iSample < _cache_.samplesToFillList.size() ; iSample++ ){
-      t.addTableLine({{"\""+_cache_.samplesToFillList[iSample]->getName()+"\""}, std::to_string(_cache_.sampleNbOfEvents[iSample])});
-    }
-    t.printTable();
+    this->printSampleEventCount();
   }
 
 }
@@ -419,47 +455,44 @@ void DataDispenser::preAllocateMemory(){
     ));
   }
 
-  eventPlaceholder.getVariables().allocateMemory( leafFormToVarList );
+  // only defines the column types of the sample variable stores
+  this->fillStorageTypeNameList( leafFormToVarList );
+  for( size_t iVar = 0 ; iVar < leafFormToVarList.size() ; iVar++ ){
+    eventPlaceholder.getVariables().getVarList()[iVar].set(GenericToolbox::leafToAnyType( _cache_.varsStorageTypeNameList[iVar] ));
+  }
 
   LogInfo << "Reserving event memory..." << std::endl;
   _cache_.sampleIndexOffsetList.resize(_cache_.samplesToFillList.size());
   _cache_.sampleEventListPtrToFill.resize(_cache_.samplesToFillList.size());
+  _cache_.sampleWeightStorePtrToFill.resize(_cache_.samplesToFillList.size());
   for( size_t iSample = 0 ; iSample < _cache_.sampleNbOfEvents.size() ; iSample++ ){
     auto* container = &_cache_.samplesToFillList[iSample]->getDataContainer();
     if(_parameters_.useMcContainer) container = &_cache_.samplesToFillList[iSample]->getMcContainer();
 
     _cache_.sampleEventListPtrToFill[iSample] = &container->getEventList();
+    _cache_.sampleWeightStorePtrToFill[iSample] = &container->getWeightStore();
     _cache_.sampleIndexOffsetList[iSample] = _cache_.sampleEventListPtrToFill[iSample]->size();
     container->reserveEventMemory(_owner_->getDataSetIndex(), _cache_.sampleNbOfEvents[iSample], eventPlaceholder);
   }
 
-  LogInfo << "Filling var index cache for bin edges..." << std::endl;
-  for( auto* samplePtr : _cache_.samplesToFillList ){
-    for( auto& bin : samplePtr->getBinning().getBinList() ){
-      for( auto& edges : bin.getEdgesList() ){
-        edges.varIndexCache = GenericToolbox::findElementIndex( edges.varName, _cache_.varsRequestedForIndexing );
-      }
-    }
+  _cache_.sampleSlotCounterList.resize( _cache_.sampleIndexOffsetList.size() );
+  for( size_t iSample = 0 ; iSample < _cache_.sampleIndexOffsetList.size() ; iSample++ ){
+    _cache_.sampleSlotCounterList[iSample].value = _cache_.sampleIndexOffsetList[iSample];
   }
+  _cache_.nbLoadedEvents.value = 0;
+
+  this->fillVarIndexCache();
 
 
   size_t nEvents = treeChain.GetEntries();
   if( _parameters_.useMcContainer ){
     if( not _cache_.dialCollectionsRefList.empty() ){
       LogInfo << "Creating slots for event-by-event dials..." << std::endl;
-      size_t nDialsMaxPerEvent{0};
       for( auto& dialCollection : _cache_.dialCollectionsRefList ){
         LogScopeIndent;
-        nDialsMaxPerEvent += 1;
-        if( dialCollection->isBinned() ){
-          // Filling var indexes for faster eval with PhysicsEvent:
-          for( auto& bin : dialCollection->getDialBinSet().getBinList() ){
-            for( auto& edges : bin.getEdgesList() ){
-              edges.varIndexCache = GenericToolbox::findElementIndex( edges.varName, _cache_.varsRequestedForIndexing );
-            }
-          }
-        }
-        else if( not dialCollection->getGlobalDialLeafName().empty() ){
+        if( dialCollection->isBinned() ){ continue; } // var indexes have been set by fillVarIndexCache()
+
+        if( not dialCollection->getGlobalDialLeafName().empty() ){
           // Reserve memory for additional dials (those on a tree leaf)
           auto dialType = dialCollection->getGlobalDialType();
           LogInfo << dialCollection->getTitle() << ": creating " << nEvents;
@@ -472,12 +505,13 @@ void DataDispenser::preAllocateMemory(){
           LogThrow("DEV ERROR: not binned, not event-by-event?");
         }
       }
-      _cache_.propagatorPtr->getEventDialCache().allocateCacheEntries(nEvents, nDialsMaxPerEvent);
-    }
-    else{
-      // all events should be referenced in the cache even with 0 dial
-      _cache_.propagatorPtr->getEventDialCache().allocateCacheEntries(nEvents, 0);
     }
+
+    // all events should be referenced in the cache even with 0 dial.
+    // Each thread fills its own chunk of the indexed cache
+    _cache_.propagatorPtr->getEventDialCache().allocateThreadIndexedCaches(
+        std::max(1, GundamGlobals::getParallelWorker().getNbThreads())
+    );
   }
 }
 void DataDispenser::readAndFill(){
@@ -501,6 +535,16 @@ void DataDispenser::readAndFill(){
     this->fillFunction(-1); // for better debug breakdown
   }
 
+  if( _owner_->isSinglePassLoading() ){
+    // containers are allocated with the exact size: no need to shrink
+    this->mergeThreadFillBuffers();
+    return;
+  }
+
+  for( size_t iSample = 0 ; iSample < _cache_.samplesToFillList.size() ; iSample++ ){
+    _cache_.sampleIndexOffsetList[iSample] = _cache_.sampleSlotCounterList[iSample].value.load();
+  }
+
   LogInfo << "Shrinking lists..." << std::endl;
   for( size_t iSample = 0 ; iSample < _cache_.samplesToFillList.size() ; iSample++ ){
     auto* container = &_cache_.samplesToFillList[iSample]->getDataContainer();
@@ -522,7 +566,6 @@ void DataDispenser::loadFromHistContent(){
 
   Event eventPlaceholder;
   eventPlaceholder.getIndices().dataset = (_owner_->getDataSetIndex());
-  eventPlaceholder.getWeights().current = (0); // default.
 
   // claiming event memory
   for( size_t iSample = 0 ; iSample < _cache_.samplesToFillList.size() ; iSample++ ){
@@ -532,6 +575,7 @@ void DataDispenser::loadFromHistContent(){
             _cache_.samplesToFillList[iSample]->getBinning().buildVariableNameList()
         )
     );
+    for( auto& var : eventPlaceholder.getVariables().getVarList() ){ var.set( double(0) ); }
 
     // one event per bin
     _cache_.sampleNbOfEvents[iSample] = _cache_.samplesToFillList[iSample]->getBinning().getBinList().size();
@@ -545,7 +589,8 @@ void DataDispenser::loadFromHistContent(){
 
     // indexing according to the binning
     for( size_t iEvent=_cache_.sampleIndexOffsetList[iSample] ; iEvent < container->getEventList().size() ; iEvent++ ){
-      container->getEventList()[iEvent].getIndices().bin = int( iEvent );
+      container->getEventList()[iEvent].setBinIndex( int( iEvent ), container->getWeightStore() );
+      container->getWeightStore().current[iEvent] = 0; // default.
     }
   }
 
@@ -597,10 +642,11 @@ void DataDispenser::loadFromHistContent(){
 
       container->getEventList()[iBin].getIndices().sample = sample->getIndex();
       for( size_t iVar = 0 ; iVar < target.size() ; iVar++ ){
-        container->getEventList()[iBin].getVariables().fetchVariable(axisNameList[iVar]).set(target[iVar]);
+        auto& variables = container->getEventList()[iBin].getVariables();
+        variables.setVarValue(variables.findVarIndex(axisNameList[iVar]), target[iVar]);
       }
-      container->getEventList()[iBin].getWeights().base = (hist->GetBinContent(histBinIndex));
-      container->getEventList()[iBin].getWeights().resetCurrentWeight();
+      container->getWeightStore().base[iBin] = (hist->GetBinContent(histBinIndex));
+      container->getWeightStore().resetCurrentWeight(iBin);
     }
 
   }
@@ -608,6 +654,244 @@ void DataDispenser::loadFromHistContent(){
   fHist->Close();
 }
 
+void DataDispenser::prepareThreadFillBuffers(){
+  LogInfo << "Preparing thread buffers for single-pass loading..." << std::endl;
+
+  _cache_.sampleNbOfEvents.resize(_cache_.samplesToFillList.size(), 0);
+  _cache_.sampleIndexOffsetList.resize(_cache_.samplesToFillList.size());
+  _cache_.sampleEventListPtrToFill.resize(_cache_.samplesToFillList.size());
+  _cache_.sampleWeightStorePtrToFill.resize(_cache_.samplesToFillList.size());
+  for( size_t iSample = 0 ; iSample < _cache_.samplesToFillList.size() ; iSample++ ){
+    auto* container = &_cache_.samplesToFillList[iSample]->getDataContainer();
+    if(_parameters_.useMcContainer) container = &_cache_.samplesToFillList[iSample]->getMcContainer();
+
+    _cache_.sampleEventListPtrToFill[iSample] = &container->getEventList();
+    _cache_.sampleWeightStorePtrToFill[iSample] = &container->getWeightStore();
+    _cache_.sampleIndexOffsetList[iSample] = _cache_.sampleEventListPtrToFill[iSample]->size();
+  }
+
+  this->fillVarIndexCache();
+
+  for( auto& dialCollection : _cache_.dialCollectionsRefList ){
+    LogThrowIf(not dialCollection->isBinned() and dialCollection->getGlobalDialLeafName().empty(),
+               "DEV ERROR: not binned, not event-by-event?");
+  }
+
+  _cache_.nbLoadedEvents.value = 0;
+  _cache_.threadFillBuffers.clear();
+  _cache_.threadFillBuffers.resize( std::max(1, GundamGlobals::getParallelWorker().getNbThreads()) );
+  for( auto& threadBuffer : _cache_.threadFillBuffers ){
+    threadBuffer.sampleBufferList.resize( _cache_.samplesToFillList.size() );
+    threadBuffer.dialList.resize( _cache_.dialCollectionsRefList.size() );
+  }
+}
+void DataDispenser::mergeThreadFillBuffers(){
+  LogInfo << "Merging thread buffers..." << std::endl;
+
+  auto& threadBufferList = _cache_.threadFillBuffers;
+  size_t nSamples{_cache_.samplesToFillList.size()};
+
+  // The threads are reading consecutive entry ranges: merging them in order
+  // gives the same event ordering as a single thread.
+  std::vector<std::vector<size_t>> eventOffsetList(threadBufferList.size(), std::vector<size_t>(nSamples, 0));
+
+  // defines the variable columns, the values are copied right after
+  Event eventPlaceholder;
+  eventPlaceholder.getIndices().dataset = _owner_->getDataSetIndex();
+  eventPlaceholder.getVariables().setVarNameList( std::make_shared<std::vector<std::string>>(_cache_.varsRequestedForStorage) );
+  for( size_t iVar = 0 ; iVar < _cache_.varsStorageTypeNameList.size() ; iVar++ ){
+    eventPlaceholder.getVariables().getVarList()[iVar].set(GenericToolbox::leafToAnyType( _cache_.varsStorageTypeNameList[iVar] ));
+  }
+
+  for( size_t iSample = 0 ; iSample < nSamples ; iSample++ ){
+    auto* container = &_cache_.samplesToFillList[iSample]->getDataContainer();
+    if(_parameters_.useMcContainer) container = &_cache_.samplesToFillList[iSample]->getMcContainer();
+
+    size_t nEvents{0};
+    for( size_t iThread = 0 ; iThread < threadBufferList.size() ; iThread++ ){
+      eventOffsetList[iThread][iSample] = _cache_.sampleIndexOffsetList[iSample] + nEvents;
+      nEvents += threadBufferList[iThread].sampleBufferList[iSample].eventList.size();
+    }
+    container->reserveEventMemory(_owner_->getDataSetIndex(), nEvents, eventPlaceholder);
+    _cache_.sampleNbOfEvents[iSample] = nEvents;
+
+    auto& eventList = container->getEventList();
+    auto& weightStore = container->getWeightStore();
+    for( size_t iThread = 0 ; iThread < threadBufferList.size() ; iThread++ ){
+      auto& sampleBuffer = threadBufferList[iThread].sampleBufferList[iSample];
+      size_t eventIndex{eventOffsetList[iThread][iSample]};
+      for( size_t iEvent = 0 ; iEvent < sampleBuffer.eventList.size() ; iEvent++, eventIndex++ ){
+        // keep the weight slot attributed by reserveEventMemory()
+        int weightIndex{eventList[eventIndex].getIndices().weight};
+        eventList[eventIndex].getIndices() = sampleBuffer.eventList[iEvent].getIndices();
+        eventList[eventIndex].getIndices().weight = weightIndex;
+        eventList[eventIndex].getVariables().copyData( sampleBuffer.eventList[iEvent].getVariables() );
+
+        eventList[eventIndex].setBinIndex( sampleBuffer.weightStore.bin[iEvent], weightStore );
+        weightStore.base[eventIndex] = sampleBuffer.weightStore.base[iEvent];
+        weightStore.resetCurrentWeight(eventIndex);
+      }
+      // free the memory as we go
+      sampleBuffer = DataDispenserCache::ThreadFillBuffer::SampleBuffer();
+    }
+
+    _cache_.sampleIndexOffsetList[iSample] += nEvents;
+  }
+
+  if( _owner_->isShowSelectedEventCount() ){
+    LogWarning << "Events loaded:" << std::endl;
+    this->printSampleEventCount();
+  }
+
+  if( not _parameters_.useMcContainer ){ return; }
+
+  // event-by-event dials
+  std::vector<std::vector<size_t>> dialOffsetList(threadBufferList.size(), std::vector<size_t>(_cache_.dialCollectionsRefList.size(), 0));
+  std::vector<int> collectionRefIndexList(_cache_.propagatorPtr->getDialCollectionList().size(), -1);
+  for( size_t iCollectionRef = 0 ; iCollectionRef < _cache_.dialCollectionsRefList.size() ; iCollectionRef++ ){
+    auto* dialCollection = _cache_.dialCollectionsRefList[iCollectionRef];
+    collectionRefIndexList[dialCollection->getIndex()] = int(iCollectionRef);
+    if( dialCollection->isBinned() ){ continue; }
+
+    size_t nDials{0};
+    for( auto& threadBuffer : threadBufferList ){ nDials += threadBuffer.dialList[iCollectionRef].size(); }
+
+    LogScopeIndent;
+    LogInfo << dialCollection->getTitle() << ": creating " << nDials;
+    LogInfo << " slots for " << dialCollection->getGlobalDialType() << std::endl;
+
+    dialCollection->getDialBaseList().clear();
+    dialCollection->getDialBaseList().resize( dialCollection->getDialFreeSlot() + nDials );
+
+    for( size_t iThread = 0 ; iThread < threadBufferList.size() ; iThread++ ){
+      auto& threadDialList = threadBufferList[iThread].dialList[iCollectionRef];
+      dialOffsetList[iThread][iCollectionRef] = dialCollection->getDialFreeSlot();
+      for( auto& dial : threadDialList ){
+        dialCollection->getDialBaseList()[dialCollection->getNextDialFreeSlot()] = std::move(dial);
+      }
+      threadDialList = std::vector<DialCollection::DialBaseObject>();
+    }
+  }
+
+  // sample index -> position in samplesToFillList
+  std::vector<int> samplePosList(_cache_.propagatorPtr->getSampleSet().getSampleList().size(), -1);
+  for( size_t iSample = 0 ; iSample < nSamples ; iSample++ ){
+    samplePosList[_cache_.samplesToFillList[iSample]->getIndex()] = int(iSample);
+  }
+
+  size_t nCacheEntries{0};
+  for( auto& threadBuffer : threadBufferList ){ nCacheEntries += threadBuffer.indexedCacheEntryList.size(); }
+
+  auto& eventDialCache = _cache_.propagatorPtr->getEventDialCache();
+  eventDialCache.allocateCacheEntries(nCacheEntries, _cache_.dialCollectionsRefList.size());
+  for( size_t iThread = 0 ; iThread < threadBufferList.size() ; iThread++ ){
+    for( auto& threadEntry : threadBufferList[iThread].indexedCacheEntryList ){
+      auto* cacheEntry = eventDialCache.fetchNextCacheEntry();
+      *cacheEntry = std::move( threadEntry );
+
+      // relocate the thread buffer indices
+      cacheEntry->event.eventIndex += eventOffsetList[iThread][samplePosList[cacheEntry->event.sampleIndex]];
+      for( auto& dialEntry : cacheEntry->dials ){
+        if( dialEntry.collectionIndex == std::size_t(-1) ){ continue; }
+        int iCollectionRef{collectionRefIndexList[dialEntry.collectionIndex]};
+        if( _cache_.dialCollectionsRefList[iCollectionRef]->isBinned() ){ continue; }
+        dialEntry.interfaceIndex += dialOffsetList[iThread][iCollectionRef];
+      }
+    }
+  }
+
+  threadBufferList.clear();
+}
+void DataDispenser::printSampleEventCount(){
+  GenericToolbox::TablePrinter t;
+  t.setColTitles({{"Sample"}, {"# of events"}});
+  for(size_t iSample = 0 ; iSample < _cache_.samplesToFillList.size() ; iSample++ ){
+    t.addTableLine({{"\""+_cache_.samplesToFillList[iSample]->getName()+"\""}, std::to_string(_cache_.sampleNbOfEvents[iSample])});
+  }
+  t.printTable();
+}
+void DataDispenser::fillStorageTypeNameList(const std::vector<const GenericToolbox::LeafForm*>& leafFormStorageList_){
+  LogThrowIf(leafFormStorageList_.size() != _cache_.varsRequestedForStorage.size(), "Storage leaf list size mismatch.");
+
+  _cache_.varsStorageTypeNameList.clear();
+  for( size_t iVar = 0 ; iVar < leafFormStorageList_.size() ; iVar++ ){
+    // the transforms are evaluated in double precision, whatever the type of the original leaf
+    bool isTransformOutput = std::any_of(
+        _cache_.eventVarTransformList.begin(), _cache_.eventVarTransformList.end(),
+        [&](const EventVarTransformLib& transform_){ return transform_.getOutputVariableName() == _cache_.varsRequestedForStorage[iVar]; }
+    );
+    _cache_.varsStorageTypeNameList.emplace_back( isTransformOutput ? "Double_t" : leafFormStorageList_[iVar]->getLeafTypeName() );
+  }
+}
+void DataDispenser::fillVarIndexCache(){
+  LogInfo << "Filling var index cache for bin edges..." << std::endl;
+  for( auto* samplePtr : _cache_.samplesToFillList ){
+    for( auto& bin : samplePtr->getBinning().getBinList() ){
+      for( auto& edges : bin.getEdgesList() ){
+        edges.varIndexCache = GenericToolbox::findElementIndex( edges.varName, _cache_.varsRequestedForIndexing );
+      }
+    }
+  }
+
+  // Filling var indexes for faster eval with PhysicsEvent:
+  for( auto& dialCollection : _cache_.dialCollectionsRefList ){
+    if( not dialCollection->isBinned() ){ continue; }
+    for( auto& bin : dialCollection->getDialBinSet().getBinList() ){
+      for( auto& edges : bin.getEdgesList() ){
+        edges.varIndexCache = GenericToolbox::findElementIndex( edges.varName, _cache_.varsRequestedForIndexing );
+      }
+    }
+  }
+}
+
+uint64_t DataDispenser::buildSnapshotKey(){
+  // everything the loaded events and dials depend on
+  std::stringstream ss;
+  ss << GundamUtils::getVersionFullStr() << std::endl;
+  ss << _owner_->getName() << "/" << _owner_->getDataSetIndex() << std::endl;
+  ss << _config_.dump() << std::endl;
+  ss << _parameters_.getSummary() << std::endl;
+  ss << GET_VAR_NAME_VALUE(_parameters_.dialIndexFormula) << std::endl;
+  ss << GET_VAR_NAME_VALUE(_parameters_.useMcContainer) << std::endl;
+  ss << GET_VAR_NAME_VALUE(_parameters_.debugNbMaxEventsToLoad) << std::endl;
+  ss << GenericToolbox::toString(_cache_.varsRequestedForIndexing) << std::endl;
+  ss << GenericToolbox::toString(_cache_.varsRequestedForStorage) << std::endl;
+
+  for( auto* samplePtr : _cache_.samplesToFillList ){
+    ss << samplePtr->getIndex() << ": " << samplePtr->getConfig().dump() << std::endl;
+    ss << samplePtr->getBinning().getSummary() << std::endl;
+  }
+  for( auto* dialCollection : _cache_.dialCollectionsRefList ){
+    ss << dialCollection->getIndex() << ": " << dialCollection->getConfig().dump() << std::endl;
+    ss << dialCollection->getDialBinSet().getSummary() << std::endl;
+  }
+
+  // the input files are identified by their size and modification time. The
+  // file list is taken from the chain so that the wildcards are expanded.
+  auto treeChain = this->openChain( false );
+  auto* chainFileList = treeChain->GetListOfFiles();
+  if( chainFileList == nullptr or chainFileList->GetEntries() == 0 ){
+    LogAlert << "Can't use snapshots for " << getTitle() << ": no input file found." << std::endl;
+    return 0;
+  }
+  for( int iFile = 0 ; iFile < chainFileList->GetEntries() ; iFile++ ){
+    std::string path{chainFileList->At(iFile)->GetTitle()};
+    struct stat fileStat{};
+    if( ::stat(path.c_str(), &fileStat) != 0 ){
+      LogAlert << "Can't use snapshots for " << getTitle() << ": could not stat " << path << std::endl;
+      return 0;
+    }
+    ss << path << " " << fileStat.st_size << " " << fileStat.st_mtime << std::endl;
+  }
+
+  return DataDispenserSnapshot::hash( ss.str() );
+}
+
+int DataDispenser::getNbCompiledFormulaChecks() const{
+  // every evaluation is checked in debug mode
+  if( GundamGlobals::getVerboseLevel() >= VerboseLevel::DEBUG_TRACE ){ return std::numeric_limits<int>::max(); }
+  return _owner_->getNbCompiledFormulaChecks();
+}
 std::unique_ptr<TChain> DataDispenser::openChain(bool verbose_){
   LogInfoIf(verbose_) << "Opening ROOT files containing events..." << std::endl;
 
@@ -625,41 +909,26 @@ std::unique_ptr<TChain> DataDispenser::openChain(bool verbose_){
   return treeChain;
 }
 
-void DataDispenser::eventSelectionFunction(int iThread_){
+DataDispenser::SelectionCuts DataDispenser::defineSelectionCuts(GenericToolbox::LeafCollection& lCollection_, TChain& treeChain_, bool verbose_){
+  SelectionCuts out{};
+  out.nbEntriesToCheck = this->getNbCompiledFormulaChecks();
 
-  int nThreads{GundamGlobals::getParallelWorker().getNbThreads()};
-  if( iThread_ == -1 ){ iThread_ = 0; nThreads = 1; }
-
-  // Opening ROOT file...
-  auto treeChain{this->openChain(false)};
-
-  GenericToolbox::LeafCollection lCollection;
-  lCollection.setTreePtr( treeChain.get() );
-
-  LogInfoIf(iThread_ == 0) << "Defining selection formulas..." << std::endl;
+  LogInfoIf(verbose_) << "Defining selection formulas..." << std::endl;
 
   // global cut
-  int selectionCutLeafFormIndex{-1};
   if( not _parameters_.selectionCutFormulaStr.empty() ){
-    LogInfoIf(iThread_ == 0) << "Global selection cut: \"" << _parameters_.selectionCutFormulaStr << "\"" << std::endl;
-    selectionCutLeafFormIndex = lCollection.addLeafExpression( _parameters_.selectionCutFormulaStr );
+    LogInfoIf(verbose_) << "Global selection cut: \"" << _parameters_.selectionCutFormulaStr << "\"" << std::endl;
+    out.globalCut.formulaStr = _parameters_.selectionCutFormulaStr;
+    this->defineSelectionCut( out.globalCut, out, lCollection_, treeChain_ );
   }
 
   // sample cuts
   GenericToolbox::TablePrinter tableSelectionCuts;
-  tableSelectionCuts.setColTitles({{"Sample"}, {"Selection Cut"}});
-
-  struct SampleCut{
-    int sampleIndex{-1};
-    int cutIndex{-1};
-  };
-  std::vector<SampleCut> sampleCutList;
-  sampleCutList.reserve( _cache_.samplesToFillList.size() );
+  tableSelectionCuts.setColTitles({{"Sample"}, {"Selection Cut"}, {"Compiled"}});
 
+  out.sampleCutList.resize( _cache_.samplesToFillList.size() );
   for( int iSample = 0; iSample < int(_cache_.samplesToFillList.size()) ; iSample++ ){
     auto* samplePtr = _cache_.samplesToFillList[iSample];
-    sampleCutList.emplace_back();
-    sampleCutList.back().sampleIndex = iSample;
 
     std::string selectionCut = samplePtr->getSelectionCutsStr();
     for (auto &replaceEntry: _cache_.varsToOverrideList) {
@@ -670,14 +939,171 @@ void DataDispenser::eventSelectionFunction(int iThread_){
 
     if( selectionCut.empty() ){ continue; }
 
-    sampleCutList.back().cutIndex = lCollection.addLeafExpression( selectionCut );
+    out.sampleCutList[iSample].formulaStr = selectionCut;
+    this->defineSelectionCut( out.sampleCutList[iSample], out, lCollection_, treeChain_ );
     tableSelectionCuts << samplePtr->getName() << GenericToolbox::TablePrinter::Action::NextColumn;
-    tableSelectionCuts << selectionCut << GenericToolbox::TablePrinter::Action::NextLine;
+    tableSelectionCuts << selectionCut << GenericToolbox::TablePrinter::Action::NextColumn;
+    tableSelectionCuts << (out.sampleCutList[iSample].compiledFormula.isCompiled() ? "yes" : "no") << GenericToolbox::TablePrinter::Action::NextLine;
 
   }
-  if( iThread_==0 ){ tableSelectionCuts.printTable(); }
+  if( verbose_ ){ tableSelectionCuts.printTable(); }
+
+  int nbCuts{0};
+  int nbCompiledCuts{0};
+  auto countCut = [&](const SelectionCut& cut_){
+    if( cut_.formulaStr.empty() ){ return; }
+    nbCuts++;
+    if( cut_.compiledFormula.isCompiled() ){ nbCompiledCuts++; }
+  };
+  countCut( out.globalCut );
+  for( auto& cut : out.sampleCutList ){ countCut( cut ); }
+  LogInfoIf(verbose_) << "Compiled selection cuts: " << nbCompiledCuts << "/" << nbCuts
+                      << " (checked with TTreeFormula on " << out.nbEntriesToCheck << " entries per thread)" << std::endl;
+
+  out.leafValueList.resize( out.leafExpList.size(), std::nan("unset") );
+  return out;
+}
+void DataDispenser::defineSelectionCut(SelectionCut& cut_, SelectionCuts& cuts_, GenericToolbox::LeafCollection& lCollection_, TChain& treeChain_){
+
+  // compiled only if every variable is a plain numerical leaf of the tree
+  bool isCompiled{cut_.compiledFormula.compile( cut_.formulaStr )};
+  std::vector<CompiledFormula::ValueType> typeList{};
+  if( isCompiled ){
+    for( auto& varName : cut_.compiledFormula.getVariableNameList() ){
+      auto subscriptPos = varName.find('[');
+      std::string leafName{varName.substr(0, subscriptPos)};
+      int index{subscriptPos == std::string::npos ? -1 : std::stoi(varName.substr(subscriptPos + 1))};
+
+      auto* leaf = treeChain_.GetLeaf( leafName.c_str() );
+      CompiledFormula::ValueType type{};
+      if(   treeChain_.GetAlias( leafName.c_str() ) != nullptr
+         or leaf == nullptr or leaf->GetLeafCount() != nullptr
+         or std::count( varName.begin(), varName.end(), '[' ) > 1
+         or ( index == -1 and leaf->GetLenStatic() != 1 )
+         or index >= leaf->GetLenStatic()
+         or not CompiledFormula::parseValueType( leaf->GetTypeName(), type ) ){
+        isCompiled = false;
+        break;
+      }
+      typeList.emplace_back( type );
+    }
+  }
+
+  if( not isCompiled ){
+    // TTreeFormula handles the rest (aliases, arrays loops, strings, ...)
+    cut_.compiledFormula = CompiledFormula();
+    cut_.leafExpIndex = lCollection_.addLeafExpression( cut_.formulaStr );
+    return;
+  }
+
+  for( size_t iVar = 0 ; iVar < typeList.size() ; iVar++ ){
+    auto& varName = cut_.compiledFormula.getVariableNameList()[iVar];
+    int leafIndex{GenericToolbox::findElementIndex(varName, cuts_.leafExpList)};
+    if( leafIndex == -1 ){
+      leafIndex = int(cuts_.leafExpList.size());
+      cuts_.leafExpList.emplace_back( varName );
+      cuts_.leafExpIndexList.emplace_back( lCollection_.addLeafExpression( varName ) );
+      cuts_.leafTypeList.emplace_back( typeList[iVar] );
+    }
+    cut_.leafIndexList.emplace_back( leafIndex );
+  }
+
+  // the TTreeFormula is kept to cross-check the compiled cut
+  if( cuts_.nbEntriesToCheck > 0 ){ cut_.leafExpIndex = lCollection_.addLeafExpression( cut_.formulaStr ); }
+}
+void DataDispenser::bindSelectionCuts(SelectionCuts& cuts_, GenericToolbox::LeafCollection& lCollection_){
+  cuts_.leafFormList.clear();
+  for( auto leafExpIndex : cuts_.leafExpIndexList ){
+    cuts_.leafFormList.emplace_back( &(lCollection_.getLeafFormList()[leafExpIndex]) );
+  }
+}
+bool DataDispenser::evalSelectionCuts(SelectionCuts& cuts_, GenericToolbox::LeafCollection& lCollection_, TChain& treeChain_, std::vector<bool>& isInSampleList_){
+  isInSampleList_.assign( _cache_.samplesToFillList.size(), false );
+
+  // the leaves are read once, whatever the number of cuts using them
+  for( size_t iLeaf = 0 ; iLeaf < cuts_.leafFormList.size() ; iLeaf++ ){
+    auto* leafForm = cuts_.leafFormList[iLeaf];
+    if( leafForm->getTreeFormulaPtr() != nullptr ){ leafForm->fillLocalBuffer(); }
+    cuts_.leafValueList[iLeaf] = CompiledFormula::readValue( leafForm->getDataAddress(), cuts_.leafTypeList[iLeaf] );
+  }
+
+  bool checkCompiledCuts{cuts_.nbEntriesToCheck > 0};
+  if( checkCompiledCuts ){ cuts_.nbEntriesToCheck--; }
+
+  auto evalCut = [&](const SelectionCut& cut_){
+    if( cut_.compiledFormula.isCompiled() ){
+      double value{cut_.compiledFormula.eval([&](int iVar_){ return cuts_.leafValueList[cut_.leafIndexList[iVar_]]; })};
+      if( checkCompiledCuts ){
+        double reference{lCollection_.getLeafFormList()[cut_.leafExpIndex].evalAsDouble()};
+        LogThrowIf(not CompiledFormula::isSameValue(value, reference),
+                   "Compiled selection cut \"" << cut_.formulaStr << "\" gives " << value
+                   << " while TTreeFormula gives " << reference
+                   << " for event #" << treeChain_.GetFileNumber() << ":" << treeChain_.GetReadEntry());
+      }
+      return value;
+    }
+    return lCollection_.getLeafFormList()[cut_.leafExpIndex].evalAsDouble();
+  };
+
+  if ( not cuts_.globalCut.formulaStr.empty() ){
+    if( evalCut( cuts_.globalCut ) == 0 ){
+      if (GundamGlobals::getVerboseLevel() == VerboseLevel::INLOOP_TRACE) {
+        LogTrace << "Event #" << treeChain_.GetFileNumber() << ":" << treeChain_.GetReadEntry()
+                 << " rejected because of " << _parameters_.selectionCutFormulaStr << std::endl;
+      }
+      return false;
+    }
+  }
+
+  bool hasSample{false};
+  for( size_t iSample = 0 ; iSample < cuts_.sampleCutList.size() ; iSample++ ){
+    auto& cut = cuts_.sampleCutList[iSample];
+
+    // no cut?
+    if( cut.formulaStr.empty() ){
+      isInSampleList_[iSample] = true;
+      hasSample = true;
+      if (GundamGlobals::getVerboseLevel() == VerboseLevel::INLOOP_TRACE) {
+        LogDebug << "Event #" << treeChain_.GetFileNumber() << ":" << treeChain_.GetReadEntry()
+                 << " included as sample " << iSample << " (NO SELECTION CUT)" << std::endl;
+      }
+    }
+      // pass cut?
+    else if( evalCut( cut ) != 0 ){
+      isInSampleList_[iSample] = true;
+      hasSample = true;
+      if (GundamGlobals::getVerboseLevel() == VerboseLevel::INLOOP_TRACE) {
+        LogDebug << "Event #" << treeChain_.GetFileNumber() << ":" << treeChain_.GetReadEntry()
+                 << " included as sample " << iSample << " because of " << cut.formulaStr << std::endl;
+      }
+    }
+      // don't pass cut?
+    else {
+      if (GundamGlobals::getVerboseLevel() == VerboseLevel::INLOOP_TRACE) {
+        LogTrace << "Event #" << treeChain_.GetFileNumber() << ":" << treeChain_.GetReadEntry()
+                 << " rejected as sample " << iSample << " because of " << cut.formulaStr << std::endl;
+      }
+    }
+  }
+
+  return hasSample;
+}
+
+void DataDispenser::eventSelectionFunction(int iThread_){
+
+  int nThreads{GundamGlobals::getParallelWorker().getNbThreads()};
+  if( iThread_ == -1 ){ iThread_ = 0; nThreads = 1; }
+
+  // Opening ROOT file...
+  auto treeChain{this->openChain(false)};
+
+  GenericToolbox::LeafCollection lCollection;
+  lCollection.setTreePtr( treeChain.get() );
+
+  auto selectionCuts = this->defineSelectionCuts( lCollection, *treeChain, iThread_ == 0 );
 
   lCollection.initialize();
+  DataDispenser::bindSelectionCuts( selectionCuts, lCollection );
 
   GenericToolbox::VariableMonitor readSpeed("bytes");
 
@@ -693,7 +1119,8 @@ void DataDispenser::eventSelectionFunction(int iThread_){
   // for each event, which sample is active?
   std::string progressTitle = "Performing event selection on " + this->getTitle() + "...";
   std::stringstream ssProgressTitle;
-  TFile *lastFilePtr{nullptr};
+  std::vector<bool> isInSampleList{};
+  auto& threadResults = _cache_.threadSelectionResults[iThread_];
 
   for ( Long64_t iEntry = bounds.beginIndex ; iEntry < bounds.endIndex ; iEntry++ ) {
     if( iThread_ == 0 ){
@@ -718,48 +1145,12 @@ void DataDispenser::eventSelectionFunction(int iThread_){
       treeChain->GetEntry(iEntry);
     }
 
-    if ( selectionCutLeafFormIndex != -1 ){
-      if( lCollection.getLeafFormList()[selectionCutLeafFormIndex].evalAsDouble() == 0 ){
-        for (size_t iSample = 0; iSample < _cache_.samplesToFillList.size(); iSample++) {
-          _cache_.threadSelectionResults[iThread_].eventIsInSamplesList[iEntry][iSample] = false;
-        }
-        if (GundamGlobals::getVerboseLevel() == VerboseLevel::INLOOP_TRACE) {
-          LogTrace << "Event #" << treeChain->GetFileNumber() << ":" << treeChain->GetReadEntry()
-                   << " rejected because of " << _parameters_.selectionCutFormulaStr << std::endl;
-        }
-        continue;
-      }
-    }
-
-    for( auto& sampleCut : sampleCutList ){
+    if( not this->evalSelectionCuts( selectionCuts, lCollection, *treeChain, isInSampleList ) ){ continue; }
 
-      // no cut?
-      if( sampleCut.cutIndex == -1 ){
-        _cache_.threadSelectionResults[iThread_].eventIsInSamplesList[iEntry][sampleCut.sampleIndex] = true;
-        _cache_.threadSelectionResults[iThread_].sampleNbOfEvents[sampleCut.sampleIndex]++;
-        if (GundamGlobals::getVerboseLevel() == VerboseLevel::INLOOP_TRACE) {
-          LogDebug << "Event #" << treeChain->GetFileNumber() << ":" << treeChain->GetReadEntry()
-                   << " included as sample " << sampleCut.sampleIndex << " (NO SELECTION CUT)" << std::endl;
-        }
-      }
-        // pass cut?
-      else if( lCollection.getLeafFormList()[sampleCut.cutIndex].evalAsDouble() != 0 ){
-        _cache_.threadSelectionResults[iThread_].eventIsInSamplesList[iEntry][sampleCut.sampleIndex] = true;
-        _cache_.threadSelectionResults[iThread_].sampleNbOfEvents[sampleCut.sampleIndex]++;
-        if (GundamGlobals::getVerboseLevel() == VerboseLevel::INLOOP_TRACE) {
-          LogDebug << "Event #" << treeChain->GetFileNumber() << ":" << treeChain->GetReadEntry()
-                   << " included as sample " << sampleCut.sampleIndex << " because of "
-                   << lCollection.getLeafFormList()[sampleCut.cutIndex].getSummary() << std::endl;
-        }
-      }
-        // don't pass cut?
-      else {
-        if (GundamGlobals::getVerboseLevel() == VerboseLevel::INLOOP_TRACE) {
-          LogTrace << "Event #" << treeChain->GetFileNumber() << ":" << treeChain->GetReadEntry()
-                   << " rejected as sample " << sampleCut.sampleIndex << " because of "
-                   << lCollection.getLeafFormList()[sampleCut.cutIndex].getSummary() << std::endl;
-        }
-      }
+    for( size_t iSample = 0 ; iSample < isInSampleList.size() ; iSample++ ){
+      if( not isInSampleList[iSample] ){ continue; }
+      threadResults.eventIsInSamplesList[iEntry][iSample] = true;
+      threadResults.sampleNbOfEvents[iSample]++;
     }
 
   } // iEvent
@@ -777,6 +1168,11 @@ void DataDispenser::fillFunction(int iThread_){
   GenericToolbox::LeafCollection lCollection;
   lCollection.setTreePtr( treeChain.get() );
 
+  // single-pass: the selection is performed while filling
+  bool isSinglePass{_owner_->isSinglePassLoading()};
+  SelectionCuts selectionCuts{};
+  if( isSinglePass ){ selectionCuts = this->defineSelectionCuts( lCollection, *treeChain, iThread_ == 0 ); }
+
   // nominal weight
   TTreeFormula* nominalWeightTreeFormula{nullptr};
   if( not _parameters_.nominalWeightFormulaStr.empty() ){
@@ -823,9 +1219,16 @@ void DataDispenser::fillFunction(int iThread_){
   }
   for( auto& lfInd: leafFormIndexingList ){ lfInd = &(lCollection.getLeafFormList()[(size_t) lfInd]); }
   for( auto& lfSto: leafFormStorageList ){ lfSto = &(lCollection.getLeafFormList()[(size_t) lfSto]); }
+  DataDispenser::bindSelectionCuts( selectionCuts, lCollection );
+
+  if( isSinglePass and iThread_ == 0 ){
+    // not filled by preAllocateMemory()
+    this->fillStorageTypeNameList( leafFormStorageList );
+  }
 
   // Event Var Transform
   auto eventVarTransformList = _cache_.eventVarTransformList; // copy for cache
+  for( auto& eventVarTransform : eventVarTransformList ){ eventVarTransform.setNbCompiledFormulaChecks( this->getNbCompiledFormulaChecks() ); }
   std::vector<EventVarTransformLib*> varTransformForIndexingList;
   std::vector<EventVarTransformLib*> varTransformForStorageList;
   for( auto& eventVarTransform : eventVarTransformList ){
@@ -860,6 +1263,15 @@ void DataDispenser::fillFunction(int iThread_){
   eventIndexingBuffer.getVariables().setVarNameList(std::make_shared<std::vector<std::string>>(_cache_.varsRequestedForIndexing));
   eventIndexingBuffer.getVariables().allocateMemory(leafFormIndexingList);
 
+  // compiled apply conditions read the indexing variables directly
+  std::vector<std::vector<int>> applyConditionIndexDictList( _cache_.dialCollectionsRefList.size() );
+  std::vector<int> applyConditionNbChecksList( _cache_.dialCollectionsRefList.size(), this->getNbCompiledFormulaChecks() );
+  for( size_t iCollectionRef = 0 ; iCollectionRef < _cache_.dialCollectionsRefList.size() ; iCollectionRef++ ){
+    for( auto& varName : _cache_.dialCollectionsRefList[iCollectionRef]->getApplyConditionCompiledFormula().getVariableNameList() ){
+      applyConditionIndexDictList[iCollectionRef].emplace_back( eventIndexingBuffer.getVariables().findVarIndex( varName ) );
+    }
+  }
+
   Event eventStorageBuffer;
   eventStorageBuffer.getIndices().dataset = _owner_->getDataSetIndex();
   eventStorageBuffer.getVariables().setVarNameList(std::make_shared<std::vector<std::string>>(_cache_.varsRequestedForStorage));
@@ -927,6 +1339,9 @@ void DataDispenser::fillFunction(int iThread_){
   std::string progressTitle = "Loading and indexing...";
   std::stringstream ssProgressBar;
 
+  // filled by the single-pass selection, otherwise the cached selection is read in place
+  std::vector<bool> isInSampleBuffer{};
+
   for( Long64_t iEntry = bounds.beginIndex ; iEntry < bounds.endIndex; iEntry++ ){
 
     if( iThread_ == 0 ){
@@ -947,24 +1362,34 @@ void DataDispenser::fillFunction(int iThread_){
       }
     }
 
-    bool hasSample =
-        std::any_of(
-            _cache_.eventIsInSamplesList[iEntry].begin(), _cache_.eventIsInSamplesList[iEntry].end(),
-            [](bool isInSample_){ return isInSample_; }
-        );
-    if( not hasSample ){ continue; }
-
-    Int_t nBytes{ treeChain->GetEntry(iEntry) };
+    Int_t nBytes{0};
+    const std::vector<bool>* isInSampleList{&isInSampleBuffer};
+    if( isSinglePass ){
+      nBytes = treeChain->GetEntry(iEntry);
+      if( not this->evalSelectionCuts( selectionCuts, lCollection, *treeChain, isInSampleBuffer ) ){ continue; }
+    }
+    else{
+      isInSampleList = &_cache_.eventIsInSamplesList[iEntry];
+      bool hasSample =
+          std::any_of(
+              isInSampleList->begin(), isInSampleList->end(),
+              [](bool isInSample_){ return isInSample_; }
+          );
+      if( not hasSample ){ continue; }
+
+      nBytes = treeChain->GetEntry(iEntry);
+    }
 
     // monitor
     if( iThread_ == 0 ){
       readSpeed.addQuantity(nBytes * nThreads);
     }
 
+    double nominalWeight{1};
     if( nominalWeightTreeFormula != nullptr ){
-      eventIndexingBuffer.getWeights().base = (nominalWeightTreeFormula->EvalInstance());
-      if( eventIndexingBuffer.getWeights().base < 0 ){
-        LogError << "Negative nominal weight:" << std::endl;
+      nominalWeight = nominalWeightTreeFormula->EvalInstance();
+      if( nominalWeight < 0 ){
+        LogError << "Negative nominal weight: " << nominalWeight << std::endl;
 
         LogError << "Event buffer is: " << eventIndexingBuffer.getSummary() << std::endl;
 
@@ -976,7 +1401,7 @@ void DataDispenser::fillFunction(int iThread_){
 
         LogThrow("Negative nominal weight");
       }
-      if( eventIndexingBuffer.getWeights().base == 0 ){
+      if( nominalWeight == 0 ){
         continue;
       } // skip this event
     }
@@ -984,7 +1409,7 @@ void DataDispenser::fillFunction(int iThread_){
     size_t nSample{_cache_.samplesToFillList.size()};
     for( size_t iSample = 0 ; iSample < nSample ; iSample++ ){
 
-      if( not _cache_.eventIsInSamplesList[iEntry][iSample] ){ continue; }
+      if( not (*isInSampleList)[iSample] ){ continue; }
 
       // Getting loaded data in tEventBuffer
       eventIndexingBuffer.getVariables().copyData( leafFormIndexingList );
@@ -995,43 +1420,69 @@ void DataDispenser::fillFunction(int iThread_){
       }
 
       // Look for the bin index
-      eventIndexingBuffer.fillBinIndex( _cache_.samplesToFillList[iSample]->getBinning() );
+      int binIndex{eventIndexingBuffer.getVariables().findBinIndex( _cache_.samplesToFillList[iSample]->getBinning() )};
 
       // No bin found -> next sample
-      if( eventIndexingBuffer.getIndices().bin == -1){ break; }
+      if( binIndex == -1 ){ break; }
 
       // OK, now we have a valid fit bin. Let's claim an index.
-      // Shared index among threads
+      // The indices are claimed without lock: atomic counters or thread buffers
+      if( _parameters_.useMcContainer and _parameters_.debugNbMaxEventsToLoad != 0 ){
+        // check if the limit has been reached
+        if( _cache_.nbLoadedEvents.claim() >= _parameters_.debugNbMaxEventsToLoad ){
+          LogAlertIf(iThread_==0) << std::endl << std::endl; // flush pBar
+          LogAlertIf(iThread_==0) << "debugNbMaxEventsToLoad: Event number cap reached (";
+          LogAlertIf(iThread_==0) << _parameters_.debugNbMaxEventsToLoad << ")" << std::endl;
+          return;
+        }
+      }
+
       size_t sampleEventIndex{};
+      Event* eventPtr{nullptr};
+      EventUtils::WeightStore* weightStorePtr{nullptr};
       EventDialCache::IndexedCacheEntry* eventDialCacheEntry{nullptr};
-      {
-        std::unique_lock<std::mutex> lock(GundamGlobals::getThreadMutex());
-        if( _parameters_.useMcContainer ){
-
-          if( _parameters_.debugNbMaxEventsToLoad != 0 ){
-            // check if the limit has been reached
-            if( _cache_.propagatorPtr->getEventDialCache().getFillIndex() >= _parameters_.debugNbMaxEventsToLoad ){
-              LogAlertIf(iThread_==0) << std::endl << std::endl; // flush pBar
-              LogAlertIf(iThread_==0) << "debugNbMaxEventsToLoad: Event number cap reached (";
-              LogAlertIf(iThread_==0) << _parameters_.debugNbMaxEventsToLoad << ")" << std::endl;
-              return;
-            }
-          }
+      if( isSinglePass ){
+        // Index within the thread buffers
+        auto& threadBuffer = _cache_.threadFillBuffers[iThread_];
+        auto& sampleBuffer = threadBuffer.sampleBufferList[iSample];
+        sampleEventIndex = sampleBuffer.eventList.size();
+        sampleBuffer.eventList.emplace_back( eventStorageBuffer );
+        sampleBuffer.weightStore.resize( sampleEventIndex + 1 );
+        eventPtr = &sampleBuffer.eventList.back();
+        eventPtr->getIndices().weight = int( sampleEventIndex );
+        weightStorePtr = &sampleBuffer.weightStore;
 
-          eventDialCacheEntry = _cache_.propagatorPtr->getEventDialCache().fetchNextCacheEntry();
+        if( _parameters_.useMcContainer ){
+          threadBuffer.indexedCacheEntryList.emplace_back();
+          eventDialCacheEntry = &threadBuffer.indexedCacheEntryList.back();
+          eventDialCacheEntry->dials.resize( _cache_.dialCollectionsRefList.size() );
         }
-        sampleEventIndex = _cache_.sampleIndexOffsetList[iSample]++;
       }
+      else{
+        if( _parameters_.useMcContainer ){
+          // thread chunk, stitched to the indexed cache by the EventDialCache
+          auto& threadIndexedCache = _cache_.propagatorPtr->getEventDialCache().getThreadIndexedCache(iThread_);
+          threadIndexedCache.emplace_back();
+          eventDialCacheEntry = &threadIndexedCache.back();
+          eventDialCacheEntry->dials.resize( _cache_.dialCollectionsRefList.size() );
+        }
 
-      // Get the next free event in our buffer
-      Event *eventPtr = &(*_cache_.sampleEventListPtrToFill[iSample])[sampleEventIndex];
+        // Shared index among threads
+        sampleEventIndex = _cache_.sampleSlotCounterList[iSample].claim();
+
+        // Get the next free event in our buffer
+        eventPtr = &(*_cache_.sampleEventListPtrToFill[iSample])[sampleEventIndex];
+        weightStorePtr = _cache_.sampleWeightStorePtrToFill[iSample];
+      }
 
       // fill meta info
       eventPtr->getIndices().entry = iEntry;
       eventPtr->getIndices().sample = _cache_.samplesToFillList[iSample]->getIndex();
-      eventPtr->getIndices().bin = eventIndexingBuffer.getIndices().bin;
-      eventPtr->getWeights().base = eventIndexingBuffer.getWeights().base;
-      eventPtr->getWeights().resetCurrentWeight();
+      eventPtr->setBinIndex( binIndex, *weightStorePtr );
+
+      // weights live in the sample store
+      weightStorePtr->base[sampleEventIndex] = nominalWeight;
+      weightStorePtr->resetCurrentWeight(sampleEventIndex);
 
       // drop the content of the leaves
       eventPtr->getVariables().copyData( leafFormStorageList );
@@ -1050,10 +1501,30 @@ void DataDispenser::fillFunction(int iThread_){
 
         auto* dialEntryPtr = &eventDialCacheEntry->dials[0];
 
-        for( auto *dialCollectionRef: _cache_.dialCollectionsRefList ){
+        for( size_t iCollectionRef = 0 ; iCollectionRef < _cache_.dialCollectionsRefList.size() ; iCollectionRef++ ){
+          auto* dialCollectionRef = _cache_.dialCollectionsRefList[iCollectionRef];
 
           // dial collections may come with a condition formula
-          if( dialCollectionRef->getApplyConditionFormula() != nullptr ){
+          if( dialCollectionRef->getApplyConditionCompiledFormula().isCompiled() ){
+            double applyCondition{eventIndexingBuffer.getVariables().evalFormula(
+                dialCollectionRef->getApplyConditionCompiledFormula(), &applyConditionIndexDictList[iCollectionRef])};
+
+            // cross-check with the TFormula
+            if( applyConditionNbChecksList[iCollectionRef] > 0 ){
+              applyConditionNbChecksList[iCollectionRef]--;
+              double reference{eventIndexingBuffer.getVariables().evalFormula(dialCollectionRef->getApplyConditionFormula().get())};
+              LogThrowIf(not CompiledFormula::isSameValue(applyCondition, reference),
+                         "Compiled apply condition \"" << dialCollectionRef->getApplyConditionCompiledFormula().getFormulaStr()
+                         << "\" gives " << applyCondition << " while TFormula gives " << reference
+                         << " for event #" << treeChain->GetFileNumber() << ":" << treeChain->GetReadEntry());
+            }
+
+            if( applyCondition == 0 ){
+              // next dialSet
+              continue;
+            }
+          }
+          else if( dialCollectionRef->getApplyConditionFormula() != nullptr ){
             if( eventIndexingBuffer.getVariables().evalFormula(dialCollectionRef->getApplyConditionFormula().get()) == 0 ){
               // next dialSet
               continue;
@@ -1113,10 +1584,19 @@ void DataDispenser::fillFunction(int iThread_){
 
             // dialBase is valid -> store it
             if (dialBase != nullptr) {
-              size_t freeSlotDial = dialCollectionRef->getNextDialFreeSlot();
+              size_t freeSlotDial;
               dialBase->setAllowExtrapolation(dialCollectionRef->isAllowDialExtrapolation());
-              dialCollectionRef->getDialBaseList()[freeSlotDial] = DialCollection::DialBaseObject(
-                  dialBase.release());
+              if( isSinglePass ){
+                // slot within the thread buffer
+                auto& threadDialList = _cache_.threadFillBuffers[iThread_].dialList[iCollectionRef];
+                freeSlotDial = threadDialList.size();
+                threadDialList.emplace_back( dialBase.release() );
+              }
+              else{
+                freeSlotDial = dialCollectionRef->getNextDialFreeSlot();
+                dialCollectionRef->getDialBaseList()[freeSlotDial] = DialCollection::DialBaseObject(
+                    dialBase.release());
+              }
 
               dialEntryPtr->collectionIndex = iCollection;
               dialEntryPtr->interfaceIndex = freeSlotDial;
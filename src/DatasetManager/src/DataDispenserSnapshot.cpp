@@ -0,0 +1,597 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#include "DataDispenserSnapshot.h"
+
+#include "DialCollection.h"
+#include "Shift.h"
+#include "SimpleSpline.h"
+#include "CompactSpline.h"
+#include "MonotonicSpline.h"
+#include "UniformSpline.h"
+#include "GeneralSpline.h"
+#include "LightGraph.h"
+
+#include "GenericToolbox.Root.h"
+#include "GenericToolbox.Utils.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <memory>
+#include <limits>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+LoggerInit([]{
+  Logger::setUserHeaderStr("[DataDispenserSnapshot]");
+});
+
+
+namespace {
+
+  // to be incremented whenever the layout changes
+  const uint32_t kSnapshotVersion{1};
+  const char kSnapshotMagic[8]{'G','U','N','D','S','N','A','P'};
+  const uint32_t kEndianMarker{0x01020304};
+  const uint64_t kInvalidIndex{std::numeric_limits<uint64_t>::max()};
+
+  struct FileHeader{
+    char magic[8];
+    uint32_t version;
+    uint32_t endianMarker;
+    uint64_t key;
+    uint64_t nVars;
+    uint64_t nSamples;
+    uint64_t nCollections;
+    uint64_t nCacheEntries;
+    uint64_t nDialsMaxPerEvent;
+  };
+  static_assert(sizeof(FileHeader) == 64, "Unexpected padding in FileHeader");
+
+  /// Sequential writer keeping every block 8-byte aligned
+  class SnapshotWriter{
+
+  public:
+    explicit SnapshotWriter(const std::string& filePath_): _stream_(filePath_, std::ios::binary | std::ios::trunc) {}
+
+    [[nodiscard]] bool isGood() const{ return _stream_.good(); }
+    [[nodiscard]] size_t getSize() const{ return _size_; }
+
+    void writeRaw(const void* data_, size_t size_){
+      if( size_ == 0 ){ return; }
+      _stream_.write(static_cast<const char*>(data_), std::streamsize(size_));
+      _size_ += size_;
+    }
+    void align(){
+      static const char padding[8]{};
+      size_t nPad{(8 - _size_ % 8) % 8};
+      this->writeRaw(padding, nPad);
+    }
+    template<typename T> void write(const T& value_){ this->writeArray(&value_, 1); }
+    template<typename T> void writeArray(const T* data_, size_t n_){ this->writeRaw(data_, n_*sizeof(T)); this->align(); }
+    void writeString(const std::string& str_){ this->write(uint64_t(str_.size())); this->writeArray(str_.data(), str_.size()); }
+
+    void close(){ _stream_.close(); }
+
+  private:
+    std::ofstream _stream_;
+    size_t _size_{0};
+
+  };
+
+  /// Sequential reader of a memory mapped file. Once an access is out of
+  /// bounds, every following fetch fails and isValid() returns false.
+  class SnapshotReader{
+
+  public:
+    explicit SnapshotReader(const std::string& filePath_){
+      int fd{::open(filePath_.c_str(), O_RDONLY)};
+      if( fd == -1 ){ return; }
+      struct stat fileStat{};
+      if( ::fstat(fd, &fileStat) == 0 and fileStat.st_size > 0 ){
+        void* ptr{::mmap(nullptr, size_t(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0)};
+        if( ptr != MAP_FAILED ){
+          _data_ = static_cast<const char*>(ptr);
+          _size_ = size_t(fileStat.st_size);
+        }
+      }
+      ::close(fd); // the mapping stays valid
+    }
+    ~SnapshotReader(){ if( _data_ != nullptr ){ ::munmap(const_cast<char*>(_data_), _size_); } }
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    [[nodiscard]] bool isOpen() const{ return _data_ != nullptr; }
+    [[nodiscard]] bool isValid() const{ return _isValid_ and isOpen(); }
+
+    const char* fetchBytes(size_t size_){
+      if( not this->isValid() or size_ > _size_ - _pos_ ){ _isValid_ = false; return nullptr; }
+      const char* out{_data_ + _pos_};
+      _pos_ += size_;
+      _pos_ = std::min(_pos_ + (8 - _pos_ % 8) % 8, _size_);
+      return out;
+    }
+    template<typename T> const T* fetchArray(size_t n_){
+      if( n_ > _size_ / sizeof(T) ){ _isValid_ = false; return nullptr; }
+      return reinterpret_cast<const T*>(this->fetchBytes(n_*sizeof(T)));
+    }
+    template<typename T> T fetch(){
+      T out{};
+      auto* ptr = this->fetchArray<T>(1);
+      if( ptr != nullptr ){ memcpy(&out, ptr, sizeof(T)); }
+      return out;
+    }
+    std::string fetchString(){
+      auto size = this->fetch<uint64_t>();
+      auto* ptr = this->fetchArray<char>(size);
+      if( ptr == nullptr ){ return {}; }
+      return {ptr, size};
+    }
+
+  private:
+    const char* _data_{nullptr};
+    size_t _size_{0};
+    size_t _pos_{0};
+    bool _isValid_{true};
+
+  };
+
+  std::unique_ptr<DialBase> makeSnapshotDial(const std::string& dialTypeName_){
+    if( dialTypeName_ == "Shift" ){ return std::make_unique<Shift>(); }
+    if( dialTypeName_ == "SimpleSpline" ){ return std::make_unique<SimpleSpline>(); }
+    if( dialTypeName_ == "CompactSpline" ){ return std::make_unique<CompactSpline>(); }
+    if( dialTypeName_ == "MonotonicSpline" ){ return std::make_unique<MonotonicSpline>(); }
+    if( dialTypeName_ == "UniformSpline" ){ return std::make_unique<UniformSpline>(); }
+    if( dialTypeName_ == "GeneralSpline" ){ return std::make_unique<GeneralSpline>(); }
+    if( dialTypeName_ == "LightGraph" ){ return std::make_unique<LightGraph>(); }
+    return nullptr;
+  }
+
+  bool isEventByEvent(const DialCollection* dialCollection_){
+    return not dialCollection_->isBinned() and not dialCollection_->getGlobalDialLeafName().empty();
+  }
+
+}
+
+
+uint64_t DataDispenserSnapshot::hash(const std::string& str_, uint64_t seed_){
+  uint64_t out{seed_};
+  for( unsigned char c : str_ ){
+    out ^= c;
+    out *= 1099511628211ULL;
+  }
+  return out;
+}
+bool DataDispenserSnapshot::isSupportedType(const std::string& leafTypeName_){
+  static const std::vector<std::string> supportedTypeList{
+      "Bool_t", "Char_t", "UChar_t", "Short_t", "UShort_t", "Int_t", "UInt_t",
+      "Long_t", "ULong_t", "Long64_t", "ULong64_t", "Float_t", "Double_t",
+      "bool", "char", "unsigned char", "short", "unsigned short", "int", "unsigned int",
+      "long", "unsigned long", "long long", "unsigned long long", "float", "double"
+  };
+  return GenericToolbox::doesElementIsInVector(leafTypeName_, supportedTypeList);
+}
+
+void DataDispenserSnapshot::beginRecord(const DataDispenserCache& cache_){
+  _sampleBeginList_ = cache_.sampleIndexOffsetList;
+
+  _dialSlotBeginList_.clear();
+  _dialSlotBeginList_.reserve(cache_.dialCollectionsRefList.size());
+  for( auto* dialCollection : cache_.dialCollectionsRefList ){
+    _dialSlotBeginList_.emplace_back(dialCollection->getDialFreeSlot());
+  }
+
+  _cacheEntryBegin_ = cache_.propagatorPtr->getEventDialCache().getFillIndex();
+}
+bool DataDispenserSnapshot::write(const DataDispenserCache& cache_, bool useMcContainer_) const{
+  LogThrowIf(_filePath_.empty(), "Snapshot file path not set.");
+  LogThrowIf(_sampleBeginList_.size() != cache_.samplesToFillList.size(), "beginRecord() has not been called.");
+  LogThrowIf(cache_.varsStorageTypeNameList.size() != cache_.varsRequestedForStorage.size(), "Storage var types not set.");
+
+  std::vector<size_t> varSizeList{};
+  varSizeList.reserve(cache_.varsStorageTypeNameList.size());
+  for( size_t iVar = 0 ; iVar < cache_.varsStorageTypeNameList.size() ; iVar++ ){
+    if( not isSupportedType(cache_.varsStorageTypeNameList[iVar]) ){
+      LogAlert << "Not writing snapshot: variable \"" << cache_.varsRequestedForStorage[iVar]
+               << "\" is of type " << cache_.varsStorageTypeNameList[iVar] << std::endl;
+      return false;
+    }
+    auto var = GenericToolbox::leafToAnyType(cache_.varsStorageTypeNameList[iVar]);
+    varSizeList.emplace_back(var.getPlaceHolderPtr()->getVariableSize());
+  }
+
+  auto& eventDialCache = cache_.propagatorPtr->getEventDialCache();
+  size_t nCacheEntries{0};
+  size_t nDialsMaxPerEvent{0};
+  if( useMcContainer_ ){
+    nCacheEntries = eventDialCache.getFillIndex() - _cacheEntryBegin_;
+    if( nCacheEntries != 0 ){ nDialsMaxPerEvent = eventDialCache.getIndexedCache()[_cacheEntryBegin_].dials.size(); }
+  }
+
+  std::string tmpFilePath{_filePath_ + ".tmp." + std::to_string(::getpid())};
+  SnapshotWriter writer(tmpFilePath);
+  auto abortFct = [&](const std::string& reason_){
+    writer.close();
+    std::remove(tmpFilePath.c_str());
+    LogAlert << "Not writing snapshot: " << reason_ << std::endl;
+    return false;
+  };
+  if( not writer.isGood() ){ return abortFct("could not open " + tmpFilePath); }
+
+  FileHeader header{};
+  memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+  header.version = kSnapshotVersion;
+  header.endianMarker = kEndianMarker;
+  header.key = _key_;
+  header.nVars = cache_.varsRequestedForStorage.size();
+  header.nSamples = cache_.samplesToFillList.size();
+  header.nCollections = useMcContainer_ ? cache_.dialCollectionsRefList.size() : 0;
+  header.nCacheEntries = nCacheEntries;
+  header.nDialsMaxPerEvent = nDialsMaxPerEvent;
+  writer.write(header);
+
+  for( size_t iVar = 0 ; iVar < cache_.varsRequestedForStorage.size() ; iVar++ ){
+    writer.writeString(cache_.varsRequestedForStorage[iVar]);
+    writer.writeString(cache_.varsStorageTypeNameList[iVar]);
+    writer.write(uint64_t(varSizeList[iVar]));
+  }
+
+  // events
+  std::vector<size_t> samplePosList{}; // sample index -> position in samplesToFillList
+  for( size_t iSample = 0 ; iSample < cache_.samplesToFillList.size() ; iSample++ ){
+    auto sampleIndex = size_t(cache_.samplesToFillList[iSample]->getIndex());
+    if( sampleIndex >= samplePosList.size() ){ samplePosList.resize(sampleIndex+1, size_t(-1)); }
+    samplePosList[sampleIndex] = iSample;
+
+    auto& eventList = *cache_.sampleEventListPtrToFill[iSample];
+    auto& weightStore = *cache_.sampleWeightStorePtrToFill[iSample];
+    size_t beginIndex{_sampleBeginList_[iSample]};
+    size_t nEvents{cache_.sampleIndexOffsetList[iSample] - beginIndex};
+
+    writer.write(uint64_t(iSample));
+    writer.write(int64_t(sampleIndex));
+    writer.write(uint64_t(nEvents));
+
+    std::vector<int64_t> entryList(nEvents);
+    std::vector<int32_t> binList(nEvents);
+    for( size_t iEvent = 0 ; iEvent < nEvents ; iEvent++ ){
+      entryList[iEvent] = eventList[beginIndex + iEvent].getIndices().entry;
+      binList[iEvent] = eventList[beginIndex + iEvent].getIndices().bin;
+    }
+    writer.writeArray(entryList.data(), nEvents);
+    writer.writeArray(binList.data(), nEvents);
+    writer.writeArray(weightStore.base.data() + beginIndex, nEvents);
+
+    for( size_t iEvent = 0 ; iEvent < nEvents ; iEvent++ ){
+      auto& variables = eventList[beginIndex + iEvent].getVariables();
+      for( size_t iVar = 0 ; iVar < varSizeList.size() ; iVar++ ){
+        if( variables.getVarSize(int(iVar)) != varSizeList[iVar] ){
+          return abortFct("unexpected size for variable " + cache_.varsRequestedForStorage[iVar]);
+        }
+        writer.writeRaw(variables.getVarAddress(int(iVar)), varSizeList[iVar]);
+      }
+    }
+    writer.align();
+  }
+
+  // event-by-event dials
+  std::vector<double> dialDataBuffer{};
+  for( size_t iCollection = 0 ; iCollection < header.nCollections ; iCollection++ ){
+    auto* dialCollection = cache_.dialCollectionsRefList[iCollection];
+    writer.write(int64_t(dialCollection->getIndex()));
+    writer.write(uint64_t(isEventByEvent(dialCollection)));
+    if( not isEventByEvent(dialCollection) ){ continue; }
+
+    size_t beginSlot{_dialSlotBeginList_[iCollection]};
+    size_t nDials{dialCollection->getDialFreeSlot() - beginSlot};
+
+    std::vector<std::string> dialTypeList{};
+    std::vector<uint64_t> dialTypeIndexList(nDials);
+    for( size_t iDial = 0 ; iDial < nDials ; iDial++ ){
+      auto& dial = dialCollection->getDialBaseList()[beginSlot + iDial];
+      if( dial == nullptr ){ return abortFct("empty dial slot in " + dialCollection->getTitle()); }
+      auto typeName = dial->getDialTypeName();
+      int typeIndex = GenericToolbox::findElementIndex(typeName, dialTypeList);
+      if( typeIndex == -1 ){ typeIndex = int(dialTypeList.size()); dialTypeList.emplace_back(typeName); }
+      dialTypeIndexList[iDial] = uint64_t(typeIndex);
+    }
+
+    writer.write(uint64_t(dialTypeList.size()));
+    for( auto& dialType : dialTypeList ){ writer.writeString(dialType); }
+
+    writer.write(uint64_t(nDials));
+    for( size_t iDial = 0 ; iDial < nDials ; iDial++ ){
+      auto& dial = dialCollection->getDialBaseList()[beginSlot + iDial];
+      if( not dial->getSnapshotData(dialDataBuffer) ){
+        return abortFct(dial->getDialTypeName() + " dials of " + dialCollection->getTitle() + " can't be stored");
+      }
+      writer.write(dialTypeIndexList[iDial]);
+      writer.write(uint64_t(dialDataBuffer.size()));
+      writer.writeArray(dialDataBuffer.data(), dialDataBuffer.size());
+    }
+  }
+
+  // indexed cache: sample position, relative event index, then the dial pairs
+  for( size_t iEntry = 0 ; iEntry < nCacheEntries ; iEntry++ ){
+    auto& entry = eventDialCache.getIndexedCache()[_cacheEntryBegin_ + iEntry];
+    size_t samplePos{samplePosList.at(entry.event.sampleIndex)};
+
+    uint64_t buffer[2]{samplePos, entry.event.eventIndex - _sampleBeginList_[samplePos]};
+    writer.writeRaw(buffer, sizeof(buffer));
+
+    for( auto& dial : entry.dials ){
+      buffer[0] = dial.collectionIndex;
+      buffer[1] = dial.interfaceIndex;
+      if( dial.collectionIndex != kInvalidIndex ){
+        for( size_t iCollection = 0 ; iCollection < cache_.dialCollectionsRefList.size() ; iCollection++ ){
+          auto* dialCollection = cache_.dialCollectionsRefList[iCollection];
+          if( size_t(dialCollection->getIndex()) != dial.collectionIndex ){ continue; }
+          // slots of the event-by-event dials are relative to the first one filled
+          if( isEventByEvent(dialCollection) ){ buffer[1] -= _dialSlotBeginList_[iCollection]; }
+          break;
+        }
+      }
+      writer.writeRaw(buffer, sizeof(buffer));
+    }
+  }
+  writer.align();
+
+  size_t fileSize{writer.getSize()};
+  writer.close();
+  if( not writer.isGood() ){ return abortFct("error while writing " + tmpFilePath); }
+
+  // only expose the file once it is complete
+  if( std::rename(tmpFilePath.c_str(), _filePath_.c_str()) != 0 ){ return abortFct("could not move file to " + _filePath_); }
+
+  LogInfo << "Snapshot written to " << _filePath_ << " (" << GenericToolbox::parseSizeUnits(double(fileSize)) << ")" << std::endl;
+  return true;
+}
+bool DataDispenserSnapshot::read(DataDispenserCache& cache_, int dataSetIndex_, bool useMcContainer_) const{
+  LogThrowIf(_filePath_.empty(), "Snapshot file path not set.");
+
+  SnapshotReader reader(_filePath_);
+  if( not reader.isOpen() ){
+    LogInfo << "No snapshot found at " << _filePath_ << std::endl;
+    return false;
+  }
+
+  auto rejectFct = [&](const std::string& reason_){
+    LogAlert << "Ignoring snapshot " << _filePath_ << ": " << reason_ << std::endl;
+    return false;
+  };
+
+  // first parse and check the whole file without touching the containers
+  auto header = reader.fetch<FileHeader>();
+  if( not reader.isValid() or memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) != 0 ){ return rejectFct("not a snapshot file"); }
+  if( header.version != kSnapshotVersion ){ return rejectFct("version " + std::to_string(header.version) + " != " + std::to_string(kSnapshotVersion)); }
+  if( header.endianMarker != kEndianMarker ){ return rejectFct("written with a different byte order"); }
+  if( header.key != _key_ ){ return rejectFct("key mismatch"); }
+  if( header.nVars != cache_.varsRequestedForStorage.size() ){ return rejectFct("mismatching number of variables"); }
+  if( header.nSamples != cache_.samplesToFillList.size() ){ return rejectFct("mismatching number of samples"); }
+  if( header.nCollections != (useMcContainer_ ? cache_.dialCollectionsRefList.size() : 0) ){ return rejectFct("mismatching number of dial collections"); }
+  if( not useMcContainer_ and header.nCacheEntries != 0 ){ return rejectFct("unexpected dial cache entries"); }
+
+  Event eventPlaceholder;
+  eventPlaceholder.getIndices().dataset = dataSetIndex_;
+  eventPlaceholder.getVariables().setVarNameList( std::make_shared<std::vector<std::string>>(cache_.varsRequestedForStorage) );
+
+  std::vector<size_t> varSizeList{};
+  size_t eventVarSize{0};
+  for( size_t iVar = 0 ; iVar < header.nVars ; iVar++ ){
+    auto varName = reader.fetchString();
+    auto varType = reader.fetchString();
+    auto varSize = size_t(reader.fetch<uint64_t>());
+    if( not reader.isValid() ){ return rejectFct("truncated file"); }
+    if( varName != cache_.varsRequestedForStorage[iVar] ){ return rejectFct("mismatching variable " + varName); }
+    if( not isSupportedType(varType) ){ return rejectFct("unsupported type " + varType); }
+
+    auto& var = eventPlaceholder.getVariables().getVarList()[iVar];
+    var.set(GenericToolbox::leafToAnyType(varType));
+    if( var.get().getPlaceHolderPtr()->getVariableSize() != varSize ){ return rejectFct("mismatching size for " + varName); }
+    varSizeList.emplace_back(varSize);
+    eventVarSize += varSize;
+  }
+
+  struct SampleView{
+    size_t nEvents{0};
+    const int64_t* entryList{nullptr};
+    const int32_t* binList{nullptr};
+    const double* baseWeightList{nullptr};
+    const char* varData{nullptr};
+  };
+  std::vector<SampleView> sampleViewList(header.nSamples);
+  for( size_t iSample = 0 ; iSample < header.nSamples ; iSample++ ){
+    auto& view = sampleViewList[iSample];
+    auto samplePos = reader.fetch<uint64_t>();
+    auto sampleIndex = reader.fetch<int64_t>();
+    view.nEvents = size_t(reader.fetch<uint64_t>());
+    view.entryList = reader.fetchArray<int64_t>(view.nEvents);
+    view.binList = reader.fetchArray<int32_t>(view.nEvents);
+    view.baseWeightList = reader.fetchArray<double>(view.nEvents);
+    view.varData = reader.fetchArray<char>(view.nEvents * eventVarSize);
+    if( not reader.isValid() ){ return rejectFct("truncated file"); }
+    if( samplePos != iSample or sampleIndex != cache_.samplesToFillList[iSample]->getIndex() ){
+      return rejectFct("mismatching sample " + cache_.samplesToFillList[iSample]->getName());
+    }
+  }
+
+  struct DialView{
+    uint64_t typeIndex{0};
+    size_t nData{0};
+    const double* data{nullptr};
+  };
+  struct CollectionView{
+    bool isEventByEvent{false};
+    std::vector<std::string> dialTypeList{};
+    std::vector<DialView> dialList{};
+  };
+  std::vector<CollectionView> collectionViewList(header.nCollections);
+  std::vector<int> collectionPosList(cache_.propagatorPtr->getDialCollectionList().size(), -1);
+  for( size_t iCollection = 0 ; iCollection < header.nCollections ; iCollection++ ){
+    auto* dialCollection = cache_.dialCollectionsRefList[iCollection];
+    auto& view = collectionViewList[iCollection];
+
+    auto collectionIndex = reader.fetch<int64_t>();
+    view.isEventByEvent = ( reader.fetch<uint64_t>() != 0 );
+    if( not reader.isValid() ){ return rejectFct("truncated file"); }
+    if( collectionIndex != dialCollection->getIndex() or view.isEventByEvent != isEventByEvent(dialCollection) ){
+      return rejectFct("mismatching dial collection " + dialCollection->getTitle());
+    }
+    collectionPosList.at(size_t(collectionIndex)) = int(iCollection);
+    if( not view.isEventByEvent ){ continue; }
+
+    auto nTypes = reader.fetch<uint64_t>();
+    for( uint64_t iType = 0 ; iType < nTypes and reader.isValid() ; iType++ ){
+      view.dialTypeList.emplace_back(reader.fetchString());
+      if( makeSnapshotDial(view.dialTypeList.back()) == nullptr ){ return rejectFct("unknown dial type " + view.dialTypeList.back()); }
+    }
+
+    auto nDials = reader.fetch<uint64_t>();
+    if( not reader.isValid() or nDials > header.nCacheEntries ){ return rejectFct("invalid dial list for " + dialCollection->getTitle()); }
+    view.dialList.resize(nDials);
+    for( auto& dial : view.dialList ){
+      dial.typeIndex = reader.fetch<uint64_t>();
+      dial.nData = size_t(reader.fetch<uint64_t>());
+      dial.data = reader.fetchArray<double>(dial.nData);
+      if( not reader.isValid() or dial.typeIndex >= view.dialTypeList.size() ){ return rejectFct("invalid dial in " + dialCollection->getTitle()); }
+    }
+  }
+
+  size_t nValuesPerEntry{2 + 2*header.nDialsMaxPerEvent};
+  if( header.nCacheEntries > std::numeric_limits<size_t>::max() / nValuesPerEntry ){ return rejectFct("invalid cache size"); }
+  const uint64_t* cacheData = reader.fetchArray<uint64_t>(header.nCacheEntries * nValuesPerEntry);
+  if( not reader.isValid() ){ return rejectFct("truncated file"); }
+  for( size_t iEntry = 0 ; iEntry < header.nCacheEntries ; iEntry++ ){
+    const uint64_t* entry = &cacheData[iEntry * nValuesPerEntry];
+    if( entry[0] >= header.nSamples or entry[1] >= sampleViewList[entry[0]].nEvents ){ return rejectFct("invalid cache entry"); }
+    for( size_t iDial = 0 ; iDial < header.nDialsMaxPerEvent ; iDial++ ){
+      uint64_t collectionIndex{entry[2 + 2*iDial]};
+      if( collectionIndex == kInvalidIndex ){ continue; }
+      if( collectionIndex >= collectionPosList.size() or collectionPosList[collectionIndex] == -1 ){ return rejectFct("invalid dial collection in cache entry"); }
+      auto& view = collectionViewList[collectionPosList[collectionIndex]];
+      if( view.isEventByEvent and entry[3 + 2*iDial] >= view.dialList.size() ){ return rejectFct("invalid dial slot in cache entry"); }
+    }
+  }
+
+  // the file is valid: fill the containers
+  LogInfo << "Loading events from snapshot: " << _filePath_ << std::endl;
+  cache_.sampleNbOfEvents.resize(header.nSamples);
+  cache_.sampleIndexOffsetList.resize(header.nSamples);
+  cache_.sampleEventListPtrToFill.resize(header.nSamples);
+  cache_.sampleWeightStorePtrToFill.resize(header.nSamples);
+  std::vector<size_t> sampleBeginList(header.nSamples);
+  for( size_t iSample = 0 ; iSample < header.nSamples ; iSample++ ){
+    auto& view = sampleViewList[iSample];
+    auto* container = &cache_.samplesToFillList[iSample]->getDataContainer();
+    if( useMcContainer_ ) container = &cache_.samplesToFillList[iSample]->getMcContainer();
+
+    cache_.sampleEventListPtrToFill[iSample] = &container->getEventList();
+    cache_.sampleWeightStorePtrToFill[iSample] = &container->getWeightStore();
+    sampleBeginList[iSample] = container->getEventList().size();
+    container->reserveEventMemory(dataSetIndex_, view.nEvents, eventPlaceholder);
+
+    auto& eventList = container->getEventList();
+    auto& weightStore = container->getWeightStore();
+    const char* varData{view.varData};
+    for( size_t iEvent = 0 ; iEvent < view.nEvents ; iEvent++ ){
+      size_t eventIndex{sampleBeginList[iSample] + iEvent};
+      auto& event = eventList[eventIndex];
+      event.getIndices().entry = view.entryList[iEvent];
+      event.getIndices().sample = cache_.samplesToFillList[iSample]->getIndex();
+      event.setBinIndex( view.binList[iEvent], weightStore );
+
+      weightStore.base[eventIndex] = view.baseWeightList[iEvent];
+      weightStore.resetCurrentWeight(eventIndex);
+
+      auto& variables = event.getVariables();
+      for( size_t iVar = 0 ; iVar < varSizeList.size() ; iVar++ ){
+        variables.setRawData(int(iVar), varData, varSizeList[iVar]);
+        varData += varSizeList[iVar];
+      }
+    }
+
+    cache_.sampleNbOfEvents[iSample] = view.nEvents;
+    cache_.sampleIndexOffsetList[iSample] = eventList.size();
+  }
+
+  std::vector<size_t> dialSlotBeginList(header.nCollections, 0);
+  for( size_t iCollection = 0 ; iCollection < header.nCollections ; iCollection++ ){
+    auto& view = collectionViewList[iCollection];
+    if( not view.isEventByEvent ){ continue; }
+
+    auto* dialCollection = cache_.dialCollectionsRefList[iCollection];
+    dialSlotBeginList[iCollection] = dialCollection->getDialFreeSlot();
+    LogInfo << dialCollection->getTitle() << ": restoring " << view.dialList.size() << " dials" << std::endl;
+
+    dialCollection->getDialBaseList().clear();
+    dialCollection->getDialBaseList().resize(dialSlotBeginList[iCollection] + view.dialList.size());
+
+    std::vector<double> dialData{};
+    for( auto& dialView : view.dialList ){
+      std::unique_ptr<DialBase> dialBase(makeSnapshotDial(view.dialTypeList[dialView.typeIndex]));
+      dialData.assign(dialView.data, dialView.data + dialView.nData);
+      dialBase->setSnapshotData(dialData);
+      dialBase->setAllowExtrapolation(dialCollection->isAllowDialExtrapolation());
+
+      size_t freeSlotDial = dialCollection->getNextDialFreeSlot();
+      dialCollection->getDialBaseList()[freeSlotDial] = DialCollection::DialBaseObject(dialBase.release());
+    }
+  }
+
+  if( useMcContainer_ ){
+    auto& eventDialCache = cache_.propagatorPtr->getEventDialCache();
+    eventDialCache.allocateCacheEntries(header.nCacheEntries, header.nDialsMaxPerEvent);
+    for( size_t iEntry = 0 ; iEntry < header.nCacheEntries ; iEntry++ ){
+      const uint64_t* entryData = &cacheData[iEntry * nValuesPerEntry];
+      auto* entry = eventDialCache.fetchNextCacheEntry();
+      entry->event.sampleIndex = size_t(cache_.samplesToFillList[entryData[0]]->getIndex());
+      entry->event.eventIndex = sampleBeginList[entryData[0]] + entryData[1];
+
+      for( size_t iDial = 0 ; iDial < header.nDialsMaxPerEvent ; iDial++ ){
+        auto& dial = entry->dials[iDial];
+        dial.collectionIndex = entryData[2 + 2*iDial];
+        dial.interfaceIndex = entryData[3 + 2*iDial];
+        if( dial.collectionIndex == kInvalidIndex ){ continue; }
+        int iCollection{collectionPosList[dial.collectionIndex]};
+        if( collectionViewList[iCollection].isEventByEvent ){ dial.interfaceIndex += dialSlotBeginList[iCollection]; }
+      }
+    }
+  }
+
+  return true;
+}
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
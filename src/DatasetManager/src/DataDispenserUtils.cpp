@@ -37,15 +37,22 @@ void DataDispenserCache::clear(){
   eventIsInSamplesList.clear();
 
   sampleIndexOffsetList.clear();
+  sampleSlotCounterList.clear();
   sampleEventListPtrToFill.clear();
+  sampleWeightStorePtrToFill.clear();
 
   varsRequestedForIndexing.clear();
   varsRequestedForStorage.clear();
+  varsStorageTypeNameList.clear();
   varToLeafDict.clear();
 
   varsToOverrideList.clear();
 
   eventVarTransformList.clear();
+
+  threadSelectionResults.clear();
+  threadFillBuffers.clear();
+  nbLoadedEvents.value = 0;
 }
 void DataDispenserCache::addVarRequestedForIndexing(const std::string& varName_) {
   LogThrowIf(varName_.empty(), "no var name provided.");
@@ -3,6 +3,7 @@
 //
 
 #include "DataSetManager.h"
+#include "DialDataPool.h"
 
 #ifdef GUNDAM_USING_CACHE_MANAGER
 #include "CacheManager.h"
@@ -38,6 +39,13 @@ void DataSetManager::readConfigImpl(){
     _treeWriter_.setConfig( GenericToolbox::Json::fetchValue<JsonType>(_config_, "eventTreeWriter") );
   });
   _treeWriter_.readConfig( GenericToolbox::Json::fetchValue(_config_, "eventTreeWriter", _treeWriter_.getConfig()) );
+
+  // binary images of the loaded datasets, reused by the following runs
+  _snapshotDirectory_ = GenericToolbox::Json::fetchValue(_config_, "snapshotDirectory", _snapshotDirectory_);
+  if( not _snapshotDirectory_.empty() ){
+    _snapshotDirectory_ = GenericToolbox::expandEnvironmentVariables(_snapshotDirectory_);
+    LogInfo << "Dataset snapshots will be stored in: " << _snapshotDirectory_ << std::endl;
+  }
 }
 void DataSetManager::initializeImpl(){
   LogInfo << "Initializing DataSetManager..." << std::endl;
@@ -61,6 +69,7 @@ void DataSetManager::loadData(){
 
   // make sure everything is ready for loading
   _propagator_.clearContent();
+  DialDataPool::clear(); // only counts what is loaded now
 
   // First start with the data:
   bool usedMcContainer{false};
@@ -79,6 +88,7 @@ void DataSetManager::loadData(){
 
     // loading in the propagator
     LogInfo << "Reading dataset: " << dataSet.getName() << "/" << dispenser->getParameters().name << std::endl;
+    dispenser->setSnapshotDirectory( _snapshotDirectory_ );
     dispenser->load( _propagator_ );
 
     LogInfo << "Resizing dial containers..." << std::endl;
@@ -176,6 +186,7 @@ void DataSetManager::loadData(){
     for( auto& dataSet : _dataSetList_ ){
       LogContinueIf(not dataSet.isEnabled(), "Dataset \"" << dataSet.getName() << "\" is disabled. Skipping");
       auto& dispenser = dataSet.getMcDispenser();
+      dispenser.setSnapshotDirectory( _snapshotDirectory_ );
       dispenser.load( _propagator_ );
     }
 
@@ -188,6 +199,8 @@ void DataSetManager::loadData(){
     _propagator_.buildDialCache();
   }
 
+  if( DialDataPool::getNbRequests() != 0 ){ LogInfo << DialDataPool::getSummary() << std::endl; }
+
 #ifdef GUNDAM_USING_CACHE_MANAGER
   // After all the data has been loaded.  Specifically, this must be after
   // the MC has been copied for the Asimov fit, or the "data" use the MC
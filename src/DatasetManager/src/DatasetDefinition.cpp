@@ -51,6 +51,8 @@ void DatasetDefinition::readConfigImpl() {
   _devSingleThreadEventLoaderAndIndexer_ = GenericToolbox::Json::fetchValue(_config_, "devSingleThreadEventLoaderAndIndexer", _devSingleThreadEventLoaderAndIndexer_);
   _devSingleThreadEventSelection_ = GenericToolbox::Json::fetchValue(_config_, "devSingleThreadEventSelection", _devSingleThreadEventSelection_);
   _sortLoadedEvents_ = GenericToolbox::Json::fetchValue(_config_, "sortLoadedEvents", _sortLoadedEvents_);
+  _singlePassLoading_ = GenericToolbox::Json::fetchValue(_config_, "singlePassLoading", _singlePassLoading_);
+  _nbCompiledFormulaChecks_ = GenericToolbox::Json::fetchValue(_config_, "nbCompiledFormulaChecks", _nbCompiledFormulaChecks_);
 
 }
 void DatasetDefinition::initializeImpl() {
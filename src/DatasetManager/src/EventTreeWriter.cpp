@@ -11,6 +11,8 @@
 #include "GenericToolbox.Root.h"
 #include "GenericToolbox.Json.h"
 
+#include <future>
+
 
 LoggerInit([]{
   Logger::setUserHeaderStr("[TreeWriter]");
@@ -22,6 +24,8 @@ void EventTreeWriter::readConfigImpl() {
 
   _writeDials_ = GenericToolbox::Json::fetchValue(_config_, "writeDials", _writeDials_);
   _nPointsPerDial_ = GenericToolbox::Json::fetchValue(_config_, "nPointsPerDial", _nPointsPerDial_);
+  _nEventsPerBlock_ = GenericToolbox::Json::fetchValue(_config_, "nEventsPerBlock", _nEventsPerBlock_);
+  LogThrowIf(_nEventsPerBlock_ < 1, GET_VAR_NAME_VALUE(_nEventsPerBlock_) << " should be positive.");
 
   if( _writeDials_ ){
     LogInfo << "EventTreeWriter configured as:" << std::endl;
@@ -29,6 +33,7 @@ void EventTreeWriter::readConfigImpl() {
       LogScopeIndent;
       LogInfo << GET_VAR_NAME_VALUE(_writeDials_) << std::endl;
       LogInfo << GET_VAR_NAME_VALUE(_nPointsPerDial_) << std::endl;
+      LogInfo << GET_VAR_NAME_VALUE(_nEventsPerBlock_) << std::endl;
     }
   }
 }
@@ -45,11 +50,11 @@ void EventTreeWriter::writeSamples(TDirectory* saveDir_, const Propagator& propa
     LogInfo << "Writing sample: " << sample.getName() << std::endl;
 
     for( bool isData : {false, true} ) {
-      const auto *evListPtr = (isData ? &sample.getDataContainer().getEventList() : &sample.getMcContainer().getEventList());
-      if (evListPtr->empty()) continue;
+      const auto *containerPtr = (isData ? &sample.getDataContainer() : &sample.getMcContainer());
+      if (containerPtr->getEventList().empty()) continue;
 
       if( not _writeDials_ or isData ){
-        this->writeEvents(GenericToolbox::mkdirTFile(saveDir_, sample.getName()), (isData ? "Data" : "MC"), *evListPtr);
+        this->writeEvents(GenericToolbox::mkdirTFile(saveDir_, sample.getName()), (isData ? "Data" : "MC"), *containerPtr);
       }
       else{
         std::vector<const EventDialCache::CacheEntry*> cacheSampleList{};
@@ -67,14 +72,16 @@ void EventTreeWriter::writeSamples(TDirectory* saveDir_, const Propagator& propa
   } // sample
 
 }
-void EventTreeWriter::writeEvents(TDirectory *saveDir_, const std::string& treeName_, const std::vector<Event> & eventList_) const {
-  this->writeEventsTemplate(saveDir_, treeName_, eventList_);
+void EventTreeWriter::writeEvents(TDirectory *saveDir_, const std::string& treeName_, const SampleElement& container_) const {
+  this->writeEventsTemplate(saveDir_, treeName_, container_.getEventList(), container_.getWeightStore());
 }
 void EventTreeWriter::writeEvents(TDirectory* saveDir_, const std::string& treeName_, const std::vector<const EventDialCache::CacheEntry*>& cacheSampleList_) const{
-  this->writeEventsTemplate(saveDir_, treeName_, cacheSampleList_);
+  if( cacheSampleList_.empty() ){ return; }
+  // all the entries belong to the same sample
+  this->writeEventsTemplate(saveDir_, treeName_, cacheSampleList_, *cacheSampleList_[0]->weightStorePtr);
 }
 
-template<typename T> void EventTreeWriter::writeEventsTemplate(TDirectory* saveDir_, const std::string& treeName_, const T& eventList_) const {
+template<typename T> void EventTreeWriter::writeEventsTemplate(TDirectory* saveDir_, const std::string& treeName_, const T& eventList_, const EventUtils::WeightStore& weightStore_) const {
   LogThrowIf(saveDir_ == nullptr, "Save TDirectory is not set.");
   LogThrowIf(treeName_.empty(), "TTree name no set.");
 
@@ -92,8 +99,8 @@ template<typename T> void EventTreeWriter::writeEventsTemplate(TDirectory* saveD
 
   GenericToolbox::RawDataArray privateMemberArr;
   std::map<std::string, std::function<void(GenericToolbox::RawDataArray&, const Event&)>> leafDictionary;
-  leafDictionary["eventWeight/D"] =   [](GenericToolbox::RawDataArray& arr_, const Event& ev_){ arr_.writeRawData(ev_.getWeights().current); };
-  leafDictionary["treeWeight/D"] =    [](GenericToolbox::RawDataArray& arr_, const Event& ev_){ arr_.writeRawData(ev_.getWeights().base); };
+  leafDictionary["eventWeight/D"] =   [&](GenericToolbox::RawDataArray& arr_, const Event& ev_){ arr_.writeRawData(weightStore_.current[ev_.getIndices().weight]); };
+  leafDictionary["treeWeight/D"] =    [&](GenericToolbox::RawDataArray& arr_, const Event& ev_){ arr_.writeRawData(weightStore_.base[ev_.getIndices().weight]); };
   leafDictionary["sampleBinIndex/I"]= [](GenericToolbox::RawDataArray& arr_, const Event& ev_){ arr_.writeRawData(ev_.getIndices().bin); };
   leafDictionary["dataSetIndex/I"] =  [](GenericToolbox::RawDataArray& arr_, const Event& ev_){ arr_.writeRawData(ev_.getIndices().dataset); };
   leafDictionary["entryIndex/L"] =    [](GenericToolbox::RawDataArray& arr_, const Event& ev_){ arr_.writeRawData(ev_.getIndices().entry); };
@@ -112,11 +119,8 @@ template<typename T> void EventTreeWriter::writeEventsTemplate(TDirectory* saveD
     std::string leafDefinitionStr{};
     bool disableArray{false};
 
-    void dropData(GenericToolbox::RawDataArray& arr_, const GenericToolbox::AnyType& var_){
-      arr_.writeMemoryContent(
-          var_.getPlaceHolderPtr()->getVariableAddress(),
-          var_.getPlaceHolderPtr()->getVariableSize()
-      );
+    void dropData(GenericToolbox::RawDataArray& arr_, const EventUtils::Variables& variables_, int iVar_){
+      arr_.writeMemoryContent( variables_.getVarAddress(iVar_), variables_.getVarSize(iVar_) );
       if( disableArray ){ return; }
     }
   };
@@ -129,7 +133,7 @@ template<typename T> void EventTreeWriter::writeEventsTemplate(TDirectory* saveD
       lDict.emplace_back();
       lDict.back().disableArray = true;
 
-      auto& var = evPtr->getVariables().fetchVariable( varName ).get();
+      auto& var = evPtr->getVariables().getVarPrototype( evPtr->getVariables().findVarIndex( varName ) );
       char typeTag = GenericToolbox::findOriginalVariableType(var);
       LogThrowIf( typeTag == 0 or typeTag == char(0xFF), varName << " has an invalid leaf type." );
 
@@ -149,7 +153,7 @@ template<typename T> void EventTreeWriter::writeEventsTemplate(TDirectory* saveD
       branchDefStr += lDict[iLeaf].leafDefinitionStr;
       leafNamesList.emplace_back(
           lDict[iLeaf].leafDefinitionStr.substr(0,lDict[iLeaf].leafDefinitionStr.find("[")).substr(0, lDict[iLeaf].leafDefinitionStr.find("/")));
-      lDict[iLeaf].dropData(loadedLeavesArr, EventTreeWriter::getEventPtr(eventList_[0])->getVariables().getVarList()[iLeaf].get()); // resize buffer
+      lDict[iLeaf].dropData(loadedLeavesArr, EventTreeWriter::getEventPtr(eventList_[0])->getVariables(), iLeaf); // resize buffer
     }
     loadedLeavesArr.lockArraySize();
     tree->Branch("Leaves", &loadedLeavesArr.getRawDataArray()[0], branchDefStr.c_str());
@@ -205,50 +209,84 @@ template<typename T> void EventTreeWriter::writeEventsTemplate(TDirectory* saveD
       }
     }
 
-    // parallel job to write dials
-    GundamGlobals::getParallelWorker().addJob("buildResponseGraph", [&](int iThread_){
-      TGraph* grPtr{nullptr};
-      for( size_t iGlobalPar = 0 ; iGlobalPar < parIndexList.size() ; iGlobalPar++ ){
-        if( iThread_ != -1 and iGlobalPar % GundamGlobals::getParallelWorker().getNbThreads() != iThread_ ) continue;
-
-        // reset the corresponding graph
-        grPtr = graphParResponse[iGlobalPar];
-
-        // lighten the graph
-        while( grPtr->GetN() != 1 ){ grPtr->RemovePoint(0); }
-        grPtr->SetPointX(0, parameterXvalues[iGlobalPar][_nPointsPerDial_/2+1]);
-        grPtr->SetPointY(0, 1);
-
-        // fetch corresponding dial if it exists
-        for( auto& dial : *dialElements ){
-          if( dial.dialInterface.getInputBufferRef()->getInputParameterIndicesList()[0].parSetIndex == parIndexList[iGlobalPar].first
-              and dial.dialInterface.getInputBufferRef()->getInputParameterIndicesList()[0].parIndex == parIndexList[iGlobalPar].second ){
-
-            DialInputBuffer inputBuf{*dial.dialInterface.getInputBufferRef()};
-            grPtr->RemovePoint(0); // remove the first and recreate the whole thing
-            for( double xPoint : parameterXvalues[iGlobalPar] ){
-              inputBuf.getInputBuffer()[0] = xPoint;
-              grPtr->AddPoint(
-                  xPoint,
-                  DialInterface::evalResponse(
-                      &inputBuf,
-                      dial.dialInterface.getDialBaseRef(),
-                      dial.dialInterface.getResponseSupervisorRef()
-                  )
-              );
-            }
-
-            break;
-          }
+  }
+
+  // (parSetIndex, parIndex) -> global parameter index
+  std::vector<std::vector<int>> globalParIndexLookup{};
+  for( size_t iGlobalPar = 0 ; iGlobalPar < parIndexList.size() ; iGlobalPar++ ){
+    auto& parIndex = parIndexList[iGlobalPar];
+    if( globalParIndexLookup.size() <= parIndex.first ){ globalParIndexLookup.resize(parIndex.first + 1); }
+    if( globalParIndexLookup[parIndex.first].size() <= parIndex.second ){ globalParIndexLookup[parIndex.first].resize(parIndex.second + 1, -1); }
+    globalParIndexLookup[parIndex.first][parIndex.second] = int(iGlobalPar);
+  }
+
+  // The response graphs are built for whole blocks of events: each thread
+  // evaluates the dials of a range of events, while the previous block is
+  // written in the TTree by a single filler thread.
+  ResponseBlock* currentBlock{nullptr};
+  auto buildResponseGraphs = [&](int iThread_){
+    int nThreads{GundamGlobals::getParallelWorker().getNbThreads()};
+    if( iThread_ == -1 ){ iThread_ = 0; nThreads = 1; }
+
+    auto& threadBuffer = currentBlock->threadBufferList[iThread_];
+    threadBuffer.eventOffsetList.clear();
+    threadBuffer.parIndexList.clear();
+    threadBuffer.responseList.clear();
+
+    std::vector<char> isParFilledList(parIndexList.size(), false);
+
+    auto bounds = GenericToolbox::ParallelWorker::getThreadBoundIndices(
+        iThread_, nThreads, int(currentBlock->endIndex - currentBlock->beginIndex)
+    );
+    threadBuffer.eventOffsetList.emplace_back( 0 );
+    for( int iBlockEvent = bounds.beginIndex ; iBlockEvent < bounds.endIndex ; iBlockEvent++ ){
+      size_t parOffset{threadBuffer.parIndexList.size()};
+
+      for( auto& dial : *getDialElementsPtr(eventList_[currentBlock->beginIndex + iBlockEvent]) ){
+        auto& inputPar = dial.dialInterface.getInputBufferRef()->getInputParameterIndicesList()[0];
+        if( inputPar.parSetIndex < 0 or inputPar.parSetIndex >= int(globalParIndexLookup.size()) ){ continue; }
+        if( inputPar.parIndex < 0 or inputPar.parIndex >= int(globalParIndexLookup[inputPar.parSetIndex].size()) ){ continue; }
+
+        int iGlobalPar{globalParIndexLookup[inputPar.parSetIndex][inputPar.parIndex]};
+        if( iGlobalPar == -1 or isParFilledList[iGlobalPar] ){ continue; } // the first dial of the parameter only
+        isParFilledList[iGlobalPar] = true;
+
+        threadBuffer.parIndexList.emplace_back( iGlobalPar );
+        DialInputBuffer inputBuf{*dial.dialInterface.getInputBufferRef()};
+        for( double xPoint : parameterXvalues[iGlobalPar] ){
+          inputBuf.getInputBuffer()[0] = xPoint;
+          threadBuffer.responseList.emplace_back(
+              DialInterface::evalResponse(
+                  &inputBuf,
+                  dial.dialInterface.getDialBaseRef(),
+                  dial.dialInterface.getResponseSupervisorRef()
+              )
+          );
         }
       }
-    });
-  }
+
+      for( size_t iDial = parOffset ; iDial < threadBuffer.parIndexList.size() ; iDial++ ){
+        isParFilledList[threadBuffer.parIndexList[iDial]] = false;
+      }
+      threadBuffer.eventOffsetList.emplace_back( threadBuffer.parIndexList.size() );
+    }
+  };
+
+  // graphs of the parameters without dial: a single point at 1
+  auto resetGraph = [&](size_t iGlobalPar_){
+    auto* grPtr = graphParResponse[iGlobalPar_];
+    grPtr->Set(1);
+    grPtr->SetPoint(0, parameterXvalues[iGlobalPar_][_nPointsPerDial_/2+1], 1);
+  };
+  for( size_t iGlobalPar = 0 ; iGlobalPar < graphParResponse.size() ; iGlobalPar++ ){ resetGraph(iGlobalPar); }
+  std::vector<int> filledGraphList{};
 
   std::string progressTitle = LogInfo.getPrefixString() + Logger::getIndentStr() + "Writing " + treeName_;
-  size_t iEvent{0}; size_t nEvents = (eventList_.size());
-  for( auto& cacheEntry : eventList_ ){
-    GenericToolbox::displayProgressBar(iEvent++,nEvents,progressTitle);
+  size_t nEvents = (eventList_.size());
+  auto fillEvent = [&](size_t iEvent_){
+    GenericToolbox::displayProgressBar(iEvent_,nEvents,progressTitle);
+
+    auto& cacheEntry = eventList_[iEvent_];
 
     privateMemberArr.resetCurrentByteOffset();
     for( auto& leafDef : leafDictionary ){ leafDef.second(privateMemberArr, *EventTreeWriter::getEventPtr(cacheEntry)); }
@@ -257,20 +295,67 @@ template<typename T> void EventTreeWriter::writeEventsTemplate(TDirectory* saveD
     for( int iLeaf = 0 ; iLeaf < lDict.size() ; iLeaf++ ){
       lDict[iLeaf].dropData(
           loadedLeavesArr,
-          EventTreeWriter::getEventPtr( cacheEntry )->getVariables().getVarList()[iLeaf].get()
+          EventTreeWriter::getEventPtr( cacheEntry )->getVariables(),
+          iLeaf
       );
     }
 
-    if( writeDials ){
-      dialElements = getDialElementsPtr(cacheEntry);
-      GundamGlobals::getParallelWorker().runJob("buildResponseGraph");
+    tree->Fill();
+  };
+  auto fillBlock = [&](const ResponseBlock* block_){
+    // the threads are holding contiguous ranges of events
+    size_t iEvent{block_->beginIndex};
+    for( auto& threadBuffer : block_->threadBufferList ){
+      for( size_t iThreadEvent = 0 ; iThreadEvent + 1 < threadBuffer.eventOffsetList.size() ; iThreadEvent++ ){
+
+        // only reset the graphs of the previous event
+        for( int iGlobalPar : filledGraphList ){ resetGraph(iGlobalPar); }
+        filledGraphList.clear();
+
+        for( size_t iDial = threadBuffer.eventOffsetList[iThreadEvent] ; iDial < threadBuffer.eventOffsetList[iThreadEvent+1] ; iDial++ ){
+          int iGlobalPar{threadBuffer.parIndexList[iDial]};
+          auto* grPtr = graphParResponse[iGlobalPar];
+          grPtr->Set(_nPointsPerDial_);
+          for( int iPt = 0 ; iPt < _nPointsPerDial_ ; iPt++ ){
+            grPtr->SetPoint(iPt, parameterXvalues[iGlobalPar][iPt], threadBuffer.responseList[iDial*_nPointsPerDial_ + iPt]);
+          }
+          filledGraphList.emplace_back(iGlobalPar);
+        }
+
+        fillEvent(iEvent++);
+      }
     }
+  };
 
-    tree->Fill();
+  if( not writeDials ){
+    // nothing to build: no need for the filler thread
+    for( size_t iEvent = 0 ; iEvent < nEvents ; iEvent++ ){ fillEvent(iEvent); }
   }
+  else{
+    GundamGlobals::getParallelWorker().addJob("buildResponseGraphs", buildResponseGraphs);
+
+    // double buffer: one block is being built while the other is written
+    std::vector<ResponseBlock> responseBlockList(2);
+    for( auto& block : responseBlockList ){
+      block.threadBufferList.resize( std::max(1, GundamGlobals::getParallelWorker().getNbThreads()) );
+    }
+
+    std::future<void> fillerFuture{};
+    size_t nEventsPerBlock{size_t(_nEventsPerBlock_)};
+    for( size_t iBlock = 0 ; iBlock * nEventsPerBlock < nEvents ; iBlock++ ){
+      currentBlock = &responseBlockList[iBlock % 2];
+      currentBlock->beginIndex = iBlock * nEventsPerBlock;
+      currentBlock->endIndex = std::min(nEvents, currentBlock->beginIndex + nEventsPerBlock);
+
+      GundamGlobals::getParallelWorker().runJob("buildResponseGraphs");
+
+      // the previous block has to be written before handing over this one
+      if( fillerFuture.valid() ){ fillerFuture.get(); }
+      fillerFuture = std::async(std::launch::async, fillBlock, currentBlock);
+    }
+    if( fillerFuture.valid() ){ fillerFuture.get(); }
 
-  if( writeDials ) {
-    GundamGlobals::getParallelWorker().removeJob("buildResponseGraph");
+    GundamGlobals::getParallelWorker().removeJob("buildResponseGraphs");
   }
 
 
@@ -70,7 +70,7 @@ double EventVarTransform::evalTransformation( const Event& event_, std::vector<d
   return std::nan("defaultEvalTransformOutput");
 }
 void EventVarTransform::storeOutput( double output_, Event& storeEvent_ ) const{
-  auto& variable = storeEvent_.getVariables().fetchVariable(this->getOutputVariableName());
-  variable.set( output_ );
+  auto& variables = storeEvent_.getVariables();
+  variables.setVarValue( variables.findVarIndex(this->getOutputVariableName()), output_ );
 }
 
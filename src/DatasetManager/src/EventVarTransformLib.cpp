@@ -39,9 +39,21 @@ void EventVarTransformLib::loadLibrary(){
 }
 void EventVarTransformLib::initInputFormulas(){
   _inputFormulaList_.clear();
+  _compiledInputFormulaList_.clear();
   for( auto& inputFormulaStr : _inputFormulaStrList_ ){
     _inputFormulaList_.emplace_back( inputFormulaStr.c_str(), inputFormulaStr.c_str() );
     LogThrowIf(not _inputFormulaList_.back().IsValid(), "\"" << inputFormulaStr << "\": could not be parsed as formula expression.")
+
+    // the compiled formula is only used if it reads the same variables
+    _compiledInputFormulaList_.emplace_back();
+    if( _compiledInputFormulaList_.back().compile( inputFormulaStr ) ){
+      auto& varNameList = _compiledInputFormulaList_.back().getVariableNameList();
+      bool isSameVarList{int(varNameList.size()) == _inputFormulaList_.back().GetNpar()};
+      for( auto& varName : varNameList ){
+        if( _inputFormulaList_.back().GetParNumber(varName.c_str()) == -1 ){ isSameVarList = false; }
+      }
+      if( not isSameVarList ){ _compiledInputFormulaList_.back() = CompiledFormula(); }
+    }
   }
   _inputBuffer_.resize(_inputFormulaList_.size(), std::nan("unset"));
 }
@@ -49,8 +61,22 @@ double EventVarTransformLib::evalTransformation( const Event& event_, std::vecto
   // Eval the requested variables
   size_t nFormula{_inputFormulaList_.size()};
   for( size_t iFormula = 0 ; iFormula < nFormula ; iFormula++ ){
-    inputBuffer_[iFormula] = event_.getVariables().evalFormula(&(_inputFormulaList_[iFormula]));
+    if( _compiledInputFormulaList_[iFormula].isCompiled() ){
+      inputBuffer_[iFormula] = event_.getVariables().evalFormula(_compiledInputFormulaList_[iFormula]);
+
+      // cross-check with the TFormula
+      if( _nbCompiledFormulaChecks_ > 0 ){
+        double reference{event_.getVariables().evalFormula(&(_inputFormulaList_[iFormula]))};
+        LogThrowIf(not CompiledFormula::isSameValue(inputBuffer_[iFormula], reference),
+                   "Compiled input formula \"" << _inputFormulaStrList_[iFormula] << "\" of " << _name_
+                   << " gives " << inputBuffer_[iFormula] << " while TFormula gives " << reference);
+      }
+    }
+    else{
+      inputBuffer_[iFormula] = event_.getVariables().evalFormula(&(_inputFormulaList_[iFormula]));
+    }
   }
+  if( _nbCompiledFormulaChecks_ > 0 ){ _nbCompiledFormulaChecks_--; }
   // Eval with dynamic function
   return reinterpret_cast<double(*)(double*)>(_evalVariable_)(&inputBuffer_[0]);
 }
@@ -6,6 +6,7 @@
 #define GUNDAM_COMPACTSPLINE_H
 
 #include "DialBase.h"
+#include "DialDataPool.h"
 #include "DialInputBuffer.h"
 
 #include "TGraph.h"
@@ -22,6 +23,7 @@ public:
   [[nodiscard]] std::unique_ptr<DialBase> clone() const override { return std::make_unique<CompactSpline>(*this); }
   [[nodiscard]] std::string getDialTypeName() const override { return {"CompactSpline"}; }
   [[nodiscard]] double evalResponse(const DialInputBuffer& input_) const override;
+  [[nodiscard]] double evalDerivative(const DialInputBuffer& input_, int iInput_=0) const override;
 
   [[nodiscard]] std::string getSummary() const override;
 
@@ -42,7 +44,10 @@ public:
                          const std::vector<double>& v3,
                          const std::string& option_="") override;
 
-  [[nodiscard]] const std::vector<double>& getDialData() const override {return _splineData_;}
+  [[nodiscard]] const std::vector<double>& getDialData() const override {return _splineData_.get();}
+  bool getSnapshotData(std::vector<double>& data_) const override;
+  void setSnapshotData(const std::vector<double>& data_) override;
+  [[nodiscard]] const std::pair<double, double>& getSplineBounds() const {return _splineBounds_;}
 
 protected:
   bool _allowExtrapolation_{false};
@@ -50,7 +55,7 @@ protected:
   // A block of data to calculate the spline values.  This must be filled for
   // the Cache::Manager to work, and provides the input for spline calculation
   // functions that can be shared between the CPU and the GPU.
-  std::vector<double> _splineData_{};
+  SharedDialData _splineData_{}; // interned: shared among identical dials
   std::pair<double, double> _splineBounds_{std::nan("unset"), std::nan("unset")};
 };
 
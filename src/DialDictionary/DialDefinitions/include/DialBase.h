@@ -38,6 +38,12 @@ public:
   /// DialInputBuffer.
   [[nodiscard]] virtual double evalResponse(const DialInputBuffer& input_) const = 0;
 
+  /// Evaluate the derivative of the dial response with respect to the
+  /// iInput_-th value of the DialInputBuffer.  This is used for the analytic
+  /// gradient of the likelihood.  The default is a central finite difference,
+  /// so dials with a closed form derivative should override it.
+  [[nodiscard]] virtual double evalDerivative(const DialInputBuffer& input_, int iInput_=0) const;
+
   /// Allow extrapolation of the data.  The default is to
   /// forbid extrapolation.
   virtual void setAllowExtrapolation(bool allow_) {}
@@ -80,6 +86,13 @@ public:
   /// specific data contained in the vector depends on the derived class.
   [[nodiscard]] virtual const std::vector<double>& getDialData() const;
 
+  /// Copy the internal state of the dial into a flat list of doubles so it
+  /// can be restored with setSnapshotData() without the object used to build
+  /// it.  This is used by the DataDispenser snapshots.  Returns false if the
+  /// dial doesn't support it.
+  virtual bool getSnapshotData(std::vector<double>& data_) const {return false;}
+  virtual void setSnapshotData(const std::vector<double>& data_) {throw std::runtime_error("Not implemented");}
+
 
 };
 
@@ -0,0 +1,103 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#ifndef GUNDAM_DIAL_DATA_POOL_H
+#define GUNDAM_DIAL_DATA_POOL_H
+
+#include <atomic>
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstddef>
+
+
+/// Content-addressed storage of the dial data (spline knots, graph points).
+/// Event-by-event dials often share the exact same response: the data are
+/// interned while loading so that identical knot sets are stored once and
+/// shared by all the dials referring to them. The data is immutable once
+/// interned.
+class DialDataPool{
+
+public:
+  typedef std::shared_ptr<const std::vector<double>> DataPtr;
+
+  /// Returns the pooled copy of data_ (bitwise comparison). Thread safe.
+  static DataPtr intern(std::vector<double>&& data_);
+  static const DataPtr& getEmptyData();
+
+  /// Forget the pooled entries. The data held by the dials is not affected.
+  static void clear();
+  /// Drop the entries whose data is not used by any dial anymore. The shards
+  /// are also purged by intern() each time they double in size.
+  static void purge();
+
+  // stats: the unique entries and stored values only count the live entries
+  // as of the last purge. getSummary() purges first.
+  [[nodiscard]] static size_t getNbRequests(){ return _nbRequests_; }
+  [[nodiscard]] static size_t getNbUniqueEntries(){ return _nbUniqueEntries_; }
+  [[nodiscard]] static std::string getSummary();
+
+private:
+  static std::atomic<size_t> _nbRequests_;
+  static std::atomic<size_t> _nbRequestedValues_;
+  static std::atomic<size_t> _nbUniqueEntries_;
+  static std::atomic<size_t> _nbStoredValues_;
+
+};
+
+
+/// Read-only view on interned dial data. Has the const interface of the
+/// std::vector it replaces in the dial definitions.
+class SharedDialData{
+
+public:
+  SharedDialData() = default;
+
+  void set(std::vector<double>&& data_){ _dataPtr_ = DialDataPool::intern(std::move(data_)); }
+
+  [[nodiscard]] const std::vector<double>& get() const{ return *_dataPtr_; }
+  [[nodiscard]] const DialDataPool::DataPtr& getDataPtr() const{ return _dataPtr_; }
+
+  [[nodiscard]] bool empty() const{ return _dataPtr_->empty(); }
+  [[nodiscard]] size_t size() const{ return _dataPtr_->size(); }
+  [[nodiscard]] const double* data() const{ return _dataPtr_->data(); }
+  [[nodiscard]] double back() const{ return _dataPtr_->back(); }
+  [[nodiscard]] std::vector<double>::const_iterator begin() const{ return _dataPtr_->begin(); }
+  [[nodiscard]] std::vector<double>::const_iterator end() const{ return _dataPtr_->end(); }
+  double operator[](size_t index_) const{ return (*_dataPtr_)[index_]; }
+
+private:
+  DialDataPool::DataPtr _dataPtr_{DialDataPool::getEmptyData()};
+
+};
+
+
+#endif // GUNDAM_DIAL_DATA_POOL_H
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
@@ -6,6 +6,7 @@
 #define GUNDAM_LIGHTGRAPH_H
 
 #include "DialBase.h"
+#include "DialDataPool.h"
 
 #include "TGraph.h"
 
@@ -23,19 +24,22 @@ public:
   [[nodiscard]] std::unique_ptr<DialBase> clone() const override { return std::make_unique<LightGraph>(*this); }
   [[nodiscard]] std::string getDialTypeName() const override { return {"LightGraph"}; }
   [[nodiscard]] double evalResponse(const DialInputBuffer& input_) const override;
+  [[nodiscard]] double evalDerivative(const DialInputBuffer& input_, int iInput_=0) const override;
 
   void setAllowExtrapolation(bool allowExtrapolation) override;
   [[nodiscard]] bool getAllowExtrapolation() const override;
 
   virtual void buildDial(const TGraph& grf, const std::string& option_="") override;
 
-  const std::vector<double>& getDialData() const override {return _Data_;}
+  const std::vector<double>& getDialData() const override {return _Data_.get();}
+  bool getSnapshotData(std::vector<double>& data_) const override;
+  void setSnapshotData(const std::vector<double>& data_) override;
 
 protected:
   bool _allowExtrapolation_{false};
 
-  // The data for the graph packed as {y0,x0,y1,x1,y2,x2,...}
-  std::vector<Double_t> _Data_;
+  // The data for the graph packed as {y0,x0,y1,x1,y2,x2,...}, interned: shared among identical dials
+  SharedDialData _Data_{};
 };
 
 typedef CachedDial<LightGraph> LightGraphCache;
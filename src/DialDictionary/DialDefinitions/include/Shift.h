@@ -18,9 +18,15 @@ public:
   [[nodiscard]] std::unique_ptr<DialBase> clone() const override { return std::make_unique<Shift>(*this); }
   [[nodiscard]] std::string getDialTypeName() const override { return {"Shift"}; }
   [[nodiscard]] double evalResponse(const DialInputBuffer& input_) const override { return _shiftValue_; }
+  [[nodiscard]] double evalDerivative(const DialInputBuffer& input_, int iInput_=0) const override { return 0; }
 
   void buildDial(double shift_, const std::string& options_="") override { _shiftValue_ = shift_; }
 
+  [[nodiscard]] double getShiftValue() const { return _shiftValue_; }
+
+  bool getSnapshotData(std::vector<double>& data_) const override { data_.assign(1, _shiftValue_); return true; }
+  void setSnapshotData(const std::vector<double>& data_) override { _shiftValue_ = data_.at(0); }
+
 private:
   double _shiftValue_{1};
 
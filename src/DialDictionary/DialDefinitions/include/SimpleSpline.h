@@ -6,6 +6,7 @@
 #define GUNDAM_SIMPLESPLINE_H
 
 #include "DialBase.h"
+#include "DialDataPool.h"
 #include "DialInputBuffer.h"
 
 #include "TGraph.h"
@@ -23,6 +24,7 @@ public:
   [[nodiscard]] std::unique_ptr<DialBase> clone() const override { return std::make_unique<SimpleSpline>(*this); }
   [[nodiscard]] std::string getDialTypeName() const override { return {"SimpleSpline"}; }
   [[nodiscard]] double evalResponse(const DialInputBuffer& input_) const override;
+  [[nodiscard]] double evalDerivative(const DialInputBuffer& input_, int iInput_=0) const override;
 
   void setAllowExtrapolation(bool allowExtrapolation) override;
 
@@ -35,7 +37,9 @@ public:
   virtual void buildDial(const TGraph& grf, const std::string& option_="") override;
   virtual void buildDial(const TSpline3& spl, const std::string& option_="") override;
 
-  [[nodiscard]] const std::vector<double>& getDialData() const override {return _splineData_;}
+  [[nodiscard]] const std::vector<double>& getDialData() const override {return _splineData_.get();}
+  bool getSnapshotData(std::vector<double>& data_) const override;
+  void setSnapshotData(const std::vector<double>& data_) override;
 
 protected:
   bool _isUniform_{false};
@@ -44,7 +48,7 @@ protected:
   // A block of data to calculate the spline values.  This must be filled for
   // the Cache::Manager to work, and provides the input for spline calculation
   // functions that can be shared between the CPU and the GPU.
-  std::vector<double> _splineData_{};
+  SharedDialData _splineData_{}; // interned: shared among identical dials
   std::pair<double, double> _splineBounds_{std::nan("unset"), std::nan("unset")};
 };
 
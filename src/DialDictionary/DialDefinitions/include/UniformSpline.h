@@ -6,6 +6,7 @@
 #define GUNDAM_UNIFORMSPLINE_H
 
 #include "DialBase.h"
+#include "DialDataPool.h"
 #include "DialInputBuffer.h"
 
 #include "TGraph.h"
@@ -24,6 +25,7 @@ public:
   [[nodiscard]] std::unique_ptr<DialBase> clone() const override { return std::make_unique<UniformSpline>(*this); }
   [[nodiscard]] std::string getDialTypeName() const override { return {"UniformSpline"}; }
   [[nodiscard]] double evalResponse(const DialInputBuffer& input_) const override;
+  [[nodiscard]] double evalDerivative(const DialInputBuffer& input_, int iInput_=0) const override;
 
   void setAllowExtrapolation(bool allowExtrapolation) override;
   [[nodiscard]] bool getAllowExtrapolation() const override;
@@ -39,7 +41,10 @@ public:
                          const std::vector<double>& v3,
                          const std::string& option_="") override;
 
-   const std::vector<double>& getDialData() const override {return _splineData_;}
+   const std::vector<double>& getDialData() const override {return _splineData_.get();}
+   bool getSnapshotData(std::vector<double>& data_) const override;
+   void setSnapshotData(const std::vector<double>& data_) override;
+  [[nodiscard]] const std::pair<double, double>& getSplineBounds() const {return _splineBounds_;}
 
 protected:
   bool _allowExtrapolation_{false};
@@ -47,7 +52,7 @@ protected:
   // A block of data to calculate the spline values.  This must be filled for
   // the Cache::Manager to work, and provides the input for spline calculation
   // functions that can be shared between the CPU and the GPU.
-  std::vector<double> _splineData_{};
+  SharedDialData _splineData_{}; // interned: shared among identical dials
   std::pair<double, double> _splineBounds_{std::nan("unset"), std::nan("unset")};
 };
 
@@ -20,6 +20,22 @@ bool CompactSpline::getAllowExtrapolation() const {
   return _allowExtrapolation_;
 }
 
+bool CompactSpline::getSnapshotData(std::vector<double>& data_) const {
+  data_.clear();
+  data_.reserve(_splineData_.size() + 2);
+  data_.emplace_back(_splineBounds_.first);
+  data_.emplace_back(_splineBounds_.second);
+  data_.insert(data_.end(), _splineData_.begin(), _splineData_.end());
+  return true;
+}
+
+void CompactSpline::setSnapshotData(const std::vector<double>& data_) {
+  LogThrowIf(data_.size() < 2, "Invalid snapshot data for " << this->getDialTypeName());
+  _splineBounds_.first = data_[0];
+  _splineBounds_.second = data_[1];
+  _splineData_.set(std::vector<double>(data_.begin() + 2, data_.end()));
+}
+
 void CompactSpline::buildDial(const TSpline3& spline, const std::string& option_) {
   std::vector<double> xPoint(spline.GetNp());
   std::vector<double> yPoint(spline.GetNp());
@@ -55,12 +71,14 @@ void CompactSpline::buildDial(const std::vector<double>& v1,
                               const std::string& option_) {
   LogThrowIf(not _splineData_.empty(), "Spline data already set.");
 
+  std::vector<double> splineData;
+
   _splineBounds_.first = v1.front();
   _splineBounds_.second = v1.back();
 
-  _splineData_.resize(2 + v1.size());
-  _splineData_[0] = v1.front();
-  _splineData_[1] = (v1.back() - v1.front())/(v1.size()-1.0);
+  splineData.resize(2 + v1.size());
+  splineData[0] = v1.front();
+  splineData[1] = (v1.back() - v1.front())/(v1.size()-1.0);
 
   // Non uniform input points should be caught before the CompactSpline is
   // built, but apply a final sanity check to make sure the point spacing is
@@ -69,23 +87,23 @@ void CompactSpline::buildDial(const std::vector<double>& v1,
   const double tolerance{1E-2};
   bool validInputs = true;
   // First check that the points have a reasonable separation.
-  if (_splineData_[1] < 1E-6) validInputs = false;
+  if (splineData[1] < 1E-6) validInputs = false;
   // Make sure the points are uniformly spaced.
   for (int i=0; i<v1.size()-1; ++i) {
-      double d = std::abs(v1[i] - _splineData_[0] - i*_splineData_[1]);
-      if ((d/_splineData_[1])>tolerance) validInputs = false;
+      double d = std::abs(v1[i] - splineData[0] - i*splineData[1]);
+      if ((d/splineData[1])>tolerance) validInputs = false;
   }
   // Make lots of output if there is a problem!  This hopefully gives a clue
   // which spline is causing trouble.
   if (not validInputs) {
       LogError << "Invalid inputs -- Bounds: " << _splineBounds_.first
                << " to " << _splineBounds_.second
-               << ", First X: " << _splineData_[0]
-               << ", X spacing: " << _splineData_[1]
+               << ", First X: " << splineData[0]
+               << ", X spacing: " << splineData[1]
                << std::endl;
       for (int i=0; i<v1.size()-1; ++i) {
-          double d = std::abs(v1[i] - _splineData_[0] - i*_splineData_[1]);
-          d /= _splineData_[1];
+          double d = std::abs(v1[i] - splineData[0] - i*splineData[1]);
+          d /= splineData[1];
           LogError << "Invalid inputs -- point: " << i
                    << " X: " << v1[i]
                    << " (tolerance " << d << ")"
@@ -108,8 +126,9 @@ void CompactSpline::buildDial(const std::vector<double>& v1,
 #endif
   }
 
-  for(int i=0; i<v2.size(); ++i) _splineData_[2+i] = v2[i];
+  for(int i=0; i<v2.size(); ++i) splineData[2+i] = v2[i];
 
+  _splineData_.set(std::move(splineData));
 }
 
 double CompactSpline::evalResponse(const DialInputBuffer& input_) const {
@@ -127,10 +146,21 @@ double CompactSpline::evalResponse(const DialInputBuffer& input_) const {
   return CalculateCompactSpline( dialInput, -1E20, 1E20, _splineData_.data(), int(_splineData_.size()-2) );
 }
 
+double CompactSpline::evalDerivative(const DialInputBuffer& input_, int iInput_) const {
+  double dialInput{input_.getInputBuffer()[0]};
+
+  if( not _allowExtrapolation_ ){
+    // the response is flat outside the spline bounds
+    if( dialInput < _splineBounds_.first or dialInput > _splineBounds_.second ){ return 0; }
+  }
+
+  return CalculateCompactSplineDerivative( dialInput, _splineData_.data(), int(_splineData_.size()-2) );
+}
+
 
 std::string CompactSpline::getSummary() const {
   std::stringstream ss;
-  ss << this->getDialTypeName() << ": spline data = " << GenericToolbox::toString(_splineData_);
+  ss << this->getDialTypeName() << ": spline data = " << GenericToolbox::toString(_splineData_.get());
   ss << std::endl << this->getDialTypeName() << ": defined bounds = { " << _splineBounds_.first << ", " << _splineBounds_.second << " }";
   ss << std::endl << this->getDialTypeName() << ": allow extrapolation ? " << _allowExtrapolation_;
   return ss.str();
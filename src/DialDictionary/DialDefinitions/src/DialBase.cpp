@@ -6,6 +6,9 @@
 
 #include "Logger.h"
 
+#include <cmath>
+#include <algorithm>
+
 LoggerInit([]{
   Logger::setUserHeaderStr("[DialBase]");
 });
@@ -22,4 +25,18 @@ const std::vector<double>& DialBase::getDialData() const {
     return dummy;
 }
 
+double DialBase::evalDerivative(const DialInputBuffer& input_, int iInput_) const {
+  // probe the response on a copy of the inputs so the cached responses stay valid
+  const double x{input_.getInputBuffer()[iInput_]};
+  const double step{1E-6 * std::max(1., std::abs(x))};
+
+  DialInputBuffer probe{input_};
+  probe.setInputValue(iInput_, x + step);
+  double out{this->evalResponse(probe)};
+  probe.setInputValue(iInput_, x - step);
+  out -= this->evalResponse(probe);
+
+  return out / (2 * step);
+}
+
 std::string DialBase::getDialTypeName() const { return {"DialBase"}; }
@@ -0,0 +1,184 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#include "DialDataPool.h"
+
+#include "GenericToolbox.String.h"
+#include "Logger.h"
+
+#include <unordered_map>
+#include <sstream>
+#include <cstring>
+#include <cstdint>
+#include <mutex>
+#include <algorithm>
+
+LoggerInit([]{ Logger::setUserHeaderStr("[DialDataPool]"); });
+
+
+std::atomic<size_t> DialDataPool::_nbRequests_{0};
+std::atomic<size_t> DialDataPool::_nbRequestedValues_{0};
+std::atomic<size_t> DialDataPool::_nbUniqueEntries_{0};
+std::atomic<size_t> DialDataPool::_nbStoredValues_{0};
+
+namespace {
+
+  // the loading threads are spread over independent shards to limit the lock contention
+  constexpr size_t kNbShards{32};
+
+  // a shard is not purged before it holds that many entries
+  constexpr size_t kMinNbEntriesToPurge{1024};
+
+  struct Entry{
+    std::weak_ptr<const std::vector<double>> dataPtr{};
+    size_t nbValues{0};
+  };
+
+  struct Shard{
+    std::mutex mutex{};
+    // the pool does not own the data: entries expire with the last dial using them
+    std::unordered_multimap<uint64_t, Entry> entryDict{};
+    size_t nbEntriesAfterPurge{0};
+  };
+
+  struct PurgeResult{ size_t nbEntries{0}; size_t nbValues{0}; };
+
+  // the shard mutex has to be held
+  PurgeResult purgeShard(Shard& shard_){
+    PurgeResult out{};
+    for( auto it = shard_.entryDict.begin() ; it != shard_.entryDict.end() ; ){
+      if( not it->second.dataPtr.expired() ){ ++it; continue; }
+      out.nbEntries++;
+      out.nbValues += it->second.nbValues;
+      it = shard_.entryDict.erase(it);
+    }
+    shard_.nbEntriesAfterPurge = shard_.entryDict.size();
+    return out;
+  }
+
+  std::vector<Shard>& getShardList(){
+    static std::vector<Shard> shardList(kNbShards);
+    return shardList;
+  }
+
+  uint64_t hashData(const std::vector<double>& data_){
+    // FNV-1a on the 64 bits patterns: the comparison is bitwise anyway
+    uint64_t hash{14695981039346656037ULL};
+    for( double value : data_ ){
+      uint64_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      hash ^= bits;
+      hash *= 1099511628211ULL;
+    }
+    return hash ^ data_.size();
+  }
+
+  bool isSameData(const std::vector<double>& a_, const std::vector<double>& b_){
+    return a_.size() == b_.size()
+           and ( a_.empty() or std::memcmp(a_.data(), b_.data(), a_.size() * sizeof(double)) == 0 );
+  }
+
+}
+
+DialDataPool::DataPtr DialDataPool::intern(std::vector<double>&& data_){
+  _nbRequests_++;
+  _nbRequestedValues_ += data_.size();
+
+  if( data_.empty() ){ return getEmptyData(); }
+
+  uint64_t hash{hashData(data_)};
+  auto& shard = getShardList()[hash % kNbShards];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  auto range = shard.entryDict.equal_range(hash);
+  for( auto it = range.first ; it != range.second ; ){
+    auto dataPtr = it->second.dataPtr.lock();
+    if( dataPtr == nullptr ){
+      _nbUniqueEntries_--;
+      _nbStoredValues_ -= it->second.nbValues;
+      it = shard.entryDict.erase(it);
+      continue;
+    }
+    if( isSameData(*dataPtr, data_) ){ return dataPtr; }
+    ++it;
+  }
+
+  // amortized: the whole shard is only scanned once it doubled in size
+  if( shard.entryDict.size() >= 2 * std::max(shard.nbEntriesAfterPurge, kMinNbEntriesToPurge) ){
+    auto purged = purgeShard(shard);
+    _nbUniqueEntries_ -= purged.nbEntries;
+    _nbStoredValues_ -= purged.nbValues;
+  }
+
+  data_.shrink_to_fit();
+  DataPtr out{std::make_shared<const std::vector<double>>(std::move(data_))};
+  shard.entryDict.emplace(hash, Entry{out, out->size()});
+  _nbUniqueEntries_++;
+  _nbStoredValues_ += out->size();
+  return out;
+}
+const DialDataPool::DataPtr& DialDataPool::getEmptyData(){
+  static const DataPtr emptyData{std::make_shared<const std::vector<double>>()};
+  return emptyData;
+}
+void DialDataPool::clear(){
+  for( auto& shard : getShardList() ){
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.entryDict.clear();
+    shard.nbEntriesAfterPurge = 0;
+  }
+  _nbRequests_ = 0;
+  _nbRequestedValues_ = 0;
+  _nbUniqueEntries_ = 0;
+  _nbStoredValues_ = 0;
+}
+void DialDataPool::purge(){
+  for( auto& shard : getShardList() ){
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto purged = purgeShard(shard);
+    _nbUniqueEntries_ -= purged.nbEntries;
+    _nbStoredValues_ -= purged.nbValues;
+  }
+}
+
+std::string DialDataPool::getSummary(){
+  purge();
+
+  std::stringstream ss;
+  ss << "Dial data pool: " << _nbRequests_ << " dial data interned into " << _nbUniqueEntries_ << " unique entries";
+  if( _nbStoredValues_ != 0 ){
+    ss << " (deduplication ratio: " << double(_nbRequestedValues_) / double(_nbStoredValues_) << ", ";
+    ss << GenericToolbox::parseSizeUnits(double(_nbStoredValues_ * sizeof(double))) << " stored instead of ";
+    ss << GenericToolbox::parseSizeUnits(double(_nbRequestedValues_ * sizeof(double))) << ")";
+  }
+  return ss.str();
+}
+
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
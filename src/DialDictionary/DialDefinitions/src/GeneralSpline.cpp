@@ -21,6 +21,22 @@ bool GeneralSpline::getAllowExtrapolation() const {
   return _allowExtrapolation_;
 }
 
+bool GeneralSpline::getSnapshotData(std::vector<double>& data_) const {
+  data_.clear();
+  data_.reserve(_splineData_.size() + 2);
+  data_.emplace_back(_splineBounds_.first);
+  data_.emplace_back(_splineBounds_.second);
+  data_.insert(data_.end(), _splineData_.begin(), _splineData_.end());
+  return true;
+}
+
+void GeneralSpline::setSnapshotData(const std::vector<double>& data_) {
+  LogThrowIf(data_.size() < 2, "Invalid snapshot data for " << this->getDialTypeName());
+  _splineBounds_.first = data_[0];
+  _splineBounds_.second = data_[1];
+  _splineData_.set(std::vector<double>(data_.begin() + 2, data_.end()));
+}
+
 void GeneralSpline::buildDial(const TGraph& graph_, const std::string& option_){
   // Copy the spline data into local storage.
   TGraph grf(graph_);
@@ -52,23 +68,26 @@ void GeneralSpline::buildDial(const std::vector<double>& xPoints,
                               const std::string& option_){
   LogThrowIf(not _splineData_.empty(), "Spline data already set.");
 
+  std::vector<double> splineData;
+
   _splineBounds_.first = xPoints.front();
   _splineBounds_.second = xPoints.back();
 
-  _splineData_.resize(2 + xPoints.size()*3);
-  _splineData_[0] = xPoints.front();
-  _splineData_[1] = (xPoints.back()-xPoints.front())/(xPoints.size()-1.0);
+  splineData.resize(2 + xPoints.size()*3);
+  splineData[0] = xPoints.front();
+  splineData[1] = (xPoints.back()-xPoints.front())/(xPoints.size()-1.0);
 
   // Copy the spline data into local storage.
   for (int i = 0; i < xPoints.size(); ++i) {
     double x = xPoints[i];
     double y = yPoints[i];
     double d = deriv[i];
-    _splineData_[2 + 3*i + 0] = y;
-    _splineData_[2 + 3*i + 1] = d;
-    _splineData_[2 + 3*i + 2] = x;
+    splineData[2 + 3*i + 0] = y;
+    splineData[2 + 3*i + 1] = d;
+    splineData[2 + 3*i + 2] = x;
   }
 
+  _splineData_.set(std::move(splineData));
 }
 
 double GeneralSpline::evalResponse(const DialInputBuffer& input_) const {
@@ -81,3 +100,14 @@ double GeneralSpline::evalResponse(const DialInputBuffer& input_) const {
 
   return CalculateGeneralSpline( dialInput, -1E20, 1E20, _splineData_.data(), int(_splineData_.size()) );
 }
+
+double GeneralSpline::evalDerivative(const DialInputBuffer& input_, int iInput_) const {
+  double dialInput{input_.getInputBuffer()[0]};
+
+  if( not _allowExtrapolation_ ){
+    // the response is flat outside the spline bounds
+    if( dialInput < _splineBounds_.first or dialInput > _splineBounds_.second ){ return 0; }
+  }
+
+  return CalculateGeneralSplineDerivative( dialInput, _splineData_.data(), int(_splineData_.size()) );
+}
@@ -4,6 +4,8 @@
 
 #include "Graph.h"
 
+#include "TMath.h"
+
 LoggerInit([]{
   Logger::setUserHeaderStr("[Graph]");
 });
@@ -36,3 +38,20 @@ double Graph::evalResponse(const DialInputBuffer& input_) const {
   }
   return _graph_.Eval(dialInput);
 }
+
+double Graph::evalDerivative(const DialInputBuffer& input_, int iInput_) const {
+  double dialInput{input_.getInputBuffer()[0]};
+  int nPoints{_graph_.GetN()};
+  if( nPoints < 2 ){ return 0; }
+
+  if( not _allowExtrapolation_ ){
+    // the response is flat outside the graph
+    if( dialInput < _graph_.GetX()[0] or dialInput > _graph_.GetX()[nPoints-1] ){ return 0; }
+  }
+
+  // TGraph::Eval interpolates (or extrapolates) linearly between the two closest points
+  int iLow{int(TMath::BinarySearch(nPoints, _graph_.GetX(), dialInput))};
+  if( iLow < 0 ){ iLow = 0; }
+  if( iLow > nPoints - 2 ){ iLow = nPoints - 2; }
+  return (_graph_.GetY()[iLow+1] - _graph_.GetY()[iLow]) / (_graph_.GetX()[iLow+1] - _graph_.GetX()[iLow]);
+}
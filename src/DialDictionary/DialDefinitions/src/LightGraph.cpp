@@ -18,6 +18,15 @@ bool LightGraph::getAllowExtrapolation() const {
   return _allowExtrapolation_;
 }
 
+bool LightGraph::getSnapshotData(std::vector<double>& data_) const {
+  data_ = _Data_.get();
+  return true;
+}
+
+void LightGraph::setSnapshotData(const std::vector<double>& data_) {
+  _Data_.set(std::vector<double>(data_));
+}
+
 void LightGraph::buildDial(const TGraph &grf, const std::string& option_) {
   LogThrowIf(grf.GetN() == 0, "Invalid input graph");
   TGraph graph(grf);
@@ -26,12 +35,13 @@ void LightGraph::buildDial(const TGraph &grf, const std::string& option_) {
   int nPoints = graph.GetN();
   LogThrowIf(nPoints>15, "Light graphs must have fewer than 15 points");
 
-  _Data_.reserve(2*nPoints);
-  _Data_.clear();
+  std::vector<double> data;
+  data.reserve(2*nPoints);
   for (int i=0; i< nPoints; ++i) {
-      _Data_.push_back(graph.GetY()[i]);
-      _Data_.push_back(graph.GetX()[i]);
+      data.push_back(graph.GetY()[i]);
+      data.push_back(graph.GetX()[i]);
   }
+  _Data_.set(std::move(data));
 }
 
 double LightGraph::evalResponse(const DialInputBuffer& input_) const {
@@ -48,3 +58,14 @@ double LightGraph::evalResponse(const DialInputBuffer& input_) const {
 
   return CalculateGraph(dialInput,-1E20,1E20,_Data_.data(),_Data_.size());
 }
+
+double LightGraph::evalDerivative(const DialInputBuffer& input_, int iInput_) const {
+  double dialInput{input_.getInputBuffer()[0]};
+
+  if( not _allowExtrapolation_ ){
+    // the response is flat outside the graph
+    if( dialInput < _Data_[1] or dialInput > _Data_.back() ){ return 0; }
+  }
+
+  return CalculateGraphDerivative(dialInput,_Data_.data(),_Data_.size());
+}
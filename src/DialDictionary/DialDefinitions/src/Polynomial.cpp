@@ -20,3 +20,19 @@ double Polynomial::evalResponse(const DialInputBuffer& input_) const {
   }
   return result;
 }
+
+double Polynomial::evalDerivative(const DialInputBuffer& input_, int iInput_) const {
+  double result{0};
+  double factor{1};
+  double dialInput{input_.getInputBuffer()[0]};
+
+  if( not _allowExtrapolation_ ){
+    if( dialInput < _splineBounds_.first or dialInput > _splineBounds_.second ){ return 0; }
+  }
+
+  for( size_t iCoef = 1 ; iCoef < _coefficientList_.size() ; iCoef++ ){
+    result += double(iCoef) * _coefficientList_[iCoef] * factor; // y' += n * a_n * x^{n-1}
+    factor *= dialInput;
+  }
+  return result;
+}
@@ -23,9 +23,28 @@ bool SimpleSpline::getAllowExtrapolation() const {
   return _allowExtrapolation_;
 }
 
+bool SimpleSpline::getSnapshotData(std::vector<double>& data_) const {
+  data_.clear();
+  data_.reserve(_splineData_.size() + 3);
+  data_.emplace_back(_isUniform_ ? 1 : 0);
+  data_.emplace_back(_splineBounds_.first);
+  data_.emplace_back(_splineBounds_.second);
+  data_.insert(data_.end(), _splineData_.begin(), _splineData_.end());
+  return true;
+}
+
+void SimpleSpline::setSnapshotData(const std::vector<double>& data_) {
+  LogThrowIf(data_.size() < 3, "Invalid snapshot data for " << this->getDialTypeName());
+  _isUniform_ = (data_[0] != 0);
+  _splineBounds_.first = data_[1];
+  _splineBounds_.second = data_[2];
+  _splineData_.set(std::vector<double>(data_.begin() + 3, data_.end()));
+}
+
 void SimpleSpline::buildDial(const TGraph& grf, const std::string& option_){
   LogThrowIf(not _splineData_.empty(), "Spline data already set.");
   TGraph graph_ = grf;
+  std::vector<double> splineData;
 
   // Copy the spline data into local storage.
   graph_.Sort();
@@ -42,17 +61,17 @@ void SimpleSpline::buildDial(const TGraph& grf, const std::string& option_){
     _splineBounds_.first = sp.GetXmin();
     _splineBounds_.second = sp.GetXmax();
 
-    _splineData_.resize(2 + sp.GetNp() * 2);
-    _splineData_[0] = sp.GetXmin();
-    _splineData_[1] = ((sp.GetXmax() - sp.GetXmin() ) / (sp.GetNp() - 1.0 ) );
+    splineData.resize(2 + sp.GetNp() * 2);
+    splineData[0] = sp.GetXmin();
+    splineData[1] = ((sp.GetXmax() - sp.GetXmin() ) / (sp.GetNp() - 1.0 ) );
 
     // Copy the spline data into local storage.
     for (int i = 0; i < sp.GetNp(); ++i) {
       double x;
       double y;
       sp.GetKnot(i, x, y);
-      _splineData_[2 + 2*i + 0] = y;
-      _splineData_[2 + 2*i + 1] = sp.Derivative(x);
+      splineData[2 + 2*i + 0] = y;
+      splineData[2 + 2*i + 1] = sp.Derivative(x);
     }
 #else
     // If FAKE_UNIFORM_SPLINE is defined, then use a compact spline
@@ -60,11 +79,11 @@ void SimpleSpline::buildDial(const TGraph& grf, const std::string& option_){
     _splineBounds_.first = graph_.GetX()[0];
     _splineBounds_.second = graph_.GetX()[graph_.GetN()-1];
 
-    _splineData_.resize(2 + graph_.GetN());
-    _splineData_[0] = graph_.GetX()[0];
-    _splineData_[1] = (graph_.GetX()[graph_.GetN()-1] - graph_.GetX()[0])/(graph_.GetN()-1.0);
+    splineData.resize(2 + graph_.GetN());
+    splineData[0] = graph_.GetX()[0];
+    splineData[1] = (graph_.GetX()[graph_.GetN()-1] - graph_.GetX()[0])/(graph_.GetN()-1.0);
 
-    memcpy(&_splineData_[2], graph_.GetY(), graph_.GetN() * sizeof(double));
+    memcpy(&splineData[2], graph_.GetY(), graph_.GetN() * sizeof(double));
 #endif
   }
   else{
@@ -72,21 +91,22 @@ void SimpleSpline::buildDial(const TGraph& grf, const std::string& option_){
     _splineBounds_.first = sp.GetXmin();
     _splineBounds_.second = sp.GetXmax();
 
-    _splineData_.resize(2 + sp.GetNp() * 3);
-    _splineData_[0] = sp.GetXmin();
-    _splineData_[1] = ((sp.GetXmax() - sp.GetXmin() ) / (sp.GetNp() - 1.0 ) );
+    splineData.resize(2 + sp.GetNp() * 3);
+    splineData[0] = sp.GetXmin();
+    splineData[1] = ((sp.GetXmax() - sp.GetXmin() ) / (sp.GetNp() - 1.0 ) );
 
     // Copy the spline data into local storage.
     for (int i = 0; i < sp.GetNp(); ++i) {
       double x;
       double y;
       sp.GetKnot(i, x, y);
-      _splineData_[2 + 3*i + 0] = y;
-      _splineData_[2 + 3*i + 1] = sp.Derivative(x);
-      _splineData_[2 + 3*i + 2] = x;
+      splineData[2 + 3*i + 0] = y;
+      splineData[2 + 3*i + 1] = sp.Derivative(x);
+      splineData[2 + 3*i + 2] = x;
     }
   }
 
+  _splineData_.set(std::move(splineData));
 }
 
 void SimpleSpline::buildDial(const TSpline3& sp_, const std::string& option_) {
@@ -127,3 +147,26 @@ double SimpleSpline::evalResponse(const DialInputBuffer& input_) const {
   }
   return CalculateGeneralSpline( dialInput, -1E20, 1E20, _splineData_.data(), int(_splineData_.size()) );
 }
+
+double SimpleSpline::evalDerivative(const DialInputBuffer& input_, int iInput_) const {
+  double dialInput{input_.getInputBuffer()[0]};
+
+  if( not _allowExtrapolation_ ){
+    // the response is flat outside the spline bounds
+    if( dialInput < _splineBounds_.first or dialInput > _splineBounds_.second ){ return 0; }
+  }
+
+  // same calculation as evalResponse
+  if( _isUniform_ ){
+#ifndef FAKE_UNIFORM_SPLINE
+    return CalculateUniformSplineDerivative( dialInput, _splineData_.data(), int(_splineData_.size()) );
+#else
+#ifndef FAKE_UNIFORM_SPLINE_WITH_COMPACT_SPLINE
+    return CalculateMonotonicSplineDerivative( dialInput, _splineData_.data(), int(_splineData_.size()) );
+#else
+    return CalculateCompactSplineDerivative( dialInput, _splineData_.data(), int(_splineData_.size()) );
+#endif
+#endif
+  }
+  return CalculateGeneralSplineDerivative( dialInput, _splineData_.data(), int(_splineData_.size()) );
+}
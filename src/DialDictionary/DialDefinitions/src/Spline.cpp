@@ -70,6 +70,16 @@ double Spline::evalResponse(const DialInputBuffer& input_) const {
   return _spline_.Eval( dialInput );
 }
 
+double Spline::evalDerivative(const DialInputBuffer& input_, int iInput_) const {
+  const double dialInput{input_.getInputBuffer()[0]};
+
+  if( not _allowExtrapolation_ ){
+    // the response is flat outside the spline bounds
+    if( dialInput < _spline_.GetXmin() or dialInput > _spline_.GetXmax() ){ return 0; }
+  }
+  return _spline_.Derivative( dialInput );
+}
+
 //  A Lesser GNU Public License
 
 //  Copyright (C) 2023 GUNDAM DEVELOPERS
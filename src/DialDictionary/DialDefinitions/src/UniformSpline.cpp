@@ -22,6 +22,22 @@ bool UniformSpline::getAllowExtrapolation() const {
   return _allowExtrapolation_;
 }
 
+bool UniformSpline::getSnapshotData(std::vector<double>& data_) const {
+  data_.clear();
+  data_.reserve(_splineData_.size() + 2);
+  data_.emplace_back(_splineBounds_.first);
+  data_.emplace_back(_splineBounds_.second);
+  data_.insert(data_.end(), _splineData_.begin(), _splineData_.end());
+  return true;
+}
+
+void UniformSpline::setSnapshotData(const std::vector<double>& data_) {
+  LogThrowIf(data_.size() < 2, "Invalid snapshot data for " << this->getDialTypeName());
+  _splineBounds_.first = data_[0];
+  _splineBounds_.second = data_[1];
+  _splineData_.set(std::vector<double>(data_.begin() + 2, data_.end()));
+}
+
 void UniformSpline::buildDial(const TGraph& graph_, const std::string& option_){
   // Copy the spline data into local storage.
   TGraph grf(graph_);
@@ -53,12 +69,14 @@ void UniformSpline::buildDial(const std::vector<double>& xPoints,
                               const std::string& option_){
   LogThrowIf(not _splineData_.empty(), "Spline data already set.");
 
+  std::vector<double> splineData;
+
   _splineBounds_.first = xPoints.front();
   _splineBounds_.second = xPoints.back();
 
-  _splineData_.resize(2 + xPoints.size()*2);
-  _splineData_[0] = xPoints.front();
-  _splineData_[1] = (xPoints.back()-xPoints.front())/(xPoints.size()-1.0);
+  splineData.resize(2 + xPoints.size()*2);
+  splineData[0] = xPoints.front();
+  splineData[1] = (xPoints.back()-xPoints.front())/(xPoints.size()-1.0);
 
   /// Apply a very loose check that the point spacing is uniform to catch
   /// mistakes.  This only flags clear problems and isn't an accuracy
@@ -66,8 +84,8 @@ void UniformSpline::buildDial(const std::vector<double>& xPoints,
   /// knots may have been saved or calculated using floats.
   const double tolerance{std::sqrt(std::numeric_limits<float>::epsilon())};
   for (int i=0; i<xPoints.size()-1; ++i) {
-      double d = std::abs(xPoints[i] - _splineData_[0] - i*_splineData_[1]);
-      LogThrowIf((d/_splineData_[1])>tolerance,
+      double d = std::abs(xPoints[i] - splineData[0] - i*splineData[1]);
+      LogThrowIf((d/splineData[1])>tolerance,
                  "UniformSplines require uniformly spaced knots");
   }
 
@@ -76,10 +94,11 @@ void UniformSpline::buildDial(const std::vector<double>& xPoints,
     double x = xPoints[i];
     double y = yPoints[i];
     double d = deriv[i];
-    _splineData_[2 + 2*i + 0] = y;
-    _splineData_[2 + 2*i + 1] = d;
+    splineData[2 + 2*i + 0] = y;
+    splineData[2 + 2*i + 1] = d;
   }
 
+  _splineData_.set(std::move(splineData));
 }
 
 double UniformSpline::evalResponse(const DialInputBuffer& input_) const {
@@ -96,3 +115,14 @@ double UniformSpline::evalResponse(const DialInputBuffer& input_) const {
 
   return CalculateUniformSpline( dialInput, -1E20, 1E20, _splineData_.data(), int(_splineData_.size()) );
 }
+
+double UniformSpline::evalDerivative(const DialInputBuffer& input_, int iInput_) const {
+  double dialInput{input_.getInputBuffer()[0]};
+
+  if( not _allowExtrapolation_ ){
+    // the response is flat outside the spline bounds
+    if( dialInput < _splineBounds_.first or dialInput > _splineBounds_.second ){ return 0; }
+  }
+
+  return CalculateUniformSplineDerivative( dialInput, _splineData_.data(), int(_splineData_.size()) );
+}
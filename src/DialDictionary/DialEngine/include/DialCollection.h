@@ -10,6 +10,7 @@
 #include "DialInputBuffer.h"
 #include "DialResponseSupervisor.h"
 #include "SampleSet.h"
+#include "CompiledFormula.h"
 
 #include "GenericToolbox.Wrappers.h"
 
@@ -45,12 +46,15 @@ public:
   [[nodiscard]] bool isEnabled() const{ return _isEnabled_; }
   [[nodiscard]] bool isAllowDialExtrapolation() const{ return _allowDialExtrapolation_; }
   [[nodiscard]] int getIndex() const{ return _index_; }
+  [[nodiscard]] size_t getDialFreeSlot() const{ return _dialFreeSlot_.getValue(); }
   [[nodiscard]] const std::string &getGlobalDialType() const{return _globalDialType_; }
   [[nodiscard]] const std::string &getGlobalDialSubType() const{ return _globalDialSubType_; }
   [[nodiscard]] const std::string &getGlobalDialLeafName() const{ return _globalDialLeafName_; }
   [[nodiscard]] const DataBinSet &getDialBinSet() const{ return _dialBinSet_; }
   [[nodiscard]] const std::vector<std::string> &getDataSetNameList() const{ return _dataSetNameList_; }
   [[nodiscard]] const std::shared_ptr<TFormula> &getApplyConditionFormula() const{ return _applyConditionFormula_; }
+  /// Same condition as the TFormula, not compiled if the syntax is not handled
+  [[nodiscard]] const CompiledFormula &getApplyConditionCompiledFormula() const{ return _applyConditionCompiledFormula_; }
 
   // non-const getters
   DataBinSet &getDialBinSet(){ return _dialBinSet_; }
@@ -111,6 +115,7 @@ private:
   std::vector<DialResponseSupervisor> _dialResponseSupervisorList_{};
   std::vector<DialBaseObject> _dialBaseList_{};
   std::shared_ptr<TFormula> _applyConditionFormula_{nullptr};
+  CompiledFormula _applyConditionCompiledFormula_{};
   GenericToolbox::Atomic<size_t> _dialFreeSlot_{0};
 
   // external refs
@@ -88,6 +88,14 @@ public:
   [[nodiscard]] const Parameter& getParameter(int iInput_) const { return _inputParameterReferenceList_[iInput_].getParameter(_parSetListPtr_); }
   [[nodiscard]] const ParameterReference::MirrorEdges& getMirrorEdges(int iInput_) const{ return _inputParameterReferenceList_[iInput_].mirrorEdges; }
 
+  /// Derivative of the buffered input with respect to the value of the
+  /// iInput_-th parameter: -1 on the mirrored periods, 1 otherwise.
+  [[nodiscard]] double getInputSlope(int iInput_) const;
+
+  /// Change one of the buffered values. Only meant to probe the dial
+  /// response around the current point on a copy of the buffer.
+  void setInputValue(int iBuffer_, double value_);
+
   /// Push the index of a ParameterSet and Parameter in the set onto the
   /// vector of parameters.  This must be used in the order that the dial will
   /// be expecting the parameters (e.g. for a 2D parameter,
@@ -48,6 +48,12 @@ public:
   [[nodiscard]] inline const DataBin* getDialBinRef() const {return _dialBinRef_;}
 
   [[nodiscard]] double evalResponse() const;
+
+  /// Derivative of the response with respect to the iInput_-th value of the
+  /// input buffer, given the response returned by evalResponse(). It is null
+  /// when the buffer is masked or when the response is capped by the
+  /// supervisor.
+  [[nodiscard]] double evalDerivative(double response_, int iInput_=0) const;
   [[nodiscard]] std::string getSummary(bool shallow_=true) const;
 
 private:
@@ -25,6 +25,9 @@ public:
   [[nodiscard]] double getMaxResponse() const{ return _maxResponse_; }
 
   [[nodiscard]] double process(double reponse_) const;
+  /// Is the processed response sitting on one of the caps? If so, the
+  /// response doesn't depend on the dial inputs.
+  [[nodiscard]] bool isCapped(double processedResponse_) const;
   [[nodiscard]] std::string getSummary() const;
 
 
@@ -60,11 +60,15 @@ public:
   /// DialInterface.
   struct CacheEntry {
     Event* event;
+    // the weights are reweighted in the sample WeightStore: contiguous memory
+    EventUtils::WeightStore* weightStorePtr{nullptr};
+    int weightIndex{-1};
     std::vector<DialResponseCache> dialResponseCacheList{};
 
     [[nodiscard]] std::string getSummary() const {
       std::stringstream ss;
       ss << *event << std::endl;
+      ss << "Weights{" << weightStorePtr->getSummary(weightIndex) << "}" << std::endl;
       ss << "Dials{";
       for( auto& dialResponseCache : dialResponseCacheList ){
         ss << std::endl << "  { " << dialResponseCache.dialInterface.getSummary() << " }";
@@ -74,6 +78,14 @@ public:
     }
   };
 
+  /// Derivative of an event weight with respect to one of the parameters
+  /// (referenced as in the DialInputBuffer)
+  struct WeightDerivative{
+    int parSetIndex{-1};
+    int parIndex{-1};
+    double value{0};
+  };
+
   /// A pair of indices into the vector of dial collections, and then the
   /// index of the dial interfaces in the dial collection vector of dial
   /// interfaces.
@@ -141,6 +153,7 @@ public:
 
   // returns the current index
   [[nodiscard]] size_t getFillIndex() const { return _fillIndex_; }
+  [[nodiscard]] const std::vector<IndexedCacheEntry>& getIndexedCache() const { return _indexedCache_; }
 
   /// Provide the event dial cache.  The event dial cache containes a
   /// CacheElem_t object for every dial applied to a physics event.  The
@@ -165,6 +178,16 @@ public:
   /// of the pointer is not passed to the caller.
   IndexedCacheEntry* fetchNextCacheEntry();
 
+  /// Prepare one indexed cache chunk per thread. Each thread appends its
+  /// entries to its own chunk without lock, in any order: the chunks are
+  /// stitched to the indexed cache by mergeThreadIndexedCaches().
+  void allocateThreadIndexedCaches(int nThreads_);
+  std::vector<IndexedCacheEntry>& getThreadIndexedCache(int iThread_){ return _threadIndexedCacheList_[iThread_]; }
+
+  /// Append the entries of the thread chunks to the indexed cache. Called by
+  /// buildReferenceCache(), or before reading the indexed cache.
+  void mergeThreadIndexedCaches();
+
   /// Build the association between pointers to PhysicsEvent objects and the
   /// pointers to DialInterface objects.  This must be done before the event
   /// dial cache can be used, but after the index cache has been filled.
@@ -176,6 +199,13 @@ public:
 
   void reweightEntry( CacheEntry& entry_);
 
+  /// Evaluate the weight of an entry together with its derivatives with
+  /// respect to the parameters of its dials. The responses are evaluated from
+  /// the DialInterface as the cached ones are not filled when the weights are
+  /// computed by the GroupedDialEngine or the Cache::Manager. Returns the
+  /// event weight. Can be called from several threads.
+  double evalEntryWeightGradient( const CacheEntry& entry_, std::vector<WeightDerivative>& derivativeList_ ) const;
+
 
 private:
   // The next available entry in the indexed cache.
@@ -188,6 +218,10 @@ private:
   // and dials.
   std::vector<IndexedCacheEntry> _indexedCache_{};
 
+  // Entries filled concurrently by the loading threads, not yet merged in the
+  // indexed cache
+  std::vector<std::vector<IndexedCacheEntry>> _threadIndexedCacheList_{};
+
   /// A cache of all of the valid PhysicsEvent* and DialInterface*
   /// associations for efficient use when reweighting the MC events.
   std::vector<CacheEntry> _cache_{};
@@ -0,0 +1,238 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#ifndef GUNDAM_GROUPED_DIAL_ENGINE_H
+#define GUNDAM_GROUPED_DIAL_ENGINE_H
+
+#include "EventDialCache.h"
+#include "DialInterface.h"
+#include "DialInputBuffer.h"
+#include "EventUtils.h"
+
+#include <vector>
+#include <string>
+#include <limits>
+
+
+/// GroupedDialEngine is the CPU analogue of the Cache::Manager. Once the
+/// EventDialCache has been built, every dial instance is sorted by its
+/// concrete type into flat arrays (one DialGroup per type), so the responses
+/// can be evaluated in tight, non-virtual loops. Event weights are then
+/// obtained by multiplying the responses through an index table.
+///
+/// Dial types that are not explicitly handled are kept in the "Generic"
+/// group and evaluated through the DialInterface as before.
+///
+/// In single precision mode, the dial data is stored as float and the event
+/// reweight products are evaluated in float. The dial calculations and the
+/// histogram sums are still done in double.
+class GroupedDialEngine{
+
+public:
+  enum class DialType{
+    Norm = 0,
+    Shift,
+    CompactSpline,
+    MonotonicSpline,
+    UniformSpline,
+    GeneralSpline,
+    LightGraph,
+    Generic,
+    // keep last
+    NbDialTypes
+  };
+  static std::string toString(DialType type_);
+
+  /// All the information needed to evaluate one dial without touching the DialBase
+  struct DialEntry{
+    int responseIndex{-1}; // slot in the response list
+    int inputIndex{-1}; // slot in the input buffer list
+    size_t dataOffset{0}; // where the dial data starts in the group data
+    int dataSize{0};
+
+    // input clamping when extrapolation is not allowed
+    double lowerBound{-std::numeric_limits<double>::infinity()};
+    double upperBound{std::numeric_limits<double>::infinity()};
+
+    // DialResponseSupervisor caps
+    double minResponse{-std::numeric_limits<double>::infinity()};
+    double maxResponse{std::numeric_limits<double>::infinity()};
+  };
+
+  struct DialGroup{
+    DialType type{DialType::Generic};
+    std::vector<DialEntry> dialList{};
+    std::vector<double> dataList{}; // contiguous dial data of the whole group
+    std::vector<float> floatDataList{}; // replaces dataList in single precision mode
+
+    // only used by the generic group
+    std::vector<const DialInterface*> dialInterfaceList{};
+  };
+
+  /// Where an evaluation reads its inputs and writes its responses
+  struct EvalBuffers{
+    const double* inputValueList{nullptr};
+    const char* inputIsMaskedList{nullptr};
+    const char* inputIsUpdatedList{nullptr};
+    double* responseList{nullptr};
+  };
+
+public:
+  GroupedDialEngine() = default;
+
+  // const getters
+  [[nodiscard]] bool isBuilt() const{ return _isBuilt_; }
+  [[nodiscard]] bool isUseSinglePrecision() const{ return _useSinglePrecision_; }
+  [[nodiscard]] size_t getNbDials() const{ return _responseList_.size(); }
+  [[nodiscard]] size_t getNbEvents() const{ return _eventWeightIndexList_.size(); }
+  [[nodiscard]] const std::vector<DialGroup>& getDialGroupList() const{ return _dialGroupList_; }
+  [[nodiscard]] const std::vector<double>& getResponseList() const{ return _responseList_; }
+  [[nodiscard]] bool isIncrementalUpdate() const{ return _isIncrementalUpdate_; }
+  [[nodiscard]] const std::vector<int>& getUpdatedEventList() const{ return _updatedEventList_; }
+  [[nodiscard]] const std::vector<EventUtils::WeightStore*>& getEventWeightStoreList() const{ return _eventWeightStoreList_; }
+  [[nodiscard]] const std::vector<int>& getEventWeightIndexList() const{ return _eventWeightIndexList_; }
+  [[nodiscard]] const std::vector<size_t>& getEventResponseOffsetList() const{ return _eventResponseOffsetList_; }
+  [[nodiscard]] const std::vector<int>& getEventResponseIndexList() const{ return _eventResponseIndexList_; }
+  [[nodiscard]] const EventDialCache::GlobalEventReweightCap& getGlobalEventReweightCap() const{ return _globalEventReweightCap_; }
+  [[nodiscard]] size_t getNbInputs() const{ return _inputBufferList_.size(); }
+
+  /// Dials of the generic group are evaluated through their DialInterface,
+  /// hence from the shared DialInputBuffer.
+  [[nodiscard]] bool hasGenericDials() const{ return _isBuilt_ and not _dialGroupList_[size_t(DialType::Generic)].dialList.empty(); }
+
+  // setters
+  void setEnableIncrementalUpdate(bool enable_){ _enableIncrementalUpdate_ = enable_; }
+
+  /// Store the dial data and evaluate the event reweights in float. Only
+  /// taken into account by build().
+  void setUseSinglePrecision(bool useSinglePrecision_){ _useSinglePrecision_ = useSinglePrecision_; }
+
+  /// The next update will re-evaluate every dial and event. Needed when the
+  /// event weights have been modified outside the engine.
+  void requestFullUpdate(){ _requireFullUpdate_ = true; }
+
+  /// Flatten the dials of the EventDialCache. Must be called once the
+  /// reference cache has been built, and again whenever it is rebuilt.
+  void build(EventDialCache& eventDialCache_);
+  void clear();
+
+  /// Copy the current values of the DialInputBuffer. Should be called in a
+  /// single thread once the input buffers have been updated. When only a few
+  /// inputs changed, the events depending on them are listed through the
+  /// input -> event index and the update is flagged as incremental.
+  void updateInputs();
+
+  /// Evaluate the dials of every group whose input changed. The dials of
+  /// each group are split among the threads.
+  void evalDialResponses(int iThread_ = -1);
+
+  /// Multiply the responses of each event into its WeightStore slot. On an
+  /// incremental update only the listed events are recomputed: the responses
+  /// of their unchanged dials are still cached in the response list.
+  void applyEventWeights(int iThread_ = -1);
+
+  /// Copy the current values of the DialInputBuffer in external lists, the
+  /// state of the engine is left untouched.
+  void fetchInputs(std::vector<double>& inputValueList_, std::vector<char>& inputIsMaskedList_) const;
+
+  /// Evaluate every dial for the given inputs into an external response
+  /// list. As nothing is written in the engine, several evaluations can run
+  /// concurrently. Not available if the engine has generic dials.
+  void evalDialResponses(const std::vector<double>& inputValueList_, const std::vector<char>& inputIsMaskedList_, std::vector<double>& responseList_) const;
+
+  /// Product of the responses of the iEvent_-th event, with the global
+  /// reweight cap applied. Evaluated in float in single precision mode.
+  [[nodiscard]] double evalEventReweight(const double* responseList_, int iEvent_) const{
+    if( _useSinglePrecision_ ){ return this->evalEventReweight<float>(responseList_, iEvent_); }
+    return this->evalEventReweight<double>(responseList_, iEvent_);
+  }
+
+  [[nodiscard]] std::string getSummary() const;
+
+protected:
+  template<typename T> [[nodiscard]] double evalEventReweight(const double* responseList_, int iEvent_) const{
+    T reweight{1};
+    for( size_t iResponse = _eventResponseOffsetList_[iEvent_] ; iResponse < _eventResponseOffsetList_[iEvent_+1] ; iResponse++ ){
+      reweight *= T(responseList_[_eventResponseIndexList_[iResponse]]);
+    }
+    double out{reweight};
+    _globalEventReweightCap_.process( out );
+    return out;
+  }
+
+  /// Spline types evaluated with the batched (vectorized) calculations
+  static bool isBatched(DialType type_);
+  void evalDialGroup(const DialGroup& group_, size_t beginIndex_, size_t endIndex_, const EvalBuffers& buffers_) const;
+  template<typename FloatType> void evalDialGroup(const DialGroup& group_, const FloatType* data_, size_t beginIndex_, size_t endIndex_, const EvalBuffers& buffers_) const;
+
+private:
+  bool _isBuilt_{false};
+  bool _requireFullUpdate_{true}; // all the responses are evaluated at the first call
+  bool _enableIncrementalUpdate_{true};
+  bool _useSinglePrecision_{false};
+  bool _isIncrementalUpdate_{false};
+
+  // above this fraction of affected events, the full update is cheaper
+  double _incrementalUpdateMaxFraction_{0.3};
+
+  // one group per dial type
+  std::vector<DialGroup> _dialGroupList_{};
+
+  // inputs: snapshot of the DialInputBuffer states taken in updateInputs()
+  std::vector<const DialInputBuffer*> _inputBufferList_{};
+  std::vector<double> _inputValueList_{};
+  std::vector<char> _inputIsMaskedList_{};
+  std::vector<char> _inputIsUpdatedList_{};
+  std::vector<char> _allInputsUpdatedList_{}; // used by the external evaluations
+
+  // one response per dial instance
+  std::vector<double> _responseList_{};
+
+  // index table: event -> responses [offset[i], offset[i+1])
+  std::vector<size_t> _eventResponseOffsetList_{};
+  std::vector<int> _eventResponseIndexList_{};
+  std::vector<EventUtils::WeightStore*> _eventWeightStoreList_{};
+  std::vector<int> _eventWeightIndexList_{};
+
+  // inverted index table: input -> events [offset[i], offset[i+1])
+  std::vector<size_t> _inputEventOffsetList_{};
+  std::vector<int> _inputEventIndexList_{};
+
+  // events to recompute during an incremental update (sorted)
+  std::vector<int> _updatedEventList_{};
+  std::vector<char> _eventIsUpdatedList_{};
+
+  EventDialCache::GlobalEventReweightCap _globalEventReweightCap_{};
+
+};
+
+
+#endif //GUNDAM_GROUPED_DIAL_ENGINE_H
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
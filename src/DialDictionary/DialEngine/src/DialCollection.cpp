@@ -373,6 +373,16 @@ void DialCollection::readGlobals(const JsonType &config_) {
     _applyConditionFormula_ = std::make_shared<TFormula>("_applyConditionFormula_", _applyConditionStr_.c_str());
     LogThrowIf(not _applyConditionFormula_->IsValid(),
                "\"" << _applyConditionStr_ << "\": could not be parsed as formula expression.")
+
+    // the compiled condition is only used if it reads the same variables
+    if( _applyConditionCompiledFormula_.compile(_applyConditionStr_) ){
+      auto& varNameList = _applyConditionCompiledFormula_.getVariableNameList();
+      bool isSameVarList{int(varNameList.size()) == _applyConditionFormula_->GetNpar()};
+      for( auto& varName : varNameList ){
+        if( _applyConditionFormula_->GetParNumber(varName.c_str()) == -1 ){ isSameVarList = false; }
+      }
+      if( not isSameVarList ){ _applyConditionCompiledFormula_ = CompiledFormula(); }
+    }
   }
 
   _minDialResponse_ = GenericToolbox::Json::fetchValue(config_, {{"minDialResponse"}, {"minimumSplineResponse"}}, _minDialResponse_);
@@ -511,6 +521,7 @@ bool DialCollection::initializeDialsWithDefinition() {
               _dialBinSet_.getBinList().erase(_dialBinSet_.getBinList().begin() + iBin);
             }
           }
+          _dialBinSet_.buildSearchIndex();
         }
 
         dialsTFile->Close();
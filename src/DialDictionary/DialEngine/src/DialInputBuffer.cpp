@@ -47,6 +47,22 @@ void DialInputBuffer::initialise(){
   _isInitialized_ = true;
 }
 
+double DialInputBuffer::getInputSlope(int iInput_) const{
+  auto& inputRef = _inputParameterReferenceList_[iInput_];
+  if( std::isnan( inputRef.mirrorEdges.minValue ) ){ return 1; }
+
+  // same folding as update()
+  double delta{inputRef.getParameter(_parSetListPtr_).getParameterValue() - inputRef.mirrorEdges.minValue};
+  double slope{delta < 0 ? -1. : 1.}; // std::abs of the remainder
+  if( std::abs(std::fmod( delta, 2 * inputRef.mirrorEdges.range )) > inputRef.mirrorEdges.range ){ slope = -slope; }
+  return slope;
+}
+void DialInputBuffer::setInputValue(int iBuffer_, double value_){
+  _inputBuffer_[iBuffer_] = value_;
+#if USE_ZLIB
+  _currentHash_ = generateHash();
+#endif
+}
 void DialInputBuffer::update(){
   // by default consider we have to update
   _isDialUpdateRequested_ = true;
@@ -15,6 +15,11 @@ LoggerInit([]{
 double DialInterface::evalResponse() const {
   return DialInterface::evalResponse(_inputBufferRef_, _dialBaseRef_, _responseSupervisorRef_);
 }
+double DialInterface::evalDerivative(double response_, int iInput_) const {
+  if( _inputBufferRef_->isMasked() ){ return 0; }
+  if( _responseSupervisorRef_->isCapped(response_) ){ return 0; }
+  return _dialBaseRef_->evalDerivative(*_inputBufferRef_, iInput_);
+}
 std::string DialInterface::getSummary(bool shallow_) const {
   std::stringstream ss;
   ss << _dialBaseRef_->getDialTypeName() << ":";
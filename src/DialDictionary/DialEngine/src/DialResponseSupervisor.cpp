@@ -16,6 +16,9 @@ double DialResponseSupervisor::process(double reponse_) const {
 
   return reponse_;
 }
+bool DialResponseSupervisor::isCapped(double processedResponse_) const {
+  return processedResponse_ == _minResponse_ or processedResponse_ == _maxResponse_;
+}
 std::string DialResponseSupervisor::getSummary() const{
   std::stringstream ss;
 
@@ -6,6 +6,9 @@
 
 #include "Logger.h"
 
+#include <iterator>
+#include <algorithm>
+
 LoggerInit([]{
   Logger::setUserHeaderStr("[EventDialCache]");
 });
@@ -13,11 +16,17 @@ LoggerInit([]{
 void EventDialCache::buildReferenceCache( SampleSet& sampleSet_, std::vector<DialCollection>& dialCollectionList_){
   LogInfo << "Building event dial cache..." << std::endl;
 
+  this->mergeThreadIndexedCaches();
+
   LogInfo << "Indexed cache size: " << _indexedCache_.size() << std::endl;
   LogInfo << "Sorting events in sync with indexed cache..." << std::endl;
 
   size_t nCacheSlots{0};
   std::vector<std::vector<IndexedCacheEntry>> sampleIndexCacheList{sampleSet_.getSampleList().size()};
+  std::vector<size_t> sampleNbEntriesList(sampleSet_.getSampleList().size(), 0);
+  for( auto& sample : sampleSet_.getSampleList() ){
+    sampleIndexCacheList[sample.getIndex()].resize( sample.getMcContainer().getEventList().size() );
+  }
 
   {
     LogScopeIndent;
@@ -26,13 +35,21 @@ void EventDialCache::buildReferenceCache( SampleSet& sampleSet_, std::vector<Dia
       if( entry.event.sampleIndex == size_t(-1) ){ continue; }
       if( entry.event.eventIndex == size_t(-1) ){ continue; }
 
-      sampleIndexCacheList[entry.event.sampleIndex].emplace_back( entry );
-      sampleIndexCacheList[entry.event.sampleIndex].back().dials.clear();
+      // the loading threads claim the event slots in any order:
+      // the entries are placed according to their event index
+      auto& sampleIndexCache = sampleIndexCacheList[entry.event.sampleIndex];
+      LogThrowIf(entry.event.eventIndex >= sampleIndexCache.size(),
+                 "Indexed cache entry out of the event list: " << entry);
+
+      auto& sampleEntry = sampleIndexCache[entry.event.eventIndex];
+      sampleEntry.event = entry.event;
+      sampleEntry.dials.clear();
       for( auto& dial : entry.dials ){
         if( dial.collectionIndex == size_t(-1) ){ continue; }
         if( dial.interfaceIndex == size_t(-1)  ){ continue; }
-        sampleIndexCacheList[entry.event.sampleIndex].back().dials.emplace_back(dial);
+        sampleEntry.dials.emplace_back(dial);
       }
+      sampleNbEntriesList[entry.event.sampleIndex]++;
     }
 
     LogInfo << "Cleaning up the index cache..." << std::endl;
@@ -51,14 +68,14 @@ void EventDialCache::buildReferenceCache( SampleSet& sampleSet_, std::vector<Dia
           });
 
       LogThrowIf(
-          sampleIndexCacheList[iSample].size() != sample.getMcContainer().getEventList().size(),
+          sampleNbEntriesList[iSample] != sample.getMcContainer().getEventList().size(),
           std::endl << "MISMATCH cache and event list for sample: #" << sample.getIndex() << " " << sample.getName()
-              << std::endl << GET_VAR_NAME_VALUE(sampleIndexCacheList[iSample].size())
+              << std::endl << GET_VAR_NAME_VALUE(sampleNbEntriesList[iSample])
               << " <-> " << GET_VAR_NAME_VALUE(sample.getMcContainer().getEventList().size())
       );
       nCacheSlots += sampleIndexCacheList[iSample].size();
 
-      GenericToolbox::applyPermutation( sample.getMcContainer().getEventList(), p );
+      sample.getMcContainer().applyEventPermutation( p );
       GenericToolbox::applyPermutation( sampleIndexCacheList[iSample],     p );
 
       // now update the event indices
@@ -86,12 +103,10 @@ void EventDialCache::buildReferenceCache( SampleSet& sampleSet_, std::vector<Dia
 
       auto& cacheEntry{_cache_.emplace_back()};
 
-      cacheEntry.event =
-          &sampleSet_.getSampleList().at(
-              indexCache.event.sampleIndex
-          ).getMcContainer().getEventList().at(
-              indexCache.event.eventIndex
-          );
+      auto& mcContainer{sampleSet_.getSampleList().at(indexCache.event.sampleIndex).getMcContainer()};
+      cacheEntry.event = &mcContainer.getEventList().at( indexCache.event.eventIndex );
+      cacheEntry.weightStorePtr = &mcContainer.getWeightStore();
+      cacheEntry.weightIndex = cacheEntry.event->getIndices().weight;
 
       cacheEntry.dialResponseCacheList.reserve( countValidDials(indexCache.dials) );
       for( auto& dialIndex : indexCache.dials ){
@@ -121,6 +136,24 @@ EventDialCache::IndexedCacheEntry* EventDialCache::fetchNextCacheEntry(){
   // This only works IFF the indexed cache is not resized.
   return &_indexedCache_[_fillIndex_++];
 }
+void EventDialCache::allocateThreadIndexedCaches(int nThreads_){
+  // chunks of previous loads might still be waiting to be merged
+  if( int(_threadIndexedCacheList_.size()) < nThreads_ ){ _threadIndexedCacheList_.resize(nThreads_); }
+}
+void EventDialCache::mergeThreadIndexedCaches(){
+  size_t nEntries{0};
+  for( auto& threadIndexedCache : _threadIndexedCacheList_ ){ nEntries += threadIndexedCache.size(); }
+  if( nEntries == 0 ){ return; }
+
+  // the pre-allocated entries that haven't been fetched are dropped
+  _indexedCache_.resize(_fillIndex_);
+  _indexedCache_.reserve(_fillIndex_ + nEntries);
+  for( auto& threadIndexedCache : _threadIndexedCacheList_ ){
+    std::move(threadIndexedCache.begin(), threadIndexedCache.end(), std::back_inserter(_indexedCache_));
+    threadIndexedCache = std::vector<IndexedCacheEntry>();
+  }
+  _fillIndex_ = _indexedCache_.size();
+}
 
 
 void EventDialCache::reweightEntry( EventDialCache::CacheEntry& entry_){
@@ -136,6 +169,58 @@ void EventDialCache::reweightEntry( EventDialCache::CacheEntry& entry_){
   // applying event weight cap if defined
   _globalEventReweightCap_.process( tempReweight );
 
-  entry_.event->getWeights().resetCurrentWeight(); // reset to the base weight
-  entry_.event->getWeights().current *= tempReweight; // apply the reweight factor
+  // apply the reweight factor on top of the base weight
+  entry_.weightStorePtr->current[entry_.weightIndex] = entry_.weightStorePtr->base[entry_.weightIndex] * tempReweight;
+}
+double EventDialCache::evalEntryWeightGradient( const CacheEntry& entry_, std::vector<WeightDerivative>& derivativeList_ ) const {
+  derivativeList_.clear();
+
+  static thread_local std::vector<double> responseList;
+  responseList.resize( entry_.dialResponseCacheList.size() );
+
+  double reweight{1};
+  int nNullResponses{0};
+  for( size_t iDial = 0 ; iDial < responseList.size() ; iDial++ ){
+    responseList[iDial] = entry_.dialResponseCacheList[iDial].dialInterface.evalResponse();
+    reweight *= responseList[iDial];
+    if( responseList[iDial] == 0 ){ nNullResponses++; }
+  }
+
+  const double baseWeight{entry_.weightStorePtr->base[entry_.weightIndex]};
+
+  double cappedReweight{reweight};
+  _globalEventReweightCap_.process( cappedReweight );
+
+  // a capped weight doesn't depend on the parameters, and with more than one
+  // null response no single dial can move the weight
+  if( cappedReweight != reweight or nNullResponses > 1 ){ return baseWeight * cappedReweight; }
+
+  for( size_t iDial = 0 ; iDial < responseList.size() ; iDial++ ){
+
+    // product of the other responses
+    double otherResponses{0};
+    if( responseList[iDial] != 0 ){ otherResponses = reweight / responseList[iDial]; }
+    else{
+      otherResponses = 1;
+      for( size_t jDial = 0 ; jDial < responseList.size() ; jDial++ ){
+        if( jDial != iDial ){ otherResponses *= responseList[jDial]; }
+      }
+    }
+    if( otherResponses == 0 ){ continue; }
+
+    auto& dialInterface = entry_.dialResponseCacheList[iDial].dialInterface;
+    auto* inputBuffer = dialInterface.getInputBufferRef();
+    auto& parReferenceList = inputBuffer->getInputParameterIndicesList();
+    for( int iInput = 0 ; iInput < int(parReferenceList.size()) ; iInput++ ){
+      double derivative{dialInterface.evalDerivative(responseList[iDial], parReferenceList[iInput].bufferIndex)};
+      if( derivative == 0 ){ continue; }
+
+      derivativeList_.emplace_back();
+      derivativeList_.back().parSetIndex = parReferenceList[iInput].parSetIndex;
+      derivativeList_.back().parIndex = parReferenceList[iInput].parIndex;
+      derivativeList_.back().value = baseWeight * otherResponses * derivative * inputBuffer->getInputSlope(iInput);
+    }
+  }
+
+  return baseWeight * reweight;
 }
@@ -0,0 +1,503 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#include "GroupedDialEngine.h"
+
+#include "Norm.h"
+#include "Shift.h"
+#include "CompactSpline.h"
+#include "MonotonicSpline.h"
+#include "UniformSpline.h"
+#include "GeneralSpline.h"
+#include "LightGraph.h"
+
+#include "CalculateCompactSpline.h"
+#include "CalculateMonotonicSpline.h"
+#include "CalculateUniformSpline.h"
+#include "CalculateGeneralSpline.h"
+#include "CalculateGraph.h"
+#include "CalculateSplineBatch.h"
+
+#include "GundamGlobals.h"
+
+#include "Logger.h"
+
+#include <unordered_map>
+#include <algorithm>
+#include <sstream>
+#include <cmath>
+
+LoggerInit([]{
+  Logger::setUserHeaderStr("[GroupedDialEngine]");
+});
+
+
+std::string GroupedDialEngine::toString(DialType type_){
+  switch( type_ ){
+    case DialType::Norm:            return "Norm";
+    case DialType::Shift:           return "Shift";
+    case DialType::CompactSpline:   return "CompactSpline";
+    case DialType::MonotonicSpline: return "MonotonicSpline";
+    case DialType::UniformSpline:   return "UniformSpline";
+    case DialType::GeneralSpline:   return "GeneralSpline";
+    case DialType::LightGraph:      return "LightGraph";
+    case DialType::Generic:         return "Generic";
+    default:                        return "Unknown";
+  }
+}
+
+void GroupedDialEngine::build(EventDialCache& eventDialCache_){
+  LogInfo << "Building grouped dial engine..." << std::endl;
+
+  this->clear();
+  _globalEventReweightCap_ = eventDialCache_.getGlobalEventReweightCap();
+
+  _dialGroupList_.resize( size_t(DialType::NbDialTypes) );
+  for( size_t iType = 0 ; iType < _dialGroupList_.size() ; iType++ ){
+    _dialGroupList_[iType].type = DialType(iType);
+  }
+
+  std::unordered_map<const DialInterface*, int> responseIndexDict{};
+  std::vector<int> responseInputList{}; // response -> input
+  std::unordered_map<const DialInputBuffer*, int> inputIndexDict{};
+  // the dial data is interned by the DialDataPool: shared data is copied once per group
+  std::vector<std::unordered_map<const std::vector<double>*, size_t>> dataOffsetDictList( _dialGroupList_.size() );
+
+  auto fetchInputIndex = [&](const DialInputBuffer* inputBufferPtr_){
+    auto it = inputIndexDict.find( inputBufferPtr_ );
+    if( it != inputIndexDict.end() ){ return it->second; }
+    int index{int(_inputBufferList_.size())};
+    _inputBufferList_.emplace_back( inputBufferPtr_ );
+    inputIndexDict[inputBufferPtr_] = index;
+    return index;
+  };
+
+  auto registerDial = [&](const DialInterface& interface_){
+    DialEntry dial{};
+    dial.responseIndex = int(_responseList_.size());
+    dial.inputIndex = fetchInputIndex( interface_.getInputBufferRef() );
+    _responseList_.emplace_back( std::nan("unset") );
+    responseInputList.emplace_back( dial.inputIndex );
+
+    if( interface_.getResponseSupervisorRef() != nullptr ){
+      auto* supervisor = interface_.getResponseSupervisorRef();
+      if( not std::isnan(supervisor->getMinResponse()) ){ dial.minResponse = supervisor->getMinResponse(); }
+      if( not std::isnan(supervisor->getMaxResponse()) ){ dial.maxResponse = supervisor->getMaxResponse(); }
+    }
+
+    auto setSplineBounds = [&](bool allowExtrapolation_, const std::pair<double, double>& bounds_){
+      if( allowExtrapolation_ ){ return; }
+      dial.lowerBound = bounds_.first;
+      dial.upperBound = bounds_.second;
+    };
+
+    const DialBase* dialBase{interface_.getDialBaseRef()};
+    DialType type{DialType::Generic};
+    std::vector<double> shiftData{};
+    const std::vector<double>* dataPtr{nullptr};
+
+    if( interface_.getInputBufferRef()->getBufferSize() != 1 ){
+      // multi-dimensional dials are left to the virtual interface
+    }
+    else if( dynamic_cast<const Norm*>(dialBase) != nullptr ){
+      type = DialType::Norm;
+    }
+    else if( auto* shift = dynamic_cast<const Shift*>(dialBase) ){
+      type = DialType::Shift;
+      shiftData.emplace_back( shift->getShiftValue() );
+      dataPtr = &shiftData;
+    }
+    else if( auto* spline = dynamic_cast<const CompactSpline*>(dialBase) ){
+      type = DialType::CompactSpline;
+      setSplineBounds( spline->getAllowExtrapolation(), spline->getSplineBounds() );
+      dataPtr = &spline->getDialData();
+    }
+    else if( auto* spline = dynamic_cast<const MonotonicSpline*>(dialBase) ){
+      type = DialType::MonotonicSpline;
+      setSplineBounds( spline->getAllowExtrapolation(), spline->getSplineBounds() );
+      dataPtr = &spline->getDialData();
+    }
+    else if( auto* spline = dynamic_cast<const UniformSpline*>(dialBase) ){
+      type = DialType::UniformSpline;
+      setSplineBounds( spline->getAllowExtrapolation(), spline->getSplineBounds() );
+      dataPtr = &spline->getDialData();
+    }
+    else if( auto* spline = dynamic_cast<const GeneralSpline*>(dialBase) ){
+      type = DialType::GeneralSpline;
+      setSplineBounds( spline->getAllowExtrapolation(), spline->getSplineBounds() );
+      dataPtr = &spline->getDialData();
+    }
+    else if( auto* graph = dynamic_cast<const LightGraph*>(dialBase) ){
+      type = DialType::LightGraph;
+      dataPtr = &graph->getDialData();
+      // packed as {y0,x0,y1,x1,...}: clamping x gives back the edge values
+      if( not graph->getAllowExtrapolation() ){
+        dial.lowerBound = (*dataPtr)[1];
+        dial.upperBound = dataPtr->back();
+      }
+    }
+
+    auto& group = _dialGroupList_[size_t(type)];
+    if( dataPtr != nullptr ){
+      dial.dataSize = int(dataPtr->size());
+      auto& dataOffsetDict = dataOffsetDictList[size_t(type)];
+      auto it = ( dataPtr == &shiftData ? dataOffsetDict.end() : dataOffsetDict.find( dataPtr ) );
+      if( it != dataOffsetDict.end() ){ dial.dataOffset = it->second; }
+      else{
+        dial.dataOffset = group.dataList.size();
+        group.dataList.insert( group.dataList.end(), dataPtr->begin(), dataPtr->end() );
+        if( dataPtr != &shiftData ){ dataOffsetDict.emplace( dataPtr, dial.dataOffset ); }
+      }
+    }
+    if( type == DialType::Generic ){ group.dialInterfaceList.emplace_back( &interface_ ); }
+    group.dialList.emplace_back( dial );
+
+    return dial.responseIndex;
+  };
+
+  auto& cache = eventDialCache_.getCache();
+  _eventResponseOffsetList_.reserve( cache.size() + 1 );
+  _eventWeightStoreList_.reserve( cache.size() );
+  _eventWeightIndexList_.reserve( cache.size() );
+
+  _eventResponseOffsetList_.emplace_back( 0 );
+  for( auto& entry : cache ){
+    for( auto& dialResponseCache : entry.dialResponseCacheList ){
+      const DialInterface* interfacePtr{&dialResponseCache.dialInterface};
+      auto it = responseIndexDict.find( interfacePtr );
+      if( it == responseIndexDict.end() ){
+        it = responseIndexDict.emplace( interfacePtr, registerDial(*interfacePtr) ).first;
+      }
+      _eventResponseIndexList_.emplace_back( it->second );
+    }
+    _eventResponseOffsetList_.emplace_back( _eventResponseIndexList_.size() );
+    _eventWeightStoreList_.emplace_back( entry.weightStorePtr );
+    _eventWeightIndexList_.emplace_back( entry.weightIndex );
+  }
+
+  for( auto& group : _dialGroupList_ ){
+    group.dialList.shrink_to_fit();
+    group.dataList.shrink_to_fit();
+
+    if( isBatched(group.type) ){
+      // splines with the same number of knots are evaluated together
+      LogThrowIf( group.dataList.size() > size_t(std::numeric_limits<int>::max()),
+                  toString(group.type) << " data can't be indexed with int offsets." );
+      std::stable_sort( group.dialList.begin(), group.dialList.end(), [](const DialEntry& a_, const DialEntry& b_){
+        if( a_.dataSize != b_.dataSize ){ return a_.dataSize < b_.dataSize; }
+        return a_.inputIndex < b_.inputIndex;
+      } );
+    }
+
+    if( _useSinglePrecision_ ){
+      // the double copy is released: only the float data is kept
+      group.floatDataList.assign( group.dataList.begin(), group.dataList.end() );
+      group.dataList.clear();
+      group.dataList.shrink_to_fit();
+    }
+  }
+
+  // inverted index: the events depending on each input
+  {
+    std::vector<std::vector<int>> inputEventList( _inputBufferList_.size() );
+    std::vector<int> eventInputList{};
+    for( size_t iEvent = 0 ; iEvent < _eventWeightIndexList_.size() ; iEvent++ ){
+      eventInputList.clear();
+      for( size_t iResponse = _eventResponseOffsetList_[iEvent] ; iResponse < _eventResponseOffsetList_[iEvent+1] ; iResponse++ ){
+        eventInputList.emplace_back( responseInputList[_eventResponseIndexList_[iResponse]] );
+      }
+      std::sort( eventInputList.begin(), eventInputList.end() );
+      eventInputList.erase( std::unique( eventInputList.begin(), eventInputList.end() ), eventInputList.end() );
+      for( auto iInput : eventInputList ){ inputEventList[iInput].emplace_back( int(iEvent) ); }
+    }
+
+    _inputEventOffsetList_.reserve( inputEventList.size() + 1 );
+    _inputEventOffsetList_.emplace_back( 0 );
+    for( auto& eventList : inputEventList ){
+      _inputEventIndexList_.insert( _inputEventIndexList_.end(), eventList.begin(), eventList.end() );
+      _inputEventOffsetList_.emplace_back( _inputEventIndexList_.size() );
+    }
+  }
+  _eventIsUpdatedList_.resize( _eventWeightIndexList_.size(), false );
+
+  _inputValueList_.resize( _inputBufferList_.size(), std::nan("unset") );
+  _inputIsMaskedList_.resize( _inputBufferList_.size(), false );
+  _inputIsUpdatedList_.resize( _inputBufferList_.size(), true );
+  _allInputsUpdatedList_.resize( _inputBufferList_.size(), true );
+
+  _isBuilt_ = true;
+  _requireFullUpdate_ = true;
+
+  LogInfo << this->getSummary() << std::endl;
+}
+bool GroupedDialEngine::isBatched(DialType type_){
+  return type_ == DialType::CompactSpline
+      or type_ == DialType::MonotonicSpline
+      or type_ == DialType::UniformSpline;
+}
+void GroupedDialEngine::clear(){
+  _isBuilt_ = false;
+  _dialGroupList_.clear();
+  _inputBufferList_.clear();
+  _inputValueList_.clear();
+  _inputIsMaskedList_.clear();
+  _inputIsUpdatedList_.clear();
+  _allInputsUpdatedList_.clear();
+  _responseList_.clear();
+  _eventResponseOffsetList_.clear();
+  _eventResponseIndexList_.clear();
+  _eventWeightStoreList_.clear();
+  _eventWeightIndexList_.clear();
+  _inputEventOffsetList_.clear();
+  _inputEventIndexList_.clear();
+  _updatedEventList_.clear();
+  _eventIsUpdatedList_.clear();
+  _isIncrementalUpdate_ = false;
+}
+
+void GroupedDialEngine::updateInputs(){
+  size_t nAffectedEvents{0};
+  for( size_t iInput = 0 ; iInput < _inputBufferList_.size() ; iInput++ ){
+    auto* inputBuffer = _inputBufferList_[iInput];
+    _inputValueList_[iInput] = inputBuffer->getInputBuffer()[0];
+    _inputIsMaskedList_[iInput] = inputBuffer->isMasked();
+    _inputIsUpdatedList_[iInput] = _requireFullUpdate_ or inputBuffer->isDialUpdateRequested();
+    if( _inputIsUpdatedList_[iInput] ){ nAffectedEvents += _inputEventOffsetList_[iInput+1] - _inputEventOffsetList_[iInput]; }
+  }
+
+  // nAffectedEvents might count the same event several times: it's an upper bound
+  _isIncrementalUpdate_ = (
+      _enableIncrementalUpdate_ and not _requireFullUpdate_
+      and double(nAffectedEvents) < _incrementalUpdateMaxFraction_ * double(_eventWeightIndexList_.size())
+  );
+  _requireFullUpdate_ = false;
+
+  _updatedEventList_.clear();
+  if( not _isIncrementalUpdate_ ){ return; }
+
+  for( size_t iInput = 0 ; iInput < _inputBufferList_.size() ; iInput++ ){
+    if( not _inputIsUpdatedList_[iInput] ){ continue; }
+    for( size_t iEntry = _inputEventOffsetList_[iInput] ; iEntry < _inputEventOffsetList_[iInput+1] ; iEntry++ ){
+      int iEvent{_inputEventIndexList_[iEntry]};
+      if( _eventIsUpdatedList_[iEvent] ){ continue; }
+      _eventIsUpdatedList_[iEvent] = true;
+      _updatedEventList_.emplace_back( iEvent );
+    }
+  }
+  for( auto iEvent : _updatedEventList_ ){ _eventIsUpdatedList_[iEvent] = false; }
+
+  // sorted for a contiguous memory access
+  std::sort( _updatedEventList_.begin(), _updatedEventList_.end() );
+}
+void GroupedDialEngine::evalDialResponses(int iThread_){
+  int nThreads{GundamGlobals::getParallelWorker().getNbThreads()};
+
+  EvalBuffers buffers{};
+  buffers.inputValueList = _inputValueList_.data();
+  buffers.inputIsMaskedList = _inputIsMaskedList_.data();
+  buffers.inputIsUpdatedList = _inputIsUpdatedList_.data();
+  buffers.responseList = _responseList_.data();
+
+  for( auto& group : _dialGroupList_ ){
+    if( group.dialList.empty() ){ continue; }
+    auto bounds = GenericToolbox::ParallelWorker::getThreadBoundIndices( iThread_, nThreads, int(group.dialList.size()) );
+    this->evalDialGroup( group, bounds.beginIndex, bounds.endIndex, buffers );
+  }
+}
+void GroupedDialEngine::fetchInputs(std::vector<double>& inputValueList_, std::vector<char>& inputIsMaskedList_) const{
+  inputValueList_.resize( _inputBufferList_.size() );
+  inputIsMaskedList_.resize( _inputBufferList_.size() );
+  for( size_t iInput = 0 ; iInput < _inputBufferList_.size() ; iInput++ ){
+    inputValueList_[iInput] = _inputBufferList_[iInput]->getInputBuffer()[0];
+    inputIsMaskedList_[iInput] = _inputBufferList_[iInput]->isMasked();
+  }
+}
+void GroupedDialEngine::evalDialResponses(const std::vector<double>& inputValueList_, const std::vector<char>& inputIsMaskedList_, std::vector<double>& responseList_) const{
+  LogThrowIf( not _isBuilt_, "The grouped dial engine is not built." );
+  LogThrowIf( this->hasGenericDials(), "Generic dials can't be evaluated from external inputs." );
+  LogThrowIf( inputValueList_.size() != _inputBufferList_.size() or inputIsMaskedList_.size() != _inputBufferList_.size(),
+              "Expecting " << _inputBufferList_.size() << " inputs, got " << inputValueList_.size() );
+
+  responseList_.resize( _responseList_.size() );
+
+  EvalBuffers buffers{};
+  buffers.inputValueList = inputValueList_.data();
+  buffers.inputIsMaskedList = inputIsMaskedList_.data();
+  buffers.inputIsUpdatedList = _allInputsUpdatedList_.data();
+  buffers.responseList = responseList_.data();
+
+  for( auto& group : _dialGroupList_ ){
+    if( group.dialList.empty() ){ continue; }
+    this->evalDialGroup( group, 0, group.dialList.size(), buffers );
+  }
+}
+void GroupedDialEngine::applyEventWeights(int iThread_){
+
+  //! Warning: everything you modify here, may significantly slow down the
+  //! fitter
+
+  const double* responseList{_responseList_.data()};
+
+  auto reweightEvent = [&](int iEvent_){
+    // product of the responses, with the event weight cap if defined
+    double reweight{this->evalEventReweight( responseList, iEvent_ )};
+
+    auto* weightStore{_eventWeightStoreList_[iEvent_]};
+    int weightIndex{_eventWeightIndexList_[iEvent_]};
+    weightStore->current[weightIndex] = weightStore->base[weightIndex] * reweight;
+  };
+
+  if( _isIncrementalUpdate_ ){
+    auto bounds = GenericToolbox::ParallelWorker::getThreadBoundIndices(
+        iThread_, GundamGlobals::getParallelWorker().getNbThreads(),
+        int(_updatedEventList_.size())
+    );
+    for( int iEntry = bounds.beginIndex ; iEntry < bounds.endIndex ; iEntry++ ){
+      reweightEvent( _updatedEventList_[iEntry] );
+    }
+    return;
+  }
+
+  auto bounds = GenericToolbox::ParallelWorker::getThreadBoundIndices(
+      iThread_, GundamGlobals::getParallelWorker().getNbThreads(),
+      int(_eventWeightIndexList_.size())
+  );
+  for( int iEvent = bounds.beginIndex ; iEvent < bounds.endIndex ; iEvent++ ){
+    reweightEvent( iEvent );
+  }
+}
+
+std::string GroupedDialEngine::getSummary() const{
+  std::stringstream ss;
+  ss << "GroupedDialEngine: " << _responseList_.size() << " dials, "
+     << _inputBufferList_.size() << " inputs, " << _eventWeightIndexList_.size() << " events"
+     << " (spline batches: " << SplineBatchIsaName( GetSplineBatchIsa() ) << ")";
+  if( _useSinglePrecision_ ){ ss << " in single precision"; }
+  if( not _enableIncrementalUpdate_ ){ ss << " with full reweights"; }
+  for( auto& group : _dialGroupList_ ){
+    if( group.dialList.empty() ){ continue; }
+    ss << std::endl << " - " << toString(group.type) << ": " << group.dialList.size() << " dials ("
+       << GenericToolbox::parseSizeUnits( double(group.dialList.size() * sizeof(DialEntry) + group.dataList.size() * sizeof(double) + group.floatDataList.size() * sizeof(float)) )
+       << ")";
+  }
+  return ss.str();
+}
+
+void GroupedDialEngine::evalDialGroup(const DialGroup& group_, size_t beginIndex_, size_t endIndex_, const EvalBuffers& buffers_) const{
+  if( _useSinglePrecision_ ){ this->evalDialGroup( group_, group_.floatDataList.data(), beginIndex_, endIndex_, buffers_ ); }
+  else{ this->evalDialGroup( group_, group_.dataList.data(), beginIndex_, endIndex_, buffers_ ); }
+}
+template<typename FloatType> void GroupedDialEngine::evalDialGroup(const DialGroup& group_, const FloatType* data, size_t beginIndex_, size_t endIndex_, const EvalBuffers& buffers_) const{
+  const double* inputValueList{buffers_.inputValueList};
+  const char* inputIsMaskedList{buffers_.inputIsMaskedList};
+  const char* inputIsUpdatedList{buffers_.inputIsUpdatedList};
+  double* responseList{buffers_.responseList};
+
+  // the type dispatch is done once per group: the loop itself is not virtual
+  auto evalLoop = [&](auto&& calculate_){
+    for( size_t iDial = beginIndex_ ; iDial < endIndex_ ; iDial++ ){
+      auto& dial = group_.dialList[iDial];
+      if( not inputIsUpdatedList[dial.inputIndex] ){ continue; }
+      if( inputIsMaskedList[dial.inputIndex] ){ responseList[dial.responseIndex] = 1; continue; }
+
+      double input{inputValueList[dial.inputIndex]};
+      if     ( input <= dial.lowerBound ){ input = dial.lowerBound; }
+      else if( input >= dial.upperBound ){ input = dial.upperBound; }
+
+      double response{calculate_(input, dial)};
+      if     ( response < dial.minResponse ){ response = dial.minResponse; }
+      else if( response > dial.maxResponse ){ response = dial.maxResponse; }
+
+      responseList[dial.responseIndex] = response;
+    }
+  };
+
+  // batched spline evaluation: the responses are stored when a batch is evaluated
+  auto evalBatchLoop = [&](typename SplineBatchBufferT<FloatType>::BatchFunction batchFunction_, int dimOffset_){
+    SplineBatchBufferT<FloatType> batch(batchFunction_, data);
+    auto store = [&](int iDial_, double response_){
+      auto& dial = group_.dialList[iDial_];
+      if     ( response_ < dial.minResponse ){ response_ = dial.minResponse; }
+      else if( response_ > dial.maxResponse ){ response_ = dial.maxResponse; }
+      responseList[dial.responseIndex] = response_;
+    };
+    for( size_t iDial = beginIndex_ ; iDial < endIndex_ ; iDial++ ){
+      auto& dial = group_.dialList[iDial];
+      if( not inputIsUpdatedList[dial.inputIndex] ){ continue; }
+      if( inputIsMaskedList[dial.inputIndex] ){ responseList[dial.responseIndex] = 1; continue; }
+
+      double input{inputValueList[dial.inputIndex]};
+      if     ( input <= dial.lowerBound ){ input = dial.lowerBound; }
+      else if( input >= dial.upperBound ){ input = dial.upperBound; }
+
+      batch.Add( input, int(dial.dataOffset), dial.dataSize - dimOffset_, int(iDial), store );
+    }
+    batch.Flush( store );
+  };
+
+  switch( group_.type ){
+    case DialType::Norm:
+      evalLoop([](double x_, const DialEntry&){ return x_; });
+      break;
+    case DialType::Shift:
+      evalLoop([&](double, const DialEntry& d_){ return double(data[d_.dataOffset]); });
+      break;
+    case DialType::CompactSpline:
+      evalBatchLoop( &CalculateCompactSplineBatch, 2 );
+      break;
+    case DialType::MonotonicSpline:
+      evalBatchLoop( &CalculateMonotonicSplineBatch, 2 );
+      break;
+    case DialType::UniformSpline:
+      evalBatchLoop( &CalculateUniformSplineBatch, 0 );
+      break;
+    case DialType::GeneralSpline:
+      evalLoop([&](double x_, const DialEntry& d_){
+        return CalculateGeneralSpline( x_, -1E20, 1E20, data + d_.dataOffset, d_.dataSize );
+      });
+      break;
+    case DialType::LightGraph:
+      evalLoop([&](double x_, const DialEntry& d_){
+        return CalculateGraph( x_, -1E20, 1E20, data + d_.dataOffset, d_.dataSize );
+      });
+      break;
+    case DialType::Generic:
+      // fallback on the virtual interface (handles masking and supervisor)
+      for( size_t iDial = beginIndex_ ; iDial < endIndex_ ; iDial++ ){
+        auto& dial = group_.dialList[iDial];
+        if( not inputIsUpdatedList[dial.inputIndex] ){ continue; }
+        responseList[dial.responseIndex] = group_.dialInterfaceList[iDial]->evalResponse();
+      }
+      break;
+    default:
+      LogThrow("Unknown dial type: " << int(group_.type));
+  }
+}
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
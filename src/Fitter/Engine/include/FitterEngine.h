@@ -21,6 +21,7 @@
 
 #include <string>
 #include <vector>
+#include <utility>
 #include <memory>
 
 
@@ -79,6 +80,11 @@ public:
   [[deprecated("use getLikelihoodInterface().getDataSetManager().getPropagator()")]] Propagator& getPropagator(){ return getLikelihoodInterface().getDataSetManager().getPropagator(); }
   [[deprecated("Use runPcaCheck()")]] void fixGhostFitParameters(){ runPcaCheck(); }
 
+private:
+  /// Likelihood of each parameter moved alone to the given value, the other
+  /// parameters staying where they are. The shifts are propagated
+  /// concurrently on propagator replicas when the dials support it.
+  std::vector<LikelihoodInterface::Buffer> evalParameterShifts(const std::vector<std::pair<Parameter*, double>>& shiftList_);
 
 private:
   // Parameters
@@ -95,6 +101,10 @@ private:
   double _throwGain_{1.};
   double _parStepGain_{0.1};
   double _pcaDeltaChi2Threshold_{1E-6};
+  double _singlePrecisionMaxDeltaLlh_{1E-2};
+  bool _throwOnSinglePrecisionMismatch_{false};
+  bool _useParallelPreFitChecks_{true};
+  int _preFitChecksNbReplicas_{0};
   bool _savePostfitEventTrees_{false};
   std::vector<double> _allParamVariationsSigmas_{};
   JsonType _preFitParState_{};
@@ -4,6 +4,7 @@
 
 #include "FitterEngine.h"
 #include "GundamGlobals.h"
+#include "PropagatorReplicaPool.h"
 #include "RootMinimizer.h"
 #include "AdaptiveMcmc.h"
 
@@ -99,6 +100,10 @@ void FitterEngine::readConfigImpl(){
 
   _scaleParStepWithChi2Response_ = GenericToolbox::Json::fetchValue(_config_, "scaleParStepWithChi2Response", _scaleParStepWithChi2Response_);
   _parStepGain_ = GenericToolbox::Json::fetchValue(_config_, "parStepGain", _parStepGain_);
+  _singlePrecisionMaxDeltaLlh_ = GenericToolbox::Json::fetchValue(_config_, "singlePrecisionMaxDeltaLlh", _singlePrecisionMaxDeltaLlh_);
+  _throwOnSinglePrecisionMismatch_ = GenericToolbox::Json::fetchValue(_config_, "throwOnSinglePrecisionMismatch", _throwOnSinglePrecisionMismatch_);
+  _useParallelPreFitChecks_ = GenericToolbox::Json::fetchValue(_config_, "useParallelPreFitChecks", _useParallelPreFitChecks_);
+  _preFitChecksNbReplicas_ = GenericToolbox::Json::fetchValue(_config_, "preFitChecksNbReplicas", _preFitChecksNbReplicas_);
 
   _throwMcBeforeFit_ = GenericToolbox::Json::fetchValue(_config_, "throwMcBeforeFit", _throwMcBeforeFit_);
   _throwGain_ = GenericToolbox::Json::fetchValue(_config_, "throwMcBeforeFitGain", _throwGain_);
@@ -167,7 +172,10 @@ void FitterEngine::initializeImpl(){
   // and other properties)
   _minimizer_->initialize();
 
-  if( GundamGlobals::getVerboseLevel() >= VerboseLevel::MORE_PRINTOUT ){ checkNumericalAccuracy(); }
+  if( GundamGlobals::getVerboseLevel() >= VerboseLevel::MORE_PRINTOUT
+      or _likelihoodInterface_.getDataSetManager().getPropagator().isUseSinglePrecisionDials() ){
+    checkNumericalAccuracy();
+  }
 
   // Write data
   LogInfo << "Writing propagator objects..." << std::endl;
@@ -454,6 +462,17 @@ void FitterEngine::runPcaCheck(){
   std::stringstream ssPrint;
   double deltaChi2Stat;
 
+  // the +1 sigma shifts of all the parameters are evaluated at once
+  std::vector<std::pair<Parameter*, double>> shiftList{};
+  for( auto& parSet : _likelihoodInterface_.getDataSetManager().getPropagator().getParametersManager().getParameterSetsList() ){
+    if( not parSet.isEnabled() or not parSet.isEnablePca() ){ continue; }
+    for( auto& par : parSet.getEffectiveParameterList() ){
+      if( par.isEnabled() and not par.isFixed() ){ shiftList.emplace_back( &par, par.getParameterValue() + par.getStdDevValue() ); }
+    }
+  }
+  auto llhBufferList = this->evalParameterShifts( shiftList );
+  size_t iShift{0};
+
   for( auto& parSet : _likelihoodInterface_.getDataSetManager().getPropagator().getParametersManager().getParameterSetsList() ){
 
     if( not parSet.isEnabled() ){ continue; }
@@ -471,6 +490,9 @@ void FitterEngine::runPcaCheck(){
     for( auto& par : parList ){
       LogScopeIndent;
 
+      bool isShifted{ iShift < shiftList.size() and shiftList[iShift].first == &par };
+      if( isShifted ){ iShift++; }
+
       ssPrint.str("");
       ssPrint << "(" << par.getParameterIndex()+1 << "/" << parList.size() << ") +1 std-dev on " << parSet.getName() + "/" + par.getTitle();
 
@@ -487,26 +509,16 @@ void FitterEngine::runPcaCheck(){
         continue;
       }
 
-      if( par.isEnabled() and not par.isFixed() ){
-        double currentParValue = par.getParameterValue();
-        par.setParameterValue( currentParValue + par.getStdDevValue() );
+      if( isShifted ){
+        ssPrint << " " << par.getParameterValue() << " -> " << shiftList[iShift-1].second;
 
-        ssPrint << " " << currentParValue << " -> " << par.getParameterValue();
-        LogInfo << ssPrint.str() << "..." << std::endl;
-
-        _likelihoodInterface_.propagateAndEvalLikelihood();
-
-        deltaChi2Stat = _likelihoodInterface_.getLastStatLikelihood() - baseLlhStat;
+        deltaChi2Stat = llhBufferList[iShift-1].statLikelihood - baseLlhStat;
 
         ssPrint << ": diff. stat log-likelihood = " << deltaChi2Stat;
 
-        LogInfo.moveTerminalCursorBack(1);
-        LogInfo << ssPrint.str() << std::endl;
-
         if( std::abs(deltaChi2Stat) < _pcaDeltaChi2Threshold_ ){
           par.setIsFixed(true); // ignored in the Chi2 computation of the parSet
           ssPrint << " < " << GenericToolbox::Json::fetchValue(_config_, {{"ghostParameterDeltaChi2Threshold"}, {"pcaDeltaChi2Threshold"}}, 1E-6) << " -> FIXED";
-          LogInfo.moveTerminalCursorBack(1);
 #ifndef NOCOLOR
           std::string red(GenericToolbox::ColorCodes::redBackground);
           std::string rst(GenericToolbox::ColorCodes::resetColor);
@@ -520,9 +532,9 @@ void FitterEngine::runPcaCheck(){
             fixNextEigenPars = true;
           }
         }
-
-        // Come back to the original values
-        par.setParameterValue( currentParValue );
+        else{
+          LogInfo << ssPrint.str() << std::endl;
+        }
       }
     }
 
@@ -546,51 +558,137 @@ void FitterEngine::rescaleParametersStepSize(){
   double baseLlh = _likelihoodInterface_.getLastLikelihood();
 
   // +1 sigma
+  std::vector<std::pair<Parameter*, double>> shiftList{};
+  std::vector<std::string> parNameList{};
   for( auto& parSet : _likelihoodInterface_.getDataSetManager().getPropagator().getParametersManager().getParameterSetsList() ){
-
     for( auto& par : parSet.getEffectiveParameterList() ){
-
       if( not par.isEnabled() ){ continue; }
+      shiftList.emplace_back( &par, par.getParameterValue() + par.getStdDevValue() );
+      parNameList.emplace_back( parSet.getName() + "/" + par.getTitle() );
+    }
+  }
+  auto llhBufferList = this->evalParameterShifts( shiftList );
 
-      double currentParValue = par.getParameterValue();
-      par.setParameterValue( currentParValue + par.getStdDevValue() );
+  std::vector<double> deltaChi2List( shiftList.size() );
+  std::vector<double> deltaChi2PullsList( shiftList.size() );
+  std::vector<double> stepScaleList( shiftList.size() );
+  std::vector<std::pair<Parameter*, double>> stepShiftList( shiftList.size() );
+  for( size_t iShift = 0 ; iShift < shiftList.size() ; iShift++ ){
+    auto& par = *shiftList[iShift].first;
 
-      _likelihoodInterface_.propagateAndEvalLikelihood();
+    deltaChi2List[iShift] = llhBufferList[iShift].totalLikelihood - baseLlh;
+    deltaChi2PullsList[iShift] = llhBufferList[iShift].penaltyLikelihood - baseLlhPull;
 
-      double deltaChi2 = _likelihoodInterface_.getLastLikelihood() - baseLlh;
-      double deltaChi2Pulls = _likelihoodInterface_.getLastPenaltyLikelihood() - baseLlhPull;
-
-      // Consider a parabolic approx:
-      // only rescale with X2 stat?
+    // Consider a parabolic approx:
+    // only rescale with X2 stat?
 //        double stepSize = TMath::Sqrt(deltaChi2Pulls)/TMath::Sqrt(deltaChi2);
 
-      // full rescale
-      double stepSize = 1./TMath::Sqrt(std::abs(deltaChi2));
+    // full rescale
+    double stepSize = 1./TMath::Sqrt(std::abs(deltaChi2List[iShift]));
+    stepScaleList[iShift] = stepSize;
+
+    stepSize *= par.getStdDevValue() * _parStepGain_;
+
+    par.setStepSize( stepSize );
+    stepShiftList[iShift] = { &par, par.getParameterValue() + stepSize };
+  }
+
+  // check the likelihood increase of the new steps
+  auto stepLlhBufferList = this->evalParameterShifts( stepShiftList );
+  for( size_t iShift = 0 ; iShift < shiftList.size() ; iShift++ ){
+    double deltaChi2{deltaChi2List[iShift]};
+    double deltaChi2Pulls{deltaChi2PullsList[iShift]};
+    LogInfo << "Step size of " << parNameList[iShift]
+            << " -> σ x " << _parStepGain_ << " x " << stepScaleList[iShift]
+            << " -> Δχ² = " << deltaChi2 << " = " << deltaChi2 - deltaChi2Pulls << "(stat) + " << deltaChi2Pulls << "(pulls)"
+            << " -> Δχ²(step) = " << stepLlhBufferList[iShift].totalLikelihood - baseLlh << std::endl;
+  }
+
+  _likelihoodInterface_.propagateAndEvalLikelihood();
+}
+std::vector<LikelihoodInterface::Buffer> FitterEngine::evalParameterShifts(const std::vector<std::pair<Parameter*, double>>& shiftList_){
+  std::vector<LikelihoodInterface::Buffer> out( shiftList_.size() );
+  if( shiftList_.empty() ){ return out; }
 
-      LogInfo << "Step size of " << parSet.getName() + "/" + par.getTitle()
-              << " -> σ x " << _parStepGain_ << " x " << stepSize
-              << " -> Δχ² = " << deltaChi2 << " = " << deltaChi2 - deltaChi2Pulls << "(stat) + " << deltaChi2Pulls << "(pulls)";
+  auto& propagator = _likelihoodInterface_.getDataSetManager().getPropagator();
 
-      stepSize *= par.getStdDevValue() * _parStepGain_;
+  int nReplicas{ _preFitChecksNbReplicas_ > 0 ? _preFitChecksNbReplicas_ : GundamGlobals::getParallelWorker().getNbThreads() };
+  nReplicas = std::min( nReplicas, int(shiftList_.size()) );
 
-      par.setStepSize( stepSize );
-      par.setParameterValue( currentParValue + stepSize );
+  bool useReplicas{ _useParallelPreFitChecks_ and nReplicas > 1 };
+  if( useReplicas and not PropagatorReplica::isSupported( propagator ) ){
+    LogAlert << "Some dials can't be evaluated by the propagator replicas. Evaluating the parameter shifts one by one." << std::endl;
+    useReplicas = false;
+  }
+
+  if( not useReplicas ){
+    for( size_t iShift = 0 ; iShift < shiftList_.size() ; iShift++ ){
+      auto& par = *shiftList_[iShift].first;
+      double currentParValue = par.getParameterValue();
+      par.setParameterValue( shiftList_[iShift].second );
       _likelihoodInterface_.propagateAndEvalLikelihood();
-      LogInfo << " -> Δχ²(step) = " << _likelihoodInterface_.getLastLikelihood() - baseLlh << std::endl;
+      out[iShift] = _likelihoodInterface_.getBuffer();
       par.setParameterValue( currentParValue );
     }
-
+    return out;
   }
 
-  _likelihoodInterface_.propagateAndEvalLikelihood();
+  LogInfo << "Evaluating " << shiftList_.size() << " parameter shifts by batches of " << nReplicas << " propagator replicas..." << std::endl;
+
+  PropagatorReplicaPool replicaPool{"FitterEngine::propagateReplicas"};
+  replicaPool.build( propagator, nReplicas );
+  replicaPool.evalBatch(
+      int(shiftList_.size()),
+      [&](int iShift_){
+        auto& shift = shiftList_[iShift_];
+        double currentParValue = shift.first->getParameterValue();
+        shift.first->setParameterValue( shift.second );
+        propagator.updateDialInputs();
+        out[iShift_].penaltyLikelihood = _likelihoodInterface_.evalPenaltyLikelihood();
+        // the replica only reads the dial inputs
+        shift.first->setParameterValue( currentParValue );
+        return true;
+      },
+      [&](int iShift_, PropagatorReplica& replica_){
+        replica_.copyToSampleSet( propagator.getSampleSet() );
+        out[iShift_].statLikelihood = _likelihoodInterface_.evalStatLikelihood();
+        out[iShift_].updateTotal();
+        GenericToolbox::displayProgressBar( iShift_ + 1, shiftList_.size(), LogInfo.getPrefixString() + "Evaluating the parameter shifts..." );
+      }
+  );
+
+  // back to the dial inputs of the current parameters
+  propagator.updateDialInputs();
+
+  return out;
 }
 void FitterEngine::checkNumericalAccuracy(){
   LogWarning << __METHOD_NAME__ << std::endl;
   int nTest{100}; int nThrows{10}; double gain{20};
   std::vector<std::vector<std::vector<double>>> throws(nThrows); // saved throws [throw][parSet][par]
   std::vector<double> responses(nThrows, std::nan("unset"));
+  auto& propagator = _likelihoodInterface_.getDataSetManager().getPropagator();
   // stability/numerical accuracy test
 
+  // the parameters are put back at the end
+  std::vector<std::vector<double>> savedParValues{};
+  for( auto& parSet : propagator.getParametersManager().getParameterSetsList() ){
+    savedParValues.emplace_back();
+    for( auto& par : parSet.getParameterList() ){ savedParValues.back().emplace_back( par.getParameterValue() ); }
+  }
+
+  auto setThrow = [&](size_t iThrow_){
+    int iParSet{-1};
+    for( auto& parSet : propagator.getParametersManager().getParameterSetsList() ){
+      if(not parSet.isEnabled()) continue;
+      if( not parSet.isEnabledThrowToyParameters() ){ continue;}
+      iParSet++;
+      for( size_t iPar = 0 ; iPar < parSet.getParameterList().size() ; iPar++){
+        parSet.getParameterList()[iPar].setParameterValue( throws[iThrow_][iParSet][iPar] );
+      }
+    }
+  };
+
   LogInfo << "Throwing..." << std::endl;
   for(auto& throwEntry : throws ){
     for( auto& parSet : _likelihoodInterface_.getDataSetManager().getPropagator().getParametersManager().getParameterSetsList() ){
@@ -605,20 +703,34 @@ void FitterEngine::checkNumericalAccuracy(){
     }
   }
 
-  LogInfo << "Testing..." << std::endl;
+  if( propagator.isUseSinglePrecisionDials() ){
+    // the dial interfaces are evaluated in double precision
+    LogInfo << "Comparing the single precision dials with the double precision reference..." << std::endl;
+    double maxDeltaLlh{0};
+    for( size_t iThrow = 0 ; iThrow < throws.size() ; iThrow++ ){
+      setThrow( iThrow );
+      propagator.propagateParameters();
+      double singleLlh{_likelihoodInterface_.evalLikelihood()};
+      propagator.propagateParametersWithDialInterfaces();
+      double doubleLlh{_likelihoodInterface_.evalLikelihood()};
+      LogDebug << "Throw #" << iThrow << ": " << GET_VAR_NAME_VALUE(singleLlh) << " <=> " << GET_VAR_NAME_VALUE(doubleLlh) << std::endl;
+      maxDeltaLlh = std::max( maxDeltaLlh, std::abs(singleLlh - doubleLlh) );
+    }
+    LogInfo << "Max LLH difference with single precision dials: " << maxDeltaLlh << std::endl;
+    LogThrowIf( _throwOnSinglePrecisionMismatch_ and maxDeltaLlh > _singlePrecisionMaxDeltaLlh_,
+      "Single precision dials are off by " << maxDeltaLlh << " LLH units (max " << _singlePrecisionMaxDeltaLlh_ << ")." );
+    LogAlertIf( maxDeltaLlh > _singlePrecisionMaxDeltaLlh_ )
+      << "Single precision dials are off by more than " << _singlePrecisionMaxDeltaLlh_
+      << " LLH units. Consider disabling \"useSinglePrecisionDials\"." << std::endl;
+  }
+
+  if( GundamGlobals::getVerboseLevel() < VerboseLevel::MORE_PRINTOUT ){ nTest = 0; }
+  if( nTest != 0 ){ LogInfo << "Testing..." << std::endl; }
   for( int iTest = 0 ; iTest < nTest ; iTest++ ){
     GenericToolbox::displayProgressBar(iTest, nTest, "Testing computational accuracy...");
     for( size_t iThrow = 0 ; iThrow < throws.size() ; iThrow++ ){
-      int iParSet{-1};
-      for( auto& parSet : _likelihoodInterface_.getDataSetManager().getPropagator().getParametersManager().getParameterSetsList() ){
-        if(not parSet.isEnabled()) continue;
-        if( not parSet.isEnabledThrowToyParameters() ){ continue;}
-        iParSet++;
-        for( size_t iPar = 0 ; iPar < parSet.getParameterList().size() ; iPar++){
-          parSet.getParameterList()[iPar].setParameterValue( throws[iThrow][iParSet][iPar] );
-        }
-      }
-      _likelihoodInterface_.getDataSetManager().getPropagator().propagateParameters();
+      setThrow( iThrow );
+      propagator.propagateParameters();
       _likelihoodInterface_.evalLikelihood();
 
       if( responses[iThrow] == responses[iThrow] ){ // not nan
@@ -630,6 +742,12 @@ void FitterEngine::checkNumericalAccuracy(){
     }
     LogDebug << GenericToolbox::toString(responses) << std::endl;
   }
+
+  for( size_t iParSet = 0 ; iParSet < savedParValues.size() ; iParSet++ ){
+    auto& parList = propagator.getParametersManager().getParameterSetsList()[iParSet].getParameterList();
+    for( size_t iPar = 0 ; iPar < parList.size() ; iPar++ ){ parList[iPar].setParameterValue( savedParValues[iParSet][iPar] ); }
+  }
+  _likelihoodInterface_.propagateAndEvalLikelihood();
   LogInfo << "OK" << std::endl;
 }
 
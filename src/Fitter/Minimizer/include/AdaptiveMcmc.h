@@ -7,6 +7,7 @@
 
 #include "ParameterSet.h"
 #include "MinimizerBase.h"
+#include "PropagatorReplicaPool.h"
 #include "JsonBaseClass.h"
 
 #include "GenericToolbox.Utils.h"
@@ -186,6 +187,38 @@ private:
   // The "sigma" of the Gaussian along each axis for the simple step.
   double _simpleSigma_{0.01};
 
+  //////////////////////////////////////////
+  // Parameters for running several chains
+
+  // The number of chains that are run together.  Each chain has its own
+  // adaptive proposal and is saved in its own tree.  The proposed points of
+  // all the chains are propagated concurrently.
+  int _nbChains_{1};
+
+  // The temperature of each chain.  The likelihood of a chain is raised to
+  // the power 1/T, and the states of the chains are exchanged with a
+  // Metropolis condition (parallel tempering).  Only the chains with T=1
+  // sample the posterior.  If empty, the temperatures are spaced
+  // geometrically between 1 and _maxTemperature_.
+  std::vector<double> _chainTemperatures_{};
+
+  // The temperature of the hottest chain when the ladder is not explicitly
+  // provided.  The default value runs independent chains.
+  double _maxTemperature_{1.0};
+
+  // The scale of the random offset of the starting point of each chain in
+  // units of the proposal width.  The chains start from over-dispersed
+  // points so that the R-hat is meaningful.
+  double _chainDispersion_{1.0};
+
+  // The number of steps between the exchange trials of the chains at
+  // different temperatures.
+  int _swapStride_{10};
+
+  // The number of steps between the printouts of the Gelman-Rubin R-hat
+  // computed for the chains at T=1 over the current cycle.
+  int _rHatStride_{1000};
+
   //////////////////////////////////////////
   // Manage the running of the MCMC
 
@@ -234,6 +267,8 @@ private:
     /// evalFit.
     std::unique_ptr<ROOT::Math::Functor> functor{};
     std::vector<double> x;
+    /// The likelihood is tempered when running several chains.
+    double temperature{1.0};
     double operator() (const Vector& point) {
       LogThrowIf(functor == nullptr, "Functor is not initialized");
       // Copy the point into a local vector since there is no guarrantee that
@@ -244,7 +279,7 @@ private:
       // GUNDAM doesn't use the log likelihood it uses negative two times the
       // log likelihood (e.g. approximately chi-squared).  TSimpleMCMC must
       // have the true Log(Likelihood), so make the change here.
-      return -0.5*(*functor)(x.data());
+      return -0.5*(*functor)(x.data())/temperature;
     }
   };
 
@@ -267,6 +302,10 @@ private:
   typedef TSimpleMCMC<PrivateProxyLikelihood,TProposeAdaptiveStep> AdaptiveStepMCMC;
   void setupAndRunAdaptiveStep(AdaptiveStepMCMC& mcmc);
 
+  /// Setup the proposal of an adaptive step chain.  This returns the
+  /// starting point.
+  Vector setupAdaptiveProposal(AdaptiveStepMCMC& mcmc);
+
   /////////////////////////////////////////////////////////////////
   // Support routines for the adaptive step.
 
@@ -285,6 +324,88 @@ private:
 
   /// Set the default proposal based on the FitParameter values and steps.
   bool adaptiveDefaultProposalCovariance(AdaptiveStepMCMC& mcmc,Vector& prior);
+
+  /////////////////////////////////////////////////////////////////
+  // Support routines to run several adaptive step chains.
+
+  /// The state of one of the chains when several chains are run together.
+  /// The accepted point is saved in the tree of the chain the same way as
+  /// _point_, _model_, ... are saved for a single chain.
+  struct ChainState {
+    double temperature{1.0};
+    std::unique_ptr<AdaptiveStepMCMC> mcmc{};
+    TTree* tree{nullptr};
+
+    // The accepted point
+    std::vector<float> point{};
+    std::vector<float> model{};
+    std::vector<float> uncertainty{};
+    std::vector<float> saveModel{};
+    std::vector<float> saveUncertainty{};
+    float llhStatistical{0.0};
+    float llhPenalty{0.0};
+    double llh{0.0}; // Not tempered
+
+    // The last proposed point
+    std::vector<double> trialParameterList{};
+    std::vector<float> trialPoint{};
+    std::vector<float> trialModel{};
+    std::vector<float> trialUncertainty{};
+    float trialLlhStatistical{0.0};
+    float trialLlhPenalty{0.0};
+    double trialLlh{0.0};
+    bool isTrialValid{false};
+
+    // Exchanges with the next (hotter) chain
+    int nbSwapTrials{0};
+    int nbSwapAccepted{0};
+
+    // Running sums of the accepted points for the R-hat monitor
+    std::vector<double> pointSumList{};
+    std::vector<double> pointSqSumList{};
+    double nbPointSums{0};
+  };
+  std::vector<ChainState> _chainList_{};
+
+  // One propagator replica per chain if the dials can be evaluated by the
+  // replicas.  Otherwise the chains are propagated one after the other.
+  PropagatorReplicaPool _replicaPool_{"AdaptiveMcmc::propagateReplicas"};
+
+  // The titles of the entries of _point_
+  std::vector<std::string> _pointTitleList_{};
+
+  /// Run the chains, each one is saved in a separate tree.
+  void setupAndRunAdaptiveChains();
+
+  /// Throw an over-dispersed starting point for a chain around the prior.
+  /// The offsets are scaled by the proposal width of each dimension, and
+  /// the throw is repeated until the point is valid.
+  Vector throwChainStart(AdaptiveStepMCMC& mcmc, const Vector& prior);
+
+  /// Make one step on every chain.  The proposed points are evaluated
+  /// together before the Metropolis condition is applied to each chain.
+  void stepChains(bool fillModel);
+
+  /// Evaluate the likelihood at the proposed points of all the chains.
+  void evalChainProposals(bool fillModel);
+
+  /// Copy the parameters and the predicted histograms currently held by the
+  /// propagator to the proposed point of a chain.
+  void readChainTrialPoint(ChainState& chain);
+  void readChainTrialModel(ChainState& chain, bool fillModel);
+
+  /// Make the proposed point the accepted point of a chain.
+  static void acceptChainTrial(ChainState& chain);
+
+  /// Try to exchange the states of the adjacent chains at different
+  /// temperatures.
+  void swapChains();
+
+  /// Accumulate the accepted points of the chains at T=1, and print the
+  /// Gelman-Rubin R-hat.
+  void resetChainStatistics();
+  void accumulateChainStatistics();
+  void printChainStatistics(const std::string& header);
 };
 #endif // GUNDAM_ADAPTIVE_MCMC_H
 
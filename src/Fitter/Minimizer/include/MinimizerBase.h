@@ -10,6 +10,7 @@
 #include "LikelihoodInterface.h"
 #include "Parameter.h"
 #include "JsonBaseClass.h"
+#include "AsyncRecordQueue.h"
 
 #include "GenericToolbox.Utils.h"
 
@@ -17,6 +18,9 @@
 
 #include <vector>
 #include <string>
+#include <chrono>
+#include <mutex>
+#include <atomic>
 
 /*
   The MinimizerBase is an abstract layer (purely virtual) that provides
@@ -61,6 +65,13 @@ protected:
     GenericToolbox::VariablesMonitor convergenceMonitor;
 
     std::unique_ptr<TTree> historyTree{nullptr};
+    struct HistoryEntry{
+      int nbEvalLikelihoodCalls{0};
+      double totalLikelihood{0};
+      double statLikelihood{0};
+      double penaltyLikelihood{0};
+    };
+    HistoryEntry historyEntry{};
 
     struct GradientDescentMonitor{
       bool isEnabled{false};
@@ -70,8 +81,55 @@ protected:
         double llh;
       };
       std::vector<GradientStepPoint> stepPointList{};
+
+      // the parameter states are written from these values in a copy of the template
+      JsonType parStateTemplate{};
+      std::vector<const Parameter*> parStatePtrList{};
     };
     GradientDescentMonitor gradientDescentMonitor{};
+
+    /// Compact state of an evalFit() call. Everything else (history tree,
+    /// gradient steps, terminal output) is done from these records by a
+    /// background thread.
+    struct Record{
+      int nbEvalLikelihoodCalls{0};
+      double totalLikelihood{0};
+      double statLikelihood{0};
+      double penaltyLikelihood{0};
+      std::vector<double> fitParValueList{};
+      std::vector<char> fitParIsFixedList{};
+      std::vector<char> fitParIsEnabledList{};
+      std::vector<double> parStateValueList{}; // only with the gradient descent monitor
+
+      // sampled at the refresh rate of the convergence monitor
+      bool isDisplayed{false};
+      int nbDegreeOfFreedom{0};
+      std::string minimizerTitle{};
+      std::string stateTitleMonitor{};
+      std::vector<std::string> timerStrList{};
+      double ramUsage{0}; // read by the fit thread, the process stats aren't thread-safe
+      double cpuPercent{0};
+      std::vector<double> fitParDisplayValueList{}; // in the fit space
+      std::vector<std::string> fitParSetTitleList{};
+    };
+    std::chrono::steady_clock::time_point lastDisplayTime{};
+    std::vector<double> lastFitParValueList{}; // background thread only
+
+    /// The background thread never prints nor fills the history tree: its
+    /// output is handed to the fit thread, which prints it with the rest of
+    /// the log and fills the tree it owns.
+    struct PendingOutput{
+      bool isWarning{false};
+      std::string str{};
+    };
+    std::mutex pendingOutputMutex{};
+    std::vector<PendingOutput> pendingOutputList{};
+    std::vector<HistoryEntry> pendingHistoryList{};
+    std::atomic<bool> hasPendingOutput{false};
+
+    /// Has to be flushed before reading the monitor from the main thread.
+    /// Declared last: the thread is joined before the rest gets destroyed.
+    AsyncRecordQueue<Record> recordQueue{};
   };
 
 public:
@@ -98,6 +156,16 @@ public:
   /// defined by the vector of pointers to Parameter returned by the LikelihoodInterface.
   virtual double evalFit( const double* parArray_ );
 
+  /// Fill the gradient of the likelihood with respect to the minimizer
+  /// parameters using the analytic derivatives provided by the
+  /// LikelihoodInterface. The gradient array must have the size of the
+  /// minimizer parameter list.
+  virtual void evalFitGradient( const double* parArray_, double* gradient_ );
+
+  /// Single component of the gradient. The full gradient is evaluated once
+  /// per point and cached, as minimizers query the coordinates one by one.
+  virtual double evalFitDerivative( const double* parArray_, unsigned int iCoord_ );
+
   // default calcErrors() is not defined
   [[nodiscard]] virtual bool isErrorCalcEnabled() const { return false; }
 
@@ -138,6 +206,21 @@ protected:
   LikelihoodInterface& getLikelihoodInterface();
   [[nodiscard]] const LikelihoodInterface& getLikelihoodInterface() const;
 
+  /// Fill a monitor record of the current evalFit() call. Called from the
+  /// fit thread: no allocation nor formatting, unless a refresh of the
+  /// terminal output is due.
+  void pushMonitorRecord();
+  /// Called from the background thread of the monitor
+  void processMonitorRecord(const Monitor::Record& record_);
+  /// Hand a printout of the background thread to the fit thread
+  void addMonitorOutput(bool isWarning_, const std::string& str_);
+  /// Print the output of the background thread and fill the history tree.
+  /// Called from the fit thread.
+  void printMonitorOutput();
+  /// Wait for the background thread to process every record and print its
+  /// output. Has to be called before reading the monitor.
+  void flushMonitor();
+
   // Get the vector of parameters being fitted.  This is a local convenience
   // function to get the vector of fit parameter pointers.  The actual vector
   // lives in the likelihood.
@@ -155,6 +238,11 @@ protected:
   std::vector<Parameter*> _minimizerParameterPtrList_{};
   Monitor _monitor_{};
 
+  // analytic gradient buffers
+  std::vector<std::vector<double>> _parSetGradientList_{};
+  std::vector<double> _gradientPointBuffer_{};
+  std::vector<double> _gradientBuffer_{};
+
 
 private:
   /// Save a copy of the address of the engine that owns this object.
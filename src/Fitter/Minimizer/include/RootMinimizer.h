@@ -16,6 +16,7 @@
 #include "Math/Minimizer.h"
 #include "Math/Functor.h"
 #include "TDirectory.h"
+#include "TMatrixDSym.h"
 #include "nlohmann/json.hpp"
 
 #include <memory>
@@ -49,10 +50,24 @@ public:
   void saveMinimizerSettings(TDirectory* saveDir_) const;
 
 protected:
-  void writePostFitData(TDirectory* saveDir_);
+  /// Writes the post-fit errors. The covariance matrix of the minimizer is
+  /// used unless an externally computed one is provided (in fit space).
+  void writePostFitData(TDirectory* saveDir_, const TMatrixDSym* covarianceMatrix_ = nullptr);
   void updateCacheToBestfitPoint();
   void saveGradientSteps();
 
+  /// Finite-difference Hessian around the best fit point. The stencil points
+  /// are propagated by batches on propagator replicas, and are kept within the
+  /// parameter limits (one-sided differences near a limit). Returns false if the
+  /// replicas can't be used or if the Hessian is not positive definite.
+  bool evalParallelHessian(TMatrixDSym& covarianceMatrix_);
+  /// Returns false if an error differs by more than parallelHesseTolerance
+  bool compareWithMinuitHesse(const TMatrixDSym& covarianceMatrix_) const;
+
+  /// Compare the analytic gradient with central finite differences at the
+  /// current point. Throws if they differ by more than the tolerance.
+  void checkAnalyticGradient();
+
 private:
 
   // Parameters
@@ -60,14 +75,22 @@ private:
   bool _restoreStepSizeBeforeHesse_{false};
   bool _generatedPostFitParBreakdown_{false};
   bool _generatedPostFitEigenBreakdown_{false};
+  bool _useAnalyticGradient_{false};
+  bool _checkParallelHesse_{false};
+  bool _checkAnalyticGradient_{false};
 
   int _strategy_{1};
+  int _parallelHesseNbReplicas_{0};
   int _printLevel_{2};
   int _simplexStrategy_{1};
 
   double _tolerance_{1E-4};
   double _stepSizeScaling_{1};
   double _simplexToleranceLoose_{1000.};
+  double _parallelHesseStepFraction_{0.2};
+  double _parallelHesseTolerance_{1E-2};
+  double _analyticGradientStepFraction_{0.1};
+  double _analyticGradientTolerance_{1E-3};
 
   unsigned int _maxIterations_{500};
   unsigned int _maxFcnCalls_{1000000000};
@@ -83,6 +106,10 @@ private:
   /// A functor that can be called by Minuit or anybody else.  This wraps
   /// evalFit.
   ROOT::Math::Functor _functor_{};
+
+  /// Same as _functor_, but also provides the analytic gradient through
+  /// evalFitDerivative. Used when "useAnalyticGradient" is enabled.
+  ROOT::Math::GradFunctor _gradFunctor_{};
   std::unique_ptr<ROOT::Math::Minimizer> _rootMinimizer_{nullptr};
 
 };
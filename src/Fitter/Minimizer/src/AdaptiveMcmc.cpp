@@ -12,6 +12,9 @@
 #include "Logger.h"
 
 #include <locale>
+#include <algorithm>
+#include <limits>
+#include <sstream>
 
 LoggerInit([]{
   Logger::setUserHeaderStr("[MCMC]");
@@ -204,6 +207,66 @@ void AdaptiveMcmc::readConfigImpl(){
 
   // Set the step size for the simple proposal.
   _simpleSigma_ = GenericToolbox::Json::fetchValue(_config_, "simpleSigma", _simpleSigma_);
+
+  ///////////////////////////////////////////////////////////////
+  // Get parameters to run several chains.
+
+  // The number of chains run together.  The proposed points of the chains
+  // are propagated concurrently, so this should usually be about the number
+  // of threads.  Each chain is saved in its own tree, the first one keeping
+  // the name of the single chain tree.
+  _nbChains_ = GenericToolbox::Json::fetchValue(_config_, "nbChains", _nbChains_);
+
+  // The temperature ladder of the chains.  Chains at T>1 explore a flattened
+  // posterior, and exchange their state with the neighbouring chains.  The
+  // temperatures are either explicitly listed, or spread geometrically
+  // between 1 and maxTemperature.  The default runs independent chains.
+  _chainTemperatures_ = GenericToolbox::Json::fetchValue(
+      _config_, "chainTemperatures", _chainTemperatures_);
+  _maxTemperature_ = GenericToolbox::Json::fetchValue(
+      _config_, "maxTemperature", _maxTemperature_);
+
+  // The starting points of the chains are thrown around the prior with a
+  // width of chainDispersion times the proposal width.  The first chain
+  // always starts from the prior.  A zero value starts all the chains from
+  // the same point.
+  _chainDispersion_ = GenericToolbox::Json::fetchValue(
+      _config_, "chainDispersion", _chainDispersion_);
+
+  // The number of steps between the exchange trials.
+  _swapStride_ = GenericToolbox::Json::fetchValue(_config_, "swapStride", _swapStride_);
+
+  // The number of steps between the printouts of the R-hat of the chains at
+  // T=1.  The R-hat is calculated over the steps of the current cycle.
+  _rHatStride_ = GenericToolbox::Json::fetchValue(_config_, "rHatStride", _rHatStride_);
+
+  LogThrowIf(_nbChains_ < 1, "Invalid number of chains: " << _nbChains_);
+  LogThrowIf(_chainDispersion_ < 0.0,
+             "Invalid chain dispersion: " << _chainDispersion_);
+  LogThrowIf(_nbChains_ > 1 and _proposalName_ != "adaptive",
+             "Several chains can only be run with the adaptive proposal.");
+  if (_chainTemperatures_.empty()) {
+    LogThrowIf(_maxTemperature_ < 1.0,
+               "The maximum temperature must be at least 1: " << _maxTemperature_);
+    for (int iChain = 0; iChain < _nbChains_; ++iChain) {
+      double frac = (_nbChains_ > 1) ? double(iChain)/(_nbChains_-1) : 0.0;
+      _chainTemperatures_.emplace_back(std::pow(_maxTemperature_, frac));
+    }
+  }
+  LogThrowIf(int(_chainTemperatures_.size()) != _nbChains_,
+             "The number of chain temperatures ("
+             << _chainTemperatures_.size()
+             << ") doesn't match the number of chains ("
+             << _nbChains_ << ")");
+  for (size_t iChain = 0; iChain < _chainTemperatures_.size(); ++iChain) {
+    LogThrowIf(_chainTemperatures_[iChain] < 1.0,
+               "Chain temperatures must be at least 1: "
+               << GenericToolbox::toString(_chainTemperatures_));
+    LogThrowIf(iChain > 0
+               and _chainTemperatures_[iChain] < _chainTemperatures_[iChain-1],
+               "Chain temperatures must be increasing: "
+               << GenericToolbox::toString(_chainTemperatures_));
+  }
 }
 void AdaptiveMcmc::initializeImpl(){
   MinimizerBase::initializeImpl();
@@ -487,7 +550,7 @@ bool AdaptiveMcmc::adaptiveLoadProposalCovariance( AdaptiveStepMCMC& mcmc,
 
   return true;
 }
-void AdaptiveMcmc::setupAndRunAdaptiveStep( AdaptiveStepMCMC& mcmc) {
+Vector AdaptiveMcmc::setupAdaptiveProposal( AdaptiveStepMCMC& mcmc) {
 
   mcmc.GetProposeStep().SetDim(_minimizerParameterPtrList_.size());
   mcmc.GetLogLikelihood().functor = std::make_unique<ROOT::Math::Functor>(this, &AdaptiveMcmc::evalFitValid, _minimizerParameterPtrList_.size());
@@ -513,6 +576,12 @@ void AdaptiveMcmc::setupAndRunAdaptiveStep( AdaptiveStepMCMC& mcmc) {
     adaptiveDefaultProposalCovariance(mcmc,prior);
   }
 
+  return prior;
+}
+void AdaptiveMcmc::setupAndRunAdaptiveStep( AdaptiveStepMCMC& mcmc) {
+
+  Vector prior = setupAdaptiveProposal(mcmc);
+
   // Fill the initial point.
   fillPoint();
 
@@ -774,6 +843,463 @@ void AdaptiveMcmc::setupAndRunSimpleStep( SimpleStepMCMC& mcmc) {
 
 }
 
+void AdaptiveMcmc::setupAndRunAdaptiveChains() {
+
+  LogInfo << "Running " << _nbChains_ << " chains with the temperatures "
+          << GenericToolbox::toString(_chainTemperatures_) << std::endl;
+
+  // The trees keep the addresses of the chain buffers, so the list is not
+  // resized after this point.
+  _chainList_.clear();
+  _chainList_.resize(_nbChains_);
+  for (int iChain = 0; iChain < _nbChains_; ++iChain) {
+    auto& chain = _chainList_[iChain];
+    chain.temperature = _chainTemperatures_[iChain];
+
+    // The first chain is saved in the same tree as a single chain.
+    std::string treeName = _outTreeName_;
+    if (iChain > 0) treeName += "_chain" + std::to_string(iChain);
+    chain.tree = new TTree(treeName.c_str(), "Tree of accepted points");
+    chain.tree->Branch("Points",&chain.point);
+    chain.tree->Branch("LLHPenalty",&chain.llhPenalty);
+    chain.tree->Branch("LLHStatistical",&chain.llhStatistical);
+    chain.tree->Branch("Models",&chain.saveModel);
+    chain.tree->Branch("ModelUncertainty",&chain.saveUncertainty);
+    chain.tree->Branch("Temperature",&chain.temperature);
+
+    chain.trialParameterList.resize(_minimizerParameterPtrList_.size());
+    chain.mcmc = std::make_unique<AdaptiveStepMCMC>(chain.tree);
+    chain.mcmc->GetLogLikelihood().temperature = chain.temperature;
+  }
+
+  // Each chain gets its own replica of the propagator
+  _replicaPool_.clear();
+  if (PropagatorReplica::isSupported(getPropagator())) {
+    LogInfo << "The proposed points are propagated on "
+            << _nbChains_ << " propagator replicas." << std::endl;
+    _replicaPool_.build(getPropagator(), _nbChains_);
+  }
+  else {
+    LogAlert << "Some dials can't be evaluated by the propagator replicas."
+             << " The proposed points will be propagated one at a time."
+             << std::endl;
+  }
+
+  int nbColdChains = int(std::count_if(
+      _chainList_.begin(), _chainList_.end(),
+      [](const ChainState& chain_){ return chain_.temperature == 1.0; }));
+  LogAlertIf(nbColdChains < 2)
+      << "The R-hat needs at least two chains at T=1:"
+      << " the convergence will not be monitored." << std::endl;
+
+  // Start the chains from over-dispersed points around the prior, and
+  // restore them independently.  Each chain is restored from the tree with
+  // the same name.  Either all the chains are restored, or none of them.
+  int nbRestored = 0;
+  for (int iChain = 0; iChain < _nbChains_; ++iChain) {
+    auto& chain = _chainList_[iChain];
+    auto& mcmc = *chain.mcmc;
+    Vector prior = setupAdaptiveProposal(mcmc);
+
+    // Fill the initial point.
+    readChainTrialPoint(chain);
+    readChainTrialModel(chain, true);
+    acceptChainTrial(chain);
+
+    Vector start{prior};
+    if (iChain > 0 and _chainDispersion_ > 0.0) {
+      start = throwChainStart(mcmc, prior);
+    }
+
+    mcmc.Start(start, _saveBurnin_);
+    mcmc.GetProposeStep().SetAcceptanceWindow(_adaptiveWindow_);
+    mcmc.SetStepRMSWindow(_adaptiveWindow_);
+
+    std::string restorationTree
+        = std::string("FitterEngine/fit/") + chain.tree->GetName();
+    if (adaptiveRestoreState(mcmc,_adaptiveRestore_, restorationTree)) {
+      ++nbRestored;
+    }
+
+    // The propagator is now holding the starting point of this chain.
+    readChainTrialPoint(chain);
+    readChainTrialModel(chain, true);
+    chain.trialLlh = -2.0*mcmc.GetAcceptedLogLikelihood()*chain.temperature;
+    acceptChainTrial(chain);
+  }
+
+  LogThrowIf(nbRestored > 0 and nbRestored < _nbChains_,
+             "Only " << nbRestored << " of the " << _nbChains_
+             << " chains were restored from " << _adaptiveRestore_);
+  bool restored = (nbRestored == _nbChains_);
+
+  // Burn-in cycles, same as setupAndRunAdaptiveStep() for each chain.
+  if (not restored and _burninCycles_ > 0 and _burninLength_ > 0) {
+    for (auto& chain : _chainList_) {
+      auto& mcmc = *chain.mcmc;
+      mcmc.GetProposeStep().SetCovarianceWindow(_burninCovWindow_);
+      mcmc.GetProposeStep().SetAcceptanceWindow(_burninWindow_);
+      mcmc.SetStepRMSWindow(_burninWindow_);
+      mcmc.GetProposeStep()
+          .SetCovarianceUpdateDeweighting(_burninCovDeweighting_);
+      mcmc.GetProposeStep().UpdateProposal();
+      mcmc.GetProposeStep().SetCovarianceFrozen(false);
+    }
+    for (int cycle = 0; cycle < _burninCycles_; ++cycle) {
+      LogInfo << "Start burn-In chain " << cycle << std::endl;
+      for (auto& chain : _chainList_) {
+        auto& mcmc = *chain.mcmc;
+        mcmc.GetProposeStep().SetNextUpdate(2*_burninLength_*_burninCycles_);
+        mcmc.GetProposeStep()
+            .SetCovarianceUpdateDeweighting(_burninCovDeweighting_);
+        mcmc.GetProposeStep().SetAcceptanceRigidity(
+            (cycle < _burninFreezeAfter_) ? 2.0 : -1);
+      }
+      LogInfo << "Burn-in step length is "
+              << ((cycle < _burninFreezeAfter_) ? "updated" : "frozen")
+              << std::endl;
+      resetChainStatistics();
+      for (int i = 0; i < _burninLength_; ++i) {
+        stepChains(false);
+        for (auto& chain : _chainList_) {
+          auto& mcmc = *chain.mcmc;
+          if (_modelStride_ > 0
+              and 0 == (mcmc.GetProposeStep().GetTrials()%_modelStride_)) {
+            chain.saveModel.assign(chain.model.begin(), chain.model.end());
+            chain.saveUncertainty.assign(chain.uncertainty.begin(),
+                                         chain.uncertainty.end());
+          }
+          if (_saveBurnin_) mcmc.SaveStep(_burninLength_ <= (i+1));
+        }
+        accumulateChainStatistics();
+        if(_burninLength_ > 100 && !(i%(_burninLength_/100))){
+          LogInfo << "Burn-in: " << cycle
+                  << " step: " << i << "/" << _burninLength_ << " "
+                  << i*100./_burninLength_ << "%"
+                  << std::endl;
+        }
+        if (_rHatStride_ > 0 and 0 == ((i+1)%_rHatStride_)) {
+          printChainStatistics("Burn-in: " + std::to_string(cycle)
+                               + " step: " + std::to_string(i+1));
+        }
+      }
+      printChainStatistics("Burn-in: " + std::to_string(cycle) + " complete");
+      for (auto& chain : _chainList_) {
+        auto& mcmc = *chain.mcmc;
+        mcmc.GetProposeStep().UpdateProposal();
+        if (cycle < _burninResets_) {
+          Vector saveCenter{mcmc.GetProposeStep().GetEstimatedCenter()};
+          mcmc.GetProposeStep().ResetProposal();
+          if (_adaptiveCovTrials_ > 0) {
+            mcmc.GetProposeStep().SetCovarianceTrials(_adaptiveCovTrials_);
+            mcmc.GetProposeStep().SetEstimatedCenter(saveCenter);
+            mcmc.GetProposeStep().SetEstimatedCenterTrials(_adaptiveCovTrials_);
+          }
+        }
+      }
+    }
+    LogInfo << "Finished burn-in chains" << std::endl;
+  }
+
+  ////////////////////////////////////////////////////////////////
+  // Run the main cycles.
+  for (auto& chain : _chainList_) {
+    auto& mcmc = *chain.mcmc;
+    mcmc.GetProposeStep().SetCovarianceWindow(_adaptiveCovWindow_);
+    mcmc.GetProposeStep().SetAcceptanceWindow(_adaptiveWindow_);
+    mcmc.SetStepRMSWindow(_adaptiveWindow_);
+    mcmc.GetProposeStep()
+        .SetCovarianceUpdateDeweighting(_adaptiveCovDeweighting_);
+  }
+  for (int cycle = 0; cycle < _cycles_; ++cycle){
+    LogInfo << "Start run chain " << cycle << std::endl;
+    LogInfo << "Step correlations are "
+            << ((cycle < _adaptiveFreezeCorrelations_) ? "updated" : "frozen")
+            << ", step length is "
+            << ((cycle < _adaptiveFreezeAfter_) ? "updated" : "frozen")
+            << std::endl;
+    for (auto& chain : _chainList_) {
+      auto& mcmc = *chain.mcmc;
+      mcmc.GetProposeStep().UpdateProposal();
+      mcmc.GetProposeStep().SetCovarianceFrozen(
+          not (cycle < _adaptiveFreezeCorrelations_));
+      mcmc.GetProposeStep().SetNextUpdate(2*_steps_*_cycles_);
+      mcmc.GetProposeStep()
+          .SetCovarianceUpdateDeweighting(_adaptiveCovDeweighting_);
+      mcmc.GetProposeStep().SetAcceptanceRigidity(
+          (cycle < _adaptiveFreezeAfter_) ? 2.0 : -1);
+    }
+    resetChainStatistics();
+    for (int i = 0; i < _steps_; ++i) {
+      stepChains(true);
+      for (auto& chain : _chainList_) {
+        auto& mcmc = *chain.mcmc;
+        if (not _saveRawSteps_) mcmc.ClearSavedAccepted();
+        if (_modelStride_ > 0
+            and 0 == (mcmc.GetProposeStep().GetTrials()%_modelStride_)) {
+          chain.saveModel.assign(chain.model.begin(), chain.model.end());
+          chain.saveUncertainty.assign(chain.uncertainty.begin(),
+                                       chain.uncertainty.end());
+        }
+        mcmc.SaveStep(false);
+      }
+      accumulateChainStatistics();
+      if(_steps_ > 100 && !(i%(_steps_/100))){
+        LogInfo << "Chain: " << cycle
+                << " step: " << i << "/" << _steps_ << " "
+                << i*100./_steps_ << "%"
+                << std::endl;
+      }
+      if (_rHatStride_ > 0 and 0 == ((i+1)%_rHatStride_)) {
+        printChainStatistics("Chain: " + std::to_string(cycle)
+                             + " step: " + std::to_string(i+1));
+      }
+    }
+    // Make a final step and then save it with the covariance information.
+    stepChains(true);
+    for (auto& chain : _chainList_) chain.mcmc->SaveStep(true);
+    printChainStatistics("Chain: " + std::to_string(cycle) + " complete");
+    LogInfo << "Chain: " << cycle << " complete"
+            << " Run Length: " << _steps_
+            << " -- Saving state"
+            << std::endl;
+  }
+  LogInfo << "Finished running chains" << std::endl;
+
+  _replicaPool_.clear();
+}
+void AdaptiveMcmc::stepChains(bool fillModel) {
+  for (auto& chain : _chainList_) chain.mcmc->Propose(false);
+
+  evalChainProposals(fillModel);
+
+  // Apply the Metropolis condition with the tempered likelihood
+  for (auto& chain : _chainList_) {
+    if (chain.mcmc->Decide(-0.5*chain.trialLlh/chain.temperature, false)) {
+      acceptChainTrial(chain);
+    }
+  }
+
+  if (_swapStride_ > 0
+      and 0 == (_chainList_.front().mcmc->GetProposeStep().GetTrials()%_swapStride_)) {
+    swapChains();
+  }
+}
+void AdaptiveMcmc::evalChainProposals(bool fillModel) {
+  for (auto& chain : _chainList_) {
+    const Vector& proposed = chain.mcmc->GetProposed();
+    std::copy(proposed.begin(), proposed.end(), chain.trialParameterList.begin());
+  }
+
+  if (_replicaPool_.empty()) {
+    for (auto& chain : _chainList_) {
+      chain.trialLlh = evalFitValid(chain.trialParameterList.data());
+      chain.isTrialValid = std::isfinite(chain.trialLlh);
+      readChainTrialPoint(chain);
+      readChainTrialModel(chain, fillModel);
+    }
+    return;
+  }
+
+  auto& propagator = getPropagator();
+
+  // The parameters are moved in a single thread, then only the dial inputs
+  // are copied to the replicas.  The bins of each chain are put back in the
+  // samples: the likelihood is evaluated as for a single chain.
+  _replicaPool_.evalBatch(
+      int(_chainList_.size()),
+      [&](int iChain_){
+        auto& chain = _chainList_[iChain_];
+        int iFitPar{0};
+        for( auto* parPtr : _minimizerParameterPtrList_ ){
+          parPtr->setParameterValue(
+              _useNormalizedFitSpace_ ?
+              ParameterSet::toRealParValue(chain.trialParameterList[iFitPar++], *parPtr) :
+              chain.trialParameterList[iFitPar++]
+          );
+        }
+        propagator.updateDialInputs();
+        getLikelihoodInterface().evalPenaltyLikelihood();
+        readChainTrialPoint(chain);
+        if (_monitor_.isEnabled) _monitor_.nbEvalLikelihoodCalls++;
+
+        // Points out of the valid range are rejected without being propagated.
+        chain.isTrialValid = hasValidParameterValues();
+        if (not chain.isTrialValid) {
+          chain.trialLlh = std::numeric_limits<double>::infinity();
+        }
+        return chain.isTrialValid;
+      },
+      [&](int iChain_, PropagatorReplica& replica_){
+        auto& chain = _chainList_[iChain_];
+        replica_.copyToSampleSet(propagator.getSampleSet());
+        getLikelihoodInterface().evalStatLikelihood();
+        getLikelihoodInterface().getBuffer().penaltyLikelihood = chain.trialLlhPenalty;
+        getLikelihoodInterface().getBuffer().updateTotal();
+        chain.trialLlh = getLikelihoodInterface().getLastLikelihood();
+        readChainTrialModel(chain, fillModel);
+      }
+  );
+}
+Vector AdaptiveMcmc::throwChainStart(AdaptiveStepMCMC& mcmc,
+                                     const Vector& prior) {
+
+  const int nbTrials{100};
+  Vector start(prior.size());
+  for (int iTrial = 0; iTrial < nbTrials; ++iTrial) {
+    for (size_t iPar = 0; iPar < prior.size(); ++iPar) {
+      start[iPar] = prior[iPar] + gRandom->Gaus(
+          0.0, _chainDispersion_*mcmc.GetProposeStep().GetProposalWidth(int(iPar)));
+    }
+    if (std::isfinite(evalFitValid(start.data()))) return start;
+  }
+
+  LogAlert << "No valid over-dispersed starting point after " << nbTrials
+           << " throws: the chain starts from the prior." << std::endl;
+  return prior;
+}
+void AdaptiveMcmc::readChainTrialPoint(ChainState& chain) {
+  // Same as fillPoint()
+  chain.trialPoint.clear();
+  for (const ParameterSet& parSet: getPropagator().getParametersManager().getParameterSetsList()) {
+    for (const Parameter& iPar : parSet.getParameterList()) {
+      chain.trialPoint.emplace_back(iPar.getParameterValue());
+    }
+  }
+  chain.trialLlhPenalty = getLikelihoodInterface().getLastPenaltyLikelihood();
+}
+void AdaptiveMcmc::readChainTrialModel(ChainState& chain, bool fillModel) {
+  // Same as fillPoint()
+  chain.trialLlhStatistical = getLikelihoodInterface().getLastStatLikelihood();
+  chain.trialModel.clear();
+  chain.trialUncertainty.clear();
+  if (not fillModel) return;
+  for (const Sample& sample
+      : getPropagator().getSampleSet().getSampleList()) {
+    auto& hist = sample.getMcContainer().getHistogram();
+    for (int i = 1; i < hist.nBins; ++i) {
+      chain.trialModel.push_back( hist.binList[i-1].content );
+      chain.trialUncertainty.push_back( hist.binList[i-1].error );
+    }
+  }
+}
+void AdaptiveMcmc::acceptChainTrial(ChainState& chain) {
+  chain.point.assign(chain.trialPoint.begin(), chain.trialPoint.end());
+  chain.model.assign(chain.trialModel.begin(), chain.trialModel.end());
+  chain.uncertainty.assign(chain.trialUncertainty.begin(),
+                           chain.trialUncertainty.end());
+  chain.saveModel.clear();
+  chain.saveUncertainty.clear();
+  chain.llhStatistical = chain.trialLlhStatistical;
+  chain.llhPenalty = chain.trialLlhPenalty;
+  chain.llh = chain.trialLlh;
+}
+void AdaptiveMcmc::swapChains() {
+  for (size_t iChain = 0; iChain+1 < _chainList_.size(); ++iChain) {
+    auto& cold = _chainList_[iChain];
+    auto& hot = _chainList_[iChain+1];
+    if (cold.temperature == hot.temperature) continue;
+    ++cold.nbSwapTrials;
+
+    // Metropolis condition to exchange the states: the ratio of the tempered
+    // posteriors after and before the exchange.
+    double delta = 0.5*(1.0/cold.temperature - 1.0/hot.temperature)
+                   *(cold.llh - hot.llh);
+    if (std::isnan(delta)) continue;
+    if (delta < 0.0 and delta < std::log(gRandom->Uniform())) continue;
+    ++cold.nbSwapAccepted;
+
+    // The temperatures and the proposals stay with the chains, only the
+    // accepted points are exchanged.
+    Vector coldAccepted{cold.mcmc->GetAccepted()};
+    cold.mcmc->SetAccepted(hot.mcmc->GetAccepted(),
+                           -0.5*hot.llh/cold.temperature);
+    hot.mcmc->SetAccepted(coldAccepted, -0.5*cold.llh/hot.temperature);
+    std::swap(cold.llh, hot.llh);
+    std::swap(cold.llhStatistical, hot.llhStatistical);
+    std::swap(cold.llhPenalty, hot.llhPenalty);
+    cold.point.swap(hot.point);
+    cold.model.swap(hot.model);
+    cold.uncertainty.swap(hot.uncertainty);
+  }
+}
+void AdaptiveMcmc::resetChainStatistics() {
+  for (auto& chain : _chainList_) {
+    chain.pointSumList.assign(chain.point.size(), 0.0);
+    chain.pointSqSumList.assign(chain.point.size(), 0.0);
+    chain.nbPointSums = 0;
+  }
+}
+void AdaptiveMcmc::accumulateChainStatistics() {
+  for (auto& chain : _chainList_) {
+    if (chain.temperature != 1.0) continue;
+    for (size_t iPar = 0; iPar < chain.point.size(); ++iPar) {
+      chain.pointSumList[iPar] += chain.point[iPar];
+      chain.pointSqSumList[iPar] += double(chain.point[iPar])*chain.point[iPar];
+    }
+    chain.nbPointSums += 1;
+  }
+}
+void AdaptiveMcmc::printChainStatistics(const std::string& header) {
+  std::stringstream ss;
+  ss << header << " -- Acceptance:";
+  for (auto& chain : _chainList_) {
+    ss << " " << chain.mcmc->GetProposeStep().GetAcceptance();
+  }
+  for (size_t iChain = 0; iChain+1 < _chainList_.size(); ++iChain) {
+    auto& chain = _chainList_[iChain];
+    if (chain.nbSwapTrials == 0) continue;
+    ss << std::endl << "  Exchanges T=" << chain.temperature
+       << " <-> T=" << _chainList_[iChain+1].temperature << ": "
+       << chain.nbSwapAccepted << "/" << chain.nbSwapTrials;
+  }
+
+  // Gelman-Rubin R-hat of each parameter for the chains at T=1
+  std::vector<const ChainState*> coldChainList;
+  for (auto& chain : _chainList_) {
+    if (chain.temperature == 1.0) coldChainList.emplace_back(&chain);
+  }
+  double n = coldChainList.empty() ? 0 : coldChainList.front()->nbPointSums;
+  if (coldChainList.size() >= 2 and n >= 2) {
+    double m = double(coldChainList.size());
+    double maxRHat{0};
+    int maxRHatIndex{-1};
+    int nbAboveThreshold{0};
+    for (size_t iPar = 0; iPar < _point_.size(); ++iPar) {
+      double meanOfMeans{0};
+      double withinVariance{0};
+      for (auto* chainPtr : coldChainList) {
+        double mean = chainPtr->pointSumList[iPar]/n;
+        meanOfMeans += mean;
+        withinVariance += (chainPtr->pointSqSumList[iPar] - n*mean*mean)/(n-1);
+      }
+      meanOfMeans /= m;
+      withinVariance /= m;
+      // Fixed parameters don't move
+      if (not (withinVariance > 0)) continue;
+
+      double betweenVariance{0}; // Divided by n
+      for (auto* chainPtr : coldChainList) {
+        double mean = chainPtr->pointSumList[iPar]/n;
+        betweenVariance += (mean - meanOfMeans)*(mean - meanOfMeans);
+      }
+      betweenVariance /= (m-1);
+
+      double rHat = std::sqrt(((n-1)/n*withinVariance + betweenVariance)
+                              /withinVariance);
+      if (rHat > 1.1) ++nbAboveThreshold;
+      if (rHat > maxRHat) { maxRHat = rHat; maxRHatIndex = int(iPar); }
+    }
+    if (maxRHatIndex >= 0) {
+      ss << std::endl << "  R-hat over " << n << " steps of "
+         << coldChainList.size() << " chains: max " << maxRHat
+         << " (" << _pointTitleList_[maxRHatIndex] << "), "
+         << nbAboveThreshold << " parameters above 1.1";
+    }
+  }
+  LogInfo << ss.str() << std::endl;
+}
+
 void AdaptiveMcmc::minimize() {
   this->MinimizerBase::minimize();
 
@@ -826,6 +1352,7 @@ void AdaptiveMcmc::minimize() {
   // of the parameters in the call to the likelihood function.  Those
   // parameters are defined by the _minimizerFitParameterPtr_ vector.
 
+  _pointTitleList_.clear();
   for (const ParameterSet& parSet: getPropagator().getParametersManager().getParameterSetsList()) {
     // Save name of parameter set
     parameterSetNames.push_back(parSet.getName());
@@ -838,6 +1365,7 @@ void AdaptiveMcmc::minimize() {
       parameterFixed.push_back(iPar.isFixed());
       parameterEnabled.push_back(iPar.isEnabled());
       parameterName.push_back(iPar.getTitle());
+      _pointTitleList_.push_back(iPar.getFullTitle());
       parameterPrior.push_back(iPar.getPriorValue());
       parameterSigma.push_back(iPar.getStdDevValue());
       parameterMin.push_back(iPar.getMinValue());
@@ -870,15 +1398,6 @@ void AdaptiveMcmc::minimize() {
   _point_.resize(parameterName.size());
   LogInfo << "Parameters in likelihood: " << _point_.size() << std::endl;
 
-  // Create the output tree for the accepted points.
-  auto *outputTree = new TTree(_outTreeName_.c_str(),
-                               "Tree of accepted points");
-  outputTree->Branch("Points",&_point_);
-  outputTree->Branch("LLHPenalty",&_llhPenalty_);
-  outputTree->Branch("LLHStatistical",&_llhStatistical_);
-  outputTree->Branch("Models",&_saveModel_);
-  outputTree->Branch("ModelUncertainty",&_saveUncertainty_);
-
   _monitor_.stateTitleMonitor = "Running MCMC chain...";
   _monitor_.minimizerTitle = _algorithmName_ + "/" + _proposalName_;
 
@@ -886,24 +1405,42 @@ void AdaptiveMcmc::minimize() {
   int nbFitCallOffset = _monitor_.nbEvalLikelihoodCalls;
   LogInfo << "Fit call offset: " << nbFitCallOffset << std::endl;
 
-  // Create the TSimpleMCMC object and call the specific runner.
-  if (_proposalName_ == "adaptive") {
-    TSimpleMCMC<PrivateProxyLikelihood,TProposeAdaptiveStep> mcmc(outputTree);
-    setupAndRunAdaptiveStep(mcmc);
+  TTree* outputTree{nullptr};
+  if (_nbChains_ > 1) {
+    // Each chain creates and saves its own tree.
+    setupAndRunAdaptiveChains();
   }
-  else if (_proposalName_ == "simple") {
-    TSimpleMCMC<PrivateProxyLikelihood,TProposeSimpleStep> mcmc(outputTree);
-    setupAndRunSimpleStep(mcmc);
+  else {
+    // Create the output tree for the accepted points.
+    outputTree = new TTree(_outTreeName_.c_str(),
+                           "Tree of accepted points");
+    outputTree->Branch("Points",&_point_);
+    outputTree->Branch("LLHPenalty",&_llhPenalty_);
+    outputTree->Branch("LLHStatistical",&_llhStatistical_);
+    outputTree->Branch("Models",&_saveModel_);
+    outputTree->Branch("ModelUncertainty",&_saveUncertainty_);
+
+    // Create the TSimpleMCMC object and call the specific runner.
+    if (_proposalName_ == "adaptive") {
+      TSimpleMCMC<PrivateProxyLikelihood,TProposeAdaptiveStep> mcmc(outputTree);
+      setupAndRunAdaptiveStep(mcmc);
+    }
+    else if (_proposalName_ == "simple") {
+      TSimpleMCMC<PrivateProxyLikelihood,TProposeSimpleStep> mcmc(outputTree);
+      setupAndRunSimpleStep(mcmc);
+    }
   }
 
   int nbMCMCCalls = _monitor_.nbEvalLikelihoodCalls - nbFitCallOffset;
 
   // lasting printout
+  this->flushMonitor();
   LogInfo << _monitor_.convergenceMonitor.generateMonitorString();
   LogInfo << "MCMC ended after " << nbMCMCCalls << " calls." << std::endl;
 
   // Save the sampled points to the outputfile
-  outputTree->Write();
+  if (outputTree != nullptr) outputTree->Write();
+  for (auto& chain : _chainList_) chain.tree->Write();
 
   // success
   _minimizerStatus_ = 0;
@@ -4,6 +4,10 @@
 #include "GenericToolbox.Json.h"
 #include "Logger.h"
 
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+
 LoggerInit([]{
   Logger::setUserHeaderStr("[MinimizerBase]");
 });
@@ -48,10 +52,10 @@ void MinimizerBase::initializeImpl(){
   if( not GundamGlobals::isLightOutputMode() ){
     _monitor_.historyTree = std::make_unique<TTree>( "chi2History", "chi2History");
     _monitor_.historyTree->SetDirectory( nullptr ); // will be saved later
-    _monitor_.historyTree->Branch("nbEvalLikelihoodCalls", &_monitor_.nbEvalLikelihoodCalls);
-    _monitor_.historyTree->Branch("totalLikelihood", &getLikelihoodInterface().getBuffer().totalLikelihood);
-    _monitor_.historyTree->Branch("statLikelihood", &getLikelihoodInterface().getBuffer().statLikelihood);
-    _monitor_.historyTree->Branch("penaltyLikelihood", &getLikelihoodInterface().getBuffer().penaltyLikelihood);
+    _monitor_.historyTree->Branch("nbEvalLikelihoodCalls", &_monitor_.historyEntry.nbEvalLikelihoodCalls);
+    _monitor_.historyTree->Branch("totalLikelihood", &_monitor_.historyEntry.totalLikelihood);
+    _monitor_.historyTree->Branch("statLikelihood", &_monitor_.historyEntry.statLikelihood);
+    _monitor_.historyTree->Branch("penaltyLikelihood", &_monitor_.historyEntry.penaltyLikelihood);
   }
 
   _monitor_.convergenceMonitor.addDisplayedQuantity("VarName");
@@ -67,6 +71,31 @@ void MinimizerBase::initializeImpl(){
   _monitor_.convergenceMonitor.addVariable("Stat");
   _monitor_.convergenceMonitor.addVariable("Syst");
 
+  auto& gradient = _monitor_.gradientDescentMonitor;
+  gradient.parStatePtrList.clear();
+  if( gradient.isEnabled ){
+    // same ordering as exportParameterInjectorConfig()
+    gradient.parStateTemplate = getPropagator().getParametersManager().exportParameterInjectorConfig();
+    for( auto& parSet : getPropagator().getParametersManager().getParameterSetsList() ){
+      if( not parSet.isEnabled() ){ continue; }
+      for( auto& par : parSet.getParameterList() ){
+        if( not par.isEnabled() ){ continue; }
+        gradient.parStatePtrList.emplace_back( &par );
+      }
+    }
+  }
+
+  _monitor_.recordQueue.start(
+      256,
+      [&](Monitor::Record& record_){
+        record_.fitParValueList.resize( _minimizerParameterPtrList_.size() );
+        record_.fitParIsFixedList.resize( _minimizerParameterPtrList_.size() );
+        record_.fitParIsEnabledList.resize( _minimizerParameterPtrList_.size() );
+        record_.parStateValueList.resize( gradient.parStatePtrList.size() );
+      },
+      [this](const Monitor::Record& record_){ this->processMonitorRecord( record_ ); }
+  );
+
   LogWarning << "MinimizerBase initialized." << std::endl;
 }
 
@@ -109,6 +138,46 @@ void MinimizerBase::scanParameters(TDirectory* saveDir_){
   LogThrowIf( not isInitialized() );
   for( auto& parPtr : _minimizerParameterPtrList_ ) { getParameterScanner().scanParameter( *parPtr, saveDir_ ); }
 }
+void MinimizerBase::evalFitGradient( const double* parArray_, double* gradient_ ){
+  _monitor_.externalTimer.stop();
+  _monitor_.evalLlhTimer.start();
+
+  int iFitPar{0};
+  for( auto* parPtr : _minimizerParameterPtrList_ ){
+    parPtr->setParameterValue(
+        _useNormalizedFitSpace_ ?
+        ParameterSet::toRealParValue(parArray_[iFitPar++], *parPtr) :
+        parArray_[iFitPar++]
+    );
+  }
+
+  getLikelihoodInterface().propagateAndEvalGradient( _parSetGradientList_ );
+
+  // gradient wrt each minimizer parameter
+  auto& parSetList = getPropagator().getParametersManager().getParameterSetsList();
+  iFitPar = 0;
+  for( auto* parPtr : _minimizerParameterPtrList_ ){
+    auto iParSet = int( parPtr->getOwner() - &parSetList[0] );
+    gradient_[iFitPar] = _parSetGradientList_[iParSet][parPtr->getParameterIndex()];
+
+    // d(real)/d(norm) = sigma
+    if( _useNormalizedFitSpace_ ){ gradient_[iFitPar] *= parPtr->getStdDevValue(); }
+    iFitPar++;
+  }
+
+  _monitor_.evalLlhTimer.stop();
+  _monitor_.externalTimer.start();
+}
+double MinimizerBase::evalFitDerivative( const double* parArray_, unsigned int iCoord_ ){
+  auto nPars = _minimizerParameterPtrList_.size();
+  if( _gradientPointBuffer_.size() != nPars
+      or not std::equal(_gradientPointBuffer_.begin(), _gradientPointBuffer_.end(), parArray_) ){
+    _gradientPointBuffer_.assign( parArray_, parArray_ + nPars );
+    _gradientBuffer_.resize( nPars );
+    this->evalFitGradient( parArray_, _gradientBuffer_.data() );
+  }
+  return _gradientBuffer_[iCoord_];
+}
 double MinimizerBase::evalFit( const double* parArray_ ){
 /// The main access is through the evalFit method which takes an array of floating
 /// point values and returns the likelihood. The meaning of the parameters is
@@ -131,117 +200,11 @@ double MinimizerBase::evalFit( const double* parArray_ ){
   getLikelihoodInterface().propagateAndEvalLikelihood();
   _monitor_.evalLlhTimer.stop();
 
-  // Monitor if enabled
+  // Monitor if enabled: the rest is done by the background thread
   if( _monitor_.isEnabled ){
+    this->printMonitorOutput();
     _monitor_.nbEvalLikelihoodCalls++;
-
-    if( _monitor_.historyTree != nullptr ){ _monitor_.historyTree->Fill(); }
-    if( _monitor_.gradientDescentMonitor.isEnabled ){
-
-      auto& gradient = _monitor_.gradientDescentMonitor;
-
-      // When gradient descent base minimizer probe a point toward the minimum, every parameter get updated
-      bool isGradientDescentStep =
-          std::all_of(
-              _minimizerParameterPtrList_.begin(), _minimizerParameterPtrList_.end(),
-              [](const Parameter* par_){
-                return ( par_->gotUpdated() or par_->isFixed() or not par_->isEnabled() );
-              } );
-      if( isGradientDescentStep ){
-
-        if( gradient.lastGradientFall == _monitor_.nbEvalLikelihoodCalls - 1 ){
-          LogWarning << "Minimizer is adjusting the step size: ";
-        }
-        else{
-          gradient.stepPointList.emplace_back();
-          LogWarning << "Gradient step detected at iteration #" << _monitor_.nbEvalLikelihoodCalls << ": ";
-        }
-        LogWarningIf(gradient.stepPointList.size() >= 2) << gradient.stepPointList[gradient.stepPointList.size() - 2].llh << " -> ";
-        LogWarning << getLikelihoodInterface().getLastLikelihood() << std::endl;
-        gradient.stepPointList.back().parState = getPropagator().getParametersManager().exportParameterInjectorConfig();
-        gradient.stepPointList.back().llh = getLikelihoodInterface().getLastLikelihood();
-        gradient.lastGradientFall = _monitor_.nbEvalLikelihoodCalls;
-      }
-    }
-    if( _monitor_.convergenceMonitor.isGenerateMonitorStringOk() ){
-
-      _monitor_.iterationCounterClock.count( _monitor_.nbEvalLikelihoodCalls );
-
-      std::stringstream ssHeader;
-      ssHeader << std::endl << __METHOD_NAME__ << ": call #" << _monitor_.nbEvalLikelihoodCalls;
-      ssHeader << std::endl << _monitor_.stateTitleMonitor;
-//    ssHeader << std::endl << "Target EDM: " << getMinimizer().get;
-      ssHeader << std::endl << "RAM: " << GenericToolbox::parseSizeUnits(double(GenericToolbox::getProcessMemoryUsage()));
-      double cpuPercent = GenericToolbox::getCpuUsageByProcess();
-      ssHeader << " / CPU: " << cpuPercent << "% (" << cpuPercent / GundamGlobals::getParallelWorker().getNbThreads() << "% efficiency)";
-      ssHeader << std::endl << "Avg log-likelihood computation time: " << _monitor_.evalLlhTimer;
-      ssHeader << std::endl;
-
-      GenericToolbox::TablePrinter t;
-
-      t << "" << GenericToolbox::TablePrinter::NextColumn;
-      t << "Propagator" << GenericToolbox::TablePrinter::NextColumn;
-      t << "Re-weight" << GenericToolbox::TablePrinter::NextColumn;
-      t << "histograms fill" << GenericToolbox::TablePrinter::NextColumn;
-      t << _monitor_.minimizerTitle << GenericToolbox::TablePrinter::NextLine;
-
-      t << "Speed" << GenericToolbox::TablePrinter::NextColumn;
-      t << _monitor_.iterationCounterClock.evalTickSpeed() << " it/s" << GenericToolbox::TablePrinter::NextColumn;
-      t << getPropagator().reweightTimer << GenericToolbox::TablePrinter::NextColumn;
-      t << getPropagator().refillHistogramTimer << GenericToolbox::TablePrinter::NextColumn;
-      t << _monitor_.externalTimer << GenericToolbox::TablePrinter::NextLine;
-
-      ssHeader << t.generateTableString();
-
-      if( _monitor_.showParameters ){
-        std::string curParSet;
-        ssHeader << std::endl << std::setprecision(1) << std::scientific << std::showpos;
-        int nParPerLine{0};
-        for( auto* fitPar : _minimizerParameterPtrList_ ){
-          if( fitPar->isFixed() ) continue;
-          if( curParSet != fitPar->getOwner()->getName() ){
-            if( not curParSet.empty() ) ssHeader << std::endl;
-            curParSet = fitPar->getOwner()->getName();
-            ssHeader << curParSet
-                     << (fitPar->getOwner()->isEnableEigenDecomp() ? " (eigen)" : "")
-                     << ":" << std::endl;
-            nParPerLine = 0;
-          }
-          else{
-            ssHeader << ", ";
-            if( nParPerLine >= _monitor_.maxNbParametersPerLine ) {
-              ssHeader << std::endl; nParPerLine = 0;
-            }
-          }
-          if(fitPar->gotUpdated()) ssHeader << GenericToolbox::ColorCodes::blueBackground;
-          if(_useNormalizedFitSpace_){
-            ssHeader << ParameterSet::toNormalizedParValue(fitPar->getParameterValue(), *fitPar);
-          }
-          else{ ssHeader << fitPar->getParameterValue(); }
-          if(fitPar->gotUpdated()) ssHeader << GenericToolbox::ColorCodes::resetColor;
-          nParPerLine++;
-        }
-      }
-
-      _monitor_.convergenceMonitor.setHeaderString(ssHeader.str());
-      _monitor_.convergenceMonitor.getVariable("Total/dof").addQuantity(
-          getLikelihoodInterface().getLastLikelihood() / fetchNbDegreeOfFreedom()
-      );
-      _monitor_.convergenceMonitor.getVariable("Total").addQuantity( getLikelihoodInterface().getLastLikelihood() );
-      _monitor_.convergenceMonitor.getVariable("Stat").addQuantity( getLikelihoodInterface().getLastStatLikelihood() );
-      _monitor_.convergenceMonitor.getVariable("Syst").addQuantity( getLikelihoodInterface().getLastPenaltyLikelihood() );
-
-      if( _monitor_.nbEvalLikelihoodCalls == 1 ){
-        // don't erase these lines
-        LogWarning << _monitor_.convergenceMonitor.generateMonitorString();
-      }
-      else{
-        LogInfo << _monitor_.convergenceMonitor.generateMonitorString(
-            GenericToolbox::getTerminalWidth() != 0, // trail back if not in batch mode
-            true // force generate
-        );
-      }
-    }
+    this->pushMonitorRecord();
   }
 
   if( _throwOnBadLlh_ and not getLikelihoodInterface().getBuffer().isValid() ){
@@ -298,6 +261,221 @@ void MinimizerBase::printParameters(){
   }
 }
 
+void MinimizerBase::pushMonitorRecord(){
+  auto& record = _monitor_.recordQueue.acquire();
+
+  record.nbEvalLikelihoodCalls = _monitor_.nbEvalLikelihoodCalls;
+  record.totalLikelihood = getLikelihoodInterface().getLastLikelihood();
+  record.statLikelihood = getLikelihoodInterface().getLastStatLikelihood();
+  record.penaltyLikelihood = getLikelihoodInterface().getLastPenaltyLikelihood();
+  for( size_t iFitPar = 0 ; iFitPar < _minimizerParameterPtrList_.size() ; iFitPar++ ){
+    auto* fitPar = _minimizerParameterPtrList_[iFitPar];
+    record.fitParValueList[iFitPar] = fitPar->getParameterValue();
+    record.fitParIsFixedList[iFitPar] = fitPar->isFixed();
+    record.fitParIsEnabledList[iFitPar] = fitPar->isEnabled();
+  }
+  auto& parStatePtrList = _monitor_.gradientDescentMonitor.parStatePtrList;
+  for( size_t iPar = 0 ; iPar < parStatePtrList.size() ; iPar++ ){
+    record.parStateValueList[iPar] = parStatePtrList[iPar]->getParameterValue();
+  }
+
+  // the strings owned by the fit thread are only copied when the terminal output is refreshed
+  auto now = std::chrono::steady_clock::now();
+  record.isDisplayed = (
+      _monitor_.nbEvalLikelihoodCalls == 1
+      or now - _monitor_.lastDisplayTime >= std::chrono::milliseconds( _monitor_.convergenceMonitor.getMaxRefreshRateInMs() )
+  );
+  if( record.isDisplayed ){
+    _monitor_.lastDisplayTime = now;
+    record.nbDegreeOfFreedom = fetchNbDegreeOfFreedom();
+    record.minimizerTitle = _monitor_.minimizerTitle;
+    record.stateTitleMonitor = _monitor_.stateTitleMonitor;
+
+    std::stringstream ss;
+    record.timerStrList.clear();
+    ss << _monitor_.evalLlhTimer; record.timerStrList.emplace_back( ss.str() ); ss.str("");
+    ss << getPropagator().reweightTimer; record.timerStrList.emplace_back( ss.str() ); ss.str("");
+    ss << getPropagator().refillHistogramTimer; record.timerStrList.emplace_back( ss.str() ); ss.str("");
+    ss << _monitor_.externalTimer; record.timerStrList.emplace_back( ss.str() );
+
+    record.ramUsage = double(GenericToolbox::getProcessMemoryUsage());
+    record.cpuPercent = GenericToolbox::getCpuUsageByProcess();
+
+    if( _monitor_.showParameters ){
+      record.fitParDisplayValueList.resize( _minimizerParameterPtrList_.size() );
+      record.fitParSetTitleList.resize( _minimizerParameterPtrList_.size() );
+      for( size_t iFitPar = 0 ; iFitPar < _minimizerParameterPtrList_.size() ; iFitPar++ ){
+        auto* fitPar = _minimizerParameterPtrList_[iFitPar];
+        record.fitParDisplayValueList[iFitPar] = record.fitParValueList[iFitPar];
+        if( _useNormalizedFitSpace_ ){ record.fitParDisplayValueList[iFitPar] = ParameterSet::toNormalizedParValue(record.fitParValueList[iFitPar], *fitPar); }
+        record.fitParSetTitleList[iFitPar] = fitPar->getOwner()->getName();
+        if( fitPar->getOwner()->isEnableEigenDecomp() ){ record.fitParSetTitleList[iFitPar] += " (eigen)"; }
+      }
+    }
+  }
+
+  _monitor_.recordQueue.publish();
+}
+void MinimizerBase::processMonitorRecord(const Monitor::Record& record_){
+
+  if( _monitor_.historyTree != nullptr ){
+    // the tree is filled by the fit thread
+    std::lock_guard<std::mutex> lock(_monitor_.pendingOutputMutex);
+    _monitor_.pendingHistoryList.emplace_back();
+    _monitor_.pendingHistoryList.back().nbEvalLikelihoodCalls = record_.nbEvalLikelihoodCalls;
+    _monitor_.pendingHistoryList.back().totalLikelihood = record_.totalLikelihood;
+    _monitor_.pendingHistoryList.back().statLikelihood = record_.statLikelihood;
+    _monitor_.pendingHistoryList.back().penaltyLikelihood = record_.penaltyLikelihood;
+    _monitor_.hasPendingOutput.store( true, std::memory_order_release );
+  }
+
+  // Parameter::gotUpdated() is relative to the previous evalFit() call
+  auto& lastValueList = _monitor_.lastFitParValueList;
+  if( lastValueList.size() != record_.fitParValueList.size() ){ lastValueList.assign( record_.fitParValueList.size(), std::nan("unset") ); }
+  auto gotUpdated = [&](size_t iFitPar_){ return record_.fitParValueList[iFitPar_] != lastValueList[iFitPar_]; };
+
+  if( _monitor_.gradientDescentMonitor.isEnabled ){
+
+    auto& gradient = _monitor_.gradientDescentMonitor;
+
+    // When gradient descent base minimizer probe a point toward the minimum, every parameter get updated
+    bool isGradientDescentStep{true};
+    for( size_t iFitPar = 0 ; iFitPar < record_.fitParValueList.size() ; iFitPar++ ){
+      if( not ( gotUpdated(iFitPar) or record_.fitParIsFixedList[iFitPar] or not record_.fitParIsEnabledList[iFitPar] ) ){ isGradientDescentStep = false; break; }
+    }
+    if( isGradientDescentStep ){
+
+      std::stringstream ss;
+      if( gradient.lastGradientFall == record_.nbEvalLikelihoodCalls - 1 ){
+        ss << "Minimizer is adjusting the step size: ";
+      }
+      else{
+        gradient.stepPointList.emplace_back();
+        ss << "Gradient step detected at iteration #" << record_.nbEvalLikelihoodCalls << ": ";
+      }
+      if( gradient.stepPointList.size() >= 2 ){ ss << gradient.stepPointList[gradient.stepPointList.size() - 2].llh << " -> "; }
+      ss << record_.totalLikelihood << std::endl;
+      this->addMonitorOutput( true, ss.str() );
+
+      auto& parState = gradient.stepPointList.back().parState;
+      parState = gradient.parStateTemplate;
+      size_t iValue{0};
+      for( auto& parSetState : parState["parameterSetList"] ){
+        for( auto& parValue : parSetState["parameterValues"] ){ parValue["value"] = record_.parStateValueList[iValue++]; }
+      }
+      gradient.stepPointList.back().llh = record_.totalLikelihood;
+      gradient.lastGradientFall = record_.nbEvalLikelihoodCalls;
+    }
+  }
+
+  if( record_.isDisplayed ){
+
+    _monitor_.iterationCounterClock.count( record_.nbEvalLikelihoodCalls );
+
+    std::stringstream ssHeader;
+    ssHeader << std::endl << "MinimizerBase::evalFit: call #" << record_.nbEvalLikelihoodCalls;
+    ssHeader << std::endl << record_.stateTitleMonitor;
+    ssHeader << std::endl << "RAM: " << GenericToolbox::parseSizeUnits(record_.ramUsage);
+    ssHeader << " / CPU: " << record_.cpuPercent << "% (" << record_.cpuPercent / GundamGlobals::getParallelWorker().getNbThreads() << "% efficiency)";
+    ssHeader << std::endl << "Avg log-likelihood computation time: " << record_.timerStrList[0];
+    ssHeader << std::endl;
+
+    GenericToolbox::TablePrinter t;
+
+    t << "" << GenericToolbox::TablePrinter::NextColumn;
+    t << "Propagator" << GenericToolbox::TablePrinter::NextColumn;
+    t << "Re-weight" << GenericToolbox::TablePrinter::NextColumn;
+    t << "histograms fill" << GenericToolbox::TablePrinter::NextColumn;
+    t << record_.minimizerTitle << GenericToolbox::TablePrinter::NextLine;
+
+    t << "Speed" << GenericToolbox::TablePrinter::NextColumn;
+    t << _monitor_.iterationCounterClock.evalTickSpeed() << " it/s" << GenericToolbox::TablePrinter::NextColumn;
+    t << record_.timerStrList[1] << GenericToolbox::TablePrinter::NextColumn;
+    t << record_.timerStrList[2] << GenericToolbox::TablePrinter::NextColumn;
+    t << record_.timerStrList[3] << GenericToolbox::TablePrinter::NextLine;
+
+    ssHeader << t.generateTableString();
+
+    if( _monitor_.showParameters ){
+      std::string curParSet;
+      ssHeader << std::endl << std::setprecision(1) << std::scientific << std::showpos;
+      int nParPerLine{0};
+      for( size_t iFitPar = 0 ; iFitPar < record_.fitParValueList.size() ; iFitPar++ ){
+        if( record_.fitParIsFixedList[iFitPar] ) continue;
+        if( curParSet != record_.fitParSetTitleList[iFitPar] ){
+          if( not curParSet.empty() ) ssHeader << std::endl;
+          curParSet = record_.fitParSetTitleList[iFitPar];
+          ssHeader << curParSet << ":" << std::endl;
+          nParPerLine = 0;
+        }
+        else{
+          ssHeader << ", ";
+          if( nParPerLine >= _monitor_.maxNbParametersPerLine ) {
+            ssHeader << std::endl; nParPerLine = 0;
+          }
+        }
+        if(gotUpdated(iFitPar)) ssHeader << GenericToolbox::ColorCodes::blueBackground;
+        ssHeader << record_.fitParDisplayValueList[iFitPar];
+        if(gotUpdated(iFitPar)) ssHeader << GenericToolbox::ColorCodes::resetColor;
+        nParPerLine++;
+      }
+    }
+
+    _monitor_.convergenceMonitor.setHeaderString(ssHeader.str());
+    _monitor_.convergenceMonitor.getVariable("Total/dof").addQuantity( record_.totalLikelihood / record_.nbDegreeOfFreedom );
+    _monitor_.convergenceMonitor.getVariable("Total").addQuantity( record_.totalLikelihood );
+    _monitor_.convergenceMonitor.getVariable("Stat").addQuantity( record_.statLikelihood );
+    _monitor_.convergenceMonitor.getVariable("Syst").addQuantity( record_.penaltyLikelihood );
+
+    if( record_.nbEvalLikelihoodCalls == 1 ){
+      // don't erase these lines
+      this->addMonitorOutput( true, _monitor_.convergenceMonitor.generateMonitorString() );
+    }
+    else{
+      this->addMonitorOutput( false, _monitor_.convergenceMonitor.generateMonitorString(
+          GenericToolbox::getTerminalWidth() != 0, // trail back if not in batch mode
+          true // force generate
+      ) );
+    }
+  }
+
+  lastValueList = record_.fitParValueList;
+}
+void MinimizerBase::addMonitorOutput(bool isWarning_, const std::string& str_){
+  std::lock_guard<std::mutex> lock(_monitor_.pendingOutputMutex);
+  _monitor_.pendingOutputList.emplace_back();
+  _monitor_.pendingOutputList.back().isWarning = isWarning_;
+  _monitor_.pendingOutputList.back().str = str_;
+  _monitor_.hasPendingOutput.store( true, std::memory_order_release );
+}
+void MinimizerBase::printMonitorOutput(){
+  // cheap check from the fit loop
+  if( not _monitor_.hasPendingOutput.load( std::memory_order_acquire ) ){ return; }
+
+  std::vector<Monitor::PendingOutput> outputList;
+  std::vector<Monitor::HistoryEntry> historyList;
+  {
+    std::lock_guard<std::mutex> lock(_monitor_.pendingOutputMutex);
+    outputList.swap( _monitor_.pendingOutputList );
+    historyList.swap( _monitor_.pendingHistoryList );
+    _monitor_.hasPendingOutput.store( false, std::memory_order_relaxed );
+  }
+
+  for( auto& history : historyList ){
+    _monitor_.historyEntry = history;
+    _monitor_.historyTree->Fill();
+  }
+
+  for( auto& output : outputList ){
+    if( output.isWarning ){ LogWarning << output.str; }
+    else{ LogInfo << output.str; }
+  }
+}
+void MinimizerBase::flushMonitor(){
+  _monitor_.recordQueue.flush();
+  this->printMonitorOutput();
+}
+
 
 Propagator& MinimizerBase::getPropagator(){ return _owner_->getLikelihoodInterface().getDataSetManager().getPropagator(); }
 [[nodiscard]] const Propagator& MinimizerBase::getPropagator() const { return _owner_->getLikelihoodInterface().getDataSetManager().getPropagator(); }
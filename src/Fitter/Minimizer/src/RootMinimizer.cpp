@@ -7,6 +7,7 @@
 #include "FitterEngine.h"
 #include "GenericToolbox.Json.h"
 #include "GundamGlobals.h"
+#include "PropagatorReplicaPool.h"
 #include "GundamUtils.h"
 
 #include "GenericToolbox.Root.h"
@@ -16,6 +17,7 @@
 #include "Math/Minimizer.h"
 #include "Math/Functor.h"
 #include "TLegend.h"
+#include "TDecompChol.h"
 
 
 LoggerInit([]{
@@ -46,12 +48,21 @@ void RootMinimizer::readConfigImpl(){
 
   _errorAlgo_ = GenericToolbox::Json::fetchValue(_config_, {{"errorsAlgo"}, {"errors"}}, "Hesse");
   _restoreStepSizeBeforeHesse_ = GenericToolbox::Json::fetchValue(_config_, "restoreStepSizeBeforeHesse", _restoreStepSizeBeforeHesse_);
+  _parallelHesseNbReplicas_ = GenericToolbox::Json::fetchValue(_config_, "parallelHesseNbReplicas", _parallelHesseNbReplicas_);
+  _parallelHesseStepFraction_ = GenericToolbox::Json::fetchValue(_config_, "parallelHesseStepFraction", _parallelHesseStepFraction_);
+  _parallelHesseTolerance_ = GenericToolbox::Json::fetchValue(_config_, "parallelHesseTolerance", _parallelHesseTolerance_);
+  _checkParallelHesse_ = GenericToolbox::Json::fetchValue(_config_, "checkParallelHesse", _checkParallelHesse_);
 
   _generatedPostFitParBreakdown_ = GenericToolbox::Json::fetchValue(_config_, "generatedPostFitParBreakdown", _generatedPostFitParBreakdown_);
   _generatedPostFitEigenBreakdown_ = GenericToolbox::Json::fetchValue(_config_, "generatedPostFitEigenBreakdown", _generatedPostFitEigenBreakdown_);
 
   _stepSizeScaling_ = GenericToolbox::Json::fetchValue(_config_, "stepSizeScaling", _stepSizeScaling_);
 
+  _useAnalyticGradient_ = GenericToolbox::Json::fetchValue(_config_, "useAnalyticGradient", _useAnalyticGradient_);
+  _checkAnalyticGradient_ = GenericToolbox::Json::fetchValue(_config_, "checkAnalyticGradient", _checkAnalyticGradient_);
+  _analyticGradientStepFraction_ = GenericToolbox::Json::fetchValue(_config_, "analyticGradientStepFraction", _analyticGradientStepFraction_);
+  _analyticGradientTolerance_ = GenericToolbox::Json::fetchValue(_config_, "analyticGradientTolerance", _analyticGradientTolerance_);
+
   LogWarning << "RootMinimizer configured." << std::endl;
 }
 void RootMinimizer::initializeImpl(){
@@ -68,8 +79,24 @@ void RootMinimizer::initializeImpl(){
     LogWarning << "Using default minimizer algo: " << _minimizerAlgo_ << std::endl;
   }
 
-  _functor_ = ROOT::Math::Functor(this, &RootMinimizer::evalFit, _minimizerParameterPtrList_.size());
-  _rootMinimizer_->SetFunction( _functor_ );
+  if( _useAnalyticGradient_ and not getLikelihoodInterface().isGradientAvailable() ){
+    LogAlert << "useAnalyticGradient: the joint probability \"" << getLikelihoodInterface().getJointProbabilityPtr()->getType()
+             << "\" doesn't provide the bin derivatives. Falling back on numerical derivatives." << std::endl;
+    _useAnalyticGradient_ = false;
+  }
+
+  if( _useAnalyticGradient_ ){
+    LogInfo << "Providing the analytic gradient of the likelihood to the minimizer." << std::endl;
+    _gradFunctor_ = ROOT::Math::GradFunctor(
+        this, &RootMinimizer::evalFit, &RootMinimizer::evalFitDerivative,
+        _minimizerParameterPtrList_.size()
+    );
+    _rootMinimizer_->SetFunction( _gradFunctor_ );
+  }
+  else{
+    _functor_ = ROOT::Math::Functor(this, &RootMinimizer::evalFit, _minimizerParameterPtrList_.size());
+    _rootMinimizer_->SetFunction( _functor_ );
+  }
   _rootMinimizer_->SetStrategy(_strategy_);
   _rootMinimizer_->SetPrintLevel(_printLevel_);
   _rootMinimizer_->SetTolerance(_tolerance_);
@@ -107,6 +134,8 @@ void RootMinimizer::minimize(){
   // calling the common routine
   this->MinimizerBase::minimize();
 
+  if( _useAnalyticGradient_ and _checkAnalyticGradient_ ){ this->checkAnalyticGradient(); }
+
   int nbFitCallOffset = _monitor_.nbEvalLikelihoodCalls;
   LogInfo << "Fit call offset: " << nbFitCallOffset << std::endl;
 
@@ -128,6 +157,7 @@ void RootMinimizer::minimize(){
     _monitor_.isEnabled = true;
     _fitHasConverged_ = _rootMinimizer_->Minimize();
     _monitor_.isEnabled = false;
+    this->flushMonitor();
 
     // Make sure we are on the right spot
     updateCacheToBestfitPoint();
@@ -155,6 +185,7 @@ void RootMinimizer::minimize(){
   _monitor_.isEnabled = true;
   _fitHasConverged_ = _rootMinimizer_->Minimize();
   _monitor_.isEnabled = false;
+  this->flushMonitor();
 
   int nbMinimizeCalls = _monitor_.nbEvalLikelihoodCalls - nbFitCallOffset;
 
@@ -294,6 +325,7 @@ void RootMinimizer::calcErrors(){
       _monitor_.isEnabled = true;
       bool isOk = _rootMinimizer_->GetMinosError(iFitPar, errLow, errHigh);
       _monitor_.isEnabled = false;
+      this->flushMonitor();
 
 #if ROOT_VERSION_CODE >= ROOT_VERSION(6,23,02)
       LogWarning << GundamUtils::minosStatusCodeStr.at(_rootMinimizer_->MinosStatus()) << std::endl;
@@ -312,7 +344,7 @@ void RootMinimizer::calcErrors(){
       _minimizerParameterPtrList_[iFitPar]->setParameterValue(_rootMinimizer_->X()[iFitPar]);
     }
   } // Minos
-  else if( _errorAlgo_ == "Hesse" ){
+  else if( _errorAlgo_ == "Hesse" or _errorAlgo_ == "ParallelHesse" ){
 
     if( _restoreStepSizeBeforeHesse_ ){
       LogWarning << "Restoring step size before HESSE..." << std::endl;
@@ -326,30 +358,71 @@ void RootMinimizer::calcErrors(){
     // Make sure we are on the right spot
     updateCacheToBestfitPoint();
 
-    _monitor_.minimizerTitle = _minimizerType_ + "/" + _errorAlgo_;
-    _monitor_.stateTitleMonitor = "Running HESSE...";
+    std::unique_ptr<TMatrixDSym> parallelCovarianceMatrix{nullptr};
+    if( _errorAlgo_ == "ParallelHesse" ){
+      _monitor_.minimizerTitle = _errorAlgo_;
+      _monitor_.stateTitleMonitor = "Running parallel HESSE...";
 
-    _monitor_.isEnabled = true;
-    _fitHasConverged_ = _rootMinimizer_->Hesse();
-    _monitor_.isEnabled = false;
+      parallelCovarianceMatrix = std::make_unique<TMatrixDSym>(int(_rootMinimizer_->NDim()));
 
-    LogInfo << "Hesse ended after " << _monitor_.nbEvalLikelihoodCalls - nbFitCallOffset << " calls." << std::endl;
-    LogWarning << "HESSE status code: " << GundamUtils::hesseStatusCodeStr.at(_rootMinimizer_->Status()) << std::endl;
-    LogWarning << "Covariance matrix status code: " << GundamUtils::covMatrixStatusCodeStr.at(_rootMinimizer_->CovMatrixStatus()) << std::endl;
+      _monitor_.isEnabled = true;
+      bool isOk = this->evalParallelHessian( *parallelCovarianceMatrix );
+      _monitor_.isEnabled = false;
+      this->flushMonitor();
 
-    // Make sure we are on the right spot
-    updateCacheToBestfitPoint();
+      // Make sure we are on the right spot
+      updateCacheToBestfitPoint();
 
-    if(not _fitHasConverged_){
-      LogError  << "Hesse did not converge." << std::endl;
-      LogError << _monitor_.convergenceMonitor.generateMonitorString(); // lasting printout
-    }
-    else{
-      LogInfo << "Hesse converged." << std::endl;
-      LogInfo << _monitor_.convergenceMonitor.generateMonitorString(); // lasting printout
+      if( isOk ){
+        LogInfo << "Parallel HESSE ended after " << _monitor_.nbEvalLikelihoodCalls - nbFitCallOffset << " calls." << std::endl;
+      }
+      else{
+        LogThrowIf( _checkParallelHesse_, "Parallel HESSE failed while checkParallelHesse is set." );
+        LogAlert << "Parallel HESSE failed. Falling back on " << _minimizerType_ << " HESSE." << std::endl;
+        parallelCovarianceMatrix = nullptr;
+      }
     }
 
-    int covStatus = _rootMinimizer_->CovMatrixStatus();
+    int covStatus{3}; // full accurate matrix, as provided by the parallel HESSE
+    _fitHasConverged_ = true;
+    if( parallelCovarianceMatrix == nullptr or _checkParallelHesse_ ){
+      nbFitCallOffset = _monitor_.nbEvalLikelihoodCalls;
+
+      _monitor_.minimizerTitle = _minimizerType_ + "/Hesse";
+      _monitor_.stateTitleMonitor = "Running HESSE...";
+
+      _monitor_.isEnabled = true;
+      bool hasConverged = _rootMinimizer_->Hesse();
+      _monitor_.isEnabled = false;
+      this->flushMonitor();
+
+      LogInfo << "Hesse ended after " << _monitor_.nbEvalLikelihoodCalls - nbFitCallOffset << " calls." << std::endl;
+      LogWarning << "HESSE status code: " << GundamUtils::hesseStatusCodeStr.at(_rootMinimizer_->Status()) << std::endl;
+      LogWarning << "Covariance matrix status code: " << GundamUtils::covMatrixStatusCodeStr.at(_rootMinimizer_->CovMatrixStatus()) << std::endl;
+
+      // Make sure we are on the right spot
+      updateCacheToBestfitPoint();
+
+      if(not hasConverged){
+        LogError  << "Hesse did not converge." << std::endl;
+        LogError << _monitor_.convergenceMonitor.generateMonitorString(); // lasting printout
+      }
+      else{
+        LogInfo << "Hesse converged." << std::endl;
+        LogInfo << _monitor_.convergenceMonitor.generateMonitorString(); // lasting printout
+      }
+
+      if( parallelCovarianceMatrix == nullptr ){
+        // the minuit results are the ones written
+        _fitHasConverged_ = hasConverged;
+        covStatus = _rootMinimizer_->CovMatrixStatus();
+      }
+      else{
+        LogThrowIf( not hasConverged, "Can't check the parallel HESSE with " << _minimizerType_ << " as it didn't converge." );
+        LogThrowIf( not this->compareWithMinuitHesse( *parallelCovarianceMatrix ),
+                    "The parallel HESSE errors don't match the " << _minimizerType_ << " ones (checkParallelHesse)." );
+      }
+    }
 
     auto hesseStats = std::make_unique<TTree>("hesseStats", "hesseStats");
     hesseStats->SetDirectory(nullptr);
@@ -360,7 +433,7 @@ void RootMinimizer::calcErrors(){
     GenericToolbox::mkdirTFile( getOwner().getSaveDir(), "postFit")->WriteObject(hesseStats.get(), hesseStats->GetName());
 
     LogInfo << "Writing HESSE post-fit errors" << std::endl;
-    this->writePostFitData(GenericToolbox::mkdirTFile(getOwner().getSaveDir(), "postFit/Hesse"));
+    this->writePostFitData(GenericToolbox::mkdirTFile(getOwner().getSaveDir(), "postFit/Hesse"), parallelCovarianceMatrix.get());
     GenericToolbox::triggerTFileWrite(GenericToolbox::mkdirTFile(getOwner().getSaveDir(), "postFit/Hesse"));
   }
   else{
@@ -431,7 +504,7 @@ void RootMinimizer::saveMinimizerSettings( TDirectory* saveDir_) const {
 }
 
 // protected
-void RootMinimizer::writePostFitData( TDirectory* saveDir_) {
+void RootMinimizer::writePostFitData( TDirectory* saveDir_, const TMatrixDSym* covarianceMatrix_) {
   LogInfo << __METHOD_NAME__ << std::endl;
   LogThrowIf(not isInitialized(), "not initialized");
   LogThrowIf(saveDir_==nullptr, "Save dir not specified");
@@ -440,7 +513,13 @@ void RootMinimizer::writePostFitData( TDirectory* saveDir_) {
   auto* matricesDir = GenericToolbox::mkdirTFile(saveDir_, "hessian");
 
   TMatrixDSym postfitCovarianceMatrix(int(_rootMinimizer_->NDim()));
-  _rootMinimizer_->GetCovMatrix(postfitCovarianceMatrix.GetMatrixArray());
+  if( covarianceMatrix_ != nullptr ){
+    LogThrowIf(covarianceMatrix_->GetNrows() != postfitCovarianceMatrix.GetNrows(), "Provided covariance matrix has the wrong size.");
+    postfitCovarianceMatrix = *covarianceMatrix_;
+  }
+  else{
+    _rootMinimizer_->GetCovMatrix(postfitCovarianceMatrix.GetMatrixArray());
+  }
 
   std::function<void(TDirectory*)> decomposeCovarianceMatrixFct = [&](TDirectory* outDir_){
 
@@ -1224,6 +1303,249 @@ void RootMinimizer::saveGradientSteps(){
 
 }
 
+bool RootMinimizer::evalParallelHessian(TMatrixDSym& covarianceMatrix_){
+  auto& propagator = getPropagator();
+  if( not PropagatorReplica::isSupported( propagator ) ){
+    LogAlert << "Some dials can't be evaluated by the propagator replicas." << std::endl;
+    return false;
+  }
+  LogThrowIf(_rootMinimizer_->X() == nullptr, "No best fit point provided by the minimizer.");
+
+  int nDim{int(_rootMinimizer_->NDim())};
+  std::vector<double> bestFitPoint(_rootMinimizer_->X(), _rootMinimizer_->X() + nDim);
+
+  // the steps are taken as a fraction of the errors of the minimizer, if any
+  std::vector<int> freeParList{};
+  std::vector<double> stepList(nDim, 0);
+  for( int iFitPar = 0 ; iFitPar < nDim ; iFitPar++ ){
+    if( _rootMinimizer_->IsFixedVariable(iFitPar) ){ continue; }
+    freeParList.emplace_back( iFitPar );
+
+    auto& par = *_minimizerParameterPtrList_[iFitPar];
+    double error{ _rootMinimizer_->Errors() != nullptr ? _rootMinimizer_->Errors()[iFitPar] : 0. };
+    if( not std::isfinite(error) or error <= 0 ){
+      error = _useNormalizedFitSpace_ ? ParameterSet::toNormalizedParRange(par.getStepSize() * _stepSizeScaling_, par) : par.getStepSize() * _stepSizeScaling_;
+    }
+    stepList[iFitPar] = _parallelHesseStepFraction_ * error;
+  }
+  int nFree{int(freeParList.size())};
+  if( nFree == 0 ){ LogAlert << "No free parameter to evaluate the Hessian with." << std::endl; return false; }
+
+  // The stencil points have to stay within the parameter limits: a central
+  // difference is used if both +-h fit, otherwise a one-sided difference
+  // toward the farthest limit, with h clamped to half of the available room.
+  std::vector<bool> isCentralList(nDim, true);
+  std::vector<double> directionList(nDim, 1.); // sign of the shifts of the one-sided and cross differences
+  for( int iPar : freeParList ){
+    auto& par = *_minimizerParameterPtrList_[iPar];
+    auto toFitSpace = [&](double value_){ return _useNormalizedFitSpace_ ? ParameterSet::toNormalizedParValue(value_, par) : value_; };
+    double roomUp{ std::isnan(par.getMaxValue()) ? INFINITY : toFitSpace(par.getMaxValue()) - bestFitPoint[iPar] };
+    double roomDown{ std::isnan(par.getMinValue()) ? INFINITY : bestFitPoint[iPar] - toFitSpace(par.getMinValue()) };
+    if( std::min(roomUp, roomDown) >= stepList[iPar] ){ continue; }
+
+    isCentralList[iPar] = false;
+    directionList[iPar] = ( roomUp >= roomDown ? 1. : -1. );
+    double room{std::max(roomUp, roomDown)};
+    if( not ( room > 0 ) ){
+      LogAlert << "No room within the limits to evaluate the Hessian of " << _rootMinimizer_->VariableName(iPar) << std::endl;
+      return false;
+    }
+    stepList[iPar] = std::min( stepList[iPar], 0.5 * room );
+    LogInfo << _rootMinimizer_->VariableName(iPar) << " is close to its limits: one-sided difference with a step of "
+            << stepList[iPar] << std::endl;
+  }
+
+  // same stencil as Minuit2's HESSE: central differences on the diagonal,
+  // forward cross differences off-diagonal. The first diagonal point of each
+  // parameter is also the one used by the cross differences.
+  struct StencilPoint{ int iPar{-1}; int jPar{-1}; double iShift{0}; double jShift{0}; };
+  std::vector<StencilPoint> pointList{};
+  pointList.reserve( 1 + 2 * nFree + nFree * (nFree - 1) / 2 );
+  pointList.emplace_back(); // best fit point
+  for( int iPar : freeParList ){
+    double shift{directionList[iPar] * stepList[iPar]};
+    pointList.emplace_back( StencilPoint{iPar, -1, shift, 0} );
+    pointList.emplace_back( StencilPoint{iPar, -1, isCentralList[iPar] ? -shift : 2 * shift, 0} );
+  }
+  for( int iFree = 0 ; iFree < nFree ; iFree++ ){
+    for( int jFree = iFree + 1 ; jFree < nFree ; jFree++ ){
+      int iPar{freeParList[iFree]}; int jPar{freeParList[jFree]};
+      pointList.emplace_back( StencilPoint{iPar, jPar, directionList[iPar] * stepList[iPar], directionList[jPar] * stepList[jPar]} );
+    }
+  }
+
+  int nReplicas{ _parallelHesseNbReplicas_ > 0 ? _parallelHesseNbReplicas_ : GundamGlobals::getParallelWorker().getNbThreads() };
+  nReplicas = std::max( 1, std::min( nReplicas, int(pointList.size()) ) );
+  LogInfo << "Evaluating the Hessian of " << nFree << " free parameters on " << pointList.size()
+          << " points, by batches of " << nReplicas << " propagator replicas..." << std::endl;
+
+  PropagatorReplicaPool replicaPool{"RootMinimizer::propagateReplicas"};
+  replicaPool.build( propagator, nReplicas );
+
+  std::vector<double> pointBuffer( nDim );
+  std::vector<double> llhList( pointList.size(), 0 );
+  std::vector<double> penaltyLikelihoodList( pointList.size(), 0 );
+  replicaPool.evalBatch(
+      int(pointList.size()),
+      [&](int iPt_){
+        auto& point = pointList[iPt_];
+        pointBuffer = bestFitPoint;
+        if( point.iPar != -1 ){ pointBuffer[point.iPar] += point.iShift; }
+        if( point.jPar != -1 ){ pointBuffer[point.jPar] += point.jShift; }
+
+        int iFitPar{0};
+        for( auto* parPtr : _minimizerParameterPtrList_ ){
+          parPtr->setParameterValue(
+              _useNormalizedFitSpace_ ?
+              ParameterSet::toRealParValue(pointBuffer[iFitPar++], *parPtr) :
+              pointBuffer[iFitPar++]
+          );
+        }
+        propagator.updateDialInputs();
+        penaltyLikelihoodList[iPt_] = getLikelihoodInterface().evalPenaltyLikelihood();
+        return true;
+      },
+      [&](int iPt_, PropagatorReplica& replica_){
+        replica_.copyToSampleSet( propagator.getSampleSet() );
+        getLikelihoodInterface().evalStatLikelihood();
+        getLikelihoodInterface().getBuffer().penaltyLikelihood = penaltyLikelihoodList[iPt_];
+        getLikelihoodInterface().getBuffer().updateTotal();
+        llhList[iPt_] = getLikelihoodInterface().getLastLikelihood();
+        if( _monitor_.isEnabled ){ _monitor_.nbEvalLikelihoodCalls++; }
+        GenericToolbox::displayProgressBar( iPt_ + 1, pointList.size(), LogInfo.getPrefixString() + "Evaluating the Hessian..." );
+      }
+  );
+
+  // stencil -> hessian of the free parameters
+  double llhBestFit{llhList[0]};
+  std::vector<double> llhFirstList( nFree ), llhSecondList( nFree );
+  for( int iFree = 0 ; iFree < nFree ; iFree++ ){
+    llhFirstList[iFree] = llhList[1 + 2 * iFree];
+    llhSecondList[iFree] = llhList[2 + 2 * iFree];
+  }
+
+  TMatrixDSym hessianMatrix( nFree );
+  int iPoint{1 + 2 * nFree};
+  for( int iFree = 0 ; iFree < nFree ; iFree++ ){
+    double iStep{stepList[freeParList[iFree]]};
+    if( isCentralList[freeParList[iFree]] ){
+      // f(x+h), f(x-h)
+      hessianMatrix[iFree][iFree] = ( llhFirstList[iFree] + llhSecondList[iFree] - 2 * llhBestFit ) / ( iStep * iStep );
+    }
+    else{
+      // f(x+sh), f(x+2sh)
+      hessianMatrix[iFree][iFree] = ( llhSecondList[iFree] - 2 * llhFirstList[iFree] + llhBestFit ) / ( iStep * iStep );
+    }
+    if( not std::isfinite( hessianMatrix[iFree][iFree] ) or hessianMatrix[iFree][iFree] <= 0 ){
+      LogAlert << "Non positive second derivative for " << _rootMinimizer_->VariableName(freeParList[iFree]) << ": "
+               << hessianMatrix[iFree][iFree] << std::endl;
+      return false;
+    }
+    for( int jFree = iFree + 1 ; jFree < nFree ; jFree++ ){
+      double jStep{stepList[freeParList[jFree]]};
+      double directionProd{directionList[freeParList[iFree]] * directionList[freeParList[jFree]]};
+      hessianMatrix[iFree][jFree] = ( llhList[iPoint++] - llhFirstList[iFree] - llhFirstList[jFree] + llhBestFit ) / ( directionProd * iStep * jStep );
+      hessianMatrix[jFree][iFree] = hessianMatrix[iFree][jFree];
+    }
+  }
+
+  TDecompChol choleskyDecomp( hessianMatrix );
+  if( not choleskyDecomp.Decompose() ){
+    LogAlert << "The finite-difference Hessian is not positive definite." << std::endl;
+    return false;
+  }
+  TMatrixDSym invHessianMatrix( nFree );
+  choleskyDecomp.Invert( invHessianMatrix );
+
+  // as for minuit, the errors are defined by a likelihood increase of ErrorDef: cov = 2 * ErrorDef * H^-1
+  covarianceMatrix_.ResizeTo( nDim, nDim );
+  covarianceMatrix_.Zero();
+  for( int iFree = 0 ; iFree < nFree ; iFree++ ){
+    for( int jFree = 0 ; jFree < nFree ; jFree++ ){
+      covarianceMatrix_[freeParList[iFree]][freeParList[jFree]] = 2 * _rootMinimizer_->ErrorDef() * invHessianMatrix[iFree][jFree];
+    }
+  }
+
+  return true;
+}
+bool RootMinimizer::compareWithMinuitHesse(const TMatrixDSym& covarianceMatrix_) const {
+  int nDim{int(_rootMinimizer_->NDim())};
+  TMatrixDSym minuitCovarianceMatrix( nDim );
+  _rootMinimizer_->GetCovMatrix( minuitCovarianceMatrix.GetMatrixArray() );
+
+  LogInfo << "Comparing the parallel HESSE errors with " << _minimizerType_ << "..." << std::endl;
+
+  int nMismatch{0};
+  double maxRelDiff{0};
+  for( int iFitPar = 0 ; iFitPar < nDim ; iFitPar++ ){
+    if( _rootMinimizer_->IsFixedVariable(iFitPar) ){ continue; }
+
+    double parallelError{std::sqrt( covarianceMatrix_[iFitPar][iFitPar] )};
+    double minuitError{std::sqrt( minuitCovarianceMatrix[iFitPar][iFitPar] )};
+    double relDiff{ std::abs( parallelError - minuitError ) / minuitError };
+    maxRelDiff = std::max( maxRelDiff, relDiff );
+
+    if( not ( relDiff <= _parallelHesseTolerance_ ) ){
+      nMismatch++;
+      LogAlert << _rootMinimizer_->VariableName(iFitPar) << ": parallel HESSE error " << parallelError
+               << " vs " << minuitError << " (relative difference: " << relDiff << ")" << std::endl;
+    }
+  }
+
+  LogInfoIf( nMismatch == 0 ) << "Parallel HESSE errors agree with " << _minimizerType_ << " within " << _parallelHesseTolerance_
+                              << " (max relative difference: " << maxRelDiff << ")" << std::endl;
+  LogAlertIf( nMismatch != 0 ) << nMismatch << " parallel HESSE errors differ from " << _minimizerType_
+                               << " by more than " << _parallelHesseTolerance_ << std::endl;
+  return nMismatch == 0;
+}
+void RootMinimizer::checkAnalyticGradient(){
+  LogInfo << "Checking the analytic gradient against central finite differences..." << std::endl;
+
+  int nDim{int(_minimizerParameterPtrList_.size())};
+  std::vector<double> startPoint( nDim );
+  std::vector<double> stepList( nDim );
+  for( int iFitPar = 0 ; iFitPar < nDim ; iFitPar++ ){
+    auto& par = *_minimizerParameterPtrList_[iFitPar];
+    double step{ par.getStepSize() * _stepSizeScaling_ * _analyticGradientStepFraction_ };
+    startPoint[iFitPar] = _useNormalizedFitSpace_ ? ParameterSet::toNormalizedParValue(par.getParameterValue(), par) : par.getParameterValue();
+    stepList[iFitPar] = _useNormalizedFitSpace_ ? ParameterSet::toNormalizedParRange(step, par) : step;
+  }
+
+  std::vector<double> gradient( nDim );
+  this->evalFitGradient( startPoint.data(), gradient.data() );
+
+  int nbMismatches{0};
+  std::vector<double> pointBuffer{startPoint};
+  for( int iFitPar = 0 ; iFitPar < nDim ; iFitPar++ ){
+    if( _rootMinimizer_->IsFixedVariable(iFitPar) ){ continue; }
+    double step{stepList[iFitPar]};
+
+    pointBuffer[iFitPar] = startPoint[iFitPar] + step;
+    double llhPlus{ this->evalFit( pointBuffer.data() ) };
+    pointBuffer[iFitPar] = startPoint[iFitPar] - step;
+    double llhMinus{ this->evalFit( pointBuffer.data() ) };
+    pointBuffer[iFitPar] = startPoint[iFitPar];
+
+    double numericalDerivative{ ( llhPlus - llhMinus ) / ( 2 * step ) };
+    double delta{ std::abs( gradient[iFitPar] - numericalDerivative ) };
+    bool isOk{ delta <= _analyticGradientTolerance_ * std::max( 1., std::abs(numericalDerivative) ) };
+    if( not isOk ){ nbMismatches++; }
+
+    LogAlertIf( not isOk ) << _minimizerParameterPtrList_[iFitPar]->getFullTitle() << ": analytic = " << gradient[iFitPar]
+                           << ", numerical = " << numericalDerivative << std::endl;
+    LogInfoIf( isOk and GundamGlobals::getVerboseLevel() >= VerboseLevel::MORE_PRINTOUT )
+      << _minimizerParameterPtrList_[iFitPar]->getFullTitle() << ": analytic = " << gradient[iFitPar]
+      << ", numerical = " << numericalDerivative << std::endl;
+  }
+
+  // back to the start point
+  this->evalFit( startPoint.data() );
+
+  LogThrowIf( nbMismatches != 0, nbMismatches << " components of the analytic gradient differ from the finite differences by more than "
+                                 << _analyticGradientTolerance_ << " (relative)." );
+  LogInfo << "The analytic gradient matches the finite differences." << std::endl;
+}
+
 // Local Variables:
 // mode:c++
 // c-basic-offset:2
@@ -8,6 +8,7 @@
 #include "Parameter.h"
 #include "JsonBaseClass.h"
 #include "ParameterThrowerMarkHarz.h"
+#include "TruncatedGaussianSampler.h"
 
 #include "Logger.h"
 #include "GenericToolbox.Root.h"
@@ -38,9 +39,17 @@ public:
 
   // Post-init
   void processCovarianceMatrix(); // invert the matrices, and make sure fixed parameters are detached from correlations
+  /// The throwers keep their own copy of the stripped covariance matrix: has to be
+  /// called if the matrix changes. Changed bounds are picked up at the next throw.
+  void invalidateThrowCache();
 
   // Setters
   void setMaskedForPropagation(bool maskedForPropagation_){ _maskedForPropagation_ = maskedForPropagation_; }
+  /// boundedThrowMethod and the Gibbs sweeps are read by the ParametersManager
+  void setBoundedThrowConfig(const std::string& boundedThrowMethod_, int nbGibbsSweeps_, int nbGibbsBurnInSweeps_){
+    _boundedThrowMethod_ = boundedThrowMethod_; _nbGibbsSweeps_ = nbGibbsSweeps_; _nbGibbsBurnInSweeps_ = nbGibbsBurnInSweeps_;
+    invalidateThrowCache();
+  }
 
   // Getters
   [[nodiscard]] bool isEnabled() const{ return _isEnabled_; }
@@ -130,6 +139,9 @@ private:
   bool _devUseParLimitsOnEigen_{false};
   bool _maskForToyGeneration_{false};
   int _nbParameterDefinition_{-1};
+  int _nbGibbsSweeps_{5}; // set by the ParametersManager
+  int _nbGibbsBurnInSweeps_{100};
+  std::string _boundedThrowMethod_{"Rejection"};
   double _nominalStepSize_{std::nan("unset")};
   int _maxNbEigenParameters_{-1};
   double _maxEigenFraction_{1};
@@ -181,6 +193,7 @@ private:
   std::shared_ptr<TMatrixD> _choleskyMatrix_{nullptr};
   GenericToolbox::CorrelatedVariablesSampler _correlatedVariableThrower_{};
   std::shared_ptr<ParameterThrowerMarkHarz> _markHartzGen_{nullptr};
+  TruncatedGaussianSampler _truncatedGaussSampler_{};
 
 };
 
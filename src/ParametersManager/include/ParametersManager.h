@@ -7,9 +7,11 @@
 
 #include "ParameterSet.h"
 #include "Parameter.h"
+#include "TruncatedGaussianSampler.h"
 
 #include "TMatrixD.h"
 
+#include <functional>
 #include <vector>
 #include <memory>
 
@@ -26,7 +28,7 @@ public:
   void setParameterSetListConfig(const JsonType& parameterSetListConfig_){ _parameterSetListConfig_ = parameterSetListConfig_; }
   void setReThrowParSetIfOutOfBounds(bool reThrowParSetIfOutOfBounds_){ _reThrowParSetIfOutOfBounds_ = reThrowParSetIfOutOfBounds_; }
   void setThrowToyParametersWithGlobalCov(bool throwToyParametersWithGlobalCov_){ _throwToyParametersWithGlobalCov_ = throwToyParametersWithGlobalCov_; }
-  void setGlobalCovarianceMatrix(const std::shared_ptr<TMatrixD> &globalCovarianceMatrix){ _globalCovarianceMatrix_ = globalCovarianceMatrix; }
+  void setGlobalCovarianceMatrix(const std::shared_ptr<TMatrixD> &globalCovarianceMatrix){ _globalCovarianceMatrix_ = globalCovarianceMatrix; invalidateThrowCache(); }
 
   // const getters
   [[nodiscard]] const std::shared_ptr<TMatrixD> &getGlobalCovarianceMatrix() const{ return _globalCovarianceMatrix_; }
@@ -34,6 +36,7 @@ public:
   [[nodiscard]] const std::vector<ParameterSet> &getParameterSetsList() const{ return _parameterSetList_; }
 
   // getters
+  /// invalidateThrowCache() has to be called if the content is modified after a throw
   std::shared_ptr<TMatrixD> &getGlobalCovarianceMatrix(){ return _globalCovarianceMatrix_; }
   std::vector<ParameterSet> &getParameterSetsList(){ return _parameterSetList_; }
 
@@ -50,23 +53,44 @@ public:
   void throwParametersFromGlobalCovariance(bool quietVerbose_ = true);
   ParameterSet* getFitParameterSetPtr(const std::string& name_);
 
+  /// Batched version of the global covariance throws: the deltas to the prior
+  /// of the stripped parameters, one column per throw, with a single
+  /// matrix-matrix product. beforeThrowFct_(iThrow) is called before the
+  /// normal deviates of each throw are drawn from gRandom (e.g. to seed it).
+  TMatrixD throwGlobalCovarianceDeltas(int nThrows_, const std::function<void(int)>& beforeThrowFct_ = {});
+  /// Move the parameters to the given throw. Returns false if the throw is
+  /// out of bounds and reThrowParSetIfOutOfBounds is set.
+  bool applyGlobalCovarianceThrow(const TMatrixD& deltas_, int iThrow_, bool quietVerbose_ = true);
+  /// The stripped covariance and its Cholesky factor are kept between throws
+  void invalidateThrowCache();
+
   // Logger related
   static void muteLogger();
   static void unmuteLogger();
 
 private:
+  /// Rebuild the stripped covariance if the selection of thrown parameters changed
+  void updateStrippedCovarianceMatrix();
+  /// Single throw of the stripped parameters within their bounds (Gibbs sampler)
+  TMatrixD throwTruncatedGlobalCovarianceDeltas();
+
   // config
   bool _reThrowParSetIfOutOfBounds_{true};
   bool _throwToyParametersWithGlobalCov_{false};
+  int _nbGibbsSweeps_{5};
+  int _nbGibbsBurnInSweeps_{100};
+  std::string _boundedThrowMethod_{"Rejection"};
   JsonType _parameterSetListConfig_{};
 
   // internals
   std::vector<ParameterSet> _parameterSetList_{};
   std::vector<Parameter*> _globalCovParList_{};
   std::vector<Parameter*> _strippedParameterList_{};
+  std::vector<int> _strippedGlobalIndexList_{};
   std::shared_ptr<TMatrixD> _globalCovarianceMatrix_{nullptr};
   std::shared_ptr<TMatrixD> _strippedCovarianceMatrix_{nullptr};
   std::shared_ptr<TMatrixD> _choleskyMatrix_{nullptr};
+  TruncatedGaussianSampler _truncatedGaussSampler_{};
 
 };
 
@@ -144,10 +144,16 @@ void ParameterSet::muteLogger(){ Logger::setIsMuted(true ); }
 void ParameterSet::unmuteLogger(){ Logger::setIsMuted(false ); }
 
 // Post-init
+void ParameterSet::invalidateThrowCache(){
+  _truncatedGaussSampler_ = TruncatedGaussianSampler();
+}
 void ParameterSet::processCovarianceMatrix(){
 
   if( _priorCovarianceMatrix_ == nullptr ){ return; } // nothing to do
 
+  // the stripped matrix is rebuilt below
+  this->invalidateThrowCache();
+
   LogInfo << "Stripping the matrix from fixed/disabled parameters..." << std::endl;
   int nbParameters{0};
   for( const auto& par : _parameterList_ ){
@@ -490,6 +496,31 @@ void ParameterSet::throwParameters( bool rethrowIfNotInbounds_, double gain_){
       }
 
 
+    }
+    else if( rethrowIfNotInbounds_ and _boundedThrowMethod_ == "Gibbs" ){
+      LogInfo << "Throwing parameters for " << _name_ << " within their bounds (Gibbs sampler)" << std::endl;
+
+      if( not _truncatedGaussSampler_.isInitialized() ){
+        _truncatedGaussSampler_.setNbSweeps(_nbGibbsSweeps_);
+        _truncatedGaussSampler_.setNbBurnInSweeps(_nbGibbsBurnInSweeps_);
+        _truncatedGaussSampler_.setCovarianceMatrix(*_strippedCovarianceMatrix_);
+      }
+
+      // the thrown values are prior + gain * delta
+      std::vector<double> minDeltaList{}, maxDeltaList{}, deltaList{};
+      for( auto& par : _parameterList_ ){
+        if( not ParameterSet::isValidCorrelatedParameter(par) ){ continue; }
+        minDeltaList.emplace_back( (par.getMinValue() - par.getPriorValue()) / gain_ );
+        maxDeltaList.emplace_back( (par.getMaxValue() - par.getPriorValue()) / gain_ );
+      }
+
+      std::function<void()> gibbsThrowFct = [&](){
+        _truncatedGaussSampler_.throwDeltas(minDeltaList, maxDeltaList, deltaList, *gRandom);
+        for( size_t iPar = 0 ; iPar < deltaList.size() ; iPar++ ){ throwsList[int(iPar)] = deltaList[iPar]; }
+      };
+
+      // only the bounds of the eigen parameters can still trigger a rethrow
+      throwParsFct( gibbsThrowFct );
     }
     else{
       LogInfo << "Throwing parameters for " << _name_ << " using Cholesky matrix" << std::endl;
@@ -9,6 +9,8 @@
 #include "GenericToolbox.Json.h"
 #include "Logger.h"
 
+#include "TRandom.h"
+
 #include <sstream>
 
 
@@ -28,6 +30,11 @@ void ParametersManager::readConfigImpl(){
 
   _reThrowParSetIfOutOfBounds_ = GenericToolbox::Json::fetchValue(_config_, "reThrowParSetIfOutOfBounds", _reThrowParSetIfOutOfBounds_);
   _throwToyParametersWithGlobalCov_ = GenericToolbox::Json::fetchValue(_config_, "throwToyParametersWithGlobalCov", _throwToyParametersWithGlobalCov_);
+  _boundedThrowMethod_ = GenericToolbox::Json::fetchValue(_config_, "boundedThrowMethod", _boundedThrowMethod_);
+  _nbGibbsSweeps_ = GenericToolbox::Json::fetchValue(_config_, "nbGibbsSweeps", _nbGibbsSweeps_);
+  _nbGibbsBurnInSweeps_ = GenericToolbox::Json::fetchValue(_config_, "nbGibbsBurnInSweeps", _nbGibbsBurnInSweeps_);
+  LogThrowIf(_boundedThrowMethod_ != "Rejection" and _boundedThrowMethod_ != "Gibbs",
+             "Unknown boundedThrowMethod: \"" << _boundedThrowMethod_ << "\". Available: Rejection, Gibbs");
 
   LogInfo << "Reading parameter configuration..." << std::endl;
   _parameterSetList_.clear(); // make sure there nothing in case readConfig is called more than once
@@ -35,6 +42,7 @@ void ParametersManager::readConfigImpl(){
   for( const auto& parameterSetConfig : _parameterSetListConfig_ ){
     _parameterSetList_.emplace_back();
     _parameterSetList_.back().readConfig( parameterSetConfig );
+    _parameterSetList_.back().setBoundedThrowConfig( _boundedThrowMethod_, _nbGibbsSweeps_, _nbGibbsBurnInSweeps_ );
     LogInfo << _parameterSetList_.back().getSummary() << std::endl;
   }
   LogInfo << _parameterSetList_.size() << " parameter sets defined." << std::endl;
@@ -56,6 +64,7 @@ void ParametersManager::initializeImpl(){
   LogInfo << "Total number of parameters: " << nEnabledPars << std::endl;
 
   LogInfo << "Building global covariance matrix (" << nEnabledPars << "x" << nEnabledPars << ")" << std::endl;
+  this->invalidateThrowCache();
   _globalCovarianceMatrix_ = std::make_shared<TMatrixD>(nEnabledPars, nEnabledPars );
   int parSetOffset = 0;
   for( auto& parSet : _parameterSetList_ ){
@@ -171,29 +180,6 @@ void ParametersManager::throwParametersFromParSetCovariance(){
 }
 void ParametersManager::throwParametersFromGlobalCovariance(bool quietVerbose_){
 
-  if( _strippedCovarianceMatrix_ == nullptr ){
-    LogInfo << "Creating stripped global covariance matrix..." << std::endl;
-    LogThrowIf( _globalCovarianceMatrix_ == nullptr, "Global covariance matrix not set." );
-
-    _strippedParameterList_.clear();
-    for( int iGlobPar = 0 ; iGlobPar < _globalCovarianceMatrix_->GetNrows() ; iGlobPar++ ){
-      if( _globalCovParList_[iGlobPar]->isFixed() ){ continue; }
-      if( _globalCovParList_[iGlobPar]->isFree() and (*_globalCovarianceMatrix_)[iGlobPar][iGlobPar] == 0 ){ continue; }
-      _strippedParameterList_.emplace_back( _globalCovParList_[iGlobPar] );
-    }
-
-    int nStripped{int(_strippedParameterList_.size())};
-    _strippedCovarianceMatrix_ = std::make_shared<TMatrixD>(nStripped, nStripped);
-
-    for( int iStrippedPar = 0 ; iStrippedPar < nStripped ; iStrippedPar++ ){
-      int iGlobPar{GenericToolbox::findElementIndex(_strippedParameterList_[iStrippedPar], _globalCovParList_)};
-      for( int jStrippedPar = 0 ; jStrippedPar < nStripped ; jStrippedPar++ ){
-        int jGlobPar{GenericToolbox::findElementIndex(_strippedParameterList_[jStrippedPar], _globalCovParList_)};
-        (*_strippedCovarianceMatrix_)[iStrippedPar][jStrippedPar] = (*_globalCovarianceMatrix_)[iGlobPar][jGlobPar];
-      }
-    }
-  }
-
   bool isLoggerAlreadyMuted{Logger::isMuted()};
   GenericToolbox::ScopedGuard g{
       [&](){ if(quietVerbose_ and not isLoggerAlreadyMuted) Logger::setIsMuted(true); },
@@ -204,6 +190,20 @@ void ParametersManager::throwParametersFromGlobalCovariance(bool quietVerbose_){
     Logger::setIsMuted(quietVerbose_);
   }
 
+  int throwNb{0};
+  while( true ){
+    throwNb++;
+    // the Gibbs sampler respects the bounds of the parameters, only the eigen bounds can trigger a rethrow
+    auto deltas = ( _reThrowParSetIfOutOfBounds_ and _boundedThrowMethod_ == "Gibbs" ) ?
+        this->throwTruncatedGlobalCovarianceDeltas() : this->throwGlobalCovarianceDeltas(1);
+    if( this->applyGlobalCovarianceThrow(deltas, 0, quietVerbose_) ){ break; }
+    LogWarning << "Re-throwing attempt #" << throwNb << std::endl;
+  }
+}
+TMatrixD ParametersManager::throwGlobalCovarianceDeltas(int nThrows_, const std::function<void(int)>& beforeThrowFct_){
+  LogThrowIf(nThrows_ <= 0, "Invalid number of throws: " << nThrows_);
+  this->updateStrippedCovarianceMatrix();
+
   if( _choleskyMatrix_ == nullptr ){
     LogInfo << "Generating global cholesky matrix" << std::endl;
     _choleskyMatrix_ = std::shared_ptr<TMatrixD>(
@@ -211,83 +211,95 @@ void ParametersManager::throwParametersFromGlobalCovariance(bool quietVerbose_){
     );
   }
 
-  bool keepThrowing{true};
-  int throwNb{0};
+  // the normal deviates are drawn throw after throw, as with a single throw
+  int nPars{_choleskyMatrix_->GetNrows()};
+  TMatrixD normalDeviates(nPars, nThrows_);
+  for( int iThrow = 0 ; iThrow < nThrows_ ; iThrow++ ){
+    if( beforeThrowFct_ ){ beforeThrowFct_(iThrow); }
+    for( int iPar = 0 ; iPar < nPars ; iPar++ ){ normalDeviates[iPar][iThrow] = gRandom->Gaus(0, 1); }
+  }
 
-  while( keepThrowing ){
-    throwNb++;
-    bool rethrow{false};
-    auto throws = GenericToolbox::throwCorrelatedParameters(_choleskyMatrix_.get());
-    for( int iPar = 0 ; iPar < _choleskyMatrix_->GetNrows() ; iPar++ ){
-      auto* parPtr = _strippedParameterList_[iPar];
-      parPtr->setParameterValue( parPtr->getPriorValue() + throws[iPar] );
-      if( _reThrowParSetIfOutOfBounds_ ){
-        if      ( not std::isnan(parPtr->getMinValue()) and parPtr->getParameterValue() < parPtr->getMinValue() ){
-          rethrow = true;
-          LogAlert << GenericToolbox::ColorCodes::redLightText << "thrown value lower than min bound -> " << GenericToolbox::ColorCodes::resetColor
-                   << parPtr->getSummary(true) << std::endl;
-        }
-        else if( not std::isnan(parPtr->getMaxValue()) and parPtr->getParameterValue() > parPtr->getMaxValue() ){
-          rethrow = true;
-          LogAlert << GenericToolbox::ColorCodes::redLightText <<"thrown value higher than max bound -> " << GenericToolbox::ColorCodes::resetColor
-                   << parPtr->getSummary(true) << std::endl;
-        }
+  return {*_choleskyMatrix_, TMatrixD::kMult, normalDeviates};
+}
+bool ParametersManager::applyGlobalCovarianceThrow(const TMatrixD& deltas_, int iThrow_, bool quietVerbose_){
+  LogThrowIf(_strippedCovarianceMatrix_ == nullptr or deltas_.GetNrows() != int(_strippedParameterList_.size()),
+             "The throws don't match the stripped covariance matrix.");
+  LogThrowIf(iThrow_ < 0 or iThrow_ >= deltas_.GetNcols(), "Invalid throw index: " << iThrow_);
+
+  bool isLoggerAlreadyMuted{Logger::isMuted()};
+  GenericToolbox::ScopedGuard g{
+      [&](){ if(quietVerbose_ and not isLoggerAlreadyMuted) Logger::setIsMuted(true); },
+      [&](){ if(quietVerbose_ and not isLoggerAlreadyMuted) Logger::setIsMuted(false); }
+  };
+
+  bool isInBounds{true};
+  for( int iPar = 0 ; iPar < deltas_.GetNrows() ; iPar++ ){
+    auto* parPtr = _strippedParameterList_[iPar];
+    parPtr->setParameterValue( parPtr->getPriorValue() + deltas_[iPar][iThrow_] );
+    if( _reThrowParSetIfOutOfBounds_ ){
+      if      ( not std::isnan(parPtr->getMinValue()) and parPtr->getParameterValue() < parPtr->getMinValue() ){
+        isInBounds = false;
+        LogAlert << GenericToolbox::ColorCodes::redLightText << "thrown value lower than min bound -> " << GenericToolbox::ColorCodes::resetColor
+                 << parPtr->getSummary(true) << std::endl;
+      }
+      else if( not std::isnan(parPtr->getMaxValue()) and parPtr->getParameterValue() > parPtr->getMaxValue() ){
+        isInBounds = false;
+        LogAlert << GenericToolbox::ColorCodes::redLightText <<"thrown value higher than max bound -> " << GenericToolbox::ColorCodes::resetColor
+                 << parPtr->getSummary(true) << std::endl;
       }
     }
+  }
+
+  // Making sure eigen decomposed parameters get the conversion done
+  for( auto& parSet : _parameterSetList_ ){
+    if( not parSet.isEnabled() ) continue;
+    if( parSet.isEnableEigenDecomp() ){
+      parSet.propagateOriginalToEigen();
 
-    // Making sure eigen decomposed parameters get the conversion done
-    for( auto& parSet : _parameterSetList_ ){
-      if( not parSet.isEnabled() ) continue;
-      if( parSet.isEnableEigenDecomp() ){
-        parSet.propagateOriginalToEigen();
-
-        // also check the bounds of real parameter space
-        if( _reThrowParSetIfOutOfBounds_ ){
-          for( auto& par : parSet.getEigenParameterList() ){
-            if( not par.isEnabled() ) continue;
-            if( not par.isValueWithinBounds() ){
-              // re-do the throwing
-              rethrow = true;
-              break;
-            }
+      // also check the bounds of real parameter space
+      if( _reThrowParSetIfOutOfBounds_ ){
+        for( auto& par : parSet.getEigenParameterList() ){
+          if( not par.isEnabled() ) continue;
+          if( not par.isValueWithinBounds() ){
+            isInBounds = false;
+            break;
           }
         }
       }
     }
+  }
 
+  if( not isInBounds ){ return false; }
 
-    if( rethrow ){
-      // wrap back to the while loop
-      LogWarning << "Re-throwing attempt #" << throwNb << std::endl;
-      continue;
+  for( auto& parSet : _parameterSetList_ ){
+    LogInfo << parSet.getName() << ":" << std::endl;
+    for( auto& par : parSet.getParameterList() ){
+      LogScopeIndent;
+      if( ParameterSet::isValidCorrelatedParameter(par) ){
+        par.setThrowValue( par.getParameterValue() );
+        LogInfo << "Thrown par " << par.getFullTitle() << ": " << par.getPriorValue();
+        LogInfo << " → " << par.getParameterValue() << std::endl;
+      }
     }
-    else{
-      for( auto& parSet : _parameterSetList_ ){
-        LogInfo << parSet.getName() << ":" << std::endl;
-        for( auto& par : parSet.getParameterList() ){
-          LogScopeIndent;
-          if( ParameterSet::isValidCorrelatedParameter(par) ){
-            par.setThrowValue( par.getParameterValue() );
-            LogInfo << "Thrown par " << par.getFullTitle() << ": " << par.getPriorValue();
-            LogInfo << " → " << par.getParameterValue() << std::endl;
-          }
-        }
-        if( parSet.isEnableEigenDecomp() ){
-          LogInfo << "Translated to eigen space:" << std::endl;
-          for( auto& eigenPar : parSet.getEigenParameterList() ){
-            LogScopeIndent;
-            eigenPar.setThrowValue( eigenPar.getParameterValue() );
-            LogInfo << "Eigen par " << eigenPar.getFullTitle() << ": " << eigenPar.getPriorValue();
-            LogInfo << " → " << eigenPar.getParameterValue() << std::endl;
-          }
-        }
+    if( parSet.isEnableEigenDecomp() ){
+      LogInfo << "Translated to eigen space:" << std::endl;
+      for( auto& eigenPar : parSet.getEigenParameterList() ){
+        LogScopeIndent;
+        eigenPar.setThrowValue( eigenPar.getParameterValue() );
+        LogInfo << "Eigen par " << eigenPar.getFullTitle() << ": " << eigenPar.getPriorValue();
+        LogInfo << " → " << eigenPar.getParameterValue() << std::endl;
       }
-
     }
-
-    // reached this point: all parameters are within bounds
-    keepThrowing = false;
   }
+
+  return true;
+}
+void ParametersManager::invalidateThrowCache(){
+  _strippedGlobalIndexList_.clear();
+  _strippedParameterList_.clear();
+  _strippedCovarianceMatrix_ = nullptr;
+  _choleskyMatrix_ = nullptr;
+  _truncatedGaussSampler_ = TruncatedGaussianSampler();
 }
 
 void ParametersManager::moveParametersToPrior(){
@@ -319,3 +331,60 @@ ParameterSet* ParametersManager::getFitParameterSetPtr(const std::string& name_)
   return const_cast<ParameterSet*>(const_cast<const ParametersManager*>(this)->getFitParameterSetPtr(name_));
 }
 
+// private
+void ParametersManager::updateStrippedCovarianceMatrix(){
+  LogThrowIf( _globalCovarianceMatrix_ == nullptr, "Global covariance matrix not set." );
+
+  // the selection is cheap to redo: parameters might have been fixed since the last throw
+  std::vector<int> strippedGlobalIndexList{};
+  strippedGlobalIndexList.reserve( _globalCovParList_.size() );
+  for( int iGlobPar = 0 ; iGlobPar < _globalCovarianceMatrix_->GetNrows() ; iGlobPar++ ){
+    if( _globalCovParList_[iGlobPar]->isFixed() ){ continue; }
+    if( _globalCovParList_[iGlobPar]->isFree() and (*_globalCovarianceMatrix_)[iGlobPar][iGlobPar] == 0 ){ continue; }
+    strippedGlobalIndexList.emplace_back( iGlobPar );
+  }
+
+  if( _strippedCovarianceMatrix_ != nullptr and strippedGlobalIndexList == _strippedGlobalIndexList_ ){ return; }
+
+  LogInfo << "Creating stripped global covariance matrix..." << std::endl;
+  _strippedGlobalIndexList_ = std::move( strippedGlobalIndexList );
+  _choleskyMatrix_ = nullptr;
+  _truncatedGaussSampler_ = TruncatedGaussianSampler();
+
+  int nStripped{int(_strippedGlobalIndexList_.size())};
+  _strippedParameterList_.clear();
+  _strippedParameterList_.reserve( nStripped );
+  for( int iGlobPar : _strippedGlobalIndexList_ ){ _strippedParameterList_.emplace_back( _globalCovParList_[iGlobPar] ); }
+
+  _strippedCovarianceMatrix_ = std::make_shared<TMatrixD>(nStripped, nStripped);
+  for( int iStrippedPar = 0 ; iStrippedPar < nStripped ; iStrippedPar++ ){
+    const double* globalRow{(*_globalCovarianceMatrix_)[_strippedGlobalIndexList_[iStrippedPar]].GetPtr()};
+    for( int jStrippedPar = 0 ; jStrippedPar < nStripped ; jStrippedPar++ ){
+      (*_strippedCovarianceMatrix_)[iStrippedPar][jStrippedPar] = globalRow[_strippedGlobalIndexList_[jStrippedPar]];
+    }
+  }
+}
+TMatrixD ParametersManager::throwTruncatedGlobalCovarianceDeltas(){
+  this->updateStrippedCovarianceMatrix();
+
+  if( not _truncatedGaussSampler_.isInitialized() ){
+    LogInfo << "Initializing the truncated gaussian sampler (" << _nbGibbsBurnInSweeps_ << " burn-in sweeps, "
+            << _nbGibbsSweeps_ << " Gibbs sweeps per throw)" << std::endl;
+    _truncatedGaussSampler_.setNbSweeps( _nbGibbsSweeps_ );
+    _truncatedGaussSampler_.setNbBurnInSweeps( _nbGibbsBurnInSweeps_ );
+    _truncatedGaussSampler_.setCovarianceMatrix( *_strippedCovarianceMatrix_ );
+  }
+
+  int nStripped{int(_strippedParameterList_.size())};
+  std::vector<double> minDeltaList(nStripped), maxDeltaList(nStripped), deltaList(nStripped);
+  for( int iPar = 0 ; iPar < nStripped ; iPar++ ){
+    auto* parPtr = _strippedParameterList_[iPar];
+    minDeltaList[iPar] = parPtr->getMinValue() - parPtr->getPriorValue();
+    maxDeltaList[iPar] = parPtr->getMaxValue() - parPtr->getPriorValue();
+  }
+  _truncatedGaussSampler_.throwDeltas( minDeltaList, maxDeltaList, deltaList, *gRandom );
+
+  TMatrixD out(nStripped, 1);
+  for( int iPar = 0 ; iPar < nStripped ; iPar++ ){ out[iPar][0] = deltaList[iPar]; }
+  return out;
+}
@@ -9,6 +9,7 @@
 #include "ParametersManager.h"
 #include "DialCollection.h"
 #include "EventDialCache.h"
+#include "GroupedDialEngine.h"
 #include "PlotGenerator.h"
 #include "JsonBaseClass.h"
 #include "SampleSet.h"
@@ -21,6 +22,14 @@
 
 class Propagator : public JsonBaseClass {
 
+public:
+  /// Derivatives of the statistical likelihood with respect to the content
+  /// and to the sum of squared weights (error^2) of each bin of a sample.
+  struct BinLikelihoodDerivative{
+    std::vector<double> content{};
+    std::vector<double> sumW2{};
+  };
+
 protected:
   void readConfigImpl() override;
   void initializeImpl() override;
@@ -44,9 +53,11 @@ public:
   [[nodiscard]] bool isLoadAsimovData() const { return _loadAsimovData_; }
   [[nodiscard]] bool isShowEventBreakdown() const { return _showEventBreakdown_; }
   [[nodiscard]] bool isDebugPrintLoadedEvents() const { return _debugPrintLoadedEvents_; }
+  [[nodiscard]] bool isUseSinglePrecisionDials() const { return _useGroupedDialEngine_ and _groupedDialEngine_.isUseSinglePrecision(); }
   [[nodiscard]] int getDebugPrintLoadedEventsNbPerSample() const { return _debugPrintLoadedEventsNbPerSample_; }
   [[nodiscard]] int getIThrow() const { return _iThrow_; }
   [[nodiscard]] const EventDialCache& getEventDialCache() const { return _eventDialCache_; }
+  [[nodiscard]] const GroupedDialEngine& getGroupedDialEngine() const { return _groupedDialEngine_; }
   [[nodiscard]] const ParametersManager &getParametersManager() const { return _parManager_; }
   [[nodiscard]] const std::vector<DialCollection> &getDialCollectionList() const{ return _dialCollectionList_; }
   [[nodiscard]] const SampleSet &getSampleSet() const { return _sampleSet_; }
@@ -57,16 +68,41 @@ public:
   ParametersManager &getParametersManager(){ return _parManager_; }
   PlotGenerator &getPlotGenerator(){ return _plotGenerator_; }
   EventDialCache& getEventDialCache(){ return _eventDialCache_; }
+  GroupedDialEngine& getGroupedDialEngine(){ return _groupedDialEngine_; }
   std::vector<DialCollection> &getDialCollectionList(){ return _dialCollectionList_; }
 
   // Core
   void buildDialCache();
   void propagateParameters();
   void resetEventWeights();
+
+  /// Same as propagateParameters(), but the events are reweighted through the
+  /// dial interfaces in double precision. Used as a reference to check the
+  /// accuracy of the single precision dials.
+  void propagateParametersWithDialInterfaces();
+
+  /// First step of propagateParameters(): the eigen parameters are converted
+  /// (if enabled) and the dial inputs are updated, but the events are not
+  /// reweighted. Used to feed the PropagatorReplica.
+  void updateDialInputs();
   void reweightMcEvents();
   void refillMcHistograms();
   void clearContent();
 
+  /// The next propagation re-evaluates every event and refills every bin.
+  /// Must be called if the MC event weights have been modified outside the
+  /// propagation (e.g. stat throws), as incremental updates only recompute
+  /// the events whose dial inputs changed.
+  void requestFullReweight();
+
+  /// Evaluate the gradient of the statistical likelihood with respect to the
+  /// (original) parameters as gradient_[iParSet][iPar]. The likelihood
+  /// derivatives are given for each sample of the SampleSet and are
+  /// contracted on the fly with the per-bin d(weight)/d(parameter), so the
+  /// bins x parameters jacobian is never stored. The parameters must have
+  /// been propagated beforehand.
+  void evalStatGradient(const std::vector<BinLikelihoodDerivative>& binDerivativeList_, std::vector<std::vector<double>>& gradient_);
+
   // Misc
   [[nodiscard]] std::string getSampleBreakdownTableStr() const;
   void printBreakdowns();
@@ -77,10 +113,14 @@ public:
 
 protected:
   void initializeThreads();
+  void propagateEigenToOriginal();
 
   // multithreading
   void reweightMcEvents(int iThread_);
+  void evalDialResponses(int iThread_);
   void refillMcHistogramsFct( int iThread_);
+  void evalStatGradientFct( int iThread_);
+  void requestUpdatedBinsRefill();
 
 private:
   // Parameters
@@ -89,6 +129,9 @@ private:
   bool _debugPrintLoadedEvents_{false};
   bool _devSingleThreadReweight_{false};
   bool _devSingleThreadHistFill_{false};
+  bool _useGroupedDialEngine_{true};
+  bool _enableIncrementalReweight_{true};
+  bool _useSinglePrecisionDials_{false};
   int _debugPrintLoadedEventsNbPerSample_{5};
   JsonType _parameterInjectorMc_;
   JsonType _parameterInjectorToy_;
@@ -101,11 +144,18 @@ private:
   bool _showEventBreakdown_{true};
   bool _enableEigenToOrigInPropagate_{true};
   int _iThrow_{-1};
+  bool _requireFullHistogramRefill_{true};
+  bool _refillRequestedBinsOnly_{false};
+
+  // analytic gradient
+  const std::vector<BinLikelihoodDerivative>* _binLikelihoodDerivativeListPtr_{nullptr};
+  std::vector<std::vector<std::vector<double>>> _threadStatGradientList_{}; // [iThread][iParSet][iPar]
 
   // Sub-layers
   SampleSet _sampleSet_{};
   PlotGenerator _plotGenerator_{};
   EventDialCache _eventDialCache_{};
+  GroupedDialEngine _groupedDialEngine_{};
   ParametersManager _parManager_{};
 
   // A vector of all the dial collections used by all the fit samples.
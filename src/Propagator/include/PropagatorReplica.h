@@ -0,0 +1,106 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#ifndef GUNDAM_PROPAGATOR_REPLICA_H
+#define GUNDAM_PROPAGATOR_REPLICA_H
+
+#include "Propagator.h"
+
+#include "TRandom.h"
+
+#include <vector>
+
+
+/// Lightweight copy of the MC side of a Propagator. The events, the bin
+/// definitions and the flattened dials of the GroupedDialEngine are shared
+/// with the Propagator and only read, while the replica owns its dial inputs,
+/// responses, event weights and bin contents. Several replicas can then
+/// propagate different parameter values concurrently, one per thread.
+///
+/// The dial inputs are copied from the DialInputBuffer of the Propagator with
+/// copyInputs(), which has to be called from a single thread once the inputs
+/// have been updated.
+class PropagatorReplica{
+
+public:
+  struct SampleBuffer{
+    const Sample* samplePtr{nullptr};
+    std::vector<double> eventWeightList{}; // same slots as the MC WeightStore
+    std::vector<double> binContentList{};
+    std::vector<double> binErrorList{};
+  };
+
+  /// The grouped dial engine evaluates the dials from external inputs only
+  /// if every dial has a dedicated type.
+  static bool isSupported(const Propagator& propagator_);
+
+public:
+  explicit PropagatorReplica(const Propagator& propagator_);
+
+  // const getters
+  [[nodiscard]] const std::vector<SampleBuffer>& getSampleBufferList() const{ return _sampleBufferList_; }
+
+  /// False if the events or the dials of the Propagator have been rebuilt
+  /// since the replica has been created
+  [[nodiscard]] bool isUpToDate() const;
+
+  /// Snapshot of the current dial inputs of the Propagator
+  void copyInputs();
+
+  /// Evaluate the dials, reweight the MC events and refill the bins
+  void propagate();
+
+  /// Write the bin contents (and optionally the event weights) in the MC
+  /// containers, as if the Propagator had propagated the same inputs.
+  void copyToSampleSet(SampleSet& sampleSet_, bool copyEventWeights_ = false) const;
+
+  /// Same as SampleElement::throwEventMcError() on the replica content
+  void throwEventMcError(TRandom& rng_);
+
+  /// Same as SampleElement::throwStatError() on the replica content
+  void throwStatError(TRandom& rng_, bool useGaussThrow_ = false);
+
+private:
+  const Propagator& _propagator_;
+
+  std::vector<double> _inputValueList_{};
+  std::vector<char> _inputIsMaskedList_{};
+  std::vector<double> _responseList_{};
+
+  // engine event -> replica sample buffer
+  std::vector<int> _eventSampleIndexList_{};
+
+  std::vector<SampleBuffer> _sampleBufferList_{};
+
+};
+
+
+#endif //GUNDAM_PROPAGATOR_REPLICA_H
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
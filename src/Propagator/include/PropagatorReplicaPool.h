@@ -0,0 +1,103 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#ifndef GUNDAM_PROPAGATOR_REPLICA_POOL_H
+#define GUNDAM_PROPAGATOR_REPLICA_POOL_H
+
+#include "PropagatorReplica.h"
+#include "Propagator.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+
+/// A set of PropagatorReplica evaluating a list of points by batches. The
+/// parameters of each point are moved in a single thread, the replicas
+/// snapshot the dial inputs, then they are propagated concurrently by a job
+/// of the parallel worker. The results are read back in the point order.
+///
+/// The job is registered by build() and removed by clear(): the pool can't be
+/// copied nor moved.
+class PropagatorReplicaPool{
+
+public:
+  /// Called in the main thread: move the parameters of the point and update
+  /// the dial inputs of the propagator. Returns false to skip the point.
+  typedef std::function<bool(int iPt_)> LoadPointFct;
+  /// Called with the replica holding the point once it has been propagated
+  typedef std::function<void(int iPt_, PropagatorReplica& replica_)> ReplicaPointFct;
+
+public:
+  explicit PropagatorReplicaPool(std::string jobName_) : _jobName_(std::move(jobName_)) {}
+  PropagatorReplicaPool(const PropagatorReplicaPool&) = delete;
+  PropagatorReplicaPool& operator=(const PropagatorReplicaPool&) = delete;
+  ~PropagatorReplicaPool(){ this->clear(); }
+
+  // const getters
+  [[nodiscard]] bool empty() const{ return _replicaList_.empty(); }
+  [[nodiscard]] int getNbReplicas() const{ return int(_replicaList_.size()); }
+
+  /// False if the events or the dials of the Propagator have been rebuilt
+  /// since the replicas have been created
+  [[nodiscard]] bool isUpToDate() const;
+
+  /// Create the replicas and register the job propagating them
+  void build(Propagator& propagator_, int nbReplicas_);
+  /// Remove the replicas and their job
+  void clear();
+
+  /// Evaluate nPoints_ points by batches of getNbReplicas(). postPropagate_
+  /// is optional and is called from the worker threads right after the
+  /// propagation of each point, readPoint_ is called in the main thread in
+  /// the point order. The samples of the propagator are overwritten by the
+  /// replicas, so a full reweight is requested once done.
+  void evalBatch(
+      int nPoints_,
+      const LoadPointFct& loadPoint_,
+      const ReplicaPointFct& readPoint_,
+      const ReplicaPointFct& postPropagate_ = {}
+  );
+
+private:
+  void propagateReplicasFct(int iThread_);
+
+  std::string _jobName_{};
+  Propagator* _propagatorPtr_{nullptr};
+
+  std::vector<PropagatorReplica> _replicaList_{};
+  std::vector<int> _pointIndexList_{}; // point held by each replica in the current batch, -1 if none
+  ReplicaPointFct _postPropagate_{};
+
+};
+
+
+#endif //GUNDAM_PROPAGATOR_REPLICA_POOL_H
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
@@ -61,6 +61,13 @@ void Propagator::readConfigImpl(){
   _debugPrintLoadedEventsNbPerSample_ = GenericToolbox::Json::fetchValue(_config_, "debugPrintLoadedEventsNbPerSample", _debugPrintLoadedEventsNbPerSample_);
   _devSingleThreadReweight_ = GenericToolbox::Json::fetchValue(_config_, "devSingleThreadReweight", _devSingleThreadReweight_);
   _devSingleThreadHistFill_ = GenericToolbox::Json::fetchValue(_config_, "devSingleThreadHistFill", _devSingleThreadHistFill_);
+  _useGroupedDialEngine_ = GenericToolbox::Json::fetchValue(_config_, "useGroupedDialEngine", _useGroupedDialEngine_);
+  _enableIncrementalReweight_ = GenericToolbox::Json::fetchValue(_config_, "enableIncrementalReweight", _enableIncrementalReweight_);
+  _useSinglePrecisionDials_ = GenericToolbox::Json::fetchValue(_config_, "useSinglePrecisionDials", _useSinglePrecisionDials_);
+  if( _useSinglePrecisionDials_ and not _useGroupedDialEngine_ ){
+    LogAlert << "useSinglePrecisionDials is only available with the grouped dial engine. Ignored." << std::endl;
+    _useSinglePrecisionDials_ = false;
+  }
 
   // EventDialCache parameters
   if( GenericToolbox::Json::doKeyExist(_config_, "globalEventReweightCap") ){
@@ -140,6 +147,14 @@ void Propagator::buildDialCache(){
   _eventDialCache_.shrinkIndexedCache();
   _eventDialCache_.buildReferenceCache(_sampleSet_, _dialCollectionList_);
 
+  // flatten the dials per type for the CPU reweight
+  if( _useGroupedDialEngine_ ){
+    _groupedDialEngine_.setEnableIncrementalUpdate( _enableIncrementalReweight_ );
+    _groupedDialEngine_.setUseSinglePrecision( _useSinglePrecisionDials_ );
+    _groupedDialEngine_.build(_eventDialCache_);
+  }
+  _requireFullHistogramRefill_ = true;
+
   // be extra sure the dial input will request an update
   for( auto& dialCollection : _dialCollectionList_ ){
     for( auto& dialInput : dialCollection.getDialInputBufferList() ){
@@ -148,17 +163,28 @@ void Propagator::buildDialCache(){
   }
 }
 void Propagator::propagateParameters(){
+  this->propagateEigenToOriginal();
+  this->reweightMcEvents();
+  this->refillMcHistograms();
+}
+void Propagator::propagateParametersWithDialInterfaces(){
+  bool useGroupedDialEngine{_useGroupedDialEngine_};
+  _useGroupedDialEngine_ = false;
 
-  if( _enableEigenToOrigInPropagate_ ){
-    // Only real parameters are propagated on the spectra -> need to convert the eigen to original
-    for( auto& parSet : _parManager_.getParameterSetsList() ){
-      if( parSet.isEnableEigenDecomp() ){ parSet.propagateEigenToOriginal(); }
+  // the dial interfaces only re-evaluate the responses of updated inputs
+  for( auto& dialCollection : _dialCollectionList_ ){
+    for( auto& dialInput : dialCollection.getDialInputBufferList() ){
+      dialInput.invalidateBuffers();
     }
   }
+  this->propagateParameters();
 
-  this->reweightMcEvents();
-  this->refillMcHistograms();
-
+  _useGroupedDialEngine_ = useGroupedDialEngine;
+  this->requestFullReweight();
+}
+void Propagator::updateDialInputs(){
+  this->propagateEigenToOriginal();
+  this->resetEventWeights();
 }
 void Propagator::resetEventWeights(){
   std::for_each(_dialCollectionList_.begin(), _dialCollectionList_.end(), [&]( DialCollection& dc_){
@@ -178,10 +204,25 @@ void Propagator::reweightMcEvents() {
   }
 #endif
   if( not usedGPU ){
+    bool useGroupedDialEngine{_useGroupedDialEngine_ and _groupedDialEngine_.isBuilt()};
+    if( useGroupedDialEngine ){ _groupedDialEngine_.updateInputs(); }
+
     if( not _devSingleThreadReweight_ ){
+      // all the dial responses need to be ready before the events get reweighted
+      if( useGroupedDialEngine ){ GundamGlobals::getParallelWorker().runJob("Propagator::evalDialResponses"); }
       GundamGlobals::getParallelWorker().runJob("Propagator::reweightMcEvents");
     }
-    else{ this->reweightMcEvents(-1); }
+    else{
+      if( useGroupedDialEngine ){ this->evalDialResponses(-1); }
+      this->reweightMcEvents(-1);
+    }
+
+    // only the bins of the updated events will need a refill
+    if( useGroupedDialEngine and _groupedDialEngine_.isIncrementalUpdate() ){ this->requestUpdatedBinsRefill(); }
+    else{ _requireFullHistogramRefill_ = true; }
+  }
+  else{
+    _requireFullHistogramRefill_ = true;
   }
 
   reweightTimer.stop();
@@ -189,8 +230,10 @@ void Propagator::reweightMcEvents() {
 void Propagator::refillMcHistograms(){
   refillHistogramTimer.start();
 
+  _refillRequestedBinsOnly_ = not _requireFullHistogramRefill_;
   if( not _devSingleThreadHistFill_ ){ GundamGlobals::getParallelWorker().runJob("Propagator::refillMcHistograms"); }
   else{ refillMcHistogramsFct(-1); }
+  _requireFullHistogramRefill_ = false;
 
   refillHistogramTimer.stop();
 }
@@ -210,8 +253,43 @@ void Propagator::clearContent(){
     }
   }
   _eventDialCache_ = EventDialCache();
+  _groupedDialEngine_.clear();
+  _requireFullHistogramRefill_ = true;
 
 }
+void Propagator::requestFullReweight(){
+  _groupedDialEngine_.requestFullUpdate();
+  _requireFullHistogramRefill_ = true;
+}
+void Propagator::evalStatGradient(const std::vector<BinLikelihoodDerivative>& binDerivativeList_, std::vector<std::vector<double>>& gradient_){
+  LogThrowIf(binDerivativeList_.size() != _sampleSet_.getSampleList().size(),
+             "Expecting the likelihood derivatives of " << _sampleSet_.getSampleList().size() << " samples, got " << binDerivativeList_.size());
+
+  auto& parSetList = _parManager_.getParameterSetsList();
+
+  // one gradient per thread, summed at the end
+  _threadStatGradientList_.resize( GundamGlobals::getParallelWorker().getNbThreads() );
+  for( auto& threadGradient : _threadStatGradientList_ ){
+    threadGradient.resize( parSetList.size() );
+    for( size_t iParSet = 0 ; iParSet < parSetList.size() ; iParSet++ ){
+      threadGradient[iParSet].assign( parSetList[iParSet].getNbParameters(), 0 );
+    }
+  }
+
+  _binLikelihoodDerivativeListPtr_ = &binDerivativeList_;
+  if( not _devSingleThreadReweight_ ){ GundamGlobals::getParallelWorker().runJob("Propagator::evalStatGradient"); }
+  else{ evalStatGradientFct(-1); }
+  _binLikelihoodDerivativeListPtr_ = nullptr;
+
+  gradient_ = _threadStatGradientList_[0];
+  for( size_t iThread = 1 ; iThread < _threadStatGradientList_.size() ; iThread++ ){
+    for( size_t iParSet = 0 ; iParSet < parSetList.size() ; iParSet++ ){
+      for( size_t iPar = 0 ; iPar < gradient_[iParSet].size() ; iPar++ ){
+        gradient_[iParSet][iPar] += _threadStatGradientList_[iThread][iParSet][iPar];
+      }
+    }
+  }
+}
 
 // Misc
 std::string Propagator::getSampleBreakdownTableStr() const{
@@ -304,6 +382,14 @@ void Propagator::printBreakdowns(){
 }
 
 // Protected
+void Propagator::propagateEigenToOriginal(){
+  if( not _enableEigenToOrigInPropagate_ ){ return; }
+
+  // Only real parameters are propagated on the spectra -> need to convert the eigen to original
+  for( auto& parSet : _parManager_.getParameterSetsList() ){
+    if( parSet.isEnableEigenDecomp() ){ parSet.propagateEigenToOriginal(); }
+  }
+}
 void Propagator::initializeThreads() {
 
   GundamGlobals::getParallelWorker().addJob(
@@ -311,11 +397,21 @@ void Propagator::initializeThreads() {
       [this](int iThread){ this->reweightMcEvents(iThread); }
   );
 
+  GundamGlobals::getParallelWorker().addJob(
+      "Propagator::evalDialResponses",
+      [this](int iThread){ this->evalDialResponses(iThread); }
+  );
+
   GundamGlobals::getParallelWorker().addJob(
       "Propagator::refillMcHistograms",
       [this](int iThread){ this->refillMcHistogramsFct(iThread); }
   );
 
+  GundamGlobals::getParallelWorker().addJob(
+      "Propagator::evalStatGradient",
+      [this](int iThread){ this->evalStatGradientFct(iThread); }
+  );
+
 }
 
 // multithreading
@@ -324,6 +420,11 @@ void Propagator::reweightMcEvents(int iThread_) {
   //! Warning: everything you modify here, may significantly slow down the
   //! fitter
 
+  if( _useGroupedDialEngine_ and _groupedDialEngine_.isBuilt() ){
+    _groupedDialEngine_.applyEventWeights(iThread_);
+    return;
+  }
+
   auto bounds = GenericToolbox::ParallelWorker::getThreadBoundIndices(
       iThread_, GundamGlobals::getParallelWorker().getNbThreads(),
       int(_eventDialCache_.getCache().size())
@@ -336,9 +437,79 @@ void Propagator::reweightMcEvents(int iThread_) {
   );
 
 }
+void Propagator::evalDialResponses(int iThread_){
+  _groupedDialEngine_.evalDialResponses(iThread_);
+}
 void Propagator::refillMcHistogramsFct( int iThread_){
   for( auto& sample : _sampleSet_.getSampleList() ){
-    sample.getMcContainer().refillHistogram(iThread_);
+    sample.getMcContainer().refillHistogram(iThread_, _refillRequestedBinsOnly_);
+  }
+}
+void Propagator::evalStatGradientFct( int iThread_){
+  auto& gradient = _threadStatGradientList_[iThread_ == -1 ? 0 : iThread_];
+  auto& sampleList = _sampleSet_.getSampleList();
+
+  auto bounds = GenericToolbox::ParallelWorker::getThreadBoundIndices(
+      iThread_, GundamGlobals::getParallelWorker().getNbThreads(),
+      int(_eventDialCache_.getCache().size())
+  );
+
+  std::vector<EventDialCache::WeightDerivative> derivativeList;
+  const EventUtils::WeightStore* lastWeightStore{nullptr};
+  const BinLikelihoodDerivative* binDerivative{nullptr};
+  for( int iEntry = bounds.beginIndex ; iEntry < bounds.endIndex ; iEntry++ ){
+    auto& entry = _eventDialCache_.getCache()[iEntry];
+
+    // events out of the binning don't contribute to the likelihood
+    int iBin{entry.weightStorePtr->bin[entry.weightIndex]};
+    if( iBin < 0 ){ continue; }
+
+    if( entry.weightStorePtr != lastWeightStore ){
+      // entries are grouped by sample: this lookup is rarely done
+      lastWeightStore = entry.weightStorePtr;
+      binDerivative = nullptr;
+      for( size_t iSample = 0 ; iSample < sampleList.size() ; iSample++ ){
+        if( &sampleList[iSample].getMcContainer().getWeightStore() != lastWeightStore ){ continue; }
+        binDerivative = &(*_binLikelihoodDerivativeListPtr_)[iSample];
+        break;
+      }
+      LogThrowIf( binDerivative == nullptr, "Could not find the MC container of a cache entry." );
+    }
+
+    double weight{_eventDialCache_.evalEntryWeightGradient( entry, derivativeList )};
+
+    // d(content)/dw = 1 and d(sumW2)/dw = 2w
+    double coefficient{binDerivative->content[iBin] + 2 * weight * binDerivative->sumW2[iBin]};
+    if( coefficient == 0 ){ continue; }
+
+    for( auto& derivative : derivativeList ){
+      gradient[derivative.parSetIndex][derivative.parIndex] += coefficient * derivative.value;
+    }
+  }
+}
+void Propagator::requestUpdatedBinsRefill(){
+  // called in a single thread after an incremental reweight
+  auto& weightStoreList = _groupedDialEngine_.getEventWeightStoreList();
+  auto& weightIndexList = _groupedDialEngine_.getEventWeightIndexList();
+
+  const EventUtils::WeightStore* lastWeightStore{nullptr};
+  SampleElement* container{nullptr};
+  for( auto iEvent : _groupedDialEngine_.getUpdatedEventList() ){
+    auto* weightStore = weightStoreList[iEvent];
+    if( weightStore != lastWeightStore ){
+      // events are sorted: this lookup is done about once per sample
+      lastWeightStore = weightStore;
+      container = nullptr;
+      for( auto& sample : _sampleSet_.getSampleList() ){
+        if( &sample.getMcContainer().getWeightStore() != weightStore ){ continue; }
+        container = &sample.getMcContainer();
+        break;
+      }
+      LogThrowIf( container == nullptr, "Could not find the MC container of an updated event." );
+    }
+
+    int iBin{weightStore->bin[weightIndexList[iEvent]]};
+    if( iBin >= 0 ){ container->requestBinRefill( iBin ); }
   }
 }
 
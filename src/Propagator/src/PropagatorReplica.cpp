@@ -0,0 +1,186 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#include "PropagatorReplica.h"
+
+#include "GundamGlobals.h"
+
+#include "Logger.h"
+
+#include "TMath.h"
+
+#include <unordered_map>
+#include <algorithm>
+
+LoggerInit([]{
+  Logger::setUserHeaderStr("[PropagatorReplica]");
+});
+
+
+bool PropagatorReplica::isSupported(const Propagator& propagator_){
+#ifdef GUNDAM_USING_CACHE_MANAGER
+  // the propagator weights would be computed by the Cache::Manager
+  if( GundamGlobals::getEnableCacheManager() ){ return false; }
+#endif
+  return propagator_.getGroupedDialEngine().isBuilt() and not propagator_.getGroupedDialEngine().hasGenericDials();
+}
+
+PropagatorReplica::PropagatorReplica(const Propagator& propagator_) : _propagator_(propagator_) {
+  LogThrowIf( not isSupported(_propagator_), "The propagator can't be replicated: the grouped dial engine is not built or has generic dials." );
+
+  auto& engine = _propagator_.getGroupedDialEngine();
+  auto& sampleList = _propagator_.getSampleSet().getSampleList();
+
+  std::unordered_map<const EventUtils::WeightStore*, int> sampleIndexDict{};
+  _sampleBufferList_.resize( sampleList.size() );
+  for( size_t iSample = 0 ; iSample < sampleList.size() ; iSample++ ){
+    auto& mc = sampleList[iSample].getMcContainer();
+    _sampleBufferList_[iSample].samplePtr = &sampleList[iSample];
+    _sampleBufferList_[iSample].eventWeightList = mc.getWeightStore().base;
+    _sampleBufferList_[iSample].binContentList.resize( mc.getHistogram().nBins, 0 );
+    _sampleBufferList_[iSample].binErrorList.resize( mc.getHistogram().nBins, 0 );
+    sampleIndexDict[&mc.getWeightStore()] = int(iSample);
+  }
+
+  _eventSampleIndexList_.reserve( engine.getNbEvents() );
+  for( auto* weightStorePtr : engine.getEventWeightStoreList() ){
+    auto it = sampleIndexDict.find( weightStorePtr );
+    LogThrowIf( it == sampleIndexDict.end(), "An event of the grouped dial engine doesn't belong to any MC sample." );
+    _eventSampleIndexList_.emplace_back( it->second );
+  }
+
+  _responseList_.resize( engine.getNbDials(), 1 );
+}
+
+bool PropagatorReplica::isUpToDate() const{
+  auto& engine = _propagator_.getGroupedDialEngine();
+  if( not engine.isBuilt() ){ return false; }
+  if( engine.getNbEvents() != _eventSampleIndexList_.size() or engine.getNbDials() != _responseList_.size() ){ return false; }
+
+  auto& sampleList = _propagator_.getSampleSet().getSampleList();
+  if( sampleList.size() != _sampleBufferList_.size() ){ return false; }
+  for( size_t iSample = 0 ; iSample < sampleList.size() ; iSample++ ){
+    if( sampleList[iSample].getMcContainer().getWeightStore().size() != _sampleBufferList_[iSample].eventWeightList.size() ){ return false; }
+  }
+  return true;
+}
+
+void PropagatorReplica::copyInputs(){
+  _propagator_.getGroupedDialEngine().fetchInputs( _inputValueList_, _inputIsMaskedList_ );
+}
+void PropagatorReplica::propagate(){
+  auto& engine = _propagator_.getGroupedDialEngine();
+
+  engine.evalDialResponses( _inputValueList_, _inputIsMaskedList_, _responseList_ );
+
+  // events without dials stay at their base weight
+  for( auto& sampleBuffer : _sampleBufferList_ ){
+    auto& base = sampleBuffer.samplePtr->getMcContainer().getWeightStore().base;
+    std::copy( base.begin(), base.end(), sampleBuffer.eventWeightList.begin() );
+  }
+
+  // same loop as GroupedDialEngine::applyEventWeights()
+  auto& weightStoreList = engine.getEventWeightStoreList();
+  auto& weightIndexList = engine.getEventWeightIndexList();
+  for( size_t iEvent = 0 ; iEvent < _eventSampleIndexList_.size() ; iEvent++ ){
+    double reweight{engine.evalEventReweight( _responseList_.data(), int(iEvent) )};
+
+    int weightIndex{weightIndexList[iEvent]};
+    _sampleBufferList_[_eventSampleIndexList_[iEvent]].eventWeightList[weightIndex] = weightStoreList[iEvent]->base[weightIndex] * reweight;
+  }
+
+  for( auto& sampleBuffer : _sampleBufferList_ ){
+    auto& binList = sampleBuffer.samplePtr->getMcContainer().getHistogram().binList;
+    for( size_t iBin = 0 ; iBin < sampleBuffer.binContentList.size() ; iBin++ ){
+      // same sums as SampleElement::refillHistogram()
+      double content{0};
+      double error{0};
+      for( auto iEvent : binList[iBin].eventIndexList ){
+        double weight{sampleBuffer.eventWeightList[iEvent]};
+        content += weight;
+        error += weight * weight;
+      }
+      sampleBuffer.binContentList[iBin] = content;
+      sampleBuffer.binErrorList[iBin] = sqrt(error);
+    }
+  }
+}
+void PropagatorReplica::copyToSampleSet(SampleSet& sampleSet_, bool copyEventWeights_) const{
+  LogThrowIf( sampleSet_.getSampleList().size() != _sampleBufferList_.size(), "Sample set doesn't match the replica." );
+
+  for( size_t iSample = 0 ; iSample < _sampleBufferList_.size() ; iSample++ ){
+    auto& sampleBuffer = _sampleBufferList_[iSample];
+    auto& mc = sampleSet_.getSampleList()[iSample].getMcContainer();
+
+    auto& binList = mc.getHistogram().binList;
+    for( size_t iBin = 0 ; iBin < sampleBuffer.binContentList.size() ; iBin++ ){
+      binList[iBin].content = sampleBuffer.binContentList[iBin];
+      binList[iBin].error = sampleBuffer.binErrorList[iBin];
+    }
+
+    if( copyEventWeights_ ){
+      std::copy( sampleBuffer.eventWeightList.begin(), sampleBuffer.eventWeightList.end(), mc.getWeightStore().current.begin() );
+    }
+  }
+}
+
+void PropagatorReplica::throwEventMcError(TRandom& rng_){
+  for( auto& sampleBuffer : _sampleBufferList_ ){
+    auto& binList = sampleBuffer.samplePtr->getMcContainer().getHistogram().binList;
+    for( size_t iBin = 0 ; iBin < sampleBuffer.binContentList.size() ; iBin++ ){
+      double weightSum{0};
+      for( auto iEvent : binList[iBin].eventIndexList ){
+        // rng_.Poisson(1) -> returns an INT -> can be 0
+        sampleBuffer.eventWeightList[iEvent] *= rng_.Poisson(1);
+        weightSum += sampleBuffer.eventWeightList[iEvent];
+      }
+      sampleBuffer.binContentList[iBin] = weightSum;
+    }
+  }
+}
+void PropagatorReplica::throwStatError(TRandom& rng_, bool useGaussThrow_){
+  for( auto& sampleBuffer : _sampleBufferList_ ){
+    auto& binList = sampleBuffer.samplePtr->getMcContainer().getHistogram().binList;
+    for( size_t iBin = 0 ; iBin < sampleBuffer.binContentList.size() ; iBin++ ){
+      double& content = sampleBuffer.binContentList[iBin];
+      if( content == 0 ){ continue; }
+
+      int nCounts;
+      if( not useGaussThrow_ ){ nCounts = rng_.Poisson( content ); }
+      else{ nCounts = std::max( int( rng_.Gaus(content, TMath::Sqrt(content)) ), 0 ); }
+
+      for( auto iEvent : binList[iBin].eventIndexList ){
+        sampleBuffer.eventWeightList[iEvent] *= double(nCounts) / content;
+      }
+      content = nCounts;
+    }
+  }
+}
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
@@ -0,0 +1,124 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#include "PropagatorReplicaPool.h"
+
+#include "GundamGlobals.h"
+
+#include "GenericToolbox.Utils.h"
+
+#include "Logger.h"
+
+#include <algorithm>
+
+LoggerInit([]{
+  Logger::setUserHeaderStr("[PropagatorReplicaPool]");
+});
+
+
+bool PropagatorReplicaPool::isUpToDate() const{
+  for( auto& replica : _replicaList_ ){
+    if( not replica.isUpToDate() ){ return false; }
+  }
+  return true;
+}
+
+void PropagatorReplicaPool::build(Propagator& propagator_, int nbReplicas_){
+  LogThrowIf( nbReplicas_ < 1, "Invalid number of propagator replicas: " << nbReplicas_ );
+  this->clear();
+
+  _propagatorPtr_ = &propagator_;
+  _replicaList_.reserve( nbReplicas_ );
+  for( int iReplica = 0 ; iReplica < nbReplicas_ ; iReplica++ ){ _replicaList_.emplace_back( propagator_ ); }
+  _pointIndexList_.assign( nbReplicas_, -1 );
+
+  GundamGlobals::getParallelWorker().addJob(
+      _jobName_,
+      [this](int iThread){ this->propagateReplicasFct(iThread); }
+  );
+}
+void PropagatorReplicaPool::clear(){
+  if( _replicaList_.empty() ){ return; }
+  GundamGlobals::getParallelWorker().removeJob( _jobName_ );
+  _replicaList_.clear();
+  _pointIndexList_.clear();
+  _propagatorPtr_ = nullptr;
+}
+
+void PropagatorReplicaPool::evalBatch(
+    int nPoints_,
+    const LoadPointFct& loadPoint_,
+    const ReplicaPointFct& readPoint_,
+    const ReplicaPointFct& postPropagate_
+){
+  LogThrowIf( _replicaList_.empty(), "The propagator replicas have not been built." );
+
+  GenericToolbox::ScopedGuard g{
+      [&](){ _postPropagate_ = postPropagate_; },
+      [&](){
+        std::fill( _pointIndexList_.begin(), _pointIndexList_.end(), -1 );
+        _postPropagate_ = nullptr;
+        // the content of the samples doesn't match the state of the propagator anymore
+        _propagatorPtr_->requestFullReweight();
+      }
+  };
+
+  int nbReplicas{int(_replicaList_.size())};
+  for( int iFirstPt = 0 ; iFirstPt < nPoints_ ; iFirstPt += nbReplicas ){
+
+    // the parameters are moved in a single thread, then only the dial inputs are copied
+    for( int iReplica = 0 ; iReplica < nbReplicas ; iReplica++ ){
+      int iPt{iFirstPt + iReplica};
+      _pointIndexList_[iReplica] = -1;
+      if( iPt >= nPoints_ or not loadPoint_( iPt ) ){ continue; }
+      _replicaList_[iReplica].copyInputs();
+      _pointIndexList_[iReplica] = iPt;
+    }
+
+    GundamGlobals::getParallelWorker().runJob( _jobName_ );
+
+    for( int iReplica = 0 ; iReplica < nbReplicas ; iReplica++ ){
+      if( _pointIndexList_[iReplica] == -1 ){ continue; }
+      readPoint_( _pointIndexList_[iReplica], _replicaList_[iReplica] );
+    }
+  }
+}
+
+void PropagatorReplicaPool::propagateReplicasFct(int iThread_){
+  int nThreads{GundamGlobals::getParallelWorker().getNbThreads()};
+  if( iThread_ == -1 ){ iThread_ = 0; nThreads = 1; }
+
+  for( int iReplica = iThread_ ; iReplica < int(_replicaList_.size()) ; iReplica += nThreads ){
+    if( _pointIndexList_[iReplica] == -1 ){ continue; }
+    _replicaList_[iReplica].propagate();
+    if( _postPropagate_ ){ _postPropagate_( _pointIndexList_[iReplica], _replicaList_[iReplica] ); }
+  }
+}
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
@@ -29,19 +29,17 @@ public:
 
   // const getters
   [[nodiscard]] const EventUtils::Indices& getIndices() const{ return _indices_; }
-  [[nodiscard]] const EventUtils::Weights& getWeights() const{ return _weights_; }
   [[nodiscard]] const EventUtils::Variables& getVariables() const{ return _variables_; }
 
   // mutable getters
   EventUtils::Indices& getIndices(){ return _indices_; }
-  EventUtils::Weights& getWeights(){ return _weights_; }
   EventUtils::Variables& getVariables(){ return _variables_; }
 
-  // const core
-  [[nodiscard]] double getEventWeight() const;
-
   // misc
-  void fillBinIndex(const DataBinSet& binSet_){ _indices_.bin = _variables_.findBinIndex(binSet_); }
+  /// The refill loops read the bin index from the WeightStore of the sample:
+  /// both copies are only set here.
+  void setBinIndex(int bin_, EventUtils::WeightStore& weightStore_){ _indices_.bin = bin_; weightStore_.bin[_indices_.weight] = bin_; }
+  void fillBinIndex(const DataBinSet& binSet_, EventUtils::WeightStore& weightStore_){ setBinIndex(_variables_.findBinIndex(binSet_), weightStore_); }
 
   [[nodiscard]] std::string getSummary() const;
   friend std::ostream& operator <<( std::ostream& o, const Event& this_ ){ o << this_.getSummary(); return o; }
@@ -49,7 +47,6 @@ public:
 private:
   // internals
   EventUtils::Indices _indices_{};
-  EventUtils::Weights _weights_{};
   EventUtils::Variables _variables_{};
 
 #ifdef GUNDAM_USING_CACHE_MANAGER
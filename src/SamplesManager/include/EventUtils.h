@@ -7,6 +7,7 @@
 
 #include "DataBin.h"
 #include "DataBinSet.h"
+#include "CompiledFormula.h"
 
 #include "GenericToolbox.Utils.h"
 #include "GenericToolbox.Root.h"
@@ -14,6 +15,8 @@
 #include <RtypesCore.h> // ROOT types
 
 #include <string>
+#include <vector>
+#include <memory>
 #include <iostream>
 
 
@@ -24,18 +27,75 @@ namespace EventUtils{
     Long64_t entry{-1}; // which entry of the TChain?
     int sample{-1}; // this information is lost in the EventDialCache manager
     int bin{-1}; // which bin of the sample?
+    int weight{-1}; // which slot of the sample WeightStore?
 
     [[nodiscard]] std::string getSummary() const;
     friend std::ostream& operator <<( std::ostream& o, const Indices& this_ ){ o << this_.getSummary(); return o; }
   };
 
-  struct Weights{
-    double base{1};
-    double current{1};
+  /// Structure-of-arrays holding the weights of every event of a SampleElement.
+  /// Events only keep their slot index (Indices::weight) so that the reweight
+  /// and histogram refill loops run over contiguous memory.
+  struct WeightStore{
+    std::vector<double> base{};
+    std::vector<double> current{};
+    std::vector<int> bin{};
+
+    [[nodiscard]] size_t size() const{ return base.size(); }
+
+    void resize(size_t size_){ base.resize(size_, 1); current.resize(size_, 1); bin.resize(size_, -1); }
+    void shrinkToFit(){ base.shrink_to_fit(); current.shrink_to_fit(); bin.shrink_to_fit(); }
+    void clear(){ base.clear(); current.clear(); bin.clear(); }
+
+    void resetCurrentWeight(size_t index_){ current[index_] = base[index_]; }
+    void applyPermutation(const std::vector<size_t>& permutation_);
+
+    [[nodiscard]] std::string getSummary(size_t index_) const;
+  };
+
+  class Variables;
+
+  /// Typed columnar storage of the event variables of one loaded dataset.
+  /// Each variable is kept in a contiguous array of its native type instead
+  /// of one heap allocated AnyType per event. Events only keep their row
+  /// index (see Variables::bindToStore()).
+  class VariableStore{
+
+  public:
+    struct Column{
+      GenericToolbox::AnyType prototype{}; // type information only, the values are in data
+      CompiledFormula::ValueType valueType{CompiledFormula::ValueType::Double};
+      bool isNumeric{false};
+      size_t valueSize{0};
+      std::vector<unsigned char> data{};
+
+      [[nodiscard]] const void* getAddress(size_t row_) const{ return &data[row_ * valueSize]; }
+      void* getAddress(size_t row_){ return &data[row_ * valueSize]; }
+    };
+
+  public:
+    VariableStore() = default;
+
+    // const-getters
+    [[nodiscard]] size_t getNbRows() const{ return _nbRows_; }
+    [[nodiscard]] const std::shared_ptr<std::vector<std::string>>& getNameListPtr() const{ return _nameListPtr_; }
+    [[nodiscard]] const std::vector<Column>& getColumnList() const{ return _columnList_; }
+
+    // mutable-getters
+    std::vector<Column>& getColumnList(){ return _columnList_; }
+
+    // memory
+    /// Take the variable names and types of a standalone Variables buffer
+    void defineColumns(const Variables& prototype_);
+    void resize(size_t nRows_);
+    void shrinkToFit();
+    [[nodiscard]] size_t getMemorySize() const;
+
+  private:
+    size_t _nbRows_{0};
+    std::vector<Column> _columnList_{};
+    std::shared_ptr<std::vector<std::string>> _nameListPtr_{nullptr};
 
-    void resetCurrentWeight(){ current = base; }
-    [[nodiscard]] std::string getSummary() const;
-    friend std::ostream& operator <<( std::ostream& o, const Weights& this_ ){ o << this_.getSummary(); return o; }
   };
 
   class Variables{
@@ -48,6 +108,7 @@ namespace EventUtils{
 
       template<typename T>void set(const T& value_){ var = value_; updateCache(); }
       void set(const GenericToolbox::LeafForm& leafForm_);
+      void setRawData(const void* data_, size_t size_);
       [[nodiscard]] const GenericToolbox::AnyType& get() const { return var; }
       [[nodiscard]] double getVarAsDouble() const { return cache; }
 
@@ -68,17 +129,36 @@ namespace EventUtils{
 
     // setters
     void setVarNameList(const std::shared_ptr<std::vector<std::string>>& nameListPtr_);
+    /// The values are then read and written in the row_-th row of the store.
+    /// The standalone variables are released.
+    void bindToStore(VariableStore* storePtr_, size_t row_);
 
     // const-getters
-    [[nodiscard]] const std::shared_ptr<std::vector<std::string>>& getNameListPtr() const{ return _nameListPtr_; }
-    [[nodiscard]] const std::vector<Variable>& getVarList() const{ return _varList_; }
+    [[nodiscard]] bool isBoundToStore() const{ return _storePtr_ != nullptr; }
+    [[nodiscard]] size_t getStoreRow() const{ return _storeRow_; }
+    [[nodiscard]] const VariableStore* getStorePtr() const{ return _storePtr_; }
+    [[nodiscard]] const std::shared_ptr<std::vector<std::string>>& getNameListPtr() const{ return (_storePtr_ != nullptr ? _storePtr_->getNameListPtr() : _nameListPtr_); }
+    [[nodiscard]] const std::vector<Variable>& getVarList() const{ return _varList_; } // standalone only
 
     // mutable-getters
-    std::vector<Variable>& getVarList(){ return _varList_; }
+    std::vector<Variable>& getVarList(){ return _varList_; } // standalone only
+
+    // accessors (both standalone and bound to a store)
+    [[nodiscard]] int getNbVars() const;
+    [[nodiscard]] inline double getVarAsDouble(int iVar_) const;
+    [[nodiscard]] double getVarAsDouble(const std::string& name_) const{ return this->getVarAsDouble(this->findVarIndex(name_)); }
+    [[nodiscard]] const void* getVarAddress(int iVar_) const;
+    [[nodiscard]] size_t getVarSize(int iVar_) const;
+    [[nodiscard]] const GenericToolbox::AnyType& getVarPrototype(int iVar_) const; // for the type information
+    /// Standalone variables are set as double, store columns keep their type
+    void setVarValue(int iVar_, double value_);
+    void setRawData(int iVar_, const void* data_, size_t size_);
 
     // memory
     void allocateMemory( const std::vector<const GenericToolbox::LeafForm*>& leafFormList_);
     void copyData( const std::vector<const GenericToolbox::LeafForm*>& leafFormList_);
+    /// Same variable list, the values are converted if the types differ
+    void copyData( const Variables& other_ );
 
     // fetch
     [[nodiscard]] int findVarIndex( const std::string& leafName_, bool throwIfNotFound_ = true) const;
@@ -92,6 +172,9 @@ namespace EventUtils{
 
     // formula
     [[nodiscard]] double evalFormula(const TFormula* formulaPtr_, std::vector<int>* indexDict_ = nullptr) const;
+    /// indexDict_ maps the formula variables to the variable list. If not
+    /// provided, the variables are looked up by name.
+    [[nodiscard]] double evalFormula(const CompiledFormula& formula_, const std::vector<int>* indexDict_ = nullptr) const;
 
     // printouts
     [[nodiscard]] std::string getSummary() const;
@@ -102,8 +185,22 @@ namespace EventUtils{
     // keep only one list of name in memory -> shared_ptr is used to make sure it gets properly deleted
     std::shared_ptr<std::vector<std::string>> _nameListPtr_{nullptr};
 
+    // columnar mode
+    VariableStore* _storePtr_{nullptr};
+    size_t _storeRow_{0};
+
   };
 
+  double Variables::getVarAsDouble(int iVar_) const{
+    //! Warning: this is called for every event and every variable
+    if( _storePtr_ != nullptr ){
+      auto& column = _storePtr_->getColumnList()[iVar_];
+      if( not column.isNumeric ){ return std::nan("notNumeric"); }
+      return CompiledFormula::readValue(column.getAddress(_storeRow_), column.valueType);
+    }
+    return _varList_[iVar_].getVarAsDouble();
+  }
+
 #ifdef GUNDAM_USING_CACHE_MANAGER
   struct Cache{
     // An "opaque" index into the cache that is used to simplify bookkeeping.
@@ -22,6 +22,7 @@ public:
     size_t dataSetIndex{0};
     size_t eventOffSet{0};
     size_t eventNb{0};
+    std::shared_ptr<EventUtils::VariableStore> variableStore{nullptr}; // each copy of the event list has its own
   };
 
   struct Histogram{
@@ -30,7 +31,8 @@ public:
       double content{0};
       double error{0};
       const DataBin* dataBinPtr{nullptr};
-      std::vector<Event*> eventPtrList{};
+      std::vector<int> eventIndexList{}; // slots in the WeightStore
+      bool isRefillRequested{false}; // for partial refills
     };
     std::vector<Bin> binList{};
     int nBins{0};
@@ -46,16 +48,26 @@ public:
   [[nodiscard]] const std::string& getName() const{ return _name_; }
   [[nodiscard]] const std::vector<Event> &getEventList() const{ return _eventList_; }
   [[nodiscard]] const Histogram &getHistogram() const{ return _histogram_; }
+  [[nodiscard]] const EventUtils::WeightStore &getWeightStore() const{ return _weightStore_; }
 
   // mutable-getters
   std::vector<Event> &getEventList(){ return _eventList_; }
+  EventUtils::WeightStore &getWeightStore(){ return _weightStore_; }
+  Histogram &getHistogram(){ return _histogram_; }
+
+  // event weights
+  [[nodiscard]] double getEventWeight(const Event& event_) const;
 
   // core
   void buildHistogram(const DataBinSet& binning_);
   void reserveEventMemory(size_t dataSetIndex_, size_t nEvents, const Event &eventBuffer_);
   void shrinkEventList(size_t newTotalSize_);
+  void applyEventPermutation(const std::vector<size_t>& permutation_);
+  void copyEventList(const SampleElement& other_);
+  void clearEventList();
   void updateBinEventList(int iThread_ = -1);
-  void refillHistogram(int iThread_ = -1);
+  void refillHistogram(int iThread_ = -1, bool requestedBinsOnly_ = false);
+  void requestBinRefill(int iBin_){ _histogram_.binList[iBin_].isRefillRequested = true; }
 
   // event by event poisson throw -> takes into account the finite amount of stat in MC
   void throwEventMcError();
@@ -75,6 +87,7 @@ private:
   std::string _name_{};
   Histogram _histogram_{};
   std::vector<Event> _eventList_{};
+  EventUtils::WeightStore _weightStore_{}; // aligned with _eventList_
   std::vector<DatasetProperties> _loadedDatasetList_{};
 
 #ifdef GUNDAM_USING_CACHE_MANAGER
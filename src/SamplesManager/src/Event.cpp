@@ -14,19 +14,10 @@ LoggerInit([]{
 });
 
 
-// const getters
-double Event::getEventWeight() const {
-#ifdef GUNDAM_USING_CACHE_MANAGER
-  if( _cache_.valuePtr != nullptr ){ return _cache_.getWeight(); }
-#endif
-  return _weights_.current;
-}
-
 // misc
 std::string Event::getSummary() const {
   std::stringstream ss;
   ss << "Indices{" << _indices_ << "}";
-  ss << std::endl << "Weights{" << _weights_ << "}";
   ss << std::endl << "Variables{" << std::endl << _variables_ << std::endl << "}";
   return ss.str();
 }
@@ -10,6 +10,9 @@
 #include "Logger.h"
 
 #include <sstream>
+#include <cstring>
+#include <cmath>
+#include <map>
 
 LoggerInit([]{
   Logger::getUserHeader() << "[EventUtils]";
@@ -24,22 +27,77 @@ namespace EventUtils{
     ss << ", " << "entry(" << entry << ")";
     ss << ", " << "sample(" << sample << ")";
     ss << ", " << "bin(" << bin << ")";
+    ss << ", " << "weight(" << weight << ")";
     return ss.str();
   }
 }
 
 
-/// Weights
+/// WeightStore
 namespace EventUtils{
-  std::string Weights::getSummary() const{
+  void WeightStore::applyPermutation(const std::vector<size_t>& permutation_){
+    LogThrowIf(permutation_.size() != this->size(),
+               "Permutation size mismatch: " << permutation_.size() << " != " << this->size());
+    GenericToolbox::applyPermutation(base, permutation_);
+    GenericToolbox::applyPermutation(current, permutation_);
+    GenericToolbox::applyPermutation(bin, permutation_);
+  }
+  std::string WeightStore::getSummary(size_t index_) const{
     std::stringstream ss;
-    ss << "base(" << base << ")";
-    ss << ", " << "current(" << current << ")";
+    ss << "base(" << base[index_] << ")";
+    ss << ", " << "current(" << current[index_] << ")";
+    ss << ", " << "bin(" << bin[index_] << ")";
     return ss.str();
   }
 }
 
 
+/// VariableStore
+namespace EventUtils{
+  void VariableStore::defineColumns(const Variables& prototype_){
+    LogThrowIf(prototype_.getNameListPtr() == nullptr, "var name list not set.");
+    LogThrowIf(_nbRows_ != 0, "Can't redefine the columns of a filled store.");
+
+    // mapping of the ROOT leaf type tags
+    static const std::map<char, CompiledFormula::ValueType> typeTagDict{
+        {'D', CompiledFormula::ValueType::Double}, {'F', CompiledFormula::ValueType::Float},
+        {'L', CompiledFormula::ValueType::Long64}, {'l', CompiledFormula::ValueType::ULong64},
+        {'I', CompiledFormula::ValueType::Int},    {'i', CompiledFormula::ValueType::UInt},
+        {'S', CompiledFormula::ValueType::Short},  {'s', CompiledFormula::ValueType::UShort},
+        {'B', CompiledFormula::ValueType::Char},   {'b', CompiledFormula::ValueType::UChar},
+        {'O', CompiledFormula::ValueType::Bool},
+    };
+
+    _nameListPtr_ = prototype_.getNameListPtr();
+    _columnList_.clear();
+    _columnList_.resize(_nameListPtr_->size());
+    for( size_t iVar = 0 ; iVar < _columnList_.size() ; iVar++ ){
+      auto& column = _columnList_[iVar];
+      column.prototype = prototype_.getVarPrototype(int(iVar));
+      LogThrowIf(column.prototype.getPlaceHolderPtr() == nullptr,
+                 "Type of " << _nameListPtr_->at(iVar) << " is not defined.");
+      column.valueSize = column.prototype.getPlaceHolderPtr()->getVariableSize();
+
+      auto typeTag = typeTagDict.find(GenericToolbox::findOriginalVariableType(column.prototype));
+      column.isNumeric = ( typeTag != typeTagDict.end() );
+      if( column.isNumeric ){ column.valueType = typeTag->second; }
+    }
+  }
+  void VariableStore::resize(size_t nRows_){
+    _nbRows_ = nRows_;
+    for( auto& column : _columnList_ ){ column.data.resize(_nbRows_ * column.valueSize, 0); }
+  }
+  void VariableStore::shrinkToFit(){
+    for( auto& column : _columnList_ ){ column.data.shrink_to_fit(); }
+  }
+  size_t VariableStore::getMemorySize() const{
+    size_t out{0};
+    for( auto& column : _columnList_ ){ out += column.data.capacity(); }
+    return out;
+  }
+}
+
+
 /// Variables
 namespace EventUtils{
 
@@ -51,13 +109,64 @@ namespace EventUtils{
     );
     updateCache();
   }
+  void Variables::Variable::setRawData(const void* data_, size_t size_){
+    LogThrowIf(size_ != var.getPlaceHolderPtr()->getVariableSize(), "Size mismatch: " << size_ << " != " << var.getPlaceHolderPtr()->getVariableSize());
+    memcpy(var.getPlaceHolderPtr()->getVariableAddress(), data_, size_);
+    updateCache();
+  }
 
   void Variables::setVarNameList( const std::shared_ptr<std::vector<std::string>> &nameListPtr_ ){
     LogThrowIf(nameListPtr_ == nullptr, "Invalid commonNameListPtr_ provided.");
+    LogThrowIf(_storePtr_ != nullptr, "Can't set the var name list of variables bound to a store.");
     _nameListPtr_ = nameListPtr_;
     _varList_.clear();
     _varList_.resize(_nameListPtr_->size());
   }
+  void Variables::bindToStore(VariableStore* storePtr_, size_t row_){
+    LogThrowIf(storePtr_ == nullptr, "Invalid store provided.");
+    _storePtr_ = storePtr_;
+    _storeRow_ = row_;
+
+    // release the standalone memory
+    _varList_ = std::vector<Variable>();
+    _nameListPtr_ = nullptr;
+  }
+
+  // accessors
+  int Variables::getNbVars() const{
+    if( _storePtr_ != nullptr ){ return int(_storePtr_->getColumnList().size()); }
+    return int(_varList_.size());
+  }
+  const void* Variables::getVarAddress(int iVar_) const{
+    if( _storePtr_ != nullptr ){ return _storePtr_->getColumnList()[iVar_].getAddress(_storeRow_); }
+    return _varList_[iVar_].get().getPlaceHolderPtr()->getVariableAddress();
+  }
+  size_t Variables::getVarSize(int iVar_) const{
+    if( _storePtr_ != nullptr ){ return _storePtr_->getColumnList()[iVar_].valueSize; }
+    return _varList_[iVar_].get().getPlaceHolderPtr()->getVariableSize();
+  }
+  const GenericToolbox::AnyType& Variables::getVarPrototype(int iVar_) const{
+    if( _storePtr_ != nullptr ){ return _storePtr_->getColumnList()[iVar_].prototype; }
+    return _varList_[iVar_].get();
+  }
+  void Variables::setVarValue(int iVar_, double value_){
+    if( _storePtr_ != nullptr ){
+      auto& column = _storePtr_->getColumnList()[iVar_];
+      LogThrowIf(not column.isNumeric, "Can't set a number in " << this->getNameListPtr()->at(iVar_));
+      CompiledFormula::writeValue(column.getAddress(_storeRow_), column.valueType, value_);
+      return;
+    }
+    _varList_[iVar_].set(value_);
+  }
+  void Variables::setRawData(int iVar_, const void* data_, size_t size_){
+    if( _storePtr_ != nullptr ){
+      auto& column = _storePtr_->getColumnList()[iVar_];
+      LogThrowIf(size_ != column.valueSize, "Size mismatch: " << size_ << " != " << column.valueSize);
+      memcpy(column.getAddress(_storeRow_), data_, size_);
+      return;
+    }
+    _varList_[iVar_].setRawData(data_, size_);
+  }
 
   // memory
   void Variables::allocateMemory( const std::vector<const GenericToolbox::LeafForm*>& leafFormList_){
@@ -71,8 +180,44 @@ namespace EventUtils{
   }
   void Variables::copyData( const std::vector<const GenericToolbox::LeafForm*>& leafFormList_){
     size_t nLeaf{leafFormList_.size()};
+
+    if( _storePtr_ == nullptr ){
+      for( size_t iLeaf = 0 ; iLeaf < nLeaf ; iLeaf++ ){
+        _varList_[iLeaf].set( *leafFormList_[iLeaf] );
+      }
+      return;
+    }
+
     for( size_t iLeaf = 0 ; iLeaf < nLeaf ; iLeaf++ ){
-      _varList_[iLeaf].set( *leafFormList_[iLeaf] );
+      auto* leafForm = leafFormList_[iLeaf];
+      auto& column = _storePtr_->getColumnList()[iLeaf];
+      if( leafForm->getTreeFormulaPtr() != nullptr ){ leafForm->fillLocalBuffer(); }
+
+      if( leafForm->getDataSize() == column.valueSize ){
+        memcpy(column.getAddress(_storeRow_), leafForm->getDataAddress(), column.valueSize);
+        continue;
+      }
+
+      // the column has been given another type (transformed variables are stored as double)
+      CompiledFormula::ValueType leafType;
+      LogThrowIf(not column.isNumeric or not CompiledFormula::parseValueType(leafForm->getLeafTypeName(), leafType),
+                 "Can't convert " << leafForm->getLeafTypeName() << " into the column of " << this->getNameListPtr()->at(iLeaf));
+      CompiledFormula::writeValue(
+          column.getAddress(_storeRow_), column.valueType,
+          CompiledFormula::readValue(leafForm->getDataAddress(), leafType)
+      );
+    }
+  }
+  void Variables::copyData( const Variables& other_ ){
+    int nVars{this->getNbVars()};
+    LogThrowIf(other_.getNbVars() != nVars, "Variable number mismatch: " << other_.getNbVars() << " != " << nVars);
+    for( int iVar = 0 ; iVar < nVars ; iVar++ ){
+      if( other_.getVarSize(iVar) == this->getVarSize(iVar) ){
+        this->setRawData(iVar, other_.getVarAddress(iVar), other_.getVarSize(iVar));
+      }
+      else{
+        this->setVarValue(iVar, other_.getVarAsDouble(iVar));
+      }
     }
   }
 
@@ -83,10 +228,12 @@ namespace EventUtils{
     return out;
   }
   const Variables::Variable& Variables::fetchVariable(const std::string& name_) const{
+    LogThrowIf(_storePtr_ != nullptr, "Can't fetch " << name_ << " from variables bound to a store.");
     int index = this->findVarIndex(name_, true);
     return _varList_[index];
   }
   Variables::Variable& Variables::fetchVariable(const std::string& name_){
+    LogThrowIf(_storePtr_ != nullptr, "Can't fetch " << name_ << " from variables bound to a store.");
     int index = this->findVarIndex(name_, true);
     return _varList_[index];
   }
@@ -99,8 +246,8 @@ namespace EventUtils{
           return bin_.isBetweenEdges(
               edges_,
               ( edges_.varIndexCache != -1 ?
-                _varList_[edges_.varIndexCache].getVarAsDouble():    // use directly the index if available
-                this->fetchVariable(edges_.varName).getVarAsDouble() // look for the name otherwise
+                this->getVarAsDouble(edges_.varIndexCache): // use directly the index if available
+                this->getVarAsDouble(edges_.varName)        // look for the name otherwise
               )
           );
         }
@@ -117,28 +264,62 @@ namespace EventUtils{
     if ( dialItr == binList_.end() ){ return -1; }
     return int( std::distance( binList_.begin(), dialItr ) );
   }
-  int Variables::findBinIndex( const DataBinSet& binSet_) const{ return this->findBinIndex( binSet_.getBinList() ); }
+  int Variables::findBinIndex( const DataBinSet& binSet_) const{
+    if( not binSet_.isSearchIndexValid() ){ return this->findBinIndex( binSet_.getBinList() ); }
+
+    // values of the variables the search index is split along
+    static thread_local std::vector<double> searchVarValueList;
+    searchVarValueList.resize( binSet_.getSearchVarList().size() );
+    for( size_t iVar = 0 ; iVar < searchVarValueList.size() ; iVar++ ){
+      auto& searchVar = binSet_.getSearchVarList()[iVar];
+      auto& edges = binSet_.getBinList()[searchVar.binIndex].getEdgesList()[searchVar.edgesIndex];
+      searchVarValueList[iVar] = ( edges.varIndexCache != -1 ?
+          this->getVarAsDouble(edges.varIndexCache) :
+          this->getVarAsDouble(edges.varName)
+      );
+
+      // NaN passes the edge checks: keep the scan behaviour
+      if( std::isnan(searchVarValueList[iVar]) ){ return this->findBinIndex( binSet_.getBinList() ); }
+    }
+
+    auto* candidateBinList = binSet_.findCandidateBinList( searchVarValueList );
+    if( candidateBinList == nullptr ){ return -1; }
+
+    for( int iBin : *candidateBinList ){
+      if( this->isInBin( binSet_.getBinList()[iBin] ) ){ return iBin; }
+    }
+    return -1;
+  }
 
   // formula
   double Variables::evalFormula( const TFormula* formulaPtr_, std::vector<int>* indexDict_) const{
     LogThrowIf(formulaPtr_ == nullptr, GET_VAR_NAME_VALUE(formulaPtr_));
 
-    std::vector<double> parArray(formulaPtr_->GetNpar());
+    // reused buffer: no allocation per call
+    static thread_local std::vector<double> parArray;
+    parArray.resize(formulaPtr_->GetNpar());
     for( int iPar = 0 ; iPar < formulaPtr_->GetNpar() ; iPar++ ){
-      if(indexDict_ != nullptr){ parArray[iPar] = _varList_[(*indexDict_)[iPar]].getVarAsDouble(); }
-      else                     { parArray[iPar] = this->fetchVariable(formulaPtr_->GetParName(iPar)).getVarAsDouble(); }
+      if(indexDict_ != nullptr){ parArray[iPar] = this->getVarAsDouble((*indexDict_)[iPar]); }
+      else                     { parArray[iPar] = this->getVarAsDouble(formulaPtr_->GetParName(iPar)); }
     }
 
-    return formulaPtr_->EvalPar(nullptr, &parArray[0]);
+    return formulaPtr_->EvalPar(nullptr, parArray.data());
+  }
+  double Variables::evalFormula( const CompiledFormula& formula_, const std::vector<int>* indexDict_) const{
+    if( indexDict_ != nullptr ){
+      return formula_.eval([&](int iVar_){ return this->getVarAsDouble((*indexDict_)[iVar_]); });
+    }
+    return formula_.eval([&](int iVar_){ return this->getVarAsDouble(formula_.getVariableNameList()[iVar_]); });
   }
 
   // printout
   std::string Variables::getSummary() const{
     std::stringstream ss;
-    for( int iVar = 0 ; iVar < int(_varList_.size()) ; iVar++ ){
+    for( int iVar = 0 ; iVar < this->getNbVars() ; iVar++ ){
       if( not ss.str().empty() ){ ss << std::endl; }
-      ss << "  { name: " << _nameListPtr_->at(iVar);
-      ss << ", value: " << _varList_.at(iVar).get();
+      ss << "  { name: " << this->getNameListPtr()->at(iVar);
+      if( _storePtr_ != nullptr ){ ss << ", value: " << this->getVarAsDouble(iVar); }
+      else                       { ss << ", value: " << _varList_.at(iVar).get(); }
       ss << " }";
     }
     return ss.str();
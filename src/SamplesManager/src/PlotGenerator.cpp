@@ -153,6 +153,8 @@ void PlotGenerator::generateSampleHistograms(TDirectory *saveDir_, int cacheSlot
           }
         }
 
+        const SampleElement& container{isData ? sample.getDataContainer() : sample.getMcContainer()};
+
         // Filling the selected histograms
         std::function<void(int)> fillJob = [&]( int iThread_ ){
 
@@ -166,7 +168,7 @@ void PlotGenerator::generateSampleHistograms(TDirectory *saveDir_, int cacheSlot
             for( int iBin = bounds.beginIndex+1 ; iBin <= bounds.endIndex ; iBin++ ){
               hist->histPtr->SetBinContent(iBin, 0);
               for( auto* evtPtr : hist->_binEventPtrList_[iBin-1] ){
-                hist->histPtr->AddBinContent(iBin, evtPtr->getEventWeight());
+                hist->histPtr->AddBinContent(iBin, container.getEventWeight(*evtPtr));
               }
               hist->histPtr->SetBinError(iBin, TMath::Sqrt(hist->histPtr->GetBinContent(iBin)));
             }
@@ -909,13 +911,13 @@ void PlotGenerator::buildEventBinCache( const std::vector<HistHolder *> &histPtr
         for( const auto& event : *eventListPtr ){
           int splitValue;
           if( not histPtr->splitVarName.empty() ){
-            splitValue = event.getVariables().fetchVariable(histPtr->splitVarName).get().getValue<int>();
+            splitValue = int( event.getVariables().getVarAsDouble(histPtr->splitVarName) );
           }
 
           if( histPtr->splitVarName.empty() or splitValue == histPtr->splitVarValue){
 
             if( histPtr->varToPlot == "Raw" ){ iBin = event.getIndices().bin + 1; }
-            else                             { iBin = histPtr->histPtr->FindBin(event.getVariables().fetchVariable(histPtr->varToPlot).getVarAsDouble()); }
+            else                             { iBin = histPtr->histPtr->FindBin(event.getVariables().getVarAsDouble(histPtr->varToPlot)); }
 
             if( iBin > 0 and iBin <= histPtr->histPtr->GetNbinsX() ){
               // so it's a valid bin!
@@ -33,12 +33,29 @@ void SampleElement::reserveEventMemory(size_t dataSetIndex_, size_t nEvents, con
   datasetProperties.eventOffSet = _eventList_.size();
   datasetProperties.eventNb = nEvents;
 
+  // the variables of the dataset are held in typed columns
+  datasetProperties.variableStore = std::make_shared<EventUtils::VariableStore>();
+  datasetProperties.variableStore->defineColumns( eventBuffer_.getVariables() );
+  datasetProperties.variableStore->resize( nEvents );
+
   LogScopeIndent;
   LogInfo << _name_ << ": creating " << nEvents << " events ("
-          << GenericToolbox::parseSizeUnits( double(nEvents) * sizeof(eventBuffer_) )
+          << GenericToolbox::parseSizeUnits( double(nEvents) * sizeof(eventBuffer_) + double(datasetProperties.variableStore->getMemorySize()) )
           << ")" << std::endl;
 
-  _eventList_.resize(datasetProperties.eventOffSet + datasetProperties.eventNb, eventBuffer_);
+  // copying the event buffer without its standalone variables
+  Event eventTemplate;
+  eventTemplate.getIndices() = eventBuffer_.getIndices();
+  eventTemplate.getVariables().bindToStore( datasetProperties.variableStore.get(), 0 );
+
+  _eventList_.resize(datasetProperties.eventOffSet + datasetProperties.eventNb, eventTemplate);
+  _weightStore_.resize(_eventList_.size());
+
+  // each event points to its own slot of the weight store and row of the variable store
+  for( size_t iEvent = datasetProperties.eventOffSet ; iEvent < _eventList_.size() ; iEvent++ ){
+    _eventList_[iEvent].getIndices().weight = int( iEvent );
+    _eventList_[iEvent].getVariables().bindToStore( datasetProperties.variableStore.get(), iEvent - datasetProperties.eventOffSet );
+  }
 }
 void SampleElement::shrinkEventList(size_t newTotalSize_){
 
@@ -59,8 +76,54 @@ void SampleElement::shrinkEventList(size_t newTotalSize_){
           << "(+" << GenericToolbox::parseSizeUnits(double(_eventList_.size() - newTotalSize_) * sizeof(_eventList_.back()) ) << ")" << std::endl;
 
   _loadedDatasetList_.back().eventNb -= (_eventList_.size() - newTotalSize_);
+  if( _loadedDatasetList_.back().variableStore != nullptr ){
+    _loadedDatasetList_.back().variableStore->resize( _loadedDatasetList_.back().eventNb );
+    _loadedDatasetList_.back().variableStore->shrinkToFit();
+  }
   _eventList_.resize(newTotalSize_);
   _eventList_.shrink_to_fit();
+  _weightStore_.resize(newTotalSize_);
+  _weightStore_.shrinkToFit();
+}
+void SampleElement::applyEventPermutation(const std::vector<size_t>& permutation_){
+  // the events keep their row in the variable stores: no variable data is moved
+  GenericToolbox::applyPermutation( _eventList_, permutation_ );
+  _weightStore_.applyPermutation( permutation_ );
+
+  // keep the weight slots aligned with the event list
+  for( size_t iEvent = 0 ; iEvent < _eventList_.size() ; iEvent++ ){
+    _eventList_[iEvent].getIndices().weight = int( iEvent );
+  }
+}
+void SampleElement::copyEventList(const SampleElement& other_){
+  // indices are kept as both lists are aligned with their weight stores
+  _eventList_ = other_.getEventList();
+  _weightStore_ = other_.getWeightStore();
+
+  // the variables can be modified independently (e.g. the data of a toy):
+  // the stores are copied and the events are bound to the copies
+  _loadedDatasetList_ = other_._loadedDatasetList_;
+  for( auto& dataset : _loadedDatasetList_ ){
+    if( dataset.variableStore == nullptr ){ continue; }
+    dataset.variableStore = std::make_shared<EventUtils::VariableStore>( *dataset.variableStore );
+  }
+  for( auto& event : _eventList_ ){
+    auto& variables = event.getVariables();
+    if( not variables.isBoundToStore() ){ continue; }
+    bool isRebound{false};
+    for( size_t iDataset = 0 ; iDataset < _loadedDatasetList_.size() ; iDataset++ ){
+      if( variables.getStorePtr() != other_._loadedDatasetList_[iDataset].variableStore.get() ){ continue; }
+      variables.bindToStore( _loadedDatasetList_[iDataset].variableStore.get(), variables.getStoreRow() );
+      isRebound = true;
+      break;
+    }
+    LogThrowIf(not isRebound, "An event of \"" << other_._name_ << "\" is bound to a variable store it doesn't own.");
+  }
+}
+void SampleElement::clearEventList(){
+  _eventList_.clear();
+  _weightStore_.clear();
+  _loadedDatasetList_.clear(); // releases the variable stores
 }
 void SampleElement::updateBinEventList(int iThread_) {
   int nbThreads = GundamGlobals::getParallelWorker().getNbThreads();
@@ -68,22 +131,25 @@ void SampleElement::updateBinEventList(int iThread_) {
 
   if( iThread_ == 0 ){ LogScopeIndent; LogInfo << "Filling bin event cache for \"" << _name_ << "\"..." << std::endl; }
 
+  // the bin indices of the store are contiguous: much cheaper to scan than the events
+  auto& binIndexList{_weightStore_.bin};
+
   // multithread technique with iBin += nbThreads;
   int iBin{iThread_};
   while( iBin < _histogram_.nBins ){
-    size_t count = std::count_if(_eventList_.begin(), _eventList_.end(), [&]( auto& e) {return e.getIndices().bin == iBin;});
-    _histogram_.binList[iBin].eventPtrList.resize(count, nullptr);
+    size_t count = std::count(binIndexList.begin(), binIndexList.end(), iBin);
+    _histogram_.binList[iBin].eventIndexList.resize(count, -1);
 
-    // Now filling the event indexes
+    // Now filling the event indexes (ascending -> forward memory access while refilling)
     size_t index = 0;
-    std::for_each(_eventList_.begin(), _eventList_.end(), [&]( auto& e){
-      if( e.getIndices().bin == iBin){ _histogram_.binList[iBin].eventPtrList[index++] = &e; }
-    });
+    for( int iEvent = 0 ; iEvent < int(binIndexList.size()) ; iEvent++ ){
+      if( binIndexList[iEvent] == iBin ){ _histogram_.binList[iBin].eventIndexList[index++] = iEvent; }
+    }
 
     iBin += nbThreads;
   }
 }
-void SampleElement::refillHistogram(int iThread_){
+void SampleElement::refillHistogram(int iThread_, bool requestedBinsOnly_){
   int nThreads = GundamGlobals::getParallelWorker().getNbThreads();
   if( iThread_ == -1 ){ nThreads = 1; iThread_ = 0; }
 
@@ -102,10 +168,13 @@ void SampleElement::refillHistogram(int iThread_){
   // Faster that pointer shifter. -> would be slower if refillHistogram is
   // handled by the propagator
   int iBin = iThread_; // iBin += nbThreads;
+  const double* currentWeightList{_weightStore_.current.data()};
   Histogram::Bin* binPtr;
   double buffer{};
   while( iBin < _histogram_.nBins ){
     binPtr = &_histogram_.binList[iBin];
+    if( requestedBinsOnly_ and not binPtr->isRefillRequested ){ iBin += nThreads; continue; }
+    binPtr->isRefillRequested = false;
     binPtr->content = 0;
     binPtr->error = 0;
 #ifdef GUNDAM_USING_CACHE_MANAGER
@@ -117,8 +186,8 @@ void SampleElement::refillHistogram(int iThread_){
 #ifdef CACHE_MANAGER_SLOW_VALIDATION
       double content = binContentArray[iBin+1];
       double slowValue = 0.0;
-      for( auto* eventPtr : perBinEventPtrList.at(iBin)){
-        slowValue += eventPtr->getEventWeight();
+      for( auto iEvent : binPtr->eventIndexList ){
+        slowValue += getEventWeight(_eventList_[iEvent]);
       }
       double delta = std::abs(slowValue-content);
       if (delta > 1E-6) {
@@ -134,8 +203,8 @@ void SampleElement::refillHistogram(int iThread_){
     }
     else {
 #endif
-      for (auto *eventPtr: binPtr->eventPtrList) {
-        buffer = eventPtr->getEventWeight();
+      for( auto iEvent : binPtr->eventIndexList ){
+        buffer = currentWeightList[iEvent];
         binPtr->content += buffer;
         binPtr->error += buffer * buffer;
       }
@@ -155,10 +224,10 @@ void SampleElement::throwEventMcError(){
   double weightSum;
   for( auto& bin : _histogram_.binList ){
     weightSum = 0;
-    for (auto *eventPtr: bin.eventPtrList) {
+    for( auto iEvent : bin.eventIndexList ){
       // gRandom->Poisson(1) -> returns an INT -> can be 0
-      eventPtr->getWeights().current = (gRandom->Poisson(1) * eventPtr->getEventWeight());
-      weightSum += eventPtr->getEventWeight();
+      _weightStore_.current[iEvent] = (gRandom->Poisson(1) * getEventWeight(_eventList_[iEvent]));
+      weightSum += getEventWeight(_eventList_[iEvent]);
     }
     bin.content = weightSum;
   }
@@ -179,24 +248,30 @@ void SampleElement::throwStatError(bool useGaussThrow_){
           , 0 // if the throw is negative, cap it to 0
       );
     }
-    for (auto *eventPtr: bin.eventPtrList) {
+    for( auto iEvent : bin.eventIndexList ){
       // make sure refill of the histogram will produce the same hist
-      eventPtr->getWeights().current = ( eventPtr->getEventWeight()*((double) nCounts / bin.content) );
+      _weightStore_.current[iEvent] = ( getEventWeight(_eventList_[iEvent])*((double) nCounts / bin.content) );
     }
     bin.content = nCounts;
   }
 }
 
+double SampleElement::getEventWeight(const Event& event_) const{
+#ifdef GUNDAM_USING_CACHE_MANAGER
+  if( event_.getCache().valuePtr != nullptr ){ return event_.getCache().getWeight(); }
+#endif
+  return _weightStore_.current[event_.getIndices().weight];
+}
 double SampleElement::getSumWeights() const{
   double output = std::accumulate(_eventList_.begin(), _eventList_.end(), double(0.),
-                                  [](double sum_, const Event& ev_){ return sum_ + ev_.getEventWeight(); });
+                                  [this](double sum_, const Event& ev_){ return sum_ + getEventWeight(ev_); });
   return output;
 }
 size_t SampleElement::getNbBinnedEvents() const{
   return std::accumulate(
-      _eventList_.begin(), _eventList_.end(), size_t(0.),
-      []( size_t sum_, const Event &ev_ ){
-        return sum_ + (ev_.getIndices().bin != -1);
+      _weightStore_.bin.begin(), _weightStore_.bin.end(), size_t(0.),
+      []( size_t sum_, int bin_ ){
+        return sum_ + (bin_ != -1);
   });
 }
 std::shared_ptr<TH1D> SampleElement::generateRootHistogram() const{
@@ -46,20 +46,13 @@ void SampleSet::initializeImpl() {
 void SampleSet::copyMcEventListToDataContainer(){
   for( auto& sample : _sampleList_ ){
     LogInfo << "Copying MC events in sample \"" << sample.getName() << "\"" << std::endl;
-    sample.getDataContainer().getEventList().clear();
-    sample.getDataContainer().getEventList().reserve(sample.getMcContainer().getEventList().size());
-//    sample.getDataContainer().getEventList() = sample.getMcContainer().getEventList();
-    sample.getDataContainer().getEventList().insert(
-        sample.getDataContainer().getEventList().begin(),
-        std::begin(sample.getMcContainer().getEventList()),
-        std::end(sample.getMcContainer().getEventList())
-    );
+    sample.getDataContainer().copyEventList( sample.getMcContainer() );
   }
 }
 void SampleSet::clearMcContainers(){
   for( auto& sample : _sampleList_ ){
     LogInfo << "Clearing event list for \"" << sample.getName() << "\"" << std::endl;
-    sample.getMcContainer().getEventList().clear();
+    sample.getMcContainer().clearEventList();
   }
 }
 
@@ -14,36 +14,36 @@ namespace JointProbability{
   public:
     [[nodiscard]] std::string getType() const override { return "BarlowBeeston"; }
     [[nodiscard]] double eval(const Sample& sample_, int bin_) const override;
-
-    struct Buffer{ double rel_var, b, c, beta, mc_hat, chi2; };
-    mutable Buffer _buf_{};
   };
 
   double BarlowBeeston::eval(const Sample& sample_, int bin_) const {
-    _buf_.rel_var = sample_.getMcContainer().getHistogram().binList[bin_].error / TMath::Sq(sample_.getMcContainer().getHistogram().binList[bin_].content);
-    _buf_.b       = (sample_.getMcContainer().getHistogram().binList[bin_].content * _buf_.rel_var) - 1;
-    _buf_.c       = 4 * sample_.getDataContainer().getHistogram().binList[bin_].content * _buf_.rel_var;
+    // eval() is called concurrently on different bins: no state is kept in the object
+    const double mcContent{sample_.getMcContainer().getHistogram().binList[bin_].content};
+    const double dataContent{sample_.getDataContainer().getHistogram().binList[bin_].content};
+
+    double rel_var = sample_.getMcContainer().getHistogram().binList[bin_].error / TMath::Sq(mcContent);
+    double b       = (mcContent * rel_var) - 1;
+    double c       = 4 * dataContent * rel_var;
 
-    _buf_.beta   = (-_buf_.b + std::sqrt(_buf_.b * _buf_.b + _buf_.c)) / 2.0;
-    _buf_.mc_hat = sample_.getMcContainer().getHistogram().binList[bin_].content * _buf_.beta;
+    double beta   = (-b + std::sqrt(b * b + c)) / 2.0;
+    double mc_hat = mcContent * beta;
 
     // Calculate the following LLH:
     //-2lnL = 2 * beta*mc - data + data * ln(data / (beta*mc)) + (beta-1)^2 / sigma^2
     // where sigma^2 is the same as above.
-    _buf_.chi2 = 0.0;
-    if(sample_.getDataContainer().getHistogram().binList[bin_].content <= 0.0) {
-      _buf_.chi2 = 2 * _buf_.mc_hat;
-      _buf_.chi2 += (_buf_.beta - 1) * (_buf_.beta - 1) / _buf_.rel_var;
+    double chi2{0.0};
+    if(dataContent <= 0.0) {
+      chi2 = 2 * mc_hat;
+      chi2 += (beta - 1) * (beta - 1) / rel_var;
     }
     else{
-      _buf_.chi2 = 2 * (_buf_.mc_hat - sample_.getDataContainer().getHistogram().binList[bin_].content);
-      if(sample_.getDataContainer().getHistogram().binList[bin_].content > 0.0) {
-        _buf_.chi2 += 2 * sample_.getDataContainer().getHistogram().binList[bin_].content *
-                      std::log(sample_.getDataContainer().getHistogram().binList[bin_].content / _buf_.mc_hat);
+      chi2 = 2 * (mc_hat - dataContent);
+      if(dataContent > 0.0) {
+        chi2 += 2 * dataContent * std::log(dataContent / mc_hat);
       }
-      _buf_.chi2 += (_buf_.beta - 1) * (_buf_.beta - 1) / _buf_.rel_var;
+      chi2 += (beta - 1) * (beta - 1) / rel_var;
     }
-    return _buf_.chi2;
+    return chi2;
   }
 
 }
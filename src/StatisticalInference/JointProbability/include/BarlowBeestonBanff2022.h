@@ -7,7 +7,7 @@
 
 #include "JointProbabilityBase.h"
 
-#include "GenericToolbox.Map.h"
+#include <vector>
 
 
 namespace JointProbability{
@@ -21,15 +21,18 @@ namespace JointProbability{
     [[nodiscard]] std::string getType() const override { return "BarlowBeestonBanff2022"; }
     [[nodiscard]] double eval(const Sample& sample_, int bin_) const override;
 
-    void createNominalMc(const Sample& sample_) const;
+    [[nodiscard]] bool hasBinDerivatives() const override { return true; }
+    void evalBinDerivatives(const Sample& sample_, int bin_, double& dContent_, double& dSumW2_) const override;
+
+    void prepareSamples(const std::vector<Sample>& sampleList_) override;
+    void createNominalMc(const Sample& sample_);
 
     int verboseLevel{0};
     bool throwIfInfLlh{false};
     bool allowZeroMcWhenZeroData{true};
     bool usePoissonLikelihood{false};
     bool BBNoUpdateWeights{false}; // OA 2021 bug reimplementation
-    mutable std::map<const Sample*, std::vector<double>> nomMcUncertList{}; // OA 2021 bug reimplementation
-    mutable GenericToolbox::NoCopyWrapper<std::mutex> _mutex_{}; // for creating the nomMC
+    std::vector<std::vector<double>> nomMcUncertList{}; // OA 2021 bug reimplementation, [sample index][bin]
   };
 
   void BarlowBeestonBanff2022::readConfigImpl(){
@@ -53,14 +56,6 @@ namespace JointProbability{
     double dataVal = sample_.getDataContainer().getHistogram().binList[bin_].content;
     double predVal = sample_.getMcContainer().getHistogram().binList[bin_].content;
 
-    {
-      /// the first time we reach this point, we assume the predMC is at its nominal value
-      std::lock_guard<std::mutex> g(_mutex_);
-      if( not GenericToolbox::isIn(&sample_, nomMcUncertList) ){ createNominalMc(sample_); }
-    }
-
-    // it should exist past this point
-    auto& nomHistErr = nomMcUncertList[&sample_];
     double mcuncert{0.0};
 
     // From OA2021_Eb branch -> BANFFBinnedSample::CalcLLRContrib
@@ -70,6 +65,9 @@ namespace JointProbability{
     // let the BBH make the sqrt
     // https://github.com/t2k-software/BANFF/blob/9140ec11bd74606c10ab4af9ec525352de119c06/src/BANFFSample/BANFFBinnedSample.cxx#L374
     if (BBNoUpdateWeights) {
+      // filled by prepareSamples(): no lock needed
+      LogThrowIf(sample_.getIndex() >= int(nomMcUncertList.size()), "Nominal MC not created for sample: " << sample_.getName());
+      auto& nomHistErr = nomMcUncertList[sample_.getIndex()];
       mcuncert = nomHistErr[bin_];
       mcuncert *= mcuncert;
 
@@ -216,9 +214,70 @@ namespace JointProbability{
 
     return chisq;
   }
-  void BarlowBeestonBanff2022::createNominalMc(const Sample& sample_) const {
+  void BarlowBeestonBanff2022::evalBinDerivatives(const Sample& sample_, int bin_, double& dContent_, double& dSumW2_) const {
+    double dataVal = sample_.getDataContainer().getHistogram().binList[bin_].content;
+    double predVal = sample_.getMcContainer().getHistogram().binList[bin_].content;
+
+    dContent_ = 0;
+    dSumW2_ = 0;
+
+    // null or infinite llh: nothing to derive
+    if( predVal <= 0.0 ){ return; }
+
+    // same convention as eval(): the data is considered as 0 below epsilon
+    double statDataVal = dataVal;
+    if( dataVal <= std::numeric_limits<double>::epsilon() ){ statDataVal = 0; }
+
+    if( usePoissonLikelihood ){
+      dContent_ = 2.0 * (1 - statDataVal / predVal);
+      return;
+    }
+
+    double mcuncert{0.0};
+    if( BBNoUpdateWeights ){
+      LogThrowIf(sample_.getIndex() >= int(nomMcUncertList.size()), "Nominal MC not created for sample: " << sample_.getName());
+      mcuncert = nomMcUncertList[sample_.getIndex()][bin_];
+    }
+    else{
+      mcuncert = sample_.getMcContainer().getHistogram().binList[bin_].error;
+    }
+    mcuncert *= mcuncert;
+    if( not std::isfinite(mcuncert) or mcuncert < 0.0 ){ return; }
+
+    if( mcuncert <= std::numeric_limits<double>::epsilon()
+        or predVal <= std::numeric_limits<double>::epsilon() ){
+      // no Barlow-Beeston correction
+      if( statDataVal == 0 ){ dContent_ = 2.0; }
+      else if( predVal > std::numeric_limits<double>::epsilon() ){ dContent_ = 2.0 * (1 - statDataVal / predVal); }
+      return;
+    }
+
+    double fractional = sqrt(mcuncert) / predVal;
+    double fractional2 = fractional * fractional;
+    double temp = predVal * fractional2 - 1;
+    double temp2 = temp * temp + 4 * dataVal * fractional2;
+    if( temp2 < 0 ){ return; }
+    double beta = (-1 * temp + sqrt(temp2)) / 2.;
+
+    // beta minimizes stat + penalty: its own variation doesn't contribute
+    // to the derivatives (envelope theorem). With sumW2 = mcuncert:
+    // stat + penalty = predVal*beta - data + data*ln(data/(predVal*beta)) + (beta-1)^2*predVal^2/(2*sumW2)
+    if( statDataVal != 0 and predVal * beta <= std::numeric_limits<double>::epsilon() ){ return; }
+    dContent_ = 2.0 * ( beta - statDataVal / predVal + (beta - 1) * (beta - 1) / (fractional2 * predVal) );
+    if( not BBNoUpdateWeights ){
+      dSumW2_ = - (beta - 1) * (beta - 1) / (fractional2 * fractional2 * predVal * predVal);
+    }
+  }
+  void BarlowBeestonBanff2022::prepareSamples(const std::vector<Sample>& sampleList_){
+    // the predMC is at its nominal value
+    nomMcUncertList.clear();
+    nomMcUncertList.resize( sampleList_.size() );
+    for( auto& sample : sampleList_ ){ createNominalMc(sample); }
+  }
+  void BarlowBeestonBanff2022::createNominalMc(const Sample& sample_) {
     LogWarning << "Creating nominal MC histogram for sample \"" << sample_.getName() << "\"" << std::endl;
-    auto& nomHistErr = nomMcUncertList[&sample_];
+    auto& nomHistErr = nomMcUncertList[sample_.getIndex()];
+    nomHistErr.clear();
     nomHistErr.reserve( sample_.getMcContainer().getHistogram().nBins );
     for( auto& bin : sample_.getMcContainer().getHistogram().binList ){
       nomHistErr.emplace_back( bin.error );
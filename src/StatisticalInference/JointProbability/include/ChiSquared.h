@@ -14,6 +14,9 @@ namespace JointProbability{
   public:
     [[nodiscard]] std::string getType() const override { return "ChiSquared"; }
     [[nodiscard]] double eval(const Sample& sample_, int bin_) const override;
+
+    [[nodiscard]] bool hasBinDerivatives() const override { return true; }
+    void evalBinDerivatives(const Sample& sample_, int bin_, double& dContent_, double& dSumW2_) const override;
   };
 
   double ChiSquared::eval(const Sample& sample_, int bin_) const {
@@ -27,6 +30,13 @@ namespace JointProbability{
     }
     return TMath::Sq(predVal - dataVal)/predVal;
   }
+  void ChiSquared::evalBinDerivatives(const Sample& sample_, int bin_, double& dContent_, double& dSumW2_) const {
+    double predVal = sample_.getMcContainer().getHistogram().binList[bin_].content;
+    double dataVal = sample_.getDataContainer().getHistogram().binList[bin_].content;
+    dSumW2_ = 0;
+    if( predVal == 0 ){ dContent_ = 0; return; } // infinite llh
+    dContent_ = 1 - TMath::Sq(dataVal/predVal);
+  }
 
 }
 
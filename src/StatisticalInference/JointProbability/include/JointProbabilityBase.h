@@ -9,6 +9,7 @@
 #include "JsonBaseClass.h"
 
 #include <string>
+#include <vector>
 
 namespace JointProbability{
 
@@ -18,10 +19,17 @@ namespace JointProbability{
     // simple rtti, makes the class purely virtual
     [[nodiscard]] virtual std::string getType() const = 0;
 
-    // two choices -> either override bin by bin llh or global eval function
+    // two choices -> either override bin by bin llh or global eval function.
+    // The bin by bin eval() is called from several threads: it must not modify the object.
     [[nodiscard]] virtual double eval( const Sample &sample_, int bin_ ) const{ return 0; }
 
+    // called once the samples have been filled with the parameters at their nominal values.
+    // Per sample/bin lookup tables should be built here: eval() is called from several threads.
+    virtual void prepareSamples( const std::vector<Sample>& sampleList_ ){}
+
     // classic binned llh. Could be overriden to introduce correlations for instance.
+    // In that case, isBinByBin() should return false so the bins are not split among threads.
+    [[nodiscard]] virtual bool isBinByBin() const{ return true; }
     [[nodiscard]] virtual double eval( const Sample &sample_ ) const{
       double out{0};
       int nBins = int(sample_.getBinning().getBinList().size());
@@ -29,6 +37,13 @@ namespace JointProbability{
       return out;
     }
 
+    // analytic derivatives of the bin llh with respect to the predicted content and to the
+    // sum of the squared MC weights (error^2) of the bin. Used to build the likelihood gradient.
+    [[nodiscard]] virtual bool hasBinDerivatives() const{ return false; }
+    virtual void evalBinDerivatives( const Sample &sample_, int bin_, double& dContent_, double& dSumW2_ ) const{
+      dContent_ = 0; dSumW2_ = 0;
+    }
+
   };
 }
 
@@ -23,6 +23,9 @@ namespace JointProbability{
     [[nodiscard]] std::string getType() const override { return "PluginJointProbability"; }
     [[nodiscard]] double eval(const Sample& sample_, int bin_) const override;
 
+    [[nodiscard]] bool hasBinDerivatives() const override { return true; }
+    void evalBinDerivatives(const Sample& sample_, int bin_, double& dContent_, double& dSumW2_) const override;
+
     /// If true the use Poissonian approximation with the variance equal to
     /// the observed value (i.e. the data).
     bool lsqPoissonianApproximation{false};
@@ -42,6 +45,14 @@ namespace JointProbability{
     if (lsqPoissonianApproximation && dataVal > 1.0) v /= 0.5*dataVal;
     return v;
   }
+  void LeastSquares::evalBinDerivatives(const Sample& sample_, int bin_, double& dContent_, double& dSumW2_) const {
+    double predVal = sample_.getMcContainer().getHistogram().binList[bin_].content;
+    double dataVal = sample_.getDataContainer().getHistogram().binList[bin_].content;
+    double dv = -2.0*(dataVal - predVal);
+    if (lsqPoissonianApproximation && dataVal > 1.0) dv /= 0.5*dataVal;
+    dContent_ = dv;
+    dSumW2_ = 0;
+  }
 
 }
 
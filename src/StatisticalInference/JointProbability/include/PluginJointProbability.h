@@ -20,6 +20,9 @@ namespace JointProbability{
 
     [[nodiscard]] double eval(const Sample& sample_, int bin_) const override;
 
+    // nothing tells the external evalFct is reentrant: the bins are evaluated in a single thread
+    [[nodiscard]] bool isBinByBin() const override { return false; }
+
     std::string llhPluginSrc;
     std::string llhSharedLib;
 
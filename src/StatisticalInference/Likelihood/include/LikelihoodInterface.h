@@ -54,6 +54,7 @@ public:
   [[nodiscard]] double getLastPenaltyLikelihood() const { return _buffer_.penaltyLikelihood; }
   [[nodiscard]] const DataSetManager& getDataSetManager() const { return _dataSetManager_; }
   const JointProbability::JointProbabilityBase* getJointProbabilityPtr() const { return _jointProbabilityPtr_.get(); }
+  [[nodiscard]] bool isGradientAvailable() const;
 
   // mutable getters
   Buffer& getBuffer() { return _buffer_; }
@@ -62,6 +63,12 @@ public:
   // mutable core
   void propagateAndEvalLikelihood();
 
+  /// Propagate the parameters, evaluate the likelihood and its analytic
+  /// gradient. gradient_[iParSet] is aligned with the effective parameter
+  /// list of each set (eigen parameters if the decomposition is enabled).
+  /// Only available if the joint probability provides the bin derivatives.
+  void propagateAndEvalGradient(std::vector<std::vector<double>>& gradient_);
+
   // core
   double evalLikelihood() const;
   double evalStatLikelihood() const;
@@ -70,6 +77,11 @@ public:
   [[nodiscard]] double evalPenaltyLikelihood(const ParameterSet& parSet_) const;
   [[nodiscard]] std::string getSummary() const;
 
+protected:
+  /// Partial sum of the stat likelihood over the bins handled by the thread
+  void evalStatLikelihoodFct(int iThread_) const;
+
+public:
   // dev deprecated
   [[deprecated("use getDataSetManager().getPropagator()")]] [[nodiscard]] const Propagator& getPropagator() const { return _dataSetManager_.getPropagator(); }
   [[deprecated("use getDataSetManager().getPropagator()")]] Propagator& getPropagator(){ return _dataSetManager_.getPropagator(); }
@@ -79,6 +91,9 @@ private:
   int _nbParameters_{0};
   int _nbSampleBins_{0};
 
+  // config
+  bool _devSingleThreadStatLikelihood_{false};
+
   /// Definition of data sets to use for filling the Propagator
   DataSetManager _dataSetManager_{};
 
@@ -86,6 +101,18 @@ private:
   std::shared_ptr<JointProbability::JointProbabilityBase> _jointProbabilityPtr_{nullptr};
 
   mutable Buffer _buffer_{};
+
+  // the bins of all the samples, split among the threads
+  struct StatBin{
+    const Sample* samplePtr{nullptr};
+    int binIndex{-1};
+  };
+  std::vector<StatBin> _statBinList_{};
+  mutable std::vector<double> _threadStatLikelihoodList_{};
+
+  // gradient buffers
+  std::vector<Propagator::BinLikelihoodDerivative> _binLikelihoodDerivativeList_{};
+  std::vector<std::vector<double>> _statGradient_{};
 };
 
 #endif //  GUNDAM_LIKELIHOOD_INTERFACE_H
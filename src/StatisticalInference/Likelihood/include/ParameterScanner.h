@@ -6,6 +6,7 @@
 #define GUNDAM_PARAMETER_SCANNER_H
 
 #include "LikelihoodInterface.h"
+#include "PropagatorReplicaPool.h"
 #include "Parameter.h"
 #include "JsonBaseClass.h"
 
@@ -39,6 +40,7 @@ public:
   // const getters
   [[nodiscard]] bool isUseParameterLimits() const{ return _useParameterLimits_; }
   [[nodiscard]] int getNbPoints() const{ return _nbPoints_; }
+  [[nodiscard]] int getNbReplicas() const{ return _nbReplicas_; }
   [[nodiscard]] const std::pair<double, double> &getParameterSigmaRange() const{ return _parameterSigmaRange_; }
   [[nodiscard]] const JsonType &getVarsConfig() const { return _varsConfig_; };
   [[nodiscard]] const std::vector<GraphEntry> &getGraphEntriesBuf() const { return _graphEntriesBuf_; };
@@ -61,6 +63,7 @@ public:
     std::string yTitle{};
     std::vector<double> yPoints{};
     std::function<double()> evalY{};
+    bool useEventWeights{false}; // evalY reads the MC event weights, not only the bins
   };
 
   struct GraphEntry{
@@ -69,9 +72,17 @@ public:
     TGraph graph{};
   };
 
+protected:
+  /// Evaluate the scan entries at nPoints_ points: moveToPoint_(iPt) sets
+  /// the parameters of the point, readPoint_(iPt) is called once they have
+  /// been propagated to the dial inputs. The points are either propagated
+  /// one by one, or by batches on the propagator replicas.
+  void evalScanPoints(int nPoints_, const std::function<void(int iPt_)>& moveToPoint_, const std::function<void(int iPt_)>& readPoint_);
+
 private:
   // Config
   bool _useParameterLimits_{true};
+  int _nbReplicas_{0};
   int _nbPoints_{100};
   int _nbPointsLineScan_{_nbPoints_};
   std::pair<double, double> _parameterSigmaRange_{-3,3};
@@ -83,6 +94,9 @@ private:
   std::vector<ScanData> _scanDataDict_;
   std::vector<GraphEntry> _graphEntriesBuf_;
 
+  // concurrent scans
+  PropagatorReplicaPool _replicaPool_{"ParameterScanner::propagateReplicas"};
+
 
 };
 
@@ -53,6 +53,8 @@ void LikelihoodInterface::readConfigImpl(){
   _jointProbabilityPtr_ = std::shared_ptr<JointProbability::JointProbabilityBase>( JointProbability::makeJointProbability( jointProbabilityTypeStr ) );
   _jointProbabilityPtr_->readConfig( configJointProbability );
 
+  _devSingleThreadStatLikelihood_ = GenericToolbox::Json::fetchValue(_config_, "devSingleThreadStatLikelihood", _devSingleThreadStatLikelihood_);
+
   LogWarning << "LikelihoodInterface configured." << std::endl;
 }
 void LikelihoodInterface::initializeImpl() {
@@ -73,13 +75,35 @@ void LikelihoodInterface::initializeImpl() {
     _nbSampleBins_ += int(sample.getBinning().getBinList().size() );
   }
 
+  _statBinList_.clear();
+  _threadStatLikelihoodList_.clear();
+  if( not _devSingleThreadStatLikelihood_ and _jointProbabilityPtr_->isBinByBin() and GundamGlobals::getParallelWorker().getNbThreads() > 1 ){
+    LogInfo << "The stat likelihood of the " << _nbSampleBins_ << " bins will be evaluated in parallel." << std::endl;
+    _statBinList_.reserve( _nbSampleBins_ );
+    for( auto& sample : _dataSetManager_.getPropagator().getSampleSet().getSampleList() ){
+      for( int iBin = 0 ; iBin < int(sample.getBinning().getBinList().size()) ; iBin++ ){
+        _statBinList_.emplace_back();
+        _statBinList_.back().samplePtr = &sample;
+        _statBinList_.back().binIndex = iBin;
+      }
+    }
+    _threadStatLikelihoodList_.resize( GundamGlobals::getParallelWorker().getNbThreads(), 0 );
+
+    GundamGlobals::getParallelWorker().addJob(
+        "LikelihoodInterface::evalStatLikelihood",
+        [this](int iThread){ this->evalStatLikelihoodFct(iThread); }
+    );
+  }
+
   LogInfo << "Move back MC parameters to prior..." << std::endl;
   _dataSetManager_.getPropagator().getParametersManager().moveParametersToPrior();
 
   /// some joint fit probability might need to save the value of the nominal histogram.
   /// here we know every parameter is at its nominal value
   LogInfo << "First evaluation of the LLH at the nominal value..." << std::endl;
-  this->propagateAndEvalLikelihood();
+  _dataSetManager_.getPropagator().propagateParameters();
+  _jointProbabilityPtr_->prepareSamples( _dataSetManager_.getPropagator().getSampleSet().getSampleList() );
+  this->evalLikelihood();
   LogInfo << this->getSummary() << std::endl;
 
   /// move the parameter away from the prior if needed
@@ -106,6 +130,79 @@ void LikelihoodInterface::propagateAndEvalLikelihood(){
   this->evalLikelihood();
 }
 
+bool LikelihoodInterface::isGradientAvailable() const {
+  return _jointProbabilityPtr_ != nullptr and _jointProbabilityPtr_->hasBinDerivatives();
+}
+void LikelihoodInterface::propagateAndEvalGradient(std::vector<std::vector<double>>& gradient_){
+  LogThrowIf(not this->isGradientAvailable(), "The joint probability \"" << _jointProbabilityPtr_->getType() << "\" doesn't provide the analytic derivatives.");
+
+  auto& propagator = _dataSetManager_.getPropagator();
+  this->propagateAndEvalLikelihood();
+
+  // derivatives of the stat likelihood wrt the content of each bin
+  auto& sampleList = propagator.getSampleSet().getSampleList();
+  _binLikelihoodDerivativeList_.resize( sampleList.size() );
+  for( size_t iSample = 0 ; iSample < sampleList.size() ; iSample++ ){
+    auto& binDerivative = _binLikelihoodDerivativeList_[iSample];
+    int nBins = int(sampleList[iSample].getBinning().getBinList().size());
+    binDerivative.content.assign( nBins, 0 );
+    binDerivative.sumW2.assign( nBins, 0 );
+    if( not sampleList[iSample].isEnabled() ){ continue; }
+    for( int iBin = 0 ; iBin < nBins ; iBin++ ){
+      _jointProbabilityPtr_->evalBinDerivatives(
+          sampleList[iSample], iBin, binDerivative.content[iBin], binDerivative.sumW2[iBin]
+      );
+    }
+  }
+
+  // chain rule through the event weights: gradient wrt the original parameters
+  propagator.evalStatGradient( _binLikelihoodDerivativeList_, _statGradient_ );
+
+  auto& parSetList = propagator.getParametersManager().getParameterSetsList();
+  gradient_.resize( parSetList.size() );
+  for( size_t iParSet = 0 ; iParSet < parSetList.size() ; iParSet++ ){
+    auto& parSet = parSetList[iParSet];
+    auto& statGradient = _statGradient_[iParSet];
+    auto& gradient = gradient_[iParSet];
+    gradient.assign( parSet.getEffectiveParameterList().size(), 0 );
+    if( not parSet.isEnabled() ){ continue; }
+
+    if( parSet.isEnableEigenDecomp() ){
+      // orig = V * eigen, over the enabled and non-fixed original parameters
+      auto& eigenVectors = *parSet.getEigenVectors();
+      int iOrig{-1};
+      for( auto& par : parSet.getParameterList() ){
+        if( par.isFixed() or not par.isEnabled() ){ continue; }
+        iOrig++;
+        if( statGradient[par.getParameterIndex()] == 0 ){ continue; }
+        for( int iEigen = 0 ; iEigen < int(gradient.size()) ; iEigen++ ){
+          gradient[iEigen] += eigenVectors[iOrig][iEigen] * statGradient[par.getParameterIndex()];
+        }
+      }
+
+      // penalty: sum of ((eigen - prior)/sigma)^2
+      for( auto& eigenPar : parSet.getEigenParameterList() ){
+        if( eigenPar.isFixed() ){ continue; }
+        gradient[eigenPar.getParameterIndex()] +=
+            2 * (eigenPar.getParameterValue() - eigenPar.getPriorValue()) / TMath::Sq(eigenPar.getStdDevValue());
+      }
+    }
+    else{
+      gradient = statGradient;
+
+      if( parSet.getPriorCovarianceMatrix() != nullptr ){
+        // penalty: delta^T * C^-1 * delta -> 2 * C^-1 * delta
+        parSet.updateDeltaVector();
+        TVectorD penaltyGradient{(*parSet.getInverseStrippedCovarianceMatrix()) * (*parSet.getDeltaVectorPtr())};
+        int iFit{0};
+        for( auto& par : parSet.getParameterList() ){
+          if( not ParameterSet::isValidCorrelatedParameter(par) ){ continue; }
+          gradient[par.getParameterIndex()] += 2 * penaltyGradient[iFit++];
+        }
+      }
+    }
+  }
+}
 double LikelihoodInterface::evalLikelihood() const {
   this->evalStatLikelihood();
   this->evalPenaltyLikelihood();
@@ -115,11 +212,32 @@ double LikelihoodInterface::evalLikelihood() const {
 }
 double LikelihoodInterface::evalStatLikelihood() const {
   _buffer_.statLikelihood = 0.;
+
+  if( not _statBinList_.empty() ){
+    GundamGlobals::getParallelWorker().runJob("LikelihoodInterface::evalStatLikelihood");
+
+    // summed in the thread order: the result doesn't depend on the scheduling
+    for( double threadStatLikelihood : _threadStatLikelihoodList_ ){ _buffer_.statLikelihood += threadStatLikelihood; }
+    return _buffer_.statLikelihood;
+  }
+
   for( auto &sample: _dataSetManager_.getPropagator().getSampleSet().getSampleList()){
     _buffer_.statLikelihood += this->evalStatLikelihood( sample );
   }
   return _buffer_.statLikelihood;
 }
+void LikelihoodInterface::evalStatLikelihoodFct(int iThread_) const {
+  int nThreads{GundamGlobals::getParallelWorker().getNbThreads()};
+  if( iThread_ == -1 ){ iThread_ = 0; nThreads = 1; }
+
+  auto bounds = GenericToolbox::ParallelWorker::getThreadBoundIndices( iThread_, nThreads, int(_statBinList_.size()) );
+
+  double statLikelihood{0};
+  for( int iStatBin = bounds.beginIndex ; iStatBin < bounds.endIndex ; iStatBin++ ){
+    statLikelihood += _jointProbabilityPtr_->eval( *_statBinList_[iStatBin].samplePtr, _statBinList_[iStatBin].binIndex );
+  }
+  _threadStatLikelihoodList_[iThread_] = statLikelihood;
+}
 double LikelihoodInterface::evalPenaltyLikelihood() const {
   _buffer_.penaltyLikelihood = 0;
   for( auto& parSet : _dataSetManager_.getPropagator().getParametersManager().getParameterSetsList() ){
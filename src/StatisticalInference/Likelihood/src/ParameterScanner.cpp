@@ -5,6 +5,7 @@
 #include "ParameterScanner.h"
 #include "Propagator.h"
 #include "Parameter.h"
+#include "GundamGlobals.h"
 
 #include "GenericToolbox.Utils.h"
 #include "GenericToolbox.Json.h"
@@ -28,6 +29,7 @@ void ParameterScanner::readConfigImpl() {
   LogWarning << "Configuring ParameterScanner..." << std::endl;
 
   _useParameterLimits_ = GenericToolbox::Json::fetchValue(_config_, "useParameterLimits", _useParameterLimits_);
+  _nbReplicas_ = GenericToolbox::Json::fetchValue(_config_, "nbReplicas", _nbReplicas_);
   _nbPoints_ = GenericToolbox::Json::fetchValue(_config_, "nbPoints", _nbPoints_);
   _nbPointsLineScan_ = GenericToolbox::Json::fetchValue(_config_, "nbPointsLineScan", _nbPoints_);
   _parameterSigmaRange_ = GenericToolbox::Json::fetchValue(_config_, "parameterSigmaRange", _parameterSigmaRange_);
@@ -110,6 +112,7 @@ void ParameterScanner::initializeImpl() {
       scanEntry.yTitle = "Total MC event weight";
       auto* samplePtr = &sample;
       scanEntry.evalY = [samplePtr](){ return samplePtr->getMcContainer().getSumWeights(); };
+      scanEntry.useEventWeights = true;
     }
   }
   if( GenericToolbox::Json::fetchValue(_varsConfig_, "weightPerSamplePerBin", false) ){
@@ -130,6 +133,17 @@ void ParameterScanner::initializeImpl() {
     }
   }
 
+  _replicaPool_.clear();
+  if( _nbReplicas_ > 0 ){
+    if( not PropagatorReplica::isSupported( _likelihoodInterfacePtr_->getDataSetManager().getPropagator() ) ){
+      LogAlert << "Some dials can't be evaluated by the propagator replicas. The scan points will be propagated one at a time." << std::endl;
+      _nbReplicas_ = 0;
+    }
+    else{
+      LogInfo << "Scan points will be propagated by batches of " << _nbReplicas_ << " on propagator replicas." << std::endl;
+    }
+  }
+
   LogWarning << "ParameterScanner initialized." << std::endl;
 }
 
@@ -160,7 +174,7 @@ void ParameterScanner::scanParameter(Parameter& par_, TDirectory* saveDir_) {
   }
 
   int offSet{0}; // offset help make sure the first point
-  for( int iPt = 0 ; iPt < _nbPoints_+1 ; iPt++ ){
+  auto moveToPoint = [&](int iPt){
     double newVal = lowBound + double(iPt-offSet)/(_nbPoints_-1)*( highBound - lowBound );
     if( offSet == 0 and newVal > origVal ){
       newVal = origVal;
@@ -183,12 +197,10 @@ void ParameterScanner::scanParameter(Parameter& par_, TDirectory* saveDir_) {
         );
 
     par_.setParameterValue(newVal);
+  };
+  auto readPoint = [&](int iPt){ parPoints[iPt] = par_.getParameterValue(); };
 
-    _likelihoodInterfacePtr_->propagateAndEvalLikelihood();
-    parPoints[iPt] = par_.getParameterValue();
-
-    for( auto& scanEntry : _scanDataDict_ ){ scanEntry.yPoints[iPt] = scanEntry.evalY(); }
-  }
+  this->evalScanPoints( _nbPoints_+1, moveToPoint, readPoint );
 
   // sorting points in increasing order
   auto p = GenericToolbox::getSortPermutation(parPoints, [](double a_, double b_){
@@ -284,7 +296,7 @@ void ParameterScanner::scanSegment(TDirectory *saveDir_, const JsonType &end_, c
   ss << LogWarning.getPrefixString() << "Scanning...";
 
   LogInfo << "Scanning along the line..." << std::endl;
-  for( int iStep = 0 ; iStep < nTotalSteps ; iStep++ ){
+  auto moveToPoint = [&](int iStep){
     if( not Logger::isMuted() ){ GenericToolbox::displayProgressBar(iStep, nTotalSteps-1, ss.str()); }
 
     for( size_t iPar = 0 ; iPar < startPointParValList.size() ; iPar++ ){
@@ -303,13 +315,19 @@ void ParameterScanner::scanSegment(TDirectory *saveDir_, const JsonType &end_, c
       }
     }
 
-    _likelihoodInterfacePtr_->propagateAndEvalLikelihood();
-
+  };
+  auto readPoint = [&](int iStep){
     for( auto& graphEntry : _graphEntriesBuf_ ){
       graphEntry.graph.SetPointX(iStep, graphEntry.fitParPtr->getParameterValue());
-      graphEntry.graph.SetPointY(iStep, graphEntry.scanDataPtr->evalY());
     }
+  };
+
+  this->evalScanPoints( nTotalSteps, moveToPoint, readPoint );
 
+  for( auto& graphEntry : _graphEntriesBuf_ ){
+    for( int iStep = 0 ; iStep < nTotalSteps ; iStep++ ){
+      graphEntry.graph.SetPointY(iStep, graphEntry.scanDataPtr->yPoints[iStep]);
+    }
   }
 
   LogInfo << "Writing scan line graph in file..." << std::endl;
@@ -530,6 +548,50 @@ void ParameterScanner::varyEvenRates(const std::vector<double>& paramVariationLi
   }
 }
 
+// protected
+void ParameterScanner::evalScanPoints(int nPoints_, const std::function<void(int iPt_)>& moveToPoint_, const std::function<void(int iPt_)>& readPoint_){
+  for( auto& scanEntry : _scanDataDict_ ){ scanEntry.yPoints.resize( nPoints_, 0 ); }
+
+  if( _nbReplicas_ <= 0 ){
+    for( int iPt = 0 ; iPt < nPoints_ ; iPt++ ){
+      moveToPoint_( iPt );
+      _likelihoodInterfacePtr_->propagateAndEvalLikelihood();
+      readPoint_( iPt );
+      for( auto& scanEntry : _scanDataDict_ ){ scanEntry.yPoints[iPt] = scanEntry.evalY(); }
+    }
+    return;
+  }
+
+  auto& propagator = _likelihoodInterfacePtr_->getDataSetManager().getPropagator();
+
+  // the replicas are kept from one scan to another, unless the propagator has been rebuilt
+  if( not _replicaPool_.empty() and not _replicaPool_.isUpToDate() ){ _replicaPool_.clear(); }
+  if( _replicaPool_.empty() ){ _replicaPool_.build( propagator, _nbReplicas_ ); }
+
+  bool copyEventWeights{false};
+  for( auto& scanEntry : _scanDataDict_ ){ copyEventWeights = copyEventWeights or scanEntry.useEventWeights; }
+
+  std::vector<double> penaltyLikelihoodList( nPoints_, 0 );
+  _replicaPool_.evalBatch(
+      nPoints_,
+      [&](int iPt_){
+        moveToPoint_( iPt_ );
+        propagator.updateDialInputs();
+        readPoint_( iPt_ );
+        penaltyLikelihoodList[iPt_] = _likelihoodInterfacePtr_->evalPenaltyLikelihood();
+        return true;
+      },
+      [&](int iPt_, PropagatorReplica& replica_){
+        // the bins of each point are put back in the samples: the likelihood is evaluated as in the serial scan
+        replica_.copyToSampleSet( propagator.getSampleSet(), copyEventWeights );
+        _likelihoodInterfacePtr_->evalStatLikelihood();
+        _likelihoodInterfacePtr_->getBuffer().penaltyLikelihood = penaltyLikelihoodList[iPt_];
+        _likelihoodInterfacePtr_->getBuffer().updateTotal();
+        for( auto& scanEntry : _scanDataDict_ ){ scanEntry.yPoints[iPt_] = scanEntry.evalY(); }
+      }
+  );
+}
+
 // statics
 void ParameterScanner::writeGraphEntry(GraphEntry& entry_, TDirectory* saveDir_){
   entry_.graph.SetTitle(entry_.scanDataPtr->title.c_str());
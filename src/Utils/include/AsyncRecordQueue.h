@@ -0,0 +1,142 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#ifndef GUNDAM_ASYNC_RECORD_QUEUE_H
+#define GUNDAM_ASYNC_RECORD_QUEUE_H
+
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <cstddef>
+
+
+/// Single-producer / single-consumer ring buffer drained by a background
+/// thread. The slots are allocated once by start(): the producer fills the
+/// next slot in place (acquire() then publish()) and the consumer callback
+/// reads it from the background thread. No allocation is involved on the
+/// producer side, and the lock is only taken to wake up an idle consumer.
+/// If the ring is full, the producer waits for the consumer: records are
+/// never dropped.
+template<typename T> class AsyncRecordQueue{
+
+public:
+  AsyncRecordQueue() = default;
+  AsyncRecordQueue(const AsyncRecordQueue&) = delete;
+  AsyncRecordQueue& operator=(const AsyncRecordQueue&) = delete;
+  ~AsyncRecordQueue(){ this->stop(); }
+
+  [[nodiscard]] bool isRunning() const{ return _thread_.joinable(); }
+
+  /// prepareSlot_ is called once per slot (pre-allocate the record buffers)
+  void start(size_t capacity_, const std::function<void(T&)>& prepareSlot_, const std::function<void(const T&)>& consume_){
+    this->stop();
+    _slotList_.clear();
+    _slotList_.resize( capacity_ == 0 ? 1 : capacity_ );
+    for( auto& slot : _slotList_ ){ prepareSlot_( slot ); }
+    _consume_ = consume_;
+    _head_ = 0; _tail_ = 0;
+    _stopRequested_ = false;
+    _thread_ = std::thread( [this]{ this->consumerLoop(); } );
+  }
+  /// Process the remaining records and join the background thread
+  void stop(){
+    if( not _thread_.joinable() ){ return; }
+    _stopRequested_.store( true );
+    this->notifyConsumer();
+    _thread_.join();
+  }
+  /// Wait for the consumer to have processed every published record. Has to
+  /// be called before the producer thread reads what the consumer writes.
+  void flush() const{
+    if( not _thread_.joinable() ){ return; }
+    while( _tail_.load( std::memory_order_acquire ) != _head_.load( std::memory_order_relaxed ) ){ std::this_thread::yield(); }
+  }
+
+  // producer side
+  T& acquire(){
+    size_t head{_head_.load( std::memory_order_relaxed )};
+    while( head - _tail_.load( std::memory_order_acquire ) >= _slotList_.size() ){ std::this_thread::yield(); }
+    return _slotList_[head % _slotList_.size()];
+  }
+  void publish(){
+    _head_.store( _head_.load( std::memory_order_relaxed ) + 1 );
+    this->notifyConsumer();
+  }
+
+private:
+  // The consumer raises _isConsumerWaiting_ before checking the head one last
+  // time, and the producer checks it after moving the head (both sequentially
+  // consistent): at least one of them sees the other, so no wake-up is lost.
+  void notifyConsumer(){
+    if( not _isConsumerWaiting_.load() ){ return; }
+    std::lock_guard<std::mutex> lock(_mutex_);
+    _wakeUpConsumer_.notify_one();
+  }
+  void consumerLoop(){
+    while( true ){
+      size_t tail{_tail_.load( std::memory_order_relaxed )};
+      if( tail == _head_.load( std::memory_order_acquire ) ){
+        // stop only once everything has been processed
+        if( _stopRequested_.load() ){ break; }
+
+        std::unique_lock<std::mutex> lock(_mutex_);
+        _isConsumerWaiting_.store( true );
+        _wakeUpConsumer_.wait( lock, [&]{ return tail != _head_.load() or _stopRequested_.load(); } );
+        _isConsumerWaiting_.store( false );
+        continue;
+      }
+      _consume_( _slotList_[tail % _slotList_.size()] );
+      _tail_.store( tail + 1, std::memory_order_release );
+    }
+  }
+
+  std::vector<T> _slotList_{};
+  std::function<void(const T&)> _consume_{};
+
+  // monotonic counters, the slot index is taken modulo the capacity
+  std::atomic<size_t> _head_{0};
+  std::atomic<size_t> _tail_{0};
+  std::atomic<bool> _stopRequested_{false};
+
+  // only used to put the consumer to sleep while the ring is empty
+  std::mutex _mutex_{};
+  std::condition_variable _wakeUpConsumer_{};
+  std::atomic<bool> _isConsumerWaiting_{false};
+
+  std::thread _thread_{};
+
+};
+
+
+#endif // GUNDAM_ASYNC_RECORD_QUEUE_H
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
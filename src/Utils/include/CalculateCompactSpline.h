@@ -24,7 +24,10 @@
 #endif
 
 // Allow the floating point type to be overriden.  This would normally be done
-// using a typedef, but that doesn't play well with all CUDA compilers.
+// using a typedef, but that doesn't play well with all CUDA compilers.  The
+// type of the data is also a template parameter of the calculations so that
+// single precision copies of the dial data can be evaluated.  The arithmetic
+// is always done in double.
 #ifndef DEVICE_FLOATING_POINT
 #define DEVICE_FLOATING_POINT double
 #endif
@@ -45,10 +48,11 @@ namespace {
     // CalculateCompactSpline, and CalculateMonotonicSpline have very similar,
     // but different calls.  In particular the dim parameter meaning is not
     // consistent.
+    template <typename FloatType = DEVICE_FLOATING_POINT>
     DEVICE_CALLABLE_INLINE
     double CalculateCompactSpline(const double x,
                                   const double lowerBound, double upperBound,
-                                  const DEVICE_FLOATING_POINT* data,
+                                  const FloatType* data,
                                   const int dim) {
 
         // Interpolate between p2 and p3
@@ -127,8 +131,64 @@ namespace {
         return v;
     }
 
+    // The derivative of CalculateCompactSpline with respect to x.  The output
+    // bounds are not applied, and the slopes at the knots are found exactly as
+    // for the value.  This is used to calculate the analytic gradient of the
+    // likelihood.
+    template <typename FloatType = DEVICE_FLOATING_POINT>
+    DEVICE_CALLABLE_INLINE
+    double CalculateCompactSplineDerivative(const double x,
+                                            const FloatType* data,
+                                            const int dim) {
+        const double low = data[0];
+        const double step = data[1];
+
+        const double xx = (x-low)/step;
+        const int ix = xx;
+
+        int d21_0 = ix-1;
+        if (d21_0 < 0)     d21_0 = 0;
+        if (d21_0 > dim-2) d21_0 = dim-2;
+        int d21_1 = d21_0+1;
+        int d32_0 = ix;
+        if (d32_0 < 0)     d32_0 = 0;
+        if (d32_0 > dim-2) d32_0 = dim-2;
+        int d32_1 = d32_0+1;
+        int d43_0 = ix+1;
+        if (d43_0 < 0)     d43_0 = 0;
+        if (d43_0 > dim-2) d43_0 = dim-2;
+        int d43_1 = d43_0+1;
+
+        const double p2 = data[2+d32_0];
+        const double p3 = data[2+d32_1];
+
+        const double fx = xx-d32_0;
+        const double fxx = fx*fx;
+
+        const double d21 = data[2+d21_1] - data[2+d21_0];
+        const double d32 = p3-p2;
+        const double d43 = data[2+d43_1] - data[2+d43_0];
+
+        const double m2 = 0.5*(d21+d32);
+        const double m3 = 0.5*(d32+d43);
+
+        // Derivative of the cubic with respect to fx.
+        const double dt = 6.0*fx-6.0*fxx;
+        const double dv = - p2*dt + m2*(3.0*fxx-4.0*fx+1.0)
+                          + p3*dt + m3*(3.0*fxx-2.0*fx);
+
+        return dv/step;
+    }
+
 }
 
+// The batched (host only) version of this calculation is
+// CalculateCompactSplineBatch.  It evaluates many splines with the same number of
+// knots using the CPU vector extensions.
+#ifndef __CUDACC__
+#include "CalculateSplineBatch.h"
+#endif
+
 // An MIT Style License
 
 // Copyright (c) 2022 Clark McGrew
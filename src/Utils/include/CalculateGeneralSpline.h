@@ -46,10 +46,11 @@ namespace {
     // CalculateCompactSpline, and CalculateMonotonicSpline have very similar,
     // but different calls.  In particular the dim parameter meaning is not
     // consistent.
+    template <typename FloatType = DEVICE_FLOATING_POINT>
     DEVICE_CALLABLE_INLINE
     double CalculateGeneralSpline(const double x,
                                   const double lowerBound, double upperBound,
-                                  const DEVICE_FLOATING_POINT* data,
+                                  const FloatType* data,
                                   const int dim) {
 
         // Check to find a point that is less than x.  This is "brute force",
@@ -100,6 +101,41 @@ namespace {
 
         return v;
     }
+
+    // The derivative of CalculateGeneralSpline with respect to x.  The output
+    // bounds are not applied.  This is used to calculate the analytic
+    // gradient of the likelihood.
+    template <typename FloatType = DEVICE_FLOATING_POINT>
+    DEVICE_CALLABLE_INLINE
+    double CalculateGeneralSplineDerivative(const double x,
+                                            const FloatType* data,
+                                            const int dim) {
+        const int knotCount = (dim-2)/3;
+        int ix = 0;
+        // Same search as CalculateGeneralSpline (at most 15 knots).
+        for (int i = 0; i < 15; ++i) {
+            if (x > data[2+3*(ix+1)+2] && ix < knotCount-2) ++ix;
+        }
+
+        const double x1 = data[2+3*ix+2];
+        const double x2 = data[2+3*(ix+1)+2];
+        const double step = x2-x1;
+
+        const double fx = (x - x1)/step;
+        const double fxx = fx*fx;
+
+        const double p1 = data[2+3*ix];
+        const double m1 = data[2+3*ix+1]*step;
+        const double p2 = data[2+3*(ix+1)];
+        const double m2 = data[2+3*(ix+1)+1]*step;
+
+        // Derivative of the cubic with respect to fx.
+        const double dt = 6.0*fx-6.0*fxx;
+        const double dv = - p1*dt + m1*(3.0*fxx-4.0*fx+1.0)
+                          + p2*dt + m2*(3.0*fxx-2.0*fx);
+
+        return dv/step;
+    }
 }
 
 // An MIT Style License
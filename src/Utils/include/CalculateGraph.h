@@ -40,10 +40,11 @@ namespace {
     /// CalculateCompactSpline, and CalculateMonotonicSpline have very similar,
     /// but different calls.  In particular the dim parameter meaning is not
     /// consistent.
+    template <typename FloatType = DEVICE_FLOATING_POINT>
     DEVICE_CALLABLE_INLINE
     double CalculateGraph(const double x,
                           const double lowerBound, double upperBound,
-                          const DEVICE_FLOATING_POINT* data,
+                          const FloatType* data,
                           const int dim) {
 
         // Short circuit 1 point graphs.
@@ -89,6 +90,30 @@ namespace {
 
         return v;
     }
+
+    /// The derivative of CalculateGraph with respect to x (the slope of the
+    /// segment containing x).  The output bounds are not applied.  This is
+    /// used to calculate the analytic gradient of the likelihood.
+    template <typename FloatType = DEVICE_FLOATING_POINT>
+    DEVICE_CALLABLE_INLINE
+    double CalculateGraphDerivative(const double x,
+                                    const FloatType* data,
+                                    const int dim) {
+
+        // A 1 point graph is constant.
+        if (dim < 4) return 0.0;
+
+        const int knotCount = (dim)/2;
+        int ix = 0;
+        // Same search as CalculateGraph (at most 15 knots).
+        for (int i = 0; i < 15; ++i) {
+            if (x > data[2*(ix+1)+1] && ix < knotCount-2) ++ix;
+        }
+
+        const double step = data[2*(ix+1)+1] - data[2*ix+1];
+
+        return (data[2*(ix+1)] - data[2*ix])/step;
+    }
 }
 
 #ifdef TEST_CALCULATE_GRAPH
@@ -45,10 +45,11 @@ namespace {
     // CalculateCompactSpline, and CalculateMonotonicSpline have very similar,
     // but different calls.  In particular the dim parameter meaning is not
     // consistent.
+    template <typename FloatType = DEVICE_FLOATING_POINT>
     DEVICE_CALLABLE_INLINE
     double CalculateMonotonicSpline(const double x,
                                     const double lowerBound, double upperBound,
-                                    const DEVICE_FLOATING_POINT* data,
+                                    const FloatType* data,
                                     const int dim) {
 
         // Interpolate between p2 and p3
@@ -171,8 +172,89 @@ namespace {
         return v;
     }
 
+    // The derivative of CalculateMonotonicSpline with respect to x.  The
+    // output bounds are not applied, and the slopes at the knots get the same
+    // monotonic constraints as for the value.  This is used to calculate the
+    // analytic gradient of the likelihood.
+    template <typename FloatType = DEVICE_FLOATING_POINT>
+    DEVICE_CALLABLE_INLINE
+    double CalculateMonotonicSplineDerivative(const double x,
+                                              const FloatType* data,
+                                              const int dim) {
+        const double low = data[0];
+        const double step = data[1];
+
+        const double xx = (x-low)/step;
+        const int ix = xx;
+
+        int d21_0 = ix-1;
+        if (d21_0 < 0)     d21_0 = 0;
+        if (d21_0 > dim-2) d21_0 = dim-2;
+        int d21_1 = d21_0+1;
+        int d32_0 = ix;
+        if (d32_0 < 0)     d32_0 = 0;
+        if (d32_0 > dim-2) d32_0 = dim-2;
+        int d32_1 = d32_0+1;
+        int d43_0 = ix+1;
+        if (d43_0 < 0)     d43_0 = 0;
+        if (d43_0 > dim-2) d43_0 = dim-2;
+        int d43_1 = d43_0+1;
+        int d54_0 = ix+2;
+        if (d54_0 < 0)     d54_0 = 0;
+        if (d54_0 > dim-2) d54_0 = dim-2;
+        int d54_1 = d54_0+1;
+
+        const double p2 = data[2+d32_0];
+        const double p3 = data[2+d32_1];
+
+        const double fx = xx-d32_0;
+        const double fxx = fx*fx;
+
+        const double d21 = data[2+d21_1] - data[2+d21_0];
+        const double d32 = p3-p2;
+        const double d43 = data[2+d43_1] - data[2+d43_0];
+        const double d54 = data[2+d54_1] - data[2+d54_0];
+
+        double m2 = 0.5*(d21+d32);
+        double m3 = 0.5*(d32+d43);
+        double m4 = 0.5*(d43+d54);
+
+        // The same constraints as CalculateMonotonicSpline.
+        if (d32*d21 <= 0.0) m2 = 0.0;
+        if (d43*d32 <= 0.0) m3 = 0.0;
+        if (d54*d43 <= 0.0) m4 = 0.0;
+
+        const double b1 = (d21>0) ? m2/d21: 0;
+        const double a2 = (d32>0) ? m2/d32: 0;
+        const double b2 = (d32>0) ? m3/d32: 0;
+        const double a3 = (d43>0) ? m3/d43: 0;
+        const double b3 = (d43>0) ? m4/d43: 0;
+
+        if (b1 <= 0) m2 = 0.0;
+        if (b2 <= 0) m3 = 0.0;
+        if (a2 <= 0) m2 = 0.0;
+        if (a3 <= 0) m3 = 0.0;
+
+        if (a2 > 3 || b2 > 3) m2 = 3.0*d32;
+        if (a3 > 3 || b3 > 3) m3 = 3.0*d43;
+
+        // Derivative of the cubic with respect to fx.
+        const double dt = 6.0*fx-6.0*fxx;
+        const double dv = - p2*dt + m2*(3.0*fxx-4.0*fx+1.0)
+                          + p3*dt + m3*(3.0*fxx-2.0*fx);
+
+        return dv/step;
+    }
+
 }
 
+// The batched (host only) version of this calculation is
+// CalculateMonotonicSplineBatch.  It evaluates many splines with the same number of
+// knots using the CPU vector extensions.
+#ifndef __CUDACC__
+#include "CalculateSplineBatch.h"
+#endif
+
 // An MIT Style License
 
 // Copyright (c) 2022 Clark McGrew
@@ -0,0 +1,128 @@
+#ifndef CALCULATE_SPLINE_BATCH_H_SEEN
+#define CALCULATE_SPLINE_BATCH_H_SEEN
+// Batched (host only) evaluation of the uniformly spaced splines.  The
+// batched calls evaluate "n" splines with the same number of knots, and are
+// implemented with AVX2 and AVX-512 when the CPU supports it.  The
+// instruction set is chosen at run time, and the scalar calculation is used
+// when neither extension is available (or when not on x86-64).  The vector
+// calculations do the same operations in the same order as the scalar
+// CalculateCompactSpline, CalculateMonotonicSpline and CalculateUniformSpline
+// so the results are identical.
+//
+// The batched functions share the calling convention
+//
+//   n      -- The number of splines to evaluate.
+//   x      -- The n input values (one per spline, they may all be the same).
+//   data   -- The buffer holding the spline data.
+//   offset -- The n offsets of the spline data in the buffer.  The data for
+//             spline i starts at data[offset[i]] and has the layout expected
+//             by the scalar calculation.
+//   dim    -- The dim argument of the scalar calculation (the same for all
+//             of the splines).
+//   result -- The n output values.
+//
+// The outputs are not clamped (i.e. the scalar bounds are infinite).
+
+#ifndef __CUDACC__
+
+#include <string>
+
+enum class SplineBatchIsa {
+    Scalar = 0,
+    Avx2,
+    Avx512
+};
+
+/// The instruction set being used by the batched calculations.  On the first
+/// call this is set to the best extension supported by the CPU.
+SplineBatchIsa GetSplineBatchIsa();
+
+/// Override the instruction set.  The request is lowered to what the CPU
+/// supports, and the instruction set that will be used is returned.
+SplineBatchIsa SetSplineBatchIsa(SplineBatchIsa isa);
+
+std::string SplineBatchIsaName(SplineBatchIsa isa);
+
+// The data can be single precision: the values are converted to double and
+// the calculation is the same as for double precision data.
+void CalculateCompactSplineBatch(int n, const double* x,
+                                 const double* data, const int* offset,
+                                 int dim, double* result);
+
+void CalculateCompactSplineBatch(int n, const double* x,
+                                 const float* data, const int* offset,
+                                 int dim, double* result);
+
+void CalculateMonotonicSplineBatch(int n, const double* x,
+                                   const double* data, const int* offset,
+                                   int dim, double* result);
+
+void CalculateMonotonicSplineBatch(int n, const double* x,
+                                   const float* data, const int* offset,
+                                   int dim, double* result);
+
+void CalculateUniformSplineBatch(int n, const double* x,
+                                 const double* data, const int* offset,
+                                 int dim, double* result);
+
+void CalculateUniformSplineBatch(int n, const double* x,
+                                 const float* data, const int* offset,
+                                 int dim, double* result);
+
+/// Collect the splines one at a time, and evaluate them in batches of
+/// splines sharing the same dim.  A "tag" is kept for each spline and is
+/// passed with the value to the store function when a batch is evaluated.
+/// The store function must be callable as store(int tag, double value).
+/// FloatType is the type of the spline data.
+template <typename FloatType>
+class SplineBatchBufferT {
+public:
+    typedef void (*BatchFunction)(int, const double*,
+                                  const FloatType*, const int*,
+                                  int, double*);
+    static constexpr int kBatchSize = 64;
+
+    SplineBatchBufferT(BatchFunction function, const FloatType* data)
+        : fFunction(function), fData(data) {}
+
+    template <typename Store>
+    void Add(double x, int offset, int dim, int tag, Store&& store) {
+        if (fCount > 0 && (dim != fDim || fCount == kBatchSize)) {
+            Flush(store);
+        }
+        fDim = dim;
+        fX[fCount] = x;
+        fOffset[fCount] = offset;
+        fTag[fCount] = tag;
+        ++fCount;
+    }
+
+    template <typename Store>
+    void Flush(Store&& store) {
+        if (fCount < 1) return;
+        fFunction(fCount, fX, fData, fOffset, fDim, fResult);
+        for (int i = 0; i < fCount; ++i) store(fTag[i], fResult[i]);
+        fCount = 0;
+    }
+
+private:
+    BatchFunction fFunction;
+    const FloatType* fData;
+    int fCount{0};
+    int fDim{0};
+    double fX[kBatchSize];
+    int fOffset[kBatchSize];
+    int fTag[kBatchSize];
+    double fResult[kBatchSize];
+};
+
+typedef SplineBatchBufferT<double> SplineBatchBuffer;
+
+#endif
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:4
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
+#endif
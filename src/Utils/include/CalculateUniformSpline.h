@@ -43,10 +43,11 @@ namespace {
     // CalculateCompactSpline, and CalculateMonotonicSpline have very similar,
     // but different calls.  In particular the dim parameter meaning is not
     // consistent.
+    template <typename FloatType = DEVICE_FLOATING_POINT>
     DEVICE_CALLABLE_INLINE
     double CalculateUniformSpline(const double x,
                                   const double lowerBound, double upperBound,
-                                  const DEVICE_FLOATING_POINT* data,
+                                  const FloatType* data,
                                   const int dim) {
 
         // Get the integer part
@@ -79,8 +80,45 @@ namespace {
 
         return v;
     }
+
+    // The derivative of CalculateUniformSpline with respect to x.  The output
+    // bounds are not applied.  This is used to calculate the analytic
+    // gradient of the likelihood.
+    template <typename FloatType = DEVICE_FLOATING_POINT>
+    DEVICE_CALLABLE_INLINE
+    double CalculateUniformSplineDerivative(const double x,
+                                            const FloatType* data,
+                                            const int dim) {
+        const double step = data[1];
+        const double xx = (x-data[0])/step;
+        int ix = xx;
+        if (ix<0) ix=0;
+        if (2*ix+7>dim) ix = (dim-2)/2 - 2 ;
+
+        const double fx = xx-ix;
+        const double fxx = fx*fx;
+
+        const double p1 = data[2+2*ix];
+        const double m1 = data[2+2*ix+1]*step;
+        const double p2 = data[2+2*ix+2];
+        const double m2 = data[2+2*ix+3]*step;
+
+        // Derivative of the cubic with respect to fx.
+        const double dt = 6.0*fx-6.0*fxx;
+        const double dv = - p1*dt + m1*(3.0*fxx-4.0*fx+1.0)
+                          + p2*dt + m2*(3.0*fxx-2.0*fx);
+
+        return dv/step;
+    }
 }
 
+// The batched (host only) version of this calculation is
+// CalculateUniformSplineBatch.  It evaluates many splines with the same number of
+// knots using the CPU vector extensions.
+#ifndef __CUDACC__
+#include "CalculateSplineBatch.h"
+#endif
+
 // An MIT Style License
 
 // Copyright (c) 2022 Clark McGrew
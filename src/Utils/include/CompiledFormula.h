@@ -0,0 +1,204 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#ifndef GUNDAM_COMPILED_FORMULA_H
+#define GUNDAM_COMPILED_FORMULA_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+
+/// Arithmetic/logical expression translated once into a flat stack program.
+/// The syntax is the common subset of TFormula and TTreeFormula: numbers,
+/// variables (leaf names, optionally with constant array subscripts, or
+/// TFormula parameters written as [name]), the C operators, "^" and "**" as
+/// power, and the usual math functions (abs, sqrt, exp, log, pow, min, max,
+/// ... with or without the TMath:: prefix).
+///
+/// The variables are numbered in order of first appearance. Their values
+/// are provided at evaluation time by the caller, so no allocation or name
+/// lookup is involved. If compile() fails, the caller is expected to fall
+/// back on TFormula/TTreeFormula. This is also the case for the expressions
+/// where the ROOT formula classes don't follow the same precedence: unary
+/// minus of a power and comparisons used as bitwise operands without
+/// parentheses.
+class CompiledFormula{
+
+public:
+  /// Storage types of the raw values that can be read with readValue()
+  enum class ValueType{ Double, Float, Long64, ULong64, Int, UInt, Short, UShort, Char, UChar, Bool };
+
+  enum class OpCode{
+    Constant, Variable,
+    Negate, Not,
+    Add, Subtract, Multiply, Divide, Modulo, Power,
+    Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual,
+    And, Or, BitAnd, BitOr,
+    Function1, Function2
+  };
+
+  enum class Function{
+    Abs, Sqrt, Exp, Log, Log10, Sin, Cos, Tan, ASin, ACos, ATan, SinH, CosH, TanH, Floor, Ceil,
+    Pow, ATan2, Min, Max
+  };
+
+  struct Instruction{
+    OpCode op{OpCode::Constant};
+    int index{-1}; // variable index or function
+    double value{0}; // constant
+  };
+
+  static constexpr int kMaxStackSize{64};
+
+public:
+  CompiledFormula() = default;
+
+  // const getters
+  [[nodiscard]] bool isCompiled() const{ return not _instructionList_.empty(); }
+  [[nodiscard]] const std::string& getFormulaStr() const{ return _formulaStr_; }
+  [[nodiscard]] const std::string& getErrorMessage() const{ return _errorMessage_; }
+  [[nodiscard]] const std::vector<std::string>& getVariableNameList() const{ return _variableNameList_; }
+  [[nodiscard]] const std::vector<Instruction>& getInstructionList() const{ return _instructionList_; }
+
+  /// Translate the formula. Returns false if it uses a syntax that is not
+  /// handled. The reason is given by getErrorMessage().
+  bool compile(const std::string& formulaStr_);
+
+  /// Evaluate the program. fetchVar_(iVar) must return the value of the
+  /// iVar-th variable of getVariableNameList() as a double.
+  template<typename VarFetcher> [[nodiscard]] double eval(const VarFetcher& fetchVar_) const;
+
+  [[nodiscard]] std::string getSummary() const;
+
+  // utils
+  /// Convert a ROOT leaf type name ("Int_t", "Float_t", ...). Returns false if the type is not a number.
+  static bool parseValueType(const std::string& typeName_, ValueType& type_);
+  static double readValue(const void* address_, ValueType type_);
+  /// Compare an evaluation with the TFormula/TTreeFormula one (nan matches nan)
+  static bool isSameValue(double value_, double reference_);
+  static void writeValue(void* address_, ValueType type_, double value_);
+  static double evalFunction(Function function_, double x_);
+  static double evalFunction(Function function_, double x_, double y_);
+
+private:
+  std::string _formulaStr_{};
+  std::string _errorMessage_{};
+  std::vector<std::string> _variableNameList_{};
+  std::vector<Instruction> _instructionList_{};
+
+};
+
+template<typename VarFetcher> double CompiledFormula::eval(const VarFetcher& fetchVar_) const{
+
+  //! Warning: this is called for every event and every cut
+
+  double stack[kMaxStackSize];
+  int top{-1};
+
+  for( auto& instruction : _instructionList_ ){
+    switch( instruction.op ){
+      case OpCode::Constant: stack[++top] = instruction.value; break;
+      case OpCode::Variable: stack[++top] = fetchVar_(instruction.index); break;
+      case OpCode::Negate: stack[top] = -stack[top]; break;
+      case OpCode::Not: stack[top] = (stack[top] == 0); break;
+      case OpCode::Function1: stack[top] = evalFunction(Function(instruction.index), stack[top]); break;
+      default:{
+        // binary operators
+        double b{stack[top--]};
+        double& a{stack[top]};
+        switch( instruction.op ){
+          case OpCode::Add: a += b; break;
+          case OpCode::Subtract: a -= b; break;
+          case OpCode::Multiply: a *= b; break;
+          case OpCode::Divide: a /= b; break;
+          case OpCode::Modulo: a = ( int64_t(b) == 0 ? 0 : double(int64_t(a) % int64_t(b)) ); break;
+          case OpCode::Power: a = std::pow(a, b); break;
+          case OpCode::Less: a = (a < b); break;
+          case OpCode::LessEqual: a = (a <= b); break;
+          case OpCode::Greater: a = (a > b); break;
+          case OpCode::GreaterEqual: a = (a >= b); break;
+          case OpCode::Equal: a = (a == b); break;
+          case OpCode::NotEqual: a = (a != b); break;
+          case OpCode::And: a = (a != 0 and b != 0); break;
+          case OpCode::Or: a = (a != 0 or b != 0); break;
+          case OpCode::BitAnd: a = double(int64_t(a) & int64_t(b)); break;
+          case OpCode::BitOr: a = double(int64_t(a) | int64_t(b)); break;
+          case OpCode::Function2: a = evalFunction(Function(instruction.index), a, b); break;
+          default: break;
+        }
+      }
+    }
+  }
+
+  return stack[0];
+}
+
+inline double CompiledFormula::readValue(const void* address_, ValueType type_){
+  switch( type_ ){
+    case ValueType::Double:  return *static_cast<const double*>(address_);
+    case ValueType::Float:   return *static_cast<const float*>(address_);
+    case ValueType::Long64:  return double(*static_cast<const int64_t*>(address_));
+    case ValueType::ULong64: return double(*static_cast<const uint64_t*>(address_));
+    case ValueType::Int:     return *static_cast<const int32_t*>(address_);
+    case ValueType::UInt:    return *static_cast<const uint32_t*>(address_);
+    case ValueType::Short:   return *static_cast<const int16_t*>(address_);
+    case ValueType::UShort:  return *static_cast<const uint16_t*>(address_);
+    case ValueType::Char:    return *static_cast<const int8_t*>(address_);
+    case ValueType::UChar:   return *static_cast<const uint8_t*>(address_);
+    case ValueType::Bool:    return *static_cast<const bool*>(address_);
+  }
+  return std::nan("unknown");
+}
+inline bool CompiledFormula::isSameValue(double value_, double reference_){
+  if( std::isnan(value_) or std::isnan(reference_) ){ return std::isnan(value_) and std::isnan(reference_); }
+  if( value_ == reference_ ){ return true; }
+  return std::abs(value_ - reference_) <= 1E-12 * std::max(std::abs(value_), std::abs(reference_));
+}
+inline void CompiledFormula::writeValue(void* address_, ValueType type_, double value_){
+  switch( type_ ){
+    case ValueType::Double:  *static_cast<double*>(address_) = value_; break;
+    case ValueType::Float:   *static_cast<float*>(address_) = float(value_); break;
+    case ValueType::Long64:  *static_cast<int64_t*>(address_) = int64_t(value_); break;
+    case ValueType::ULong64: *static_cast<uint64_t*>(address_) = uint64_t(value_); break;
+    case ValueType::Int:     *static_cast<int32_t*>(address_) = int32_t(value_); break;
+    case ValueType::UInt:    *static_cast<uint32_t*>(address_) = uint32_t(value_); break;
+    case ValueType::Short:   *static_cast<int16_t*>(address_) = int16_t(value_); break;
+    case ValueType::UShort:  *static_cast<uint16_t*>(address_) = uint16_t(value_); break;
+    case ValueType::Char:    *static_cast<int8_t*>(address_) = int8_t(value_); break;
+    case ValueType::UChar:   *static_cast<uint8_t*>(address_) = uint8_t(value_); break;
+    case ValueType::Bool:    *static_cast<bool*>(address_) = (value_ != 0); break;
+  }
+}
+
+#endif // GUNDAM_COMPILED_FORMULA_H
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
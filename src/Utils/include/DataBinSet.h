@@ -18,6 +18,26 @@ public:
   // static
   static void setVerbosity(int maxLogLevel_);
 
+  /// The bin search index is a tree of sorted edge arrays. Each node splits
+  /// its bins along one of the search variables: the children are the
+  /// boundaries themselves (even indices) and the open intervals in between
+  /// (odd indices). The leaves hold the few candidate bins that still have to
+  /// be checked with all their edges (condition variables included).
+  struct SearchNode{
+    int searchVarIndex{-1}; // -1 for the leaves
+    std::vector<double> boundaryList{};
+    std::vector<int> childNodeList{}; // -1: no bin
+    std::vector<int> binIndexList{}; // leaves only, sorted
+  };
+
+  /// A variable defined as a range in every bin
+  struct SearchVar{
+    std::string name{};
+    // the edges from which the varIndexCache is read at lookup time
+    int binIndex{-1};
+    int edgesIndex{-1};
+  };
+
 public:
   DataBinSet() = default;
 
@@ -27,6 +47,8 @@ public:
   // const getters
   [[nodiscard]] const std::string &getFilePath() const { return _filePath_; }
   [[nodiscard]] const std::vector<DataBin> &getBinList() const { return _binList_; }
+  [[nodiscard]] const std::vector<SearchVar> &getSearchVarList() const { return _searchVarList_; }
+  [[nodiscard]] bool isSearchIndexValid() const { return _searchIndexNbBins_ != 0 and _searchIndexNbBins_ == _binList_.size(); }
 
   // getters
   std::vector<DataBin> &getBinList() { return _binList_; }
@@ -34,6 +56,17 @@ public:
   // core
   void readBinningDefinition(const std::string& filePath_);
   void checkBinning();
+
+  /// To be called whenever the bin list is modified. The index is only
+  /// built for large enough binnings having at least one range variable
+  /// common to all the bins. Otherwise, the bins are scanned.
+  void buildSearchIndex();
+
+  /// Candidate bins for the values of the search variables (in the order of
+  /// getSearchVarList()). The first candidate containing the event is the
+  /// one the scan of the bin list would have found. Returns nullptr if no
+  /// bin can contain the values.
+  [[nodiscard]] const std::vector<int>* findCandidateBinList(const std::vector<double>& searchVarValueList_) const;
   [[nodiscard]] std::string getSummary() const;
 
   // utils
@@ -45,11 +78,20 @@ protected:
   void readTxtBinningDefinition();    // original txt
   void readBinningConfig(); // yaml/json
 
+  // edgesTable_[iBin][iSearchVar]. Returns the index of the created node
+  int buildSearchNode(const std::vector<int>& binIndexList_, std::vector<bool>& isVarUsedList_,
+                      const std::vector<std::vector<const DataBin::Edges*>>& edgesTable_);
+
 private:
   std::string _name_;
   std::string _filePath_;
   std::vector<DataBin> _binList_{};
 
+  // bin search index
+  size_t _searchIndexNbBins_{0};
+  std::vector<SearchVar> _searchVarList_{};
+  std::vector<SearchNode> _searchNodeList_{}; // the root is the first node
+
 };
 
 
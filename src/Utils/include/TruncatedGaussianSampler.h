@@ -0,0 +1,100 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#ifndef GUNDAM_TRUNCATED_GAUSSIAN_SAMPLER_H
+#define GUNDAM_TRUNCATED_GAUSSIAN_SAMPLER_H
+
+#include "TMatrixD.h"
+#include "TRandom.h"
+
+#include <vector>
+
+
+/// Correlated gaussian throws truncated to box bounds, x ~ N(mean, cov) with
+/// min <= x <= max, drawn with a Gibbs sampler. Each coordinate is drawn in
+/// turn from its conditional distribution, a 1D truncated gaussian, so no
+/// throw is ever rejected: contrary to the rethrow of the whole vector, the
+/// cost doesn't blow up with the number of bounded parameters.
+///
+/// The sampler keeps one Markov chain: it starts from the mean (moved inside
+/// the bounds), runs the burn-in sweeps, then each throw continues the chain
+/// for a few sweeps (thinning). Restarting the chain at every throw would
+/// bias the throws toward the starting point. The chain is restarted if the
+/// bounds or the covariance matrix change.
+class TruncatedGaussianSampler{
+
+public:
+  TruncatedGaussianSampler() = default;
+
+  /// Precompute the conditional distributions (inverts the covariance)
+  void setCovarianceMatrix(const TMatrixDBase& covarianceMatrix_);
+  /// Number of sweeps over the coordinates between two throws
+  void setNbSweeps(int nbSweeps_){ _nbSweeps_ = nbSweeps_; }
+  /// Number of sweeps discarded when the chain (re)starts
+  void setNbBurnInSweeps(int nbBurnInSweeps_){ _nbBurnInSweeps_ = nbBurnInSweeps_; }
+
+  [[nodiscard]] bool isInitialized() const{ return not _condSigmaList_.empty(); }
+  [[nodiscard]] int getNbSweeps() const{ return _nbSweeps_; }
+  [[nodiscard]] int getNbBurnInSweeps() const{ return _nbBurnInSweeps_; }
+
+  /// The next throw starts a new chain
+  void resetChain(){ _chainDeltaList_.clear(); }
+
+  /// Throw the deltas to the mean. The bounds are given relative to the mean
+  /// and can be infinite or NaN (unbounded).
+  void throwDeltas(
+      const std::vector<double>& minDeltaList_, const std::vector<double>& maxDeltaList_,
+      std::vector<double>& deltaList_, TRandom& rng_
+  );
+
+  /// Standard gaussian N(mean_, sigma_) truncated to [min_, max_] by inverse
+  /// CDF, sampled on the tail side to stay accurate far from the mean.
+  static double throwTruncatedGauss(double mean_, double sigma_, double min_, double max_, TRandom& rng_);
+
+private:
+  void runSweeps(int nbSweeps_, TRandom& rng_);
+
+  int _nbSweeps_{5};
+  int _nbBurnInSweeps_{100};
+
+  // x_i | x_-i ~ N( sum_j coef_ij x_j, condSigma_i ), coef_ii = 0
+  std::vector<double> _condSigmaList_{};
+  std::vector<double> _condCoefMatrix_{}; // row major
+
+  // state of the chain and the bounds it has been run with (NaN -> inf)
+  std::vector<double> _chainDeltaList_{};
+  std::vector<double> _chainMinDeltaList_{};
+  std::vector<double> _chainMaxDeltaList_{};
+
+};
+
+
+#endif // GUNDAM_TRUNCATED_GAUSSIAN_SAMPLER_H
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
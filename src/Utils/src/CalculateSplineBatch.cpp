@@ -0,0 +1,360 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#include "CalculateSplineBatch.h"
+#include "CalculateCompactSpline.h"
+#include "CalculateMonotonicSpline.h"
+#include "CalculateUniformSpline.h"
+
+#include <limits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SPLINE_BATCH_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+    const double kInfinity = std::numeric_limits<double>::infinity();
+
+    template <typename FloatType>
+    void CompactSplineScalar(int n, const double* x,
+                             const FloatType* data, const int* offset,
+                             int dim, double* result) {
+        for (int i = 0; i < n; ++i) {
+            result[i] = CalculateCompactSpline(x[i], -kInfinity, kInfinity,
+                                               data + offset[i], dim);
+        }
+    }
+
+    template <typename FloatType>
+    void MonotonicSplineScalar(int n, const double* x,
+                               const FloatType* data, const int* offset,
+                               int dim, double* result) {
+        for (int i = 0; i < n; ++i) {
+            result[i] = CalculateMonotonicSpline(x[i], -kInfinity, kInfinity,
+                                                 data + offset[i], dim);
+        }
+    }
+
+    template <typename FloatType>
+    void UniformSplineScalar(int n, const double* x,
+                             const FloatType* data, const int* offset,
+                             int dim, double* result) {
+        for (int i = 0; i < n; ++i) {
+            result[i] = CalculateUniformSpline(x[i], -kInfinity, kInfinity,
+                                               data + offset[i], dim);
+        }
+    }
+}
+
+#ifdef SPLINE_BATCH_X86
+
+// The AVX2 calculation (four doubles per vector).  Everything defined between
+// the push and pop is compiled for AVX2.  FMA is deliberately not enabled so
+// the results match the scalar calculation.
+#ifdef __clang__
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+namespace SplineBatchAvx2 {
+    const double kInfinity = std::numeric_limits<double>::infinity();
+    constexpr int kWidth = 4;
+    typedef __m256d Vec;
+    typedef __m128i Idx;
+    typedef __m256d Mask;
+    typedef __m128i IMask;
+
+    inline Vec set1(double v) {return _mm256_set1_pd(v);}
+    inline Vec loadu(const double* p) {return _mm256_loadu_pd(p);}
+    inline void storeu(double* p, Vec v) {_mm256_storeu_pd(p, v);}
+    inline Vec add(Vec a, Vec b) {return _mm256_add_pd(a, b);}
+    inline Vec sub(Vec a, Vec b) {return _mm256_sub_pd(a, b);}
+    inline Vec mul(Vec a, Vec b) {return _mm256_mul_pd(a, b);}
+    inline Vec div(Vec a, Vec b) {return _mm256_div_pd(a, b);}
+    inline Vec gather(const double* base, Idx i) {
+        // The masked form avoids a spurious uninitialized warning from gcc.
+        return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, i,
+                                        _mm256_castsi256_pd(
+                                            _mm256_set1_epi64x(-1)), 8);
+    }
+    inline Vec gather(const float* base, Idx i) {
+        return _mm256_cvtps_pd(
+            _mm_mask_i32gather_ps(_mm_setzero_ps(), base, i,
+                                  _mm_castsi128_ps(_mm_set1_epi32(-1)), 4));
+    }
+    inline Vec gatherSub(const double* base, Idx i, Idx j) {
+        return sub(gather(base, i), gather(base, j));
+    }
+    inline Vec gatherSub(const float* base, Idx i, Idx j) {
+        // The difference of two floats is taken in single precision, as in
+        // the scalar calculation.
+        const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        return _mm256_cvtps_pd(
+            _mm_sub_ps(_mm_mask_i32gather_ps(_mm_setzero_ps(), base, i, mask, 4),
+                       _mm_mask_i32gather_ps(_mm_setzero_ps(), base, j, mask, 4)));
+    }
+    inline Idx toIdx(Vec v) {return _mm256_cvttpd_epi32(v);}
+    inline Vec toVec(Idx i) {return _mm256_cvtepi32_pd(i);}
+    inline Idx iset1(int v) {return _mm_set1_epi32(v);}
+    inline Idx iloadu(const int* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+    inline Idx iadd(Idx a, Idx b) {return _mm_add_epi32(a, b);}
+    inline Idx isub(Idx a, Idx b) {return _mm_sub_epi32(a, b);}
+    inline Idx imin(Idx a, Idx b) {return _mm_min_epi32(a, b);}
+    inline Idx imax(Idx a, Idx b) {return _mm_max_epi32(a, b);}
+    inline IMask icmpgt(Idx a, Idx b) {return _mm_cmpgt_epi32(a, b);}
+    inline Idx iselect(IMask m, Idx t, Idx f) {return _mm_blendv_epi8(f, t, m);}
+    inline Mask cmple(Vec a, Vec b) {return _mm256_cmp_pd(a, b, _CMP_LE_OQ);}
+    inline Mask cmpgt(Vec a, Vec b) {return _mm256_cmp_pd(a, b, _CMP_GT_OQ);}
+    inline Mask mor(Mask a, Mask b) {return _mm256_or_pd(a, b);}
+    inline Vec select(Mask m, Vec t, Vec f) {return _mm256_blendv_pd(f, t, m);}
+
+#include "CalculateSplineBatch.impl.h"
+}
+#ifdef __clang__
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+// The AVX-512 calculation (eight doubles per vector).  AVX-512 implies FMA,
+// so the contraction of multiplications and additions is disabled.
+#ifdef __clang__
+#pragma clang attribute push (__attribute__((target("avx512f"))), apply_to = function)
+#pragma clang fp contract(off)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#pragma GCC optimize("fp-contract=off")
+#endif
+namespace SplineBatchAvx512 {
+    const double kInfinity = std::numeric_limits<double>::infinity();
+    constexpr int kWidth = 8;
+    typedef __m512d Vec;
+    typedef __m256i Idx;
+    typedef __mmask8 Mask;
+    typedef __m256i IMask;
+
+    inline Vec set1(double v) {return _mm512_set1_pd(v);}
+    inline Vec loadu(const double* p) {return _mm512_loadu_pd(p);}
+    inline void storeu(double* p, Vec v) {_mm512_storeu_pd(p, v);}
+    inline Vec add(Vec a, Vec b) {return _mm512_add_pd(a, b);}
+    inline Vec sub(Vec a, Vec b) {return _mm512_sub_pd(a, b);}
+    inline Vec mul(Vec a, Vec b) {return _mm512_mul_pd(a, b);}
+    inline Vec div(Vec a, Vec b) {return _mm512_div_pd(a, b);}
+    inline Vec gather(const double* base, Idx i) {
+        // The masked forms avoid spurious uninitialized warnings from gcc.
+        return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, i, base, 8);
+    }
+    inline Vec gather(const float* base, Idx i) {
+        // The eight floats are gathered with the 256-bit index: widening
+        // it to 512 bits would leave its upper half undefined.
+        return _mm512_mask_cvtps_pd(
+            _mm512_setzero_pd(), 0xFF,
+            _mm256_mask_i32gather_ps(_mm256_setzero_ps(), base, i,
+                                     _mm256_castsi256_ps(
+                                         _mm256_set1_epi32(-1)), 4));
+    }
+    inline Vec gatherSub(const double* base, Idx i, Idx j) {
+        return sub(gather(base, i), gather(base, j));
+    }
+    inline Vec gatherSub(const float* base, Idx i, Idx j) {
+        // The difference of two floats is taken in single precision, as in
+        // the scalar calculation.
+        const __m256 mask = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        return _mm512_mask_cvtps_pd(
+            _mm512_setzero_pd(), 0xFF,
+            _mm256_sub_ps(
+                _mm256_mask_i32gather_ps(_mm256_setzero_ps(), base, i, mask, 4),
+                _mm256_mask_i32gather_ps(_mm256_setzero_ps(), base, j, mask, 4)));
+    }
+    inline Idx toIdx(Vec v) {
+        return _mm512_mask_cvttpd_epi32(_mm256_setzero_si256(), 0xFF, v);
+    }
+    inline Vec toVec(Idx i) {
+        return _mm512_mask_cvtepi32_pd(_mm512_setzero_pd(), 0xFF, i);
+    }
+    inline Idx iset1(int v) {return _mm256_set1_epi32(v);}
+    inline Idx iloadu(const int* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    inline Idx iadd(Idx a, Idx b) {return _mm256_add_epi32(a, b);}
+    inline Idx isub(Idx a, Idx b) {return _mm256_sub_epi32(a, b);}
+    inline Idx imin(Idx a, Idx b) {return _mm256_min_epi32(a, b);}
+    inline Idx imax(Idx a, Idx b) {return _mm256_max_epi32(a, b);}
+    inline IMask icmpgt(Idx a, Idx b) {return _mm256_cmpgt_epi32(a, b);}
+    inline Idx iselect(IMask m, Idx t, Idx f) {
+        return _mm256_blendv_epi8(f, t, m);
+    }
+    inline Mask cmple(Vec a, Vec b) {return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ);}
+    inline Mask cmpgt(Vec a, Vec b) {return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ);}
+    inline Mask mor(Mask a, Mask b) {return a | b;}
+    inline Vec select(Mask m, Vec t, Vec f) {return _mm512_mask_blend_pd(m, f, t);}
+
+#include "CalculateSplineBatch.impl.h"
+}
+#ifdef __clang__
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif // SPLINE_BATCH_X86
+
+namespace {
+    SplineBatchIsa BestSplineBatchIsa() {
+#ifdef SPLINE_BATCH_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return SplineBatchIsa::Avx512;
+        if (__builtin_cpu_supports("avx2")) return SplineBatchIsa::Avx2;
+#endif
+        return SplineBatchIsa::Scalar;
+    }
+
+    SplineBatchIsa& CurrentSplineBatchIsa() {
+        static SplineBatchIsa isa = BestSplineBatchIsa();
+        return isa;
+    }
+}
+
+SplineBatchIsa GetSplineBatchIsa() {
+    return CurrentSplineBatchIsa();
+}
+
+SplineBatchIsa SetSplineBatchIsa(SplineBatchIsa isa) {
+    const SplineBatchIsa best = BestSplineBatchIsa();
+    if (int(isa) > int(best)) isa = best;
+    CurrentSplineBatchIsa() = isa;
+    return isa;
+}
+
+std::string SplineBatchIsaName(SplineBatchIsa isa) {
+    switch (isa) {
+    case SplineBatchIsa::Avx512: return "AVX-512";
+    case SplineBatchIsa::Avx2: return "AVX2";
+    default: return "scalar";
+    }
+}
+
+namespace {
+    template <typename FloatType>
+    void CompactSplineBatchDispatch(int n, const double* x,
+                                    const FloatType* data, const int* offset,
+                                    int dim, double* result) {
+        switch (CurrentSplineBatchIsa()) {
+#ifdef SPLINE_BATCH_X86
+        case SplineBatchIsa::Avx512:
+            SplineBatchAvx512::CompactSplineBatch(n, x, data, offset, dim, result);
+            return;
+        case SplineBatchIsa::Avx2:
+            SplineBatchAvx2::CompactSplineBatch(n, x, data, offset, dim, result);
+            return;
+#endif
+        default:
+            CompactSplineScalar(n, x, data, offset, dim, result);
+        }
+    }
+
+    template <typename FloatType>
+    void MonotonicSplineBatchDispatch(int n, const double* x,
+                                      const FloatType* data, const int* offset,
+                                      int dim, double* result) {
+        switch (CurrentSplineBatchIsa()) {
+#ifdef SPLINE_BATCH_X86
+        case SplineBatchIsa::Avx512:
+            SplineBatchAvx512::MonotonicSplineBatch(n, x, data, offset, dim, result);
+            return;
+        case SplineBatchIsa::Avx2:
+            SplineBatchAvx2::MonotonicSplineBatch(n, x, data, offset, dim, result);
+            return;
+#endif
+        default:
+            MonotonicSplineScalar(n, x, data, offset, dim, result);
+        }
+    }
+
+    template <typename FloatType>
+    void UniformSplineBatchDispatch(int n, const double* x,
+                                    const FloatType* data, const int* offset,
+                                    int dim, double* result) {
+        switch (CurrentSplineBatchIsa()) {
+#ifdef SPLINE_BATCH_X86
+        case SplineBatchIsa::Avx512:
+            SplineBatchAvx512::UniformSplineBatch(n, x, data, offset, dim, result);
+            return;
+        case SplineBatchIsa::Avx2:
+            SplineBatchAvx2::UniformSplineBatch(n, x, data, offset, dim, result);
+            return;
+#endif
+        default:
+            UniformSplineScalar(n, x, data, offset, dim, result);
+        }
+    }
+}
+
+void CalculateCompactSplineBatch(int n, const double* x,
+                                 const double* data, const int* offset,
+                                 int dim, double* result) {
+    CompactSplineBatchDispatch(n, x, data, offset, dim, result);
+}
+
+void CalculateCompactSplineBatch(int n, const double* x,
+                                 const float* data, const int* offset,
+                                 int dim, double* result) {
+    CompactSplineBatchDispatch(n, x, data, offset, dim, result);
+}
+
+void CalculateMonotonicSplineBatch(int n, const double* x,
+                                   const double* data, const int* offset,
+                                   int dim, double* result) {
+    MonotonicSplineBatchDispatch(n, x, data, offset, dim, result);
+}
+
+void CalculateMonotonicSplineBatch(int n, const double* x,
+                                   const float* data, const int* offset,
+                                   int dim, double* result) {
+    MonotonicSplineBatchDispatch(n, x, data, offset, dim, result);
+}
+
+void CalculateUniformSplineBatch(int n, const double* x,
+                                 const double* data, const int* offset,
+                                 int dim, double* result) {
+    UniformSplineBatchDispatch(n, x, data, offset, dim, result);
+}
+
+void CalculateUniformSplineBatch(int n, const double* x,
+                                 const float* data, const int* offset,
+                                 int dim, double* result) {
+    UniformSplineBatchDispatch(n, x, data, offset, dim, result);
+}
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:4
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
@@ -0,0 +1,199 @@
+// The vectorized batched spline calculations.  This is included by
+// CalculateSplineBatch.cpp once per instruction set, inside of a namespace
+// that defines the vector type and operations:
+//
+//   Vec, Idx, Mask, IMask -- Double vector, int32 vector and the masks.
+//   kWidth                -- The number of lanes.
+//   set1, loadu, storeu, add, sub, mul, div, gather, gatherSub, toIdx,
+//   toVec, iset1, iloadu, iadd, isub, imin, imax, icmpgt, iselect,
+//   cmple, cmpgt, mor, select
+//
+// The operations are done in the same order as in the scalar calculations
+// (see CalculateCompactSpline.h, CalculateMonotonicSpline.h and
+// CalculateUniformSpline.h) so the results are bit for bit identical.  The
+// splines left over after the last full vector use the scalar calculation.
+// The data can be double or float (gather and gatherSub are overloaded for
+// both): float data is converted to double when it is gathered, except for
+// the differences between knots which are taken in the precision of the data,
+// as in the scalar calculations.
+
+inline Idx clampIndex(Idx i, Idx lower, Idx upper) {
+    return imin(imax(i, lower), upper);
+}
+
+template <typename FloatType>
+inline void CompactSplineBatch(int n, const double* x,
+                               const FloatType* data, const int* offset,
+                               int dim, double* result) {
+    const Idx zero = iset1(0);
+    const Idx one = iset1(1);
+    const Idx two = iset1(2);
+    const Idx top = iset1(dim-2);
+    int i = 0;
+    for (; i+kWidth <= n; i += kWidth) {
+        const Idx off = iloadu(offset+i);
+        const Vec low = gather(data, off);
+        const Vec step = gather(data, iadd(off, one));
+        const Vec xx = div(sub(loadu(x+i), low), step);
+        const Idx ix = toIdx(xx);
+
+        const Idx knots = iadd(off, two);
+        const Idx d21_0 = clampIndex(isub(ix, one), zero, top);
+        const Idx d32_0 = clampIndex(ix, zero, top);
+        const Idx d43_0 = clampIndex(iadd(ix, one), zero, top);
+
+        const Vec p2 = gather(data, iadd(knots, d32_0));
+        const Vec p3 = gather(data, iadd(knots, iadd(d32_0, one)));
+
+        const Vec fx = sub(xx, toVec(d32_0));
+        const Vec fxx = mul(fx, fx);
+        const Vec fxxx = mul(fx, fxx);
+
+        const Vec d21 = gatherSub(data, iadd(knots, iadd(d21_0, one)),
+                                  iadd(knots, d21_0));
+        const Vec d32 = sub(p3, p2);
+        const Vec d43 = gatherSub(data, iadd(knots, iadd(d43_0, one)),
+                                  iadd(knots, d43_0));
+
+        const Vec m2 = mul(set1(0.5), add(d21, d32));
+        const Vec m3 = mul(set1(0.5), add(d32, d43));
+
+        const Vec t = sub(mul(set1(3.0), fxx), mul(set1(2.0), fxxx));
+        Vec v = sub(p2, mul(p2, t));
+        v = add(v, mul(m2, add(sub(fxxx, mul(set1(2.0), fxx)), fx)));
+        v = add(v, mul(p3, t));
+        v = add(v, mul(m3, sub(fxxx, fxx)));
+        storeu(result+i, v);
+    }
+    for (; i < n; ++i) {
+        result[i] = CalculateCompactSpline(x[i], -kInfinity, kInfinity,
+                                           data + offset[i], dim);
+    }
+}
+
+template <typename FloatType>
+inline void MonotonicSplineBatch(int n, const double* x,
+                                 const FloatType* data, const int* offset,
+                                 int dim, double* result) {
+    const Idx zero = iset1(0);
+    const Idx one = iset1(1);
+    const Idx two = iset1(2);
+    const Idx top = iset1(dim-2);
+    const Vec vzero = set1(0.0);
+    const Vec vthree = set1(3.0);
+    int i = 0;
+    for (; i+kWidth <= n; i += kWidth) {
+        const Idx off = iloadu(offset+i);
+        const Vec low = gather(data, off);
+        const Vec step = gather(data, iadd(off, one));
+        const Vec xx = div(sub(loadu(x+i), low), step);
+        const Idx ix = toIdx(xx);
+
+        const Idx knots = iadd(off, two);
+        const Idx d21_0 = clampIndex(isub(ix, one), zero, top);
+        const Idx d32_0 = clampIndex(ix, zero, top);
+        const Idx d43_0 = clampIndex(iadd(ix, one), zero, top);
+        const Idx d54_0 = clampIndex(iadd(ix, two), zero, top);
+
+        const Vec p2 = gather(data, iadd(knots, d32_0));
+        const Vec p3 = gather(data, iadd(knots, iadd(d32_0, one)));
+
+        const Vec fx = sub(xx, toVec(d32_0));
+        const Vec fxx = mul(fx, fx);
+        const Vec fxxx = mul(fx, fxx);
+
+        const Vec d21 = gatherSub(data, iadd(knots, iadd(d21_0, one)),
+                                  iadd(knots, d21_0));
+        const Vec d32 = sub(p3, p2);
+        const Vec d43 = gatherSub(data, iadd(knots, iadd(d43_0, one)),
+                                  iadd(knots, d43_0));
+        const Vec d54 = gatherSub(data, iadd(knots, iadd(d54_0, one)),
+                                  iadd(knots, d54_0));
+
+        Vec m2 = mul(set1(0.5), add(d21, d32));
+        Vec m3 = mul(set1(0.5), add(d32, d43));
+        Vec m4 = mul(set1(0.5), add(d43, d54));
+
+        // Deal with cusp points and flat areas.
+        m2 = select(cmple(mul(d32, d21), vzero), vzero, m2);
+        m3 = select(cmple(mul(d43, d32), vzero), vzero, m3);
+        m4 = select(cmple(mul(d54, d43), vzero), vzero, m4);
+
+        // Find the alphas and betas
+        const Vec b1 = select(cmpgt(d21, vzero), div(m2, d21), vzero);
+        const Vec a2 = select(cmpgt(d32, vzero), div(m2, d32), vzero);
+        const Vec b2 = select(cmpgt(d32, vzero), div(m3, d32), vzero);
+        const Vec a3 = select(cmpgt(d43, vzero), div(m3, d43), vzero);
+        const Vec b3 = select(cmpgt(d43, vzero), div(m4, d43), vzero);
+
+        // Find places where can only be piecewise monotonic.
+        m2 = select(cmple(b1, vzero), vzero, m2);
+        m3 = select(cmple(b2, vzero), vzero, m3);
+        m2 = select(cmple(a2, vzero), vzero, m2);
+        m3 = select(cmple(a3, vzero), vzero, m3);
+
+        // Limit the slopes so there isn't overshoot.
+        m2 = select(mor(cmpgt(a2, vthree), cmpgt(b2, vthree)),
+                    mul(vthree, d32), m2);
+        m3 = select(mor(cmpgt(a3, vthree), cmpgt(b3, vthree)),
+                    mul(vthree, d43), m3);
+
+        const Vec t = sub(mul(vthree, fxx), mul(set1(2.0), fxxx));
+        Vec v = sub(p2, mul(p2, t));
+        v = add(v, mul(m2, add(sub(fxxx, mul(set1(2.0), fxx)), fx)));
+        v = add(v, mul(p3, t));
+        v = add(v, mul(m3, sub(fxxx, fxx)));
+        storeu(result+i, v);
+    }
+    for (; i < n; ++i) {
+        result[i] = CalculateMonotonicSpline(x[i], -kInfinity, kInfinity,
+                                             data + offset[i], dim);
+    }
+}
+
+template <typename FloatType>
+inline void UniformSplineBatch(int n, const double* x,
+                               const FloatType* data, const int* offset,
+                               int dim, double* result) {
+    const Idx zero = iset1(0);
+    const Idx one = iset1(1);
+    const Idx two = iset1(2);
+    const Idx seven = iset1(7);
+    const Idx vdim = iset1(dim);
+    const Idx last = iset1((dim-2)/2 - 2);
+    int i = 0;
+    for (; i+kWidth <= n; i += kWidth) {
+        const Idx off = iloadu(offset+i);
+        const Vec step = gather(data, iadd(off, one));
+        const Vec xx = div(sub(loadu(x+i), gather(data, off)), step);
+        Idx ix = imax(toIdx(xx), zero);
+        ix = iselect(icmpgt(iadd(iadd(ix, ix), seven), vdim), last, ix);
+
+        const Vec fx = sub(xx, toVec(ix));
+        const Vec fxx = mul(fx, fx);
+        const Vec fxxx = mul(fx, fxx);
+
+        const Idx knot = iadd(iadd(off, two), iadd(ix, ix));
+        const Vec p1 = gather(data, knot);
+        const Vec m1 = mul(gather(data, iadd(knot, one)), step);
+        const Vec p2 = gather(data, iadd(knot, two));
+        const Vec m2 = mul(gather(data, iadd(knot, iset1(3))), step);
+
+        const Vec t = sub(mul(set1(3.0), fxx), mul(set1(2.0), fxxx));
+        Vec v = sub(p1, mul(p1, t));
+        v = add(v, mul(m1, add(sub(fxxx, mul(set1(2.0), fxx)), fx)));
+        v = add(v, mul(p2, t));
+        v = add(v, mul(m2, sub(fxxx, fxx)));
+        storeu(result+i, v);
+    }
+    for (; i < n; ++i) {
+        result[i] = CalculateUniformSpline(x[i], -kInfinity, kInfinity,
+                                           data + offset[i], dim);
+    }
+}
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:4
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
@@ -0,0 +1,422 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#include "CompiledFormula.h"
+
+#include "GenericToolbox.Utils.h"
+#include "Logger.h"
+
+#include <map>
+#include <sstream>
+#include <cstdlib>
+#include <cctype>
+
+
+LoggerInit([]{
+  Logger::setUserHeaderStr("[CompiledFormula]");
+});
+
+
+namespace{
+
+  struct FunctionDefinition{
+    CompiledFormula::Function function;
+    int nArgs;
+  };
+
+  const std::map<std::string, FunctionDefinition>& getFunctionDict(){
+    using F = CompiledFormula::Function;
+    static const std::map<std::string, FunctionDefinition> functionDict{
+        {"abs", {F::Abs, 1}},     {"fabs", {F::Abs, 1}},   {"TMath::Abs", {F::Abs, 1}},
+        {"sqrt", {F::Sqrt, 1}},   {"TMath::Sqrt", {F::Sqrt, 1}},
+        {"exp", {F::Exp, 1}},     {"TMath::Exp", {F::Exp, 1}},
+        {"log", {F::Log, 1}},     {"TMath::Log", {F::Log, 1}},
+        {"log10", {F::Log10, 1}}, {"TMath::Log10", {F::Log10, 1}},
+        {"sin", {F::Sin, 1}},     {"TMath::Sin", {F::Sin, 1}},
+        {"cos", {F::Cos, 1}},     {"TMath::Cos", {F::Cos, 1}},
+        {"tan", {F::Tan, 1}},     {"TMath::Tan", {F::Tan, 1}},
+        {"asin", {F::ASin, 1}},   {"TMath::ASin", {F::ASin, 1}},
+        {"acos", {F::ACos, 1}},   {"TMath::ACos", {F::ACos, 1}},
+        {"atan", {F::ATan, 1}},   {"TMath::ATan", {F::ATan, 1}},
+        {"sinh", {F::SinH, 1}},   {"TMath::SinH", {F::SinH, 1}},
+        {"cosh", {F::CosH, 1}},   {"TMath::CosH", {F::CosH, 1}},
+        {"tanh", {F::TanH, 1}},   {"TMath::TanH", {F::TanH, 1}},
+        {"floor", {F::Floor, 1}}, {"TMath::Floor", {F::Floor, 1}},
+        {"ceil", {F::Ceil, 1}},   {"TMath::Ceil", {F::Ceil, 1}},
+        {"pow", {F::Pow, 2}},     {"TMath::Power", {F::Pow, 2}},
+        {"atan2", {F::ATan2, 2}}, {"TMath::ATan2", {F::ATan2, 2}},
+        {"min", {F::Min, 2}},     {"TMath::Min", {F::Min, 2}},
+        {"max", {F::Max, 2}},     {"TMath::Max", {F::Max, 2}},
+    };
+    return functionDict;
+  }
+
+  /// Recursive descent parser, with the C operator precedence
+  class Parser{
+
+  public:
+    Parser(const std::string& formulaStr_, std::vector<CompiledFormula::Instruction>& instructionList_, std::vector<std::string>& variableNameList_):
+        _str_(formulaStr_), _instructionList_(instructionList_), _variableNameList_(variableNameList_) {}
+
+    [[nodiscard]] const std::string& getErrorMessage() const{ return _errorMessage_; }
+
+    bool parse(){
+      if( not this->parseOr() ){ return false; }
+      this->skipSpaces();
+      if( _pos_ != _str_.size() ){ return this->fail("unexpected character"); }
+      return true;
+    }
+
+  private:
+    bool fail(const std::string& message_){
+      if( _errorMessage_.empty() ){
+        std::stringstream ss;
+        ss << message_ << " at position " << _pos_ << " of \"" << _str_ << "\"";
+        _errorMessage_ = ss.str();
+      }
+      return false;
+    }
+
+    void skipSpaces(){ while( _pos_ < _str_.size() and std::isspace(static_cast<unsigned char>(_str_[_pos_])) ){ _pos_++; } }
+
+    // matches the token, but not if it is the beginning of a longer one (e.g. "&" in "&&")
+    bool accept(const char* token_, const char* notFollowedBy_ = nullptr){
+      this->skipSpaces();
+      size_t length{std::char_traits<char>::length(token_)};
+      if( _str_.compare(_pos_, length, token_) != 0 ){ return false; }
+      if( notFollowedBy_ != nullptr and _pos_ + length < _str_.size()
+          and std::char_traits<char>::find(notFollowedBy_, std::char_traits<char>::length(notFollowedBy_), _str_[_pos_ + length]) != nullptr ){
+        return false;
+      }
+      _pos_ += length;
+      return true;
+    }
+
+    bool emit(CompiledFormula::OpCode op_, int index_ = -1, double value_ = 0){
+      using Op = CompiledFormula::OpCode;
+      if     ( op_ == Op::Constant or op_ == Op::Variable ){ _stackSize_++; }
+      else if( op_ != Op::Negate and op_ != Op::Not and op_ != Op::Function1 ){ _stackSize_--; }
+      if( _stackSize_ > CompiledFormula::kMaxStackSize ){ return this->fail("formula too deeply nested"); }
+      _instructionList_.emplace_back( CompiledFormula::Instruction{op_, index_, value_} );
+      return true;
+    }
+
+    // true if the last parsed operand is a "op_" expression that is not within parentheses
+    bool isUngrouped(CompiledFormula::OpCode firstOp_, CompiledFormula::OpCode lastOp_) const{
+      if( _instructionList_.empty() or _instructionList_.size() == _lastGroupEnd_ ){ return false; }
+      auto op = _instructionList_.back().op;
+      return int(op) >= int(firstOp_) and int(op) <= int(lastOp_);
+    }
+    // TTreeFormula and TFormula don't agree on the precedence of the bitwise
+    // operators over the comparisons: those formulas are left to ROOT
+    bool checkBitwiseOperand(){
+      if( this->isUngrouped(CompiledFormula::OpCode::Less, CompiledFormula::OpCode::NotEqual) ){
+        return this->fail("comparison used as a bitwise operand without parentheses");
+      }
+      return true;
+    }
+
+    // generic left-associative binary level
+    template<typename Next, typename Match> bool parseBinaryLevel(Next next_, Match match_, bool isBitwise_ = false){
+      if( not next_() ){ return false; }
+      CompiledFormula::OpCode op{};
+      while( match_(op) ){
+        if( isBitwise_ and not this->checkBitwiseOperand() ){ return false; }
+        if( not next_() ){ return false; }
+        if( isBitwise_ and not this->checkBitwiseOperand() ){ return false; }
+        if( not this->emit(op) ){ return false; }
+      }
+      return true;
+    }
+
+    bool parseOr(){
+      return this->parseBinaryLevel([&]{ return this->parseAnd(); }, [&](CompiledFormula::OpCode& op_){
+        if( this->accept("||") ){ op_ = CompiledFormula::OpCode::Or; return true; }
+        return false;
+      });
+    }
+    bool parseAnd(){
+      return this->parseBinaryLevel([&]{ return this->parseBitOr(); }, [&](CompiledFormula::OpCode& op_){
+        if( this->accept("&&") ){ op_ = CompiledFormula::OpCode::And; return true; }
+        return false;
+      });
+    }
+    bool parseBitOr(){
+      return this->parseBinaryLevel([&]{ return this->parseBitAnd(); }, [&](CompiledFormula::OpCode& op_){
+        if( this->accept("|", "|") ){ op_ = CompiledFormula::OpCode::BitOr; return true; }
+        return false;
+      }, true);
+    }
+    bool parseBitAnd(){
+      return this->parseBinaryLevel([&]{ return this->parseEquality(); }, [&](CompiledFormula::OpCode& op_){
+        if( this->accept("&", "&") ){ op_ = CompiledFormula::OpCode::BitAnd; return true; }
+        return false;
+      }, true);
+    }
+    bool parseEquality(){
+      return this->parseBinaryLevel([&]{ return this->parseRelational(); }, [&](CompiledFormula::OpCode& op_){
+        if( this->accept("==") ){ op_ = CompiledFormula::OpCode::Equal; return true; }
+        if( this->accept("!=") ){ op_ = CompiledFormula::OpCode::NotEqual; return true; }
+        return false;
+      });
+    }
+    bool parseRelational(){
+      return this->parseBinaryLevel([&]{ return this->parseAdditive(); }, [&](CompiledFormula::OpCode& op_){
+        if( this->accept("<=") ){ op_ = CompiledFormula::OpCode::LessEqual; return true; }
+        if( this->accept(">=") ){ op_ = CompiledFormula::OpCode::GreaterEqual; return true; }
+        if( this->accept("<", "<") ){ op_ = CompiledFormula::OpCode::Less; return true; }
+        if( this->accept(">", ">") ){ op_ = CompiledFormula::OpCode::Greater; return true; }
+        return false;
+      });
+    }
+    bool parseAdditive(){
+      return this->parseBinaryLevel([&]{ return this->parseMultiplicative(); }, [&](CompiledFormula::OpCode& op_){
+        if( this->accept("+") ){ op_ = CompiledFormula::OpCode::Add; return true; }
+        if( this->accept("-") ){ op_ = CompiledFormula::OpCode::Subtract; return true; }
+        return false;
+      });
+    }
+    bool parseMultiplicative(){
+      return this->parseBinaryLevel([&]{ return this->parseUnary(); }, [&](CompiledFormula::OpCode& op_){
+        if( this->accept("*", "*") ){ op_ = CompiledFormula::OpCode::Multiply; return true; }
+        if( this->accept("/") ){ op_ = CompiledFormula::OpCode::Divide; return true; }
+        if( this->accept("%") ){ op_ = CompiledFormula::OpCode::Modulo; return true; }
+        return false;
+      });
+    }
+    bool parseUnary(){
+      if( this->accept("-") ){
+        size_t firstInstruction{_instructionList_.size()};
+        if( not this->parseUnary() ){ return false; }
+        // -x^2 is -(x^2) for TFormula, but not for every ROOT version of TTreeFormula
+        if( this->isUngrouped(CompiledFormula::OpCode::Power, CompiledFormula::OpCode::Power) ){
+          return this->fail("unary minus of a power without parentheses");
+        }
+        // negative numbers are folded
+        if( _instructionList_.size() == firstInstruction + 1 and _instructionList_.back().op == CompiledFormula::OpCode::Constant ){
+          _instructionList_.back().value = -_instructionList_.back().value;
+          return true;
+        }
+        return this->emit(CompiledFormula::OpCode::Negate);
+      }
+      if( this->accept("+") ){ return this->parseUnary(); }
+      if( this->accept("!", "=") ){
+        if( not this->parseUnary() ){ return false; }
+        return this->emit(CompiledFormula::OpCode::Not);
+      }
+      return this->parsePower();
+    }
+    bool parsePower(){
+      if( not this->parsePrimary() ){ return false; }
+      if( this->accept("^") or this->accept("**") ){
+        // right associative
+        if( not this->parseUnary() ){ return false; }
+        return this->emit(CompiledFormula::OpCode::Power);
+      }
+      return true;
+    }
+
+    bool parsePrimary(){
+      this->skipSpaces();
+      if( _pos_ >= _str_.size() ){ return this->fail("unexpected end of formula"); }
+      char c{_str_[_pos_]};
+
+      if( this->accept("(") ){
+        if( not this->parseOr() ){ return false; }
+        if( not this->accept(")") ){ return this->fail("missing \")\""); }
+        _lastGroupEnd_ = _instructionList_.size();
+        return true;
+      }
+
+      if( std::isdigit(static_cast<unsigned char>(c)) or c == '.' ){
+        const char* begin{_str_.c_str() + _pos_};
+        char* end{nullptr};
+        double value{std::strtod(begin, &end)};
+        if( end == begin ){ return this->fail("invalid number"); }
+        _pos_ += size_t(end - begin);
+        return this->emit(CompiledFormula::OpCode::Constant, -1, value);
+      }
+
+      // TFormula parameter
+      if( c == '[' ){
+        size_t end{_str_.find(']', _pos_)};
+        if( end == std::string::npos ){ return this->fail("missing \"]\""); }
+        std::string name{GenericToolbox::trimString(_str_.substr(_pos_ + 1, end - _pos_ - 1), " ")};
+        if( name.empty() or std::isdigit(static_cast<unsigned char>(name[0])) ){ return this->fail("numbered parameters are not handled"); }
+        _pos_ = end + 1;
+        return this->emitVariable(name);
+      }
+
+      if( not ( std::isalpha(static_cast<unsigned char>(c)) or c == '_' ) ){ return this->fail("unexpected character"); }
+
+      std::string name{};
+      while( _pos_ < _str_.size() ){
+        char n{_str_[_pos_]};
+        if( std::isalnum(static_cast<unsigned char>(n)) or n == '_' or n == '.' ){ name += n; _pos_++; }
+        else if( _str_.compare(_pos_, 2, "::") == 0 ){ name += "::"; _pos_ += 2; }
+        else{ break; }
+      }
+
+      if( this->accept("(") ){
+        if( name == "TMath::Pi" ){
+          if( not this->accept(")") ){ return this->fail("TMath::Pi() takes no argument"); }
+          return this->emit(CompiledFormula::OpCode::Constant, -1, M_PI);
+        }
+        auto function = getFunctionDict().find(name);
+        if( function == getFunctionDict().end() ){ return this->fail("unknown function \"" + name + "\""); }
+        for( int iArg = 0 ; iArg < function->second.nArgs ; iArg++ ){
+          if( iArg != 0 and not this->accept(",") ){ return this->fail("missing argument"); }
+          if( not this->parseOr() ){ return false; }
+        }
+        if( not this->accept(")") ){ return this->fail("missing \")\""); }
+        return this->emit(
+            function->second.nArgs == 1 ? CompiledFormula::OpCode::Function1 : CompiledFormula::OpCode::Function2,
+            int(function->second.function)
+        );
+      }
+
+      if( name == "true" or name == "kTRUE" ){ return this->emit(CompiledFormula::OpCode::Constant, -1, 1); }
+      if( name == "false" or name == "kFALSE" ){ return this->emit(CompiledFormula::OpCode::Constant, -1, 0); }
+      if( name == "pi" ){ return this->emit(CompiledFormula::OpCode::Constant, -1, M_PI); }
+
+      // constant array subscripts are part of the variable name
+      while( this->accept("[") ){
+        this->skipSpaces();
+        size_t begin{_pos_};
+        while( _pos_ < _str_.size() and std::isdigit(static_cast<unsigned char>(_str_[_pos_])) ){ _pos_++; }
+        if( _pos_ == begin ){ return this->fail("only constant array indices are handled"); }
+        std::string index{_str_.substr(begin, _pos_ - begin)};
+        if( not this->accept("]") ){ return this->fail("missing \"]\""); }
+        name += "[" + index + "]";
+      }
+
+      return this->emitVariable(name);
+    }
+
+    bool emitVariable(const std::string& name_){
+      int index{GenericToolbox::findElementIndex(name_, _variableNameList_)};
+      if( index == -1 ){
+        index = int(_variableNameList_.size());
+        _variableNameList_.emplace_back( name_ );
+      }
+      return this->emit(CompiledFormula::OpCode::Variable, index);
+    }
+
+  private:
+    const std::string& _str_;
+    std::vector<CompiledFormula::Instruction>& _instructionList_;
+    std::vector<std::string>& _variableNameList_;
+    std::string _errorMessage_{};
+    size_t _pos_{0};
+    int _stackSize_{0};
+    size_t _lastGroupEnd_{0}; // size of the instruction list when the last parenthesis was closed
+
+  };
+
+}
+
+
+bool CompiledFormula::compile(const std::string& formulaStr_){
+  _formulaStr_ = formulaStr_;
+  _errorMessage_.clear();
+  _variableNameList_.clear();
+  _instructionList_.clear();
+
+  Parser parser(_formulaStr_, _instructionList_, _variableNameList_);
+  if( not parser.parse() ){
+    _errorMessage_ = parser.getErrorMessage();
+    _variableNameList_.clear();
+    _instructionList_.clear();
+    return false;
+  }
+
+  return true;
+}
+
+std::string CompiledFormula::getSummary() const{
+  std::stringstream ss;
+  ss << "\"" << _formulaStr_ << "\": ";
+  if( not this->isCompiled() ){ ss << "not compiled (" << _errorMessage_ << ")"; }
+  else{
+    ss << _instructionList_.size() << " instructions, variables: " << GenericToolbox::toString(_variableNameList_);
+  }
+  return ss.str();
+}
+
+bool CompiledFormula::parseValueType(const std::string& typeName_, ValueType& type_){
+  static const std::map<std::string, ValueType> typeDict{
+      {"Double_t", ValueType::Double},   {"double", ValueType::Double},
+      {"Float_t", ValueType::Float},     {"float", ValueType::Float},
+      {"Long64_t", ValueType::Long64},   {"Long_t", ValueType::Long64},   {"long", ValueType::Long64},
+      {"ULong64_t", ValueType::ULong64}, {"ULong_t", ValueType::ULong64}, {"unsigned long", ValueType::ULong64},
+      {"Int_t", ValueType::Int},         {"int", ValueType::Int},
+      {"UInt_t", ValueType::UInt},       {"unsigned int", ValueType::UInt},
+      {"Short_t", ValueType::Short},     {"short", ValueType::Short},
+      {"UShort_t", ValueType::UShort},   {"unsigned short", ValueType::UShort},
+      {"Char_t", ValueType::Char},       {"char", ValueType::Char},
+      {"UChar_t", ValueType::UChar},     {"unsigned char", ValueType::UChar},
+      {"Bool_t", ValueType::Bool},       {"bool", ValueType::Bool},
+  };
+  auto type = typeDict.find(typeName_);
+  if( type == typeDict.end() ){ return false; }
+  type_ = type->second;
+  return true;
+}
+double CompiledFormula::evalFunction(Function function_, double x_){
+  switch( function_ ){
+    case Function::Abs:   return std::abs(x_);
+    case Function::Sqrt:  return std::sqrt(x_);
+    case Function::Exp:   return std::exp(x_);
+    case Function::Log:   return std::log(x_);
+    case Function::Log10: return std::log10(x_);
+    case Function::Sin:   return std::sin(x_);
+    case Function::Cos:   return std::cos(x_);
+    case Function::Tan:   return std::tan(x_);
+    case Function::ASin:  return std::asin(x_);
+    case Function::ACos:  return std::acos(x_);
+    case Function::ATan:  return std::atan(x_);
+    case Function::SinH:  return std::sinh(x_);
+    case Function::CosH:  return std::cosh(x_);
+    case Function::TanH:  return std::tanh(x_);
+    case Function::Floor: return std::floor(x_);
+    case Function::Ceil:  return std::ceil(x_);
+    default: LogThrow("Not a single argument function: " << int(function_));
+  }
+}
+double CompiledFormula::evalFunction(Function function_, double x_, double y_){
+  switch( function_ ){
+    case Function::Pow:   return std::pow(x_, y_);
+    case Function::ATan2: return std::atan2(x_, y_);
+    case Function::Min:   return std::min(x_, y_);
+    case Function::Max:   return std::max(x_, y_);
+    default: LogThrow("Not a two arguments function: " << int(function_));
+  }
+}
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
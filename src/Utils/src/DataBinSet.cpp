@@ -11,6 +11,7 @@
 #include <string>
 #include <sstream>
 #include <stdexcept>
+#include <algorithm>
 
 
 LoggerInit([]{
@@ -38,6 +39,7 @@ void DataBinSet::readBinningDefinition(const std::string &filePath_) {
 
   this->sortBinEdges();
   this->checkBinning();
+  this->buildSearchIndex();
 }
 
 void DataBinSet::checkBinning(){
@@ -60,6 +62,131 @@ void DataBinSet::checkBinning(){
   LogThrowIf(hasErrors);
 
 }
+void DataBinSet::buildSearchIndex(){
+  _searchIndexNbBins_ = 0;
+  _searchVarList_.clear();
+  _searchNodeList_.clear();
+
+  // scanning a few bins is as fast
+  if( _binList_.size() < 16 ){ return; }
+
+  // the bins can only be split along variables defined as a range in all of them
+  std::vector<std::vector<const DataBin::Edges*>> edgesTable(_binList_.size());
+  for( auto& varName : this->buildVariableNameList() ){
+    bool isRangeInAllBins{true};
+    for( auto& bin : _binList_ ){
+      auto* edgesPtr = bin.getVarEdgesPtr( varName );
+      if( edgesPtr == nullptr or edgesPtr->isConditionVar ){ isRangeInAllBins = false; break; }
+    }
+    if( not isRangeInAllBins ){ continue; }
+
+    _searchVarList_.emplace_back();
+    _searchVarList_.back().name = varName;
+    _searchVarList_.back().binIndex = 0;
+    _searchVarList_.back().edgesIndex = int( _binList_[0].getVarEdgesPtr( varName ) - _binList_[0].getEdgesList().data() );
+    for( size_t iBin = 0 ; iBin < _binList_.size() ; iBin++ ){
+      edgesTable[iBin].emplace_back( _binList_[iBin].getVarEdgesPtr( varName ) );
+    }
+  }
+  if( _searchVarList_.empty() ){ return; }
+
+  std::vector<int> binIndexList(_binList_.size());
+  for( int iBin = 0 ; iBin < int(_binList_.size()) ; iBin++ ){ binIndexList[iBin] = iBin; }
+
+  std::vector<bool> isVarUsedList(_searchVarList_.size(), false);
+  this->buildSearchNode( binIndexList, isVarUsedList, edgesTable );
+  _searchIndexNbBins_ = _binList_.size();
+
+  LogDebug << "Bin search index: " << _searchNodeList_.size() << " nodes along " << _searchVarList_.size() << " variables" << std::endl;
+}
+const std::vector<int>* DataBinSet::findCandidateBinList(const std::vector<double>& searchVarValueList_) const{
+  int iNode{0};
+  while( true ){
+    auto& node = _searchNodeList_[iNode];
+    if( node.searchVarIndex == -1 ){ return &node.binIndexList; }
+
+    double value{searchVarValueList_[node.searchVarIndex]};
+    auto& boundaryList = node.boundaryList;
+    if( value < boundaryList.front() or value > boundaryList.back() ){ return nullptr; }
+
+    // last boundary <= value
+    size_t iBoundary = std::distance( boundaryList.begin(), std::upper_bound(boundaryList.begin(), boundaryList.end(), value) ) - 1;
+    iNode = node.childNodeList[ boundaryList[iBoundary] == value ? 2*iBoundary : 2*iBoundary + 1 ];
+    if( iNode == -1 ){ return nullptr; }
+  }
+}
+int DataBinSet::buildSearchNode(const std::vector<int>& binIndexList_, std::vector<bool>& isVarUsedList_,
+                                const std::vector<std::vector<const DataBin::Edges*>>& edgesTable_){
+  // the node list grows with the recursion: use indices only
+  int nodeIndex{int(_searchNodeList_.size())};
+  _searchNodeList_.emplace_back();
+
+  // pick the variable leaving the fewest candidates per interval
+  int bestVarIndex{-1};
+  std::vector<double> bestBoundaryList{};
+  double bestNbCandidates{double(binIndexList_.size())};
+  if( binIndexList_.size() > 4 ){
+    std::vector<double> boundaryList;
+    for( size_t iVar = 0 ; iVar < _searchVarList_.size() ; iVar++ ){
+      if( isVarUsedList_[iVar] ){ continue; }
+
+      boundaryList.clear();
+      for( int iBin : binIndexList_ ){
+        boundaryList.emplace_back( edgesTable_[iBin][iVar]->min );
+        boundaryList.emplace_back( edgesTable_[iBin][iVar]->max );
+      }
+      std::sort( boundaryList.begin(), boundaryList.end() );
+      boundaryList.erase( std::unique(boundaryList.begin(), boundaryList.end()), boundaryList.end() );
+      if( boundaryList.size() < 2 ){ continue; }
+
+      // number of intervals covered by each bin
+      size_t nCandidates{0};
+      for( int iBin : binIndexList_ ){
+        nCandidates += std::distance(
+            std::lower_bound(boundaryList.begin(), boundaryList.end(), edgesTable_[iBin][iVar]->min),
+            std::lower_bound(boundaryList.begin(), boundaryList.end(), edgesTable_[iBin][iVar]->max)
+        );
+      }
+
+      double nCandidatesPerInterval{double(nCandidates) / double(boundaryList.size() - 1)};
+      if( nCandidatesPerInterval < bestNbCandidates ){
+        bestVarIndex = int(iVar);
+        bestNbCandidates = nCandidatesPerInterval;
+        bestBoundaryList = boundaryList;
+      }
+    }
+  }
+
+  if( bestVarIndex == -1 ){
+    // leaf: the remaining bins are checked one by one
+    _searchNodeList_[nodeIndex].binIndexList = binIndexList_;
+    return nodeIndex;
+  }
+
+  // children: boundaries -> bins having it within [min, max]
+  //           intervals  -> bins covering the whole interval
+  size_t nBoundaries{bestBoundaryList.size()};
+  std::vector<std::vector<int>> childBinIndexList(2*nBoundaries - 1);
+  for( int iBin : binIndexList_ ){
+    size_t iMin = std::distance(bestBoundaryList.begin(), std::lower_bound(bestBoundaryList.begin(), bestBoundaryList.end(), edgesTable_[iBin][bestVarIndex]->min));
+    size_t iMax = std::distance(bestBoundaryList.begin(), std::lower_bound(bestBoundaryList.begin(), bestBoundaryList.end(), edgesTable_[iBin][bestVarIndex]->max));
+    for( size_t iChild = 2*iMin ; iChild <= 2*iMax ; iChild++ ){ childBinIndexList[iChild].emplace_back( iBin ); }
+  }
+
+  std::vector<int> childNodeList(childBinIndexList.size(), -1);
+  isVarUsedList_[bestVarIndex] = true;
+  for( size_t iChild = 0 ; iChild < childBinIndexList.size() ; iChild++ ){
+    if( childBinIndexList[iChild].empty() ){ continue; }
+    childNodeList[iChild] = this->buildSearchNode( childBinIndexList[iChild], isVarUsedList_, edgesTable_ );
+  }
+  isVarUsedList_[bestVarIndex] = false;
+
+  auto& node = _searchNodeList_[nodeIndex];
+  node.searchVarIndex = bestVarIndex;
+  node.boundaryList = std::move( bestBoundaryList );
+  node.childNodeList = std::move( childNodeList );
+  return nodeIndex;
+}
 void DataBinSet::sortBins(){
 
   /// DON'T SORT THE BINS FOR DIALS!!! THE ORDER MIGHT REFER TO THE COV MATRIX DEFINITION
@@ -0,0 +1,144 @@
+//
+// Created by the GUNDAM developers on 17/10/2026.
+//
+
+#include "TruncatedGaussianSampler.h"
+
+#include "Logger.h"
+
+#include "TMatrixDSym.h"
+#include "TDecompChol.h"
+#include "Math/ProbFuncMathCore.h"
+#include "Math/QuantFuncMathCore.h"
+
+#include <algorithm>
+#include <cmath>
+
+LoggerInit([]{ Logger::setUserHeaderStr("[TruncatedGaussianSampler]"); });
+
+
+void TruncatedGaussianSampler::setCovarianceMatrix(const TMatrixDBase& covarianceMatrix_){
+  LogThrowIf(covarianceMatrix_.GetNrows() != covarianceMatrix_.GetNcols(), "Covariance matrix is not square.");
+  int nPars{covarianceMatrix_.GetNrows()};
+
+  TMatrixDSym covSym(nPars);
+  for( int iPar = 0 ; iPar < nPars ; iPar++ ){
+    for( int jPar = 0 ; jPar < nPars ; jPar++ ){ covSym[iPar][jPar] = covarianceMatrix_(iPar, jPar); }
+  }
+
+  TDecompChol choleskyDecomp(covSym);
+  LogThrowIf(not choleskyDecomp.Decompose(), "Covariance matrix is not positive definite.");
+  TMatrixDSym precisionMatrix(nPars);
+  choleskyDecomp.Invert(precisionMatrix);
+
+  this->resetChain();
+  _condSigmaList_.resize(nPars);
+  _condCoefMatrix_.assign(size_t(nPars) * nPars, 0);
+  for( int iPar = 0 ; iPar < nPars ; iPar++ ){
+    double diag{precisionMatrix[iPar][iPar]};
+    _condSigmaList_[iPar] = 1. / std::sqrt(diag);
+    for( int jPar = 0 ; jPar < nPars ; jPar++ ){
+      if( jPar == iPar ){ continue; }
+      _condCoefMatrix_[size_t(iPar) * nPars + jPar] = -precisionMatrix[iPar][jPar] / diag;
+    }
+  }
+}
+
+void TruncatedGaussianSampler::throwDeltas(
+    const std::vector<double>& minDeltaList_, const std::vector<double>& maxDeltaList_,
+    std::vector<double>& deltaList_, TRandom& rng_
+){
+  LogThrowIf(not isInitialized(), "Covariance matrix not set.");
+  size_t nPars{_condSigmaList_.size()};
+  LogThrowIf(minDeltaList_.size() != nPars or maxDeltaList_.size() != nPars, "Bounds don't match the covariance matrix.");
+
+  // NaN bounds are unbounded
+  auto getMin = [&](size_t iPar_){ return std::isnan(minDeltaList_[iPar_]) ? -INFINITY : minDeltaList_[iPar_]; };
+  auto getMax = [&](size_t iPar_){ return std::isnan(maxDeltaList_[iPar_]) ? +INFINITY : maxDeltaList_[iPar_]; };
+
+  bool isSameBounds{not _chainDeltaList_.empty()};
+  for( size_t iPar = 0 ; iPar < nPars and isSameBounds ; iPar++ ){
+    isSameBounds = ( _chainMinDeltaList_[iPar] == getMin(iPar) and _chainMaxDeltaList_[iPar] == getMax(iPar) );
+  }
+
+  if( not isSameBounds ){
+    // new chain: start from the mean, moved inside the bounds if needed
+    _chainDeltaList_.assign(nPars, 0);
+    _chainMinDeltaList_.resize(nPars);
+    _chainMaxDeltaList_.resize(nPars);
+    for( size_t iPar = 0 ; iPar < nPars ; iPar++ ){
+      double min{getMin(iPar)}, max{getMax(iPar)};
+      LogThrowIf(min > max, "Empty interval for the coordinate #" << iPar << ": [" << min << ", " << max << "]");
+      _chainMinDeltaList_[iPar] = min;
+      _chainMaxDeltaList_[iPar] = max;
+      if     ( min > 0 ){ _chainDeltaList_[iPar] = std::isfinite(max) ? 0.5 * (min + max) : min + _condSigmaList_[iPar]; }
+      else if( max < 0 ){ _chainDeltaList_[iPar] = std::isfinite(min) ? 0.5 * (min + max) : max - _condSigmaList_[iPar]; }
+    }
+    this->runSweeps(_nbBurnInSweeps_, rng_);
+  }
+
+  this->runSweeps(std::max(_nbSweeps_, 1), rng_);
+  deltaList_ = _chainDeltaList_;
+}
+
+void TruncatedGaussianSampler::runSweeps(int nbSweeps_, TRandom& rng_){
+  size_t nPars{_condSigmaList_.size()};
+  for( int iSweep = 0 ; iSweep < nbSweeps_ ; iSweep++ ){
+    for( size_t iPar = 0 ; iPar < nPars ; iPar++ ){
+      const double* coefRow{&_condCoefMatrix_[iPar * nPars]};
+      double condMean{0};
+      for( size_t jPar = 0 ; jPar < nPars ; jPar++ ){ condMean += coefRow[jPar] * _chainDeltaList_[jPar]; }
+      _chainDeltaList_[iPar] = throwTruncatedGauss(condMean, _condSigmaList_[iPar], _chainMinDeltaList_[iPar], _chainMaxDeltaList_[iPar], rng_);
+    }
+  }
+}
+double TruncatedGaussianSampler::throwTruncatedGauss(double mean_, double sigma_, double min_, double max_, TRandom& rng_){
+  double a{(min_ - mean_) / sigma_};
+  double b{(max_ - mean_) / sigma_};
+
+  double z;
+  if( a > 0 ){
+    // upper tail: work with the survival function
+    double qa{ROOT::Math::normal_cdf_c(a)};
+    double qb{std::isfinite(b) ? ROOT::Math::normal_cdf_c(b) : 0.};
+    if( qa - qb <= 0 ){ return min_; } // numerically empty: the interval is far in the tail
+    z = ROOT::Math::normal_quantile_c(qb + rng_.Rndm() * (qa - qb), 1);
+  }
+  else{
+    // lower tail or interval containing the mean
+    double pa{std::isfinite(a) ? ROOT::Math::normal_cdf(a) : 0.};
+    double pb{std::isfinite(b) ? ROOT::Math::normal_cdf(b) : 1.};
+    if( pb - pa <= 0 ){ return max_; }
+    z = ROOT::Math::normal_quantile(pa + rng_.Rndm() * (pb - pa), 1);
+  }
+
+  // protect against the rounding of the quantile functions
+  return std::min( std::max(mean_ + sigma_ * z, min_), max_ );
+}
+
+//  A Lesser GNU Public License
+
+//  Copyright (C) 2023 GUNDAM DEVELOPERS
+
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the
+//
+//  Free Software Foundation, Inc.
+//  51 Franklin Street, Fifth Floor,
+//  Boston, MA  02110-1301  USA
+
+// Local Variables:
+// mode:c++
+// c-basic-offset:2
+// compile-command:"$(git rev-parse --show-toplevel)/cmake/gundam-build.sh"
+// End:
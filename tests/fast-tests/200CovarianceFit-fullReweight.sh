@@ -0,0 +1,48 @@
+#!/bin/bash
+
+# Set the base name for this test (should match the script name)
+BASE=200CovarianceFit
+
+# Get the directory containing the script from the command line
+# parameters (avoids bash trickery).  Use the current directory as the
+# default.
+DIR=.
+if [ ${#1} -gt 0 ]; then
+    DIR=${1}
+fi
+
+# Make sure that gundam has been setup.
+if ! which gundamFitter; then
+    echo FAIL: Executable not found for gundamFitter
+    exit 1
+fi
+
+# Set the expected locations for the config and output files.
+export CONFIG_DIR=${DIR}
+export DATA_DIR=${PWD}
+
+CONFIG_FILE=${CONFIG_DIR}/${BASE}-config.yaml
+OVERRIDE_FILE=${CONFIG_DIR}/${BASE}-fullReweight-override.yaml
+OUTPUT_FILE=${DATA_DIR}/${BASE}-fullReweight.root
+LOG_FILE=${DATA_DIR}/${BASE}-fullReweight.log
+
+echo ${OUTPUT_FILE}
+echo ${CONFIG_FILE}
+echo ${OVERRIDE_FILE}
+
+gundamFitter -t 1 -s 10000 -c ${CONFIG_FILE} -of ${OVERRIDE_FILE} -o ${OUTPUT_FILE} 2>&1 | tee ${LOG_FILE}
+if [ ${PIPESTATUS[0]} -ne 0 ]; then
+    echo FAIL: gundamFitter failed
+    exit 1
+fi
+
+# Every event must have been reweighted at each propagation.
+if ! grep "GroupedDialEngine: .* with full reweights" ${LOG_FILE}; then
+    echo FAIL: The incremental reweight was not disabled
+    exit 1
+fi
+
+# The fit must give the same result as 200CovarianceFit.sh
+${DIR}/900CovarianceFitCheck.C ${DIR} fullReweight || exit 1
+
+# End of the script
@@ -0,0 +1,57 @@
+#!/bin/bash
+
+# Set the base name for this test (should match the script name)
+BASE=200CovarianceFit
+
+# Get the directory containing the script from the command line
+# parameters (avoids bash trickery).  Use the current directory as the
+# default.
+DIR=.
+if [ ${#1} -gt 0 ]; then
+    DIR=${1}
+fi
+
+# Make sure that gundam has been setup.
+if ! which gundamFitter; then
+    echo FAIL: Executable not found for gundamFitter
+    exit 1
+fi
+
+# Set the expected locations for the config and output files.
+export CONFIG_DIR=${DIR}
+export DATA_DIR=${PWD}
+
+CONFIG_FILE=${CONFIG_DIR}/${BASE}-config.yaml
+OVERRIDE_FILE=${CONFIG_DIR}/${BASE}-parallelHesse-override.yaml
+OUTPUT_FILE=${DATA_DIR}/${BASE}-parallelHesse.root
+LOG_FILE=${DATA_DIR}/${BASE}-parallelHesse.log
+
+echo ${OUTPUT_FILE}
+echo ${CONFIG_FILE}
+echo ${OVERRIDE_FILE}
+
+gundamFitter -t 2 -s 10000 -c ${CONFIG_FILE} -of ${OVERRIDE_FILE} -o ${OUTPUT_FILE} 2>&1 | tee ${LOG_FILE}
+if [ ${PIPESTATUS[0]} -ne 0 ]; then
+    echo FAIL: gundamFitter failed
+    exit 1
+fi
+
+# The stencil of norm_B must have been kept within its limits.
+if ! grep "norm_B is close to its limits: one-sided difference" ${LOG_FILE}; then
+    echo FAIL: The stencil of norm_B was not one-sided
+    exit 1
+fi
+
+# The parallel HESSE must have been compared with the Minuit2 one.  The
+# comparison throws if they differ, so the fit failed in that case.
+if ! grep "Parallel HESSE errors agree with" ${LOG_FILE}; then
+    echo FAIL: The parallel HESSE was not checked
+    exit 1
+fi
+
+# The written errors are the parallel HESSE ones, which agree with
+# 200CovarianceFit.sh within parallelHesseTolerance (so 2E-2 on the
+# variances).
+${DIR}/900CovarianceFitCheck.C ${DIR} parallelHesse 2E-2 || exit 1
+
+# End of the script
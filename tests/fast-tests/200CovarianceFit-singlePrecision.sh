@@ -0,0 +1,50 @@
+#!/bin/bash
+
+# Set the base name for this test (should match the script name)
+BASE=200CovarianceFit
+
+# Get the directory containing the script from the command line
+# parameters (avoids bash trickery).  Use the current directory as the
+# default.
+DIR=.
+if [ ${#1} -gt 0 ]; then
+    DIR=${1}
+fi
+
+# Make sure that gundam has been setup.
+if ! which gundamFitter; then
+    echo FAIL: Executable not found for gundamFitter
+    exit 1
+fi
+
+# Set the expected locations for the config and output files.
+export CONFIG_DIR=${DIR}
+export DATA_DIR=${PWD}
+
+CONFIG_FILE=${CONFIG_DIR}/${BASE}-config.yaml
+OVERRIDE_FILE=${CONFIG_DIR}/${BASE}-singlePrecision-override.yaml
+OUTPUT_FILE=${DATA_DIR}/${BASE}-singlePrecision.root
+LOG_FILE=${DATA_DIR}/${BASE}-singlePrecision.log
+
+echo ${OUTPUT_FILE}
+echo ${CONFIG_FILE}
+echo ${OVERRIDE_FILE}
+
+gundamFitter -t 1 -s 10000 -c ${CONFIG_FILE} -of ${OVERRIDE_FILE} -o ${OUTPUT_FILE} 2>&1 | tee ${LOG_FILE}
+if [ ${PIPESTATUS[0]} -ne 0 ]; then
+    echo FAIL: gundamFitter failed
+    exit 1
+fi
+
+# The LLH must have been compared with the double precision dials, and
+# the fitter stops if they differ by more than singlePrecisionMaxDeltaLlh.
+if ! grep "Max LLH difference with single precision dials" ${LOG_FILE}; then
+    echo FAIL: The single precision dials were not checked
+    exit 1
+fi
+
+# The fit must give the same result as 200CovarianceFit.sh within the
+# float precision.
+${DIR}/900CovarianceFitCheck.C ${DIR} singlePrecision 1E-3 || exit 1
+
+# End of the script
@@ -0,0 +1,57 @@
+#!/bin/bash
+
+# Set the base name for this test (should match the script name)
+BASE=200CovarianceFit
+
+# Get the directory containing the script from the command line
+# parameters (avoids bash trickery).  Use the current directory as the
+# default.
+DIR=.
+if [ ${#1} -gt 0 ]; then
+    DIR=${1}
+fi
+
+# Make sure that gundam has been setup.
+if ! which gundamFitter; then
+    echo FAIL: Executable not found for gundamFitter
+    exit 1
+fi
+
+# Set the expected locations for the config and output files.
+export CONFIG_DIR=${DIR}
+export DATA_DIR=${PWD}
+
+CONFIG_FILE=${CONFIG_DIR}/${BASE}-config.yaml
+OVERRIDE_FILE=${CONFIG_DIR}/${BASE}-snapshot-override.yaml
+OUTPUT_FILE=${DATA_DIR}/${BASE}-snapshot.root
+LOG_FILE=${DATA_DIR}/${BASE}-snapshot.log
+
+echo ${OUTPUT_FILE}
+echo ${CONFIG_FILE}
+echo ${OVERRIDE_FILE}
+
+# The first run writes the dataset snapshots, the second one reads them back.
+rm -rf ${DATA_DIR}/${BASE}-snapshot
+gundamFitter -t 1 -s 10000 -c ${CONFIG_FILE} -of ${OVERRIDE_FILE} -o ${DATA_DIR}/${BASE}-snapshotWrite.root || exit 1
+if ! ls ${DATA_DIR}/${BASE}-snapshot/*.gundam.snapshot; then
+    echo FAIL: No snapshot written in ${DATA_DIR}/${BASE}-snapshot
+    exit 1
+fi
+gundamFitter -t 1 -s 10000 -c ${CONFIG_FILE} -of ${OVERRIDE_FILE} -o ${OUTPUT_FILE} 2>&1 | tee ${LOG_FILE}
+if [ ${PIPESTATUS[0]} -ne 0 ]; then
+    echo FAIL: gundamFitter failed
+    exit 1
+fi
+
+# The second run must have read the events back from every snapshot.
+NB_SNAPSHOTS=$(ls ${DATA_DIR}/${BASE}-snapshot/*.gundam.snapshot | wc -l)
+NB_LOADED=$(grep -c "Loaded .* from snapshot" ${LOG_FILE})
+if [ ${NB_LOADED} -lt ${NB_SNAPSHOTS} ]; then
+    echo FAIL: Only ${NB_LOADED} of the ${NB_SNAPSHOTS} snapshots were loaded
+    exit 1
+fi
+
+# The fit must give the same result as 200CovarianceFit.sh
+${DIR}/900CovarianceFitCheck.C ${DIR} snapshot || exit 1
+
+# End of the script
@@ -0,0 +1,35 @@
+#!/bin/bash
+
+# Set the base name for this test (should match the script name)
+BASE=210CalcXsec
+
+# Get the directory containing the script from the command line
+# parameters (avoids bash trickery).  Use the current directory as the
+# default.
+DIR=.
+if [ ${#1} -gt 0 ]; then
+    DIR=${1}
+fi
+
+# Make sure that gundam has been setup.
+if ! which gundamCalcXsec; then
+    echo FAIL: Executable not found for gundamCalcXsec
+    exit 1
+fi
+
+# Set the expected locations for the config and output files.
+export CONFIG_DIR=${DIR}
+export DATA_DIR=${PWD}
+
+CONFIG_FILE=${CONFIG_DIR}/${BASE}-config.yaml
+FITTER_FILE=${DATA_DIR}/200CovarianceFit.root
+
+echo ${FITTER_FILE}
+echo ${CONFIG_FILE}
+
+# The same toys are generated with the propagator, then on propagator
+# replicas.  The two results are compared by 910CalcXsecCheck.C
+gundamCalcXsec -t 2 -s 10000 -n 500 -f ${FITTER_FILE} -c ${CONFIG_FILE} -o ${DATA_DIR}/${BASE}.root || exit 1
+gundamCalcXsec -t 2 -s 10000 -n 500 --nb-replicas 2 -f ${FITTER_FILE} -c ${CONFIG_FILE} -o ${DATA_DIR}/${BASE}-replicas.root || exit 1
+
+# End of the script
@@ -0,0 +1,33 @@
+#!/bin/bash
+
+# Set the base name for this test (should match the script name)
+BASE=215CalcXsecBounded
+
+# Get the directory containing the script from the command line
+# parameters (avoids bash trickery).  Use the current directory as the
+# default.
+DIR=.
+if [ ${#1} -gt 0 ]; then
+    DIR=${1}
+fi
+
+# Make sure that gundam has been setup.
+if ! which gundamCalcXsec; then
+    echo FAIL: Executable not found for gundamCalcXsec
+    exit 1
+fi
+
+# Set the expected locations for the config and output files.
+export CONFIG_DIR=${DIR}
+export DATA_DIR=${PWD}
+
+FITTER_FILE=${DATA_DIR}/200CovarianceFit.root
+
+echo ${FITTER_FILE}
+
+# The same bounded toys are thrown by rejection, then with the Gibbs
+# sampler.  The two results are compared by 915CalcXsecBoundedCheck.C
+gundamCalcXsec -t 2 -s 10000 -n 2000 -f ${FITTER_FILE} -c ${CONFIG_DIR}/${BASE}-rejection-config.yaml -o ${DATA_DIR}/${BASE}-rejection.root || exit 1
+gundamCalcXsec -t 2 -s 20000 -n 2000 -f ${FITTER_FILE} -c ${CONFIG_DIR}/${BASE}-gibbs-config.yaml -o ${DATA_DIR}/${BASE}-gibbs.root || exit 1
+
+# End of the script
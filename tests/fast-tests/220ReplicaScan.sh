@@ -0,0 +1,33 @@
+#!/bin/bash
+
+# Set the base name for this test (should match the script name)
+BASE=220ReplicaScan
+
+# Get the directory containing the script from the command line
+# parameters (avoids bash trickery).  Use the current directory as the
+# default.
+DIR=.
+if [ ${#1} -gt 0 ]; then
+    DIR=${1}
+fi
+
+# Make sure that gundam has been setup.
+if ! which gundamFitter; then
+    echo FAIL: Executable not found for gundamFitter
+    exit 1
+fi
+
+# Set the expected locations for the config and output files.
+export CONFIG_DIR=${DIR}
+export DATA_DIR=${PWD}
+
+CONFIG_FILE=${CONFIG_DIR}/200CovarianceFit-config.yaml
+
+echo ${CONFIG_FILE}
+
+# Scan the pre-fit parameters one point at a time with the default
+# (incremental) propagation, then on propagator replicas.  The two scans are compared by 920ReplicaScanCheck.C
+gundamFitter -t 2 -s 10000 -d --scan 20 -c ${CONFIG_FILE} -o ${DATA_DIR}/${BASE}-serial.root || exit 1
+gundamFitter -t 2 -s 10000 -d --scan 20 -c ${CONFIG_FILE} -of ${CONFIG_DIR}/${BASE}-replicas-override.yaml -o ${DATA_DIR}/${BASE}-replicas.root
+
+# End of the script